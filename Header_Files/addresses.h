@@ -5,6 +5,7 @@
 
 #include "context.h"
 #include "instructions.h"
+#include "intern_pool.h"
 
 
 
@@ -37,6 +38,10 @@ typedef struct address_update_request {
  * are not yet resolved (e.g., direct or matrix operands). The request
  * will later be processed to patch the final label address.
  *
+ * The request is added at the head of the list (without walking the list),
+ * so the first pass builds the list in the reverse address order and
+ * restores the address order at its end (reverse_addr_update_requests).
+ *
  * @param IC_addr       Instruction counter (IC) address to be updated.
  * @param operand       Pointer to the operand requiring address resolution.
  * @param request_list  Pointer to the head of the address update request list.
@@ -45,6 +50,14 @@ typedef struct address_update_request {
 boolean add_addr_update_request(unsigned int IC_addr, operand* operand, address_update_request_ptr *request_list);
 
 
+/**
+ * @brief Reverse the order of the address update requests list.
+ *
+ * @param request_list Pointer to the head of the address update request list.
+ */
+void reverse_addr_update_requests(address_update_request_ptr *request_list);
+
+
 /**
  * @brief Print all address update requests in the list.
  *
@@ -52,8 +65,9 @@ boolean add_addr_update_request(unsigned int IC_addr, operand* operand, address_
  * where the final label address should be patched.
  *
  * @param request_list Head of the address update request list.
+ * @param names        The names pool (the operand label names).
  */
-void print_addr_update_requests(address_update_request_ptr request_list);
+void print_addr_update_requests(address_update_request_ptr request_list, const intern_pool *names);
 
 
 /**
@@ -63,6 +77,10 @@ void print_addr_update_requests(address_update_request_ptr request_list);
  * instruction memory words with the correct relocated label addresses.
  * Also updates encoding type (e.g., EXTERNAL or RELOCATABLE).
  *
+ * The requests and the instruction memory are both ordered by the addresses,
+ * so they are walked together once. Stops at the first request (in the source
+ * order) whose label isn't defined (ERROR_CODE_146).
+ *
  * @param asmContext Pointer to the assembler context containing labels,
  *                   instruction memory, and request list.
  * @return true if all requests were successfully processed, false otherwise.
@@ -123,11 +141,12 @@ boolean update_instruction_addresses(assembler_context *asmContext);
  * @brief Update request list addresses after relocation.
  *
  * Adjusts all instruction addresses stored in the address update request
- * list by adding the global memory offset.
+ * list by adding the memory offset of the target machine.
  *
- * @param request_list Head of the address update request list.
+ * @param request_list   Head of the address update request list.
+ * @param address_offset Load address of the target machine.
  */
-void update_request_list_addresses(address_update_request_ptr request_list);
+void update_request_list_addresses(address_update_request_ptr request_list, unsigned int address_offset);
 
 
 
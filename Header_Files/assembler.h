@@ -5,6 +5,32 @@
 #define ASSEMBLER_H
 
 #include "labels.h"
+#include "options.h"
+#include "build_cache.h"
+#include "config.h"
+
+
+/**
+ * @struct warm_context
+ * @brief Assembler context kept between the runs of a long-running process (server and watch modes).
+ *
+ * The constant tables, the kept tables and buffers (names pool, labels table,
+ * memory image, text buffers, nodes slabs) and the macro prelude stay loaded
+ * between the runs, so a run starts without building them again.
+ * The prelude is read again only when another prelude is requested, or when
+ * its content changed since it was read. The error sink of the warm context
+ * is set in the kept context every time it is taken (also after it was opened
+ * again).
+ */
+typedef struct warm_context {
+    boolean ready;                  /**< The context is initialized. */
+    assembler_context context;      /**< The kept context (file state recycled after every file). */
+    boolean has_prelude;            /**< A macro prelude is loaded in the context. */
+    char prelude[BUILD_CACHE_PATH_MAX_LEN + 1]; /**< Loaded prelude file ("" if its name is too long to compare). */
+    file_fingerprint prelude_print; /**< Content of the loaded prelude when it was read. */
+    error_sink_function error_sink; /**< Receives the errors of the runs (see error_report), or NULL to print them. */
+    void *error_sink_data;          /**< Data passed to the error sink. */
+} warm_context;
 
 
 
@@ -19,6 +45,10 @@
  *  - Generates output files (.obj, .ext, .ent) or removes them if not needed.
  *  - Frees all allocated memory and resources per file.
  *
+ * When the "--serve" flag is provided, the assembler runs as a persistent
+ * server instead (see run_server()), and with "--connect=<socket>" the
+ * command line is forwarded to a running server (see run_client()).
+ *
  * @param argc  Number of command-line arguments (from main).
  * @param argv  Array of command-line arguments (from main).
  *
@@ -31,17 +61,93 @@
 boolean run_assembler(int argc, char *argv[]);
 
 
+/**
+ * @brief Assemble a list of source files with the given options.
+ *
+ * Runs the full assembly workflow (preprocessor, both passes and output
+ * files generation) on every file, and prints a final summary.
+ *
+ * Without a warm context, the context of the run is initialized (and the
+ * macro prelude is read) before the files and released after them.
+ *
+ * @param files        Number of source files.
+ * @param files_names  Source file names, stored at indexes 1..files (argv style).
+ * @param options      Options of the current run.
+ * @param warm         Context kept between the runs (see get_warm_context), or NULL.
+ * @return true when all the files were processed (even if some failed to assemble).
+ */
+boolean assemble_files(int files, char *files_names[], const assembler_options *options, warm_context *warm);
+
+
+/**
+ * @brief Set an empty warm context (nothing loaded).
+ *
+ * @param warm Warm context to initialize.
+ */
+void init_warm_context(warm_context *warm);
+
+
+/**
+ * @brief Get the kept context of a run, with the requested macro prelude loaded.
+ *
+ * Initializes the context on the first call. When the loaded prelude is not
+ * @p macro_prelude (another file, another content, or none), the context is
+ * released and opened again with the requested prelude.
+ *
+ * @param warm          Warm context.
+ * @param macro_prelude Macro prelude of the run, or NULL.
+ * @return The ready context (also set as the error context), or NULL if the
+ *         prelude failed (errors printed, the warm context is left empty).
+ */
+assembler_context* get_warm_context(warm_context *warm, const char *macro_prelude);
+
+
+/**
+ * @brief Release all the memory of a warm context, and leave it empty.
+ *
+ * @param warm Warm context.
+ */
+void release_warm_context(warm_context *warm);
+
+
 
 /**
- * @brief Resets the assembler context to its initial state.
+ * @brief Initialize the assembler context of a batch of source files.
  *
- * Sets all file names, counters, error flags, and list pointers in the
- * given context to NULL or 0. This ensures a clean state before
- * processing a new source file.
+ * Sets the constant tables, creates the structures that are kept between
+ * the files (names pool, labels table, memory image and text buffers), and
+ * resets the file state (see reset_assembler). The context is released by
+ * free_all_memory at the end of the batch.
  *
  * @param asmContext Pointer to the assembler_context to initialize.
  * @return true on success, false if context pointer is NULL.
  */
 int init_assembler(assembler_context* asmContext);
 
+
+/**
+ * @brief Resets the file state of the assembler context.
+ *
+ * Sets all file names, counters, error flags, options, and list pointers
+ * in the given context to NULL or 0. This ensures a clean state before
+ * processing a new source file (after recycle_all_memory).
+ *
+ * @param asmContext Pointer to the assembler_context to reset.
+ * @return true on success, false if context pointer is NULL.
+ */
+int reset_assembler(assembler_context* asmContext);
+
+
+/**
+ * @brief Set the source file names of an initialized assembler context.
+ *
+ * Splits the source file into name and directory, adds the ".as" extension
+ * if missing, validates the name, and builds the full .as/.am file names.
+ *
+ * @param context     Initialized assembler context.
+ * @param source_file Source file as received from the user (with optional directory).
+ * @return true on success, false if the file name is invalid (error printed).
+ */
+boolean set_file_names(assembler_context *context, const char *source_file);
+
 #endif
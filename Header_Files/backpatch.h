@@ -0,0 +1,93 @@
+#ifndef BACKPATCH_H
+#define BACKPATCH_H
+
+#include "boolean.h"
+#include "context.h"
+#include "typedef.h"
+
+
+/**
+ * @file backpatch.h
+ * @brief Single pass assembly with backpatch chains ("--one-pass").
+ *
+ * A label operand whose address is known when its instruction is encoded
+ * (a code label defined before it, or an external label) is encoded at
+ * once. Otherwise the operand word is threaded into the chain of the label:
+ * the word holds the link to the previous unresolved reference of the
+ * same label (1 + its IC, 0 ends the chain), and the chain head of the
+ * label (by its name id) points to the word.
+ *
+ * The chain of a code label is patched when the label is defined, and the
+ * chain of an external label when its .extern line is read. The chains of
+ * the data labels (their addresses follow the code) are patched at the end
+ * of the input, and a chain left without a label is reported there as an
+ * undefined label. The .entry labels are kept by name and checked at the
+ * end of the input too.
+ *
+ * No address update request is made and the .am content is read once.
+ */
+
+
+/**
+ * @brief Encode the word of a label operand, or add the word to the chain of the label.
+ *
+ * @param label_name The name id of the label.
+ * @param IC_addr    The IC of the operand word.
+ * @param asmContext Assembler context (labels, externals and chains).
+ * @param word_out   [out] The encoded word, or the chain link if the address isn't known yet.
+ * @return false if the label address doesn't fit the word.
+ */
+boolean reference_label(name_id label_name, unsigned int IC_addr, assembler_context *asmContext, unsigned int *word_out);
+
+
+/**
+ * @brief Index the instruction words added since the last call by their IC (the chains are walked through them).
+ *
+ * @param asmContext Assembler context.
+ */
+void index_instruction_words(assembler_context *asmContext);
+
+
+/**
+ * @brief Patch the references made before the definition of a code label or the declaration of an external label.
+ *
+ * @param label      The label name.
+ * @param asmContext Assembler context.
+ * @return false on an encoding error or a broken chain.
+ */
+boolean patch_label_chain(const char *label, assembler_context *asmContext);
+
+
+/**
+ * @brief Keep a .entry label, it's checked at the end of the input.
+ *
+ * @param label      The entry label name.
+ * @param asmContext Assembler context (the current .am line).
+ */
+void add_entry_symbol(const char *label, assembler_context *asmContext);
+
+
+/**
+ * @brief Finish a single pass assembly at the end of the input.
+ *
+ * Marks the entry labels (ERROR_CODE_141 / ERROR_CODE_142), patches the
+ * remaining chains or reports the undefined label of the first reference in
+ * the source order (ERROR_CODE_146), and relocates the code, data and labels.
+ * These errors, and the errors of the .entry lines (printed at their lines),
+ * set the second pass error flag, as the same checks did in the second pass.
+ *
+ * @param asmContext Assembler context after a successful pass.
+ * @return true if no error was found.
+ */
+boolean resolve_backpatch_chains(assembler_context *asmContext);
+
+
+/**
+ * @brief Empty the chains and the words index of the previous file (their memory is kept).
+ *
+ * @param asmContext Assembler context.
+ */
+void reset_backpatch_chains(assembler_context *asmContext);
+
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+
+#include "boolean.h"
+#include "context.h"
+#include "options.h"
+
+
+/**
+ * @file build_cache.h
+ * @brief Results cache of the previous assemblies (server mode).
+ *
+ * While the assembler stays alive (server mode), the cache remembers a
+ * fingerprint of every source file that was assembled successfully, and
+ * of the output files that were generated for it.
+ * When the same source is requested again without any change, and its
+ * output files were not touched, the assembly is skipped, since a full run
+ * would produce exactly the same output files.
+ *
+ * A source with any changed line is assembled again from the preprocessor
+ * on, but the first pass parses only its changed lines: the unchanged lines
+ * are replayed from the records of the previous run (see line_records.h).
+ */
+
+
+/**
+ * @struct file_fingerprint
+ * @brief Identifies the content of a file.
+ */
+typedef struct file_fingerprint {
+    boolean exist;        /**< File exist (all other fields are 0 if not). */
+    unsigned long size;   /**< File size in bytes. */
+    unsigned long hash;   /**< FNV-1a hash of the file content. */
+} file_fingerprint;
+
+
+/**
+ * @brief Check if the previous output files of a source file are still valid.
+ *
+ * The build is up to date when the source file was assembled successfully
+ * before with options that generate the same output files, its content did
+ * not change since then, and all the output files generated by that run
+ * still exist with the same content (and no new output file appeared).
+ *
+ * @param asmContext Assembler context with the source file names set
+ *                   (as_file_name, file_path, as_full_file_name).
+ * @param options    Options of the current run.
+ * @return true if the file can be skipped, false if it must be assembled.
+ */
+boolean is_build_up_to_date(const assembler_context *asmContext, const assembler_options *options);
+
+
+/**
+ * @brief Save the fingerprints of a successfully assembled source file.
+ *
+ * Must be called after the output files were written.
+ * If the cache is full, or the file path is too long, the file is just
+ * not cached (it will be fully assembled next time).
+ *
+ * @param asmContext Assembler context of the assembled file.
+ * @param options    Options of the run that assembled the file.
+ */
+void build_cache_store(const assembler_context *asmContext, const assembler_options *options);
+
+
+/**
+ * @brief Remove a source file from the cache (e.g., after a failed assembly).
+ *
+ * @param asmContext Assembler context of the source file.
+ */
+void build_cache_forget(const assembler_context *asmContext);
+
+
+/**
+ * @brief Calculate the fingerprint of a file.
+ *
+ * A missing (or unreadable) file gets an empty fingerprint, no error is printed.
+ *
+ * @param file_name       Full file path.
+ * @param fingerprint_out [out] File fingerprint.
+ */
+void get_file_fingerprint(const char *file_name, file_fingerprint *fingerprint_out);
+
+
+/**
+ * @brief Compare two fingerprints.
+ *
+ * @return true if both fingerprints describe the same content.
+ */
+boolean is_same_fingerprint(const file_fingerprint *print1, const file_fingerprint *print2);
+
+
+#endif
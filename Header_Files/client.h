@@ -0,0 +1,26 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include "boolean.h"
+
+
+/**
+ * @brief Forward a command line to a running assembler server ("--connect=<socket>").
+ *
+ * Sends the working directory and all the arguments (except the program name
+ * and the client flag) to the server socket, prints the output of the request
+ * as it arrives, and returns the status of the request. The arguments are not
+ * parsed by the client, and no assembler table is built. An argument
+ * SERVER_INLINE_SOURCE_OPTION=<file> sends the standard input as the content
+ * of the source file (e.g., an unsaved editor buffer).
+ *
+ * @param socket_path   Local socket of the server (see run_server).
+ * @param argc          Number of arguments (as received by main).
+ * @param argv          Arguments array (as received by main).
+ * @param connect_index Index of the client flag in @p argv (not forwarded).
+ * @return The status of the request, false if the server can't be reached (error printed).
+ */
+boolean run_client(const char *socket_path, int argc, char *argv[], int connect_index);
+
+
+#endif
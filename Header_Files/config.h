@@ -22,6 +22,8 @@
 
 #define MAX_LINE_LEN 80
 
+#define TEXT_BUFFER_INITIAL_SIZE (MAX_LINE_LEN + 3)
+
 #define INSTRUCTIONS_AMOUNT 16
 #define DIRECTIVES_AMOUNT 3
 #define REGISTERS_AMOUNT 8
@@ -78,5 +80,85 @@
 
 #define OBJ_FILE_DATA_PRINT_LENGTH 5
 
+#define SERVER_REQUEST_MAX_LEN 1024
+#define SERVER_REQUEST_MAX_ARGS 64
+#define SERVER_END_OF_RESPONSE "#done"
+#define SERVER_QUIT_REQUEST "quit"
+#define SERVER_SOCKET_BACKLOG 8
+#define SERVER_SOCKET_REQUEST_MAX_LEN (256L * 1024)
+#define SERVER_SOCKET_LENGTH_MAX_DIGITS 10
+#define SERVER_SOCKET_TIMEOUT_MS 5000
+#define SERVER_MAX_WORKERS 16
+#define SERVER_INLINE_SOURCE_OPTION "--inline"
+#define SERVER_SOCKET_STATUS_MARK '\0'
+#define SERVER_SOCKET_SUCCESS '0'
+#define SERVER_SOCKET_FAILURE '1'
+
+#define QUERY_HOVER_MAX_LEN 255
+#define QUERY_NAME_PRINT_LENGTH 100
+
+#define JSON_MAX_KEY_LEN 64
+
+#define LSP_MAX_DOCUMENTS 32
+#define LSP_HEADER_MAX_LEN 255
+#define LSP_MAX_MESSAGE_LEN (64L * 1024 * 1024)
+#define LSP_INITIAL_BUFFER_SIZE 4096
+#define LSP_MAX_SYMBOL_LEN NAME_MAX_LEN
+
+#define BUILD_CACHE_MAX_FILES 64
+#define BUILD_CACHE_PATH_MAX_LEN 255
+
+#define LINE_RECORDS_MAX_FILES 16
+#define LINE_RECORDS_INITIAL_CAPACITY 64
+
+#define WATCH_MAX_FILES 64
+#define WATCH_POLL_INTERVAL_MS 20
+#define WATCH_SETTLE_POLLS 1
+#define WATCH_SETTLE_MS 2
+#define WATCH_EVENTS_BUFFER_SIZE 4096
+#define WATCH_MAX_DIAGNOSTICS 64
+
+#define OUTPUT_FILE_BUFFER_SIZE 8192
+#define OUTPUT_TEMP_EXTENSION ".tmp"
+
+#define SIZE_REPORT_TOP_CONSUMERS 5
+
+#define OUTLINE_DEFAULT_THRESHOLD 1
+
+#define SIMULATOR_MAX_STEPS 100000
+#define SIMULATOR_MAX_OUTPUTS 256
+#define SIMULATOR_STACK_SIZE 64
+
+#define TARGET_DEFAULT_NAME "classic"
+#define TARGET_MAX_MEMORY_CAPACITY 1024
+#define TARGET_MAX_PRINT_LENGTH 8
+
+#define WIDE_WORD_BIT_SIZE 16
+#define WIDE_MEMORY_CAPACITY 1024
+#define WIDE_MEMORY_ADDRESS_OFFSET 100
+#define WIDE_OPERAND_DATA_BITS 14
+#define WIDE_OBJ_FILE_ADDRESS_PRINT_LENGTH 5
+#define WIDE_OBJ_FILE_DATA_PRINT_LENGTH 8
+
+/*capacities of the static node pools (STATIC_NODE_POOLS build)*/
+#define STATIC_MAX_MEMORY_WORDS TARGET_MAX_MEMORY_CAPACITY
+#define STATIC_MAX_LABELS TARGET_MAX_MEMORY_CAPACITY
+#define STATIC_MAX_MAPPED_LINES 4096
+#define STATIC_MAX_MACROS 256
+#define STATIC_MAX_NAMES (2 * TARGET_MAX_MEMORY_CAPACITY)
+#define STATIC_NAMES_SIZE (STATIC_MAX_NAMES * (NAME_MAX_LEN + 1))
+/*static heap of the other allocations (buffers, tables, operands, macro contents)*/
+#define STATIC_HEAP_SIZE (1024L * 1024L)
+
+#define LABELS_INITIAL_CAPACITY 32
+#define NAMES_INITIAL_CAPACITY 64
+#define NAMES_INITIAL_SIZE 512
+#define MEMORY_IMAGE_INITIAL_CAPACITY 256
+#define ENTRY_LINES_INITIAL_CAPACITY 16
+
+/*slab allocator of the lists nodes (sys_memory.c)*/
+#define SLAB_OBJECTS 128
+#define SLAB_POISON_BYTE 0xDD
+
 
 #endif
@@ -7,8 +7,9 @@
  * It centralizes file handling, memory management, error flags,
  * symbol/macro tables, and linked lists used across the assembler passes.
  *
- * This context is initialized at the start of processing each source file
- * and is passed between functions to maintain consistent assembler state.
+ * This context is initialized once for a batch of source files, recycled
+ * between the files (see recycle_all_memory), and is passed between
+ * functions to maintain consistent assembler state.
  *
  * Main responsibilities:
  *  - Hold input/output file names and current line counters.
@@ -30,11 +31,68 @@
 #include "typedef.h"
 #include "boolean.h"
 
+
+/**
+ * @struct text_buffer
+ * @brief Growable text buffer (the capacity doubles, so building a text is linear in its length).
+ */
+typedef struct text_buffer {
+    char *data;             /**< Null terminated text. */
+    unsigned long length;   /**< Text length (without the null terminator). */
+    unsigned long capacity; /**< Allocated size of data. */
+} text_buffer;
+
+
+/**
+ * @struct entry_line
+ * @brief A .entry line of the .am content (found by the first pass, handled by the second pass).
+ */
+typedef struct entry_line {
+    unsigned long position; /**< Position of the line in the .am content. */
+    int line;               /**< The .am line number. */
+} entry_line;
+
+
+/**
+ * @struct entry_symbol
+ * @brief A .entry label of a single pass assembly (checked at the end of the input).
+ */
+typedef struct entry_symbol {
+    name_id name; /**< The entry label (id in the names pool). */
+    int line;     /**< The .am line number of the .entry line. */
+} entry_symbol;
+
+
+/**
+ * @struct error_report
+ * @brief An error reported by the assembler stages (see print_external_error and print_internal_error).
+ */
+typedef struct error_report {
+    const char *file_name;   /**< Source file name (.as) as printed, or NULL if the error has no file. */
+    const char *file_path;   /**< Full path of the source file (as given to the assembler), or NULL. */
+    boolean has_line;        /**< The error belongs to a line (otherwise to the whole file). */
+    int line;                /**< Source (.as) line of the error. */
+    boolean internal;        /**< An internal error (a developing bug), not an error of the source. */
+    const char *function;    /**< Function of an internal error, or NULL. */
+    const char *message;     /**< Error description (a constant of the errors tables). */
+} error_report;
+
+
+/**
+ * @typedef error_sink_function
+ * @brief Receives the errors of the stages instead of the standard output (see print_error_report).
+ *
+ * @param sink_data The error_sink_data of the context.
+ * @param report    The error (valid during the call only).
+ */
+typedef void (*error_sink_function)(void *sink_data, const error_report *report);
+
+
 /**
  * @struct assembler_context
  * @brief Centralized state of the assembler during a single assembly process.
  *
- * Each source file being assembled gets its own `assembler_context` instance.
+ * A batch of source files shares one `assembler_context` instance, reset for every file.
  * This structure stores file metadata, counters, memory usage, error status,
  * and all dynamically allocated linked lists and lookup tables.
  */
@@ -47,6 +105,8 @@ typedef struct assembler_context {
     char* ext_file_name;  /**< Externals usage file (.ext). */
     char* obj_file_name;  /**< Object file (.ob). */
     char* bin_file_name;  /**< Object file in binary (.bin). */
+    char* xref_file_name; /**< Symbols cross-reference file (.xref). */
+    char* lst_file_name;  /**< Listing file (.lst). */
 
     char* file_path; /**< file directory. */
 
@@ -69,16 +129,67 @@ typedef struct assembler_context {
     boolean preproc_error; /**< Set if preprocessing stage failed. */
     boolean first_pass_error;  /**< Set if first pass failed. */
     boolean second_pass_error; /**< Set if second pass failed. */
+    boolean output_error;      /**< Set if an output file couldn't be written (no output file is kept). */
     boolean global_error;      /**< Aggregated global error flag. */
 
     /* ---------- Dynamic linked lists ---------- */
     data_ptr data_memory;                  /**< Linked list for data memory image. */
     instruction_ptr instruction_memory;    /**< Linked list for instruction memory image. */
     external_ptr external_labels;          /**< Linked list of external labels usage. */
-    label_ptr labels;                      /**< Linked list of defined labels. */
+    intern_pool_ptr names;                 /**< Pool of the identifiers of the file (labels, macros, operands, externals). */
+    symbol_table_ptr labels;               /**< Table of defined labels. */
     macro_ptr macros;                      /**< Linked list of defined macros. */
+    macro_ptr prelude_macros;              /**< Macros of the macro prelude (read once, shared by all the files). */
     address_update_request_ptr address_update_requests; /**< Linked list of relocation requests. */
     lines_map_ptr lines_maper;             /**< Line mapping table (.as ↔ .am). */
+    size_record_ptr size_records;          /**< Required words of every line (collected for the size report only). */
+    memory_image_ptr memory_image;         /**< Packed code and data words (built after the second pass, for the output files). */
+
+    /* ---------- Text buffers (kept between the files) ---------- */
+    text_buffer line_buffer;               /**< Current source line of the preprocessor, the passes and the listing. */
+    text_buffer am_buffer;                 /**< The .am file content built by the preprocessor. */
+
+    /* ---------- Entry lines (kept between the files) ---------- */
+    entry_line *entry_lines;               /**< The .entry lines of the .am content, in the source order. */
+    int entry_lines_amount;                /**< Amount of .entry lines. */
+    int entry_lines_capacity;              /**< Allocated amount of .entry lines. */
+
+    /* ---------- Single pass with backpatch chains ("--one-pass", kept between the files) ---------- */
+    boolean one_pass;                      /**< Assemble in a single pass, the label operands are backpatched. */
+    unsigned int *chain_heads;             /**< By name id: 1 + the IC of the last unresolved reference to the name (0 for none). */
+    unsigned int chain_heads_capacity;     /**< Allocated amount of chain heads. */
+    instruction_ptr *instruction_words;    /**< The instruction memory node of every IC (the chains are walked through them). */
+    unsigned int instruction_words_amount; /**< Amount of indexed instruction words. */
+    entry_symbol *entry_symbols;           /**< The .entry labels, in the source order. */
+    int entry_symbols_amount;              /**< Amount of .entry labels. */
+    int entry_symbols_capacity;            /**< Allocated amount of .entry labels. */
+
+    /* ---------- Line records of the previous runs (server mode, kept between the files) ---------- */
+    boolean reuse_lines;                   /**< Replay the unchanged lines of the previous run of the file (see line_records.h). */
+    line_records_ptr line_records;         /**< The line records of the recently assembled files, or NULL. */
+    unsigned int replayed_lines;           /**< Lines of the current file replayed instead of parsed. */
+
+    /* ---------- Analysis only (symbol queries) ---------- */
+    const char *source_text;               /**< Source content read instead of the .as file (an editor document), or NULL. */
+    boolean write_am_file;                 /**< Write the .am file (false when the file is only analyzed). */
+
+    /* ---------- Error sink (kept between the files) ---------- */
+    error_sink_function error_sink;        /**< Receives the errors instead of the standard output, or NULL. */
+    void *error_sink_data;                 /**< Data passed to the error sink. */
+
+    /* ---------- Input limits ---------- */
+    boolean relaxed_limits;                /**< No limit on the line and name lengths ("--relaxed"). */
+
+    /* ---------- Optional data collection ---------- */
+    boolean collect_size_records;          /**< Collect the size records during the first pass. */
+
+    /* ---------- Optimizations ---------- */
+    boolean outline_macros;                /**< Outline the repeated macro expansions into subroutines. */
+    int outline_threshold;                 /**< Outline only macros expanded more than this amount of times. */
+    unsigned int outline_saved_words;      /**< Memory words saved by the macro outlining. */
+
+    /* ---------- Target machine ---------- */
+    const_target_ptr target;               /**< Target machine profile (word size, memory layout, encoders). */
 
     /* ---------- constant tables ---------- */
    const char** data_directive_table;       /**< Table of .data/.string/.mat directives. */
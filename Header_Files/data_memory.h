@@ -28,6 +28,7 @@
 typedef struct data_mem {
     int value;                /**< The numeric value stored in this memory cell. */
     unsigned int address;     /**< The absolute memory address of this value. */
+    int file_line;            /**< The .am file line that generated the value. */
     data_ptr next;            /**< Pointer to the next node in the list, or NULL. */
 } data_mem;
 
@@ -45,12 +46,14 @@ typedef struct data_mem {
  * @param data_memory   Pointer to the head of the data memory linked list.
  * @param DC            Pointer to the data counter (incremented after insertion).
  * @param memory_usage  Pointer to the memory usage counter (incremented after insertion).
+ * @param memory_space  Memory words available for the program (of the target machine).
+ * @param file_line     The .am file line of the data directive.
  *
  * @return true  if the value was successfully added.
  * @return false if input pointers are NULL, memory space exceeded,
  *               or memory allocation failed.
  */
-boolean add_data_to_memory(int val, data_ptr *data_memory, unsigned int *DC, unsigned int *memory_usage);
+boolean add_data_to_memory(int val, data_ptr *data_memory, unsigned int *DC, unsigned int *memory_usage, unsigned int memory_space, int file_line);
 
 
 /**
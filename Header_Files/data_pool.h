@@ -0,0 +1,40 @@
+#ifndef DATA_POOL_H
+#define DATA_POOL_H
+
+#include "context.h"
+
+
+/**
+ * @file data_pool.h
+ * @brief Constant pooling of identical data blocks ("--pool-data").
+ *
+ * A data block is the data generated by a single labeled data directive
+ * line (.data, .string or .mat). After a successful first pass, every block
+ * that is identical to a previous block is removed from the data memory,
+ * and its label is aliased to the address of the previous copy.
+ *
+ * The labels keep their names, so .entry and operand references work as
+ * before, they just resolve to the shared copy. Since the copies share the
+ * same memory words, only read-only and self-contained blocks are pooled:
+ *  - No instruction writes the block label (as its destination operand).
+ *  - No unlabeled data continues the block (the next data word starts the
+ *    next labeled block).
+ *  - The block is before the first label accessed as a matrix (a matrix
+ *    access indexes the words after its label, so that layout is kept).
+ */
+
+
+/**
+ * @brief Remove the duplicated data blocks and alias their labels.
+ *
+ * Must run after the first pass and before the data and labels relocation
+ * (the addresses are still relative to DC). Updates the data memory, the
+ * data labels addresses, DC and the memory usage.
+ *
+ * @param asmContext Assembler context after a successful first pass.
+ * @return Amount of data words saved.
+ */
+unsigned int pool_data(assembler_context *asmContext);
+
+
+#endif
@@ -46,12 +46,13 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 * Fills the operand data bit-field with new_label_addr param and the ERA bit-field
 * with encoding param, after validating both fit their respective bit sizes.
 *
+* @param[in]  target           Target machine profile (the word layout).
 * @param[in]  new_label_addr   The (relocated) address of the label to encode into the data field.
 * @param[in]  encoding         ERA value to encode (ABSOLUTE/RELOCATABLE/EXTERNAL).
-* @param[out] encoded_val_out  Receives the fully encoded 10-bit word.
+* @param[out] encoded_val_out  Receives the fully encoded word.
 *
 * @return true on success; false if @p new_label_addr or @p encoding exceed their bit ranges.
 * */
-boolean encode_label_address(unsigned int new_label_addr, encoding_type encoding, unsigned int* encoded_val_out);
+boolean encode_label_address(const_target_ptr target, unsigned int new_label_addr, encoding_type encoding, unsigned int* encoded_val_out);
 
 #endif
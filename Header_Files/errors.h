@@ -134,7 +134,8 @@ typedef enum external_error_code {
     ERROR_CODE_180 = 80,
     ERROR_CODE_181 = 81,
     ERROR_CODE_182 = 82,
-    ERROR_CODE_183 = 83
+    ERROR_CODE_183 = 83,
+    ERROR_CODE_184 = 84
 } external_error_code;
 
 
@@ -271,6 +272,17 @@ void print_system_error(system_error_code code);
 void print_external_error(external_error_code code);
 
 
+/**
+ * @brief Print an error report (the format of the assembler messages).
+ *
+ * The internal and external errors are printed this way, unless the context
+ * has an error sink (then the sink receives the report instead).
+ *
+ * @param report The error.
+ */
+void print_error_report(const error_report *report);
+
+
 /**
  * @brief Set the global assembler context for error handling.
  *
@@ -5,18 +5,19 @@
 #define EXTERNALS_H
 #include "typedef.h"
 #include "externals.h"
+#include "intern_pool.h"
 #include "util.h"
 
 
 /**
  * @brief Represents a single external label usage.
  *
- * Each node stores the name of an external label and the memory
+ * Each node stores the name id of an external label and the memory
  * address where it was referenced. The nodes are linked together
  * in a singly linked list.
  */
 typedef struct external {
-    char* label_name;           /**< The name of the external label. */
+    name_id label_name;         /**< The name of the external label (id in the names pool). */
     unsigned int mem_address;   /**< The memory address where the label is used. */
     external_ptr next;          /**< Pointer to the next external usage in the list. */
 } external;
@@ -25,16 +26,19 @@ typedef struct external {
 /**
  * @brief Add a new external label usage to the externals list.
  *
- * Allocates a new node, copies the label name, and appends it
- * to the end of the linked list.
+ * Allocates a new node and inserts it in the addresses order (after the
+ * usages of the same address, so usages that come in the addresses order are
+ * appended to the end of the linked list). The backpatch chains of a single
+ * pass add the usages from the last one back. The name is shared through the
+ * names pool, not copied.
  *
- * @param label_name     The name of the external label.
+ * @param label_name     The name id of the external label.
  * @param mem_addr       The memory address where the label is referenced.
  * @param externals_list Pointer to the head of the externals list.
  *
  * @return true on success, false if memory allocation fails or input is invalid.
  */
-boolean add_external_usage(const char* label_name, unsigned int mem_addr, external_ptr *externals_list);
+boolean add_external_usage(name_id label_name, unsigned int mem_addr, external_ptr *externals_list);
 
 
 /**
@@ -44,8 +48,9 @@ boolean add_external_usage(const char* label_name, unsigned int mem_addr, extern
  * and its corresponding memory address.
  *
  * @param externals_list Head of the externals list.
+ * @param names          The names pool.
  */
-void print_external_usages(external_ptr externals_list);
+void print_external_usages(external_ptr externals_list, const intern_pool *names);
 
 
 /**
@@ -60,7 +65,7 @@ boolean is_externals_usage_exist(external_ptr externals_list);
 /**
  * @brief Free the entire externals usage list.
  *
- * Releases all memory allocated for label names and list nodes.
+ * Releases all the list nodes.
  *
  * @param externals_list Pointer to the head of the externals list.
  */
@@ -28,6 +28,8 @@ typedef enum file_type {
     ENTRY_FILE,     /**< ENTRY_FILE: Entries file (.ent).*/
     AM_FILE,        /**< AM_FILE: Preprocessed file (.am).*/
     BIN_FILE,       /**< BINARY_FILE: object file in binary (.bin).*/
+    XREF_FILE,      /**< XREF_FILE: Symbols cross-reference file (.xref).*/
+    LST_FILE,       /**< LST_FILE: Listing file (.lst).*/
     NO_EXTENSION    /**< NO_EXTENSION: No file extension.*/
 } file_type;
 
@@ -109,6 +111,66 @@ boolean create_obj_file(assembler_context *asmContext);
  */
 boolean create_bin_file(assembler_context *asmContext);
 
+/**
+ * @brief Generate the .xref file (symbols cross-reference) of the assembled file.
+ *
+ * Writes a header with the amount of symbols and uses, then one line per
+ * symbol (name, kind, source definition line, final address, uses amount,
+ * index of its first use), and then one line per use (label name, source
+ * line, address of the patched instruction word). The uses are grouped by
+ * symbol, in the symbols order (the source order within a symbol), so the
+ * uses of a symbol are the lines from its first use index to its amount.
+ *
+ * Built in linear time from the labels table and the address update requests
+ * (a counting sort of the requests by the labels table index).
+ *
+ * @param asmContext Assembler context, after a successful second pass.
+ * @return true on success, false on open/write errors (error printed).
+ *
+ * @note on success, the new xref file name is stored in the assembler context.
+ */
+boolean create_xref_file(assembler_context *asmContext);
+
+/**
+ * @brief Generate the .lst listing file of the assembled file.
+ *
+ * Writes every .am line with its original .as line number, and for every
+ * memory word generated by the line: final address (decimal and base 4),
+ * encoded word (base 4 and binary), ERA bits (A/E/R, '-' for data words)
+ * and the label that resolved the word.
+ *
+ * The .am lines, the memory words, the address update requests and the
+ * lines map are walked together once (all of them are ordered by the .am lines).
+ *
+ * @param asmContext Assembler context, after a successful second pass.
+ * @return true on success, false on open/write errors (error printed).
+ *
+ * @note on success, the new lst file name is stored in the assembler context.
+ */
+boolean create_lst_file(assembler_context *asmContext);
+
+/**
+ * @brief Give the written output files of the source their final names.
+ *
+ * The create_*_file functions write every output file under a temporary
+ * name (the final name with OUTPUT_TEMP_EXTENSION), so the output files of
+ * a source appear together only after all of them were written. If a file
+ * can't get its final name, all the output files are removed.
+ *
+ * @param asmContext Assembler context, after all the output files were written.
+ * @return true on success, false if no output file was kept (error printed, output error set).
+ */
+boolean commit_output_files(assembler_context *asmContext);
+
+/**
+ * @brief Remove the output files written so far (a later output file failed).
+ *
+ * The output file names in the context are freed and set to NULL.
+ *
+ * @param asmContext Assembler context.
+ */
+void discard_output_files(assembler_context *asmContext);
+
 /**
  * @brief Build a new file name by replacing the extension.
  *
@@ -137,7 +199,7 @@ boolean is_file_name_valid(char* file_name);
 /**
  * @brief Removes previously generated assembler output files for a given source file.
  *
- * This function deletes any existing output files (`.ob`, `.am`, `.ent`, `.ext`)
+ * This function deletes any existing output files (`.ob`, `.am`, `.ent`, `.ext`, `.bin`, `.xref`, `.lst`)
  * associated with the current assembly source file.
  * It is typically called before starting a new assembly process to ensure
  * that old files do not interfere with the newly generated ones.
@@ -19,6 +19,7 @@
 typedef struct inst_mem {
     int value;                  /**< Encoded machine word value. */
     unsigned int address;       /**< Instruction address. */
+    int file_line;              /**< The .am file line that generated the word. */
     instruction_ptr next;       /**< Pointer to the next instruction node. */
 } inst_mem;
 
@@ -32,9 +33,11 @@ typedef struct inst_mem {
  * @param instruction_memory Pointer to the head of the instruction memory list.
  * @param IC                Pointer to the instruction counter (updated on insert).
  * @param memory_usage      Pointer to memory usage counter (updated on insert).
+ * @param memory_space      Memory words available for the program (of the target machine).
+ * @param file_line         The .am file line of the instruction.
  * @return true on success, false if memory is full or allocation fails.
  */
-boolean add_instruction_to_memory(unsigned short encoded_val,instruction_ptr *instruction_memory,unsigned int* IC,unsigned int *memory_usage);
+boolean add_instruction_to_memory(unsigned short encoded_val,instruction_ptr *instruction_memory,unsigned int* IC,unsigned int *memory_usage, unsigned int memory_space, int file_line);
 
 /**
  * @brief Print the  instruction memory.
@@ -61,7 +61,7 @@ typedef struct opcode {
  * @brief Matrix operand details (label + two registers).
  */
 typedef struct {
-    char label[NAME_MAX_LEN + 1]; /**< Matrix label name. */
+    name_id label;                /**< Matrix label name (id in the names pool). */
     int reg_1;                    /**< First register index (column). */
     int reg_2;                    /**< Second register index (row). */
     encoding_type reg_encoding;   /**< Encoding type for registers. */
@@ -73,7 +73,7 @@ typedef struct {
  */
 typedef union {
     Mat_operand matrix;                 /**< Matrix operand (struct). */
-    char label[NAME_MAX_LEN + 1];       /**< Label operand (string). */
+    name_id label;                      /**< Label operand (name id in the names pool). */
     int val;                            /**< Immediate operand (val). */
     int reg;                            /**< Register operand (val). */
 } operand_val;
@@ -89,6 +89,13 @@ typedef struct {
     int file_line;           /**< Source file operand usage line number. */
 } operand;
 
+
+/**
+ * @brief Name id of the label of a label operand (direct or matrix access).
+ */
+#define operand_label(operand) ((operand)->type == MATRIX_ACCESS ? \
+                                (operand)->operand_val.matrix.label : (operand)->operand_val.label)
+
 /**
  * @brief Handles the parsing and encoding of a full instruction line.
  *
@@ -268,4 +275,22 @@ opcode* get_opcode_info(const char *opcode_name, assembler_context *asmContext);
  */
 boolean is_opcode(const char *name, assembler_context *asmContext);
 
+
+/**
+ * @brief Make an allocated copy of an operand.
+ *
+ * @param source The operand to copy.
+ *
+ * @return Pointer to the newly allocated operand.
+ */
+operand* copy_operand(const operand *source);
+
+
+/**
+ * @brief Free an operand.
+ *
+ * @param operand_ptr Pointer to the operand pointer (set to NULL).
+ */
+void free_operand(operand **operand_ptr);
+
 #endif
@@ -0,0 +1,107 @@
+#ifndef INTERN_POOL_H
+#define INTERN_POOL_H
+
+#include "typedef.h"
+
+
+/**
+ * @file intern_pool.h
+ * @brief Pool of the identifiers of a file (string interning).
+ *
+ * Every identifier is stored once, one after the other in a single
+ * characters array, and gets a name id (its index in the pool). The labels
+ * table, the macros, the label operands and the external uses keep the id
+ * instead of their own copy of the name, so comparing two identifiers is
+ * an integer compare, and the output files read the names from the pool.
+ *
+ * A name is found by a hash table of ids (open addressing). The pool is
+ * created once for a batch of files, emptied between the files (its memory
+ * is kept), and released at the end of the batch. The names of the macro
+ * prelude are added before the first file and kept by every reset, so they
+ * have the same ids in all the files of the batch.
+ */
+
+
+/*a name that isn't in the pool*/
+#define NO_NAME_ID ((name_id)-1)
+
+
+/**
+ * @struct intern_pool
+ * @brief The names of a file.
+ */
+typedef struct intern_pool {
+    char *chars;                  /**< The names (null terminated, one after the other). */
+    unsigned long chars_length;   /**< Used size of the characters array. */
+    unsigned long chars_capacity; /**< Allocated size of the characters array. */
+    unsigned long *offsets;       /**< Offset of every name in the characters array (by id). */
+    name_id *buckets;             /**< Hash table of the ids (NO_NAME_ID marks an empty bucket). */
+    unsigned int amount;          /**< Amount of names. */
+    unsigned int capacity;        /**< Allocated amount of names. */
+    unsigned int buckets_amount;  /**< Size of the hash table (twice the names capacity). */
+    unsigned int kept;            /**< Amount of the first names that are kept by a reset. */
+    unsigned long kept_length;    /**< Characters length of the kept names. */
+} intern_pool;
+
+
+/**
+ * @brief Get the name of an id.
+ */
+#define get_name(pool, id) ((const char*)((pool)->chars + (pool)->offsets[id]))
+
+
+/**
+ * @brief Create an empty names pool.
+ *
+ * @note Terminates the program on failure (like handle_malloc).
+ *
+ * @return The new pool.
+ */
+intern_pool_ptr create_intern_pool(void);
+
+
+/**
+ * @brief Get the id of a name, add the name to the pool if it isn't there yet.
+ *
+ * @param pool The names pool.
+ * @param name The name to intern.
+ * @return The name id (the same id for every call with an equal name), or NO_NAME_ID on invalid input.
+ */
+name_id intern_name(intern_pool_ptr pool, const char *name);
+
+
+/**
+ * @brief Get the id of a name without adding it.
+ *
+ * @param pool The names pool (may be NULL).
+ * @param name The name to find.
+ * @return The name id, or NO_NAME_ID if the name isn't in the pool.
+ */
+name_id find_name(const intern_pool *pool, const char *name);
+
+
+/**
+ * @brief Remove all the names (except the kept names), the pool memory is kept for the next file.
+ *
+ * @param pool The names pool (may be NULL).
+ */
+void reset_intern_pool(intern_pool_ptr pool);
+
+
+/**
+ * @brief Keep the names that are in the pool now by every later reset (the macro prelude names).
+ *
+ * @param pool The names pool (may be NULL).
+ */
+void keep_intern_names(intern_pool_ptr pool);
+
+
+/**
+ * @brief Release the names pool.
+ *
+ * @param pool_ptr Address of the pool pointer (set to NULL).
+ */
+void free_intern_pool(intern_pool_ptr *pool_ptr);
+
+
+#endif
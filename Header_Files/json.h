@@ -0,0 +1,126 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include "boolean.h"
+#include "context.h"
+
+
+/**
+ * @file json.h
+ * @brief Minimal JSON reading and writing of the language server messages.
+ *
+ * The values are read in place from a null terminated JSON text: a value is
+ * a pointer to its first character, nothing is parsed or allocated until a
+ * string or a number is decoded. Only what the language server needs is
+ * provided: members lookup, arrays iteration, and strings and integers
+ * decoding, and the strings encoding of the messages it sends.
+ */
+
+
+/**
+ * @brief Skip a JSON value (and the white spaces after it).
+ *
+ * @param value Start of the value (leading white spaces are skipped).
+ * @return The position after the value, or NULL if the value is invalid.
+ */
+const char* json_skip_value(const char *value);
+
+
+/**
+ * @brief Get a member of a JSON object.
+ *
+ * @param object Start of the object.
+ * @param key    Member name (compared with the undecoded name, without escapes).
+ * @return Start of the member value, or NULL if @p object is not an object or has no such member.
+ */
+const char* json_get_member(const char *object, const char *key);
+
+
+/**
+ * @brief Get a nested member of a JSON object by a dotted path (e.g. "textDocument.uri").
+ *
+ * @param object Start of the object.
+ * @param path   Members names separated by '.'.
+ * @return Start of the member value, or NULL if a member is missing.
+ */
+const char* json_get_path(const char *object, const char *path);
+
+
+/**
+ * @brief Get the first element of a JSON array.
+ *
+ * @param array Start of the array.
+ * @return Start of the first element, or NULL if the array is empty or is not an array.
+ */
+const char* json_array_first(const char *array);
+
+
+/**
+ * @brief Get the next element of a JSON array.
+ *
+ * @param element Start of an element (from json_array_first or json_array_next).
+ * @return Start of the next element, or NULL after the last element.
+ */
+const char* json_array_next(const char *element);
+
+
+/**
+ * @brief Decode a JSON integer.
+ *
+ * @param value     Start of the value.
+ * @param value_out [out] The integer.
+ * @return false if the value is not an integer.
+ */
+boolean json_get_long(const char *value, long *value_out);
+
+
+/**
+ * @brief Check if a value is the JSON literal true.
+ */
+boolean json_is_true(const char *value);
+
+
+/**
+ * @brief Get the length of the decoded content of a JSON string (at most its encoded length).
+ *
+ * @param value Start of the string.
+ * @return Buffer size that holds the decoded string and its null terminator, 0 if the value is not a string.
+ */
+unsigned long json_string_size(const char *value);
+
+
+/**
+ * @brief Decode a JSON string (escapes and \\u code units are decoded to UTF-8).
+ *
+ * @param value      Start of the string.
+ * @param buffer_out [out] Buffer of at least json_string_size(value) characters.
+ * @return Length of the decoded string, or -1 if the value is not a valid string.
+ */
+long json_get_string(const char *value, char *buffer_out);
+
+
+/**
+ * @brief Check if a JSON string equals a text (the string must not contain escapes).
+ */
+boolean json_string_equals(const char *value, const char *text);
+
+
+/**
+ * @brief Append a value as is (its JSON text) to a buffer.
+ *
+ * @param buffer Output buffer.
+ * @param value  Start of the value.
+ */
+void json_append_raw(text_buffer *buffer, const char *value);
+
+
+/**
+ * @brief Append a text as a quoted JSON string (with the required escapes) to a buffer.
+ *
+ * @param buffer Output buffer.
+ * @param text   Null terminated text.
+ */
+void json_append_string(text_buffer *buffer, const char *text);
+
+
+#endif
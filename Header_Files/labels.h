@@ -3,6 +3,7 @@
 #define LABELS_H
 #include "boolean.h"
 #include "context.h"
+#include "intern_pool.h"
 #include "typedef.h"
 
 
@@ -27,20 +28,54 @@ typedef enum addr_type {
     UNKNOWN_ADDR_TYPE  /** < UNKNOWN_ADDR_TYPE: Type not yet determined.*/
 } addr_type;
 
+/*get_label result when the label is not defined*/
+#define NO_LABEL (-1)
+
 /**
- * @struct label
- * @brief Represents a label in the assembler.
- *
- * Each label is stored in a linked list and contains:
+ * @struct symbol_table
+ * @brief The labels of a file, in a struct of arrays layout.
+ *
+ * A label is an index (label id) into the parallel columns, in the
+ * definition order. The label names are ids of the names pool of the file,
+ * and the label of a name id is found directly in the label_ids index (the
+ * name ids are dense, so the index is a plain array).
+ * The entry flags are a bitset (a bit per label).
  */
-typedef struct label {
-    char *name;             /** < name: Label name (dynamically allocated).*/
-    unsigned int address;   /** < address: The memory address associated with the label.*/
-    addr_type type;         /** < type: Memory type (CODE or DATA).*/
-    def_type definition;    /** < definition: Definition type (NORMAL or EXTERN).*/
-    label_ptr next;         /** < next: Pointer to the next label in the list.*/
-    boolean is_entry;       /** < is_entry: Marks whether the label is defined as entry.*/
-} label;
+typedef struct symbol_table {
+    intern_pool_ptr names;       /**< The names pool of the file. */
+    name_id *name_ids;           /**< Label name id. */
+    unsigned int *addresses;     /**< The memory address associated with the label. */
+    unsigned char *types;        /**< Memory type (addr_type: CODE, DATA or UNKNOWN_ADDR_TYPE). */
+    unsigned char *definitions;  /**< Definition type (def_type: NORMAL or EXTERN). */
+    unsigned char *entry_bits;   /**< Entry flags bitset. */
+    int *define_lines;           /**< The line where the label defined in .am file. */
+    int *references;             /**< Amount of the label uses as instruction operand (counted in the second pass). */
+    int amount;                  /**< Amount of labels. */
+    int capacity;                /**< Allocated amount of labels. */
+    int *label_ids;              /**< Label id of every name id (NO_LABEL if the name isn't a label). */
+    unsigned int names_capacity; /**< Allocated amount of name ids in label_ids. */
+} symbol_table;
+
+
+/**
+ * @brief Amount of labels in a table (the table may be NULL, no labels yet).
+ */
+#define labels_amount(labels) ((labels) ? (labels)->amount : 0)
+
+/**
+ * @brief Name of a label.
+ */
+#define label_name(labels, id) get_name((labels)->names, (labels)->name_ids[id])
+
+/**
+ * @brief Check the entry flag of a label.
+ */
+#define is_entry_label(labels, id) ((((labels)->entry_bits[(id) >> 3]) >> ((id) & 7)) & 1U)
+
+/**
+ * @brief Set the entry flag of a label.
+ */
+#define set_entry_label(labels, id) ((labels)->entry_bits[(id) >> 3] |= (unsigned char)(1U << ((id) & 7)))
 
 
 
@@ -70,86 +105,111 @@ char *find_label_definition(char *line, assembler_context *asmContext);
 void remove_label_from_line(char *line);
 
 /**
- * @brief Add a new label node to the labels linked list.
+ * @brief Create an empty labels table.
  *
- * Creates a new label, initializes it with provided parameters, and
- * appends it to the end of the list.
+ * @param names The names pool of the file (the label names are interned in it).
+ * @return The new table.
+ */
+symbol_table_ptr create_symbol_table(intern_pool_ptr names);
+
+/**
+ * @brief Add a new label to the labels table.
+ *
+ * Interns the name in the names pool and appends the label values to the
+ * end of the columns.
  *
  * @param new_name Label name to add.
  * @param address Address associated with the label.
  * @param type Address type (CODE, DATA, UNKNOWN_ADDR_TYPE).
  * @param definition Label definition type (NORMAL, EXTERN).
- * @param labels_list Pointer to the head of the labels list.
+ * @param labels The labels table.
+ * @param define_line The .am file line where the label defined (or declared as extern).
  * @return true if successfully added, false otherwise.
  */
-boolean add_label(const char *new_name, unsigned int address, addr_type type, def_type definition, label_ptr *labels_list);
+boolean add_label(const char *new_name, unsigned int address, addr_type type, def_type definition, symbol_table_ptr labels, int define_line);
 
 /**
- * @brief Free the entire labels list.
+ * @brief Remove all the labels, the columns are kept for the next file.
  *
- * Iterates through all label nodes and releases their allocated memory.
+ * @param labels The labels table (may be NULL).
+ */
+void reset_symbol_table(symbol_table_ptr labels);
+
+/**
+ * @brief Free the labels table.
+ *
+ * Releases the columns and the table (set to NULL), the names stay in the names pool.
  *
- * @param labels_list Pointer to the head of the labels list.
+ * @param labels Pointer to the labels table.
  */
-void free_label_list(label_ptr *labels_list);
+void free_label_list(symbol_table_ptr *labels);
 
 /**
  * @brief Print all labels in the list with their properties.
  *
  * Prints label name, address, type (code/data), and definition (entry/external/default).
  *
- * @param labels_list Head of the labels list.
+ * @param labels The labels table.
  */
-void print_labels(label_ptr labels_list);
+void print_labels(symbol_table_ptr labels);
 
 /**
  * @brief Get the address of a label by name.
  *
- * Searches the labels list and returns the address if the label exists.
+ * Searches the labels table and returns the address if the label exists.
  * Returns 0 if the label is not found.
  *
  * @param name Name of the label.
- * @param labels_list Head of the labels list.
+ * @param labels The labels table.
  * @return unsigned int Label address, or 0 if not found.
  */
-unsigned int get_label_address(const char* name, label_ptr labels_list);
+unsigned int get_label_address(const char* name, symbol_table_ptr labels);
 
 /**
  * @brief Check if a label with a given name is defined.
  *
  * @param name Name of the label to search for.
- * @param labels_list Head of the labels list.
+ * @param labels The labels table.
  * @return true if label exists, false otherwise.
  */
-boolean is_label_defined(const char *name, label_ptr labels_list);
+boolean is_label_defined(const char *name, symbol_table_ptr labels);
 
 /**
- * @brief Retrieve the full label node by name.
+ * @brief Retrieve a label id by name.
  *
- * Searches the labels list and returns the label node if found.
+ * Searches the labels table and returns the label index in the columns.
  *
  * @param name Name of the label.
- * @param labels_list Head of the labels list.
- * @return label_ptr Pointer to the label node, or NULL if not found.
+ * @param labels The labels table.
+ * @return int The label id, or NO_LABEL if not found.
+ */
+int get_label(const char* name, symbol_table_ptr labels);
+
+/**
+ * @brief Retrieve a label id by the name id (a lookup in the label ids index).
+ *
+ * @param name Name id of the label (in the names pool of the table).
+ * @param labels The labels table.
+ * @return int The label id, or NO_LABEL if not found.
  */
-label_ptr get_label(const char* name, label_ptr labels_list);
+int find_label(name_id name, symbol_table_ptr labels);
 
 /**
  * @brief Print all labels marked as "entry".
  *
  * Displays entry labels and their addresses in binary form.
  *
- * @param labels_list Head of the labels list.
+ * @param labels The labels table.
  */
-void print_entry_labels(label_ptr labels_list);
+void print_entry_labels(symbol_table_ptr labels);
 
 /**
- * @brief Check if any label in the list is marked as "entry".
+ * @brief Check if any label in the table is marked as "entry" (a scan over the entry bitset).
  *
- * @param labels_list Head of the labels list.
+ * @param labels The labels table.
  * @return true if at least one entry label exists, false otherwise.
  */
-boolean is_entry_label_exist(label_ptr labels_list);
+boolean is_entry_label_exist(symbol_table_ptr labels);
 
 
 #endif
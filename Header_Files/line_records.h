@@ -0,0 +1,106 @@
+#ifndef LINE_RECORDS_H
+#define LINE_RECORDS_H
+
+#include "boolean.h"
+#include "context.h"
+#include "util.h"
+
+
+/**
+ * @file line_records.h
+ * @brief First pass results of the unchanged lines, kept between the runs (server mode).
+ *
+ * While the assembler stays alive (server mode), the first pass keeps a
+ * record of every .am line it parsed without an error: the words of the line,
+ * the label it defines (or declares as external), and its address update
+ * requests, with the addresses relative to the IC/DC at the start of the line
+ * and the label operands by name. The records are kept per source file.
+ *
+ * On the next run of the same file, a line whose text has a record is not
+ * parsed again: its record is replayed at the current IC/DC and .am line
+ * through the same functions that the parser calls (add_label,
+ * add_instruction_to_memory, add_data_to_memory, add_addr_update_request),
+ * in the same order, so the lists, the labels table and the requests are the
+ * same as after a full parse, and only the changed lines are parsed. The
+ * second pass then relocates and resolves all the requests against the new
+ * addresses, so the output files are the same as in a full run.
+ *
+ * The parse of a line depends only on its text, except for the checks of the
+ * names already in use and of the memory capacity: a record is replayed only
+ * when these checks pass (otherwise the line is parsed, and prints its error),
+ * and the records of a file are dropped when it's assembled for another
+ * target or with other length limits.
+ */
+
+
+/**
+ * @struct line_snapshot
+ * @brief The first pass state before a line, compared with the state after it to record the line.
+ */
+typedef struct line_snapshot {
+    unsigned int IC;                     /**< IC before the line. */
+    unsigned int DC;                     /**< DC before the line. */
+    address_update_request_ptr requests; /**< Head of the requests list before the line. */
+    instruction_ptr code_tail;           /**< Last instruction word before the line, or NULL. */
+    data_ptr data_tail;                  /**< Last data word before the line, or NULL. */
+    boolean had_error;                   /**< An error was found before the line. */
+} line_snapshot;
+
+
+/**
+ * @brief Open the records of the current file for its first pass.
+ *
+ * Does nothing unless asmContext->reuse_lines is set. The records of the
+ * previous run of the file are replayed by this pass, and the records of this
+ * pass replace them at its end (see end_line_records).
+ *
+ * @param asmContext Assembler context with the source file names set.
+ * @param snapshot   [out] Snapshot of the empty state, before the first line.
+ */
+void begin_line_records(assembler_context *asmContext, line_snapshot *snapshot);
+
+
+/**
+ * @brief Replay the record of an unchanged line instead of parsing it.
+ *
+ * @param asmContext Assembler context (the current .am line is already counted).
+ * @param text       The .am line, as in the .am content (with its '\n').
+ * @param length     Length of the line.
+ * @param type_out   [out] Type of the replayed line (an ENTRY_DIRECTIVE_LINE is left to the caller).
+ * @return true if the line was replayed, false if it must be parsed.
+ */
+boolean replay_line_record(assembler_context *asmContext, const char *text, unsigned long length, line_type *type_out);
+
+
+/**
+ * @brief Record a parsed line, if it was parsed without an error.
+ *
+ * @param asmContext Assembler context after the line.
+ * @param text       The .am line, as in the .am content (with its '\n').
+ * @param length     Length of the line.
+ * @param type       Type of the line.
+ * @param label      Label defined by the line (or declared by an .extern line), or NULL.
+ * @param snapshot   Snapshot taken before the line.
+ */
+void record_line(assembler_context *asmContext, const char *text, unsigned long length, line_type type,
+                 const char *label, const line_snapshot *snapshot);
+
+
+/**
+ * @brief Take the snapshot of the state before a line (moves the snapshot of the previous line).
+ *
+ * @param asmContext Assembler context.
+ * @param snapshot   Snapshot to update.
+ */
+void take_line_snapshot(const assembler_context *asmContext, line_snapshot *snapshot);
+
+
+/**
+ * @brief Keep the records of this first pass for the next run of the file.
+ *
+ * @param asmContext Assembler context.
+ */
+void end_line_records(assembler_context *asmContext);
+
+
+#endif
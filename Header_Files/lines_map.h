@@ -19,12 +19,15 @@
  *      Original line number in the `.as` file.
  * @var lines_LUT::new_line_num
  *      Corresponding line number in the `.am` file.
+ * @var lines_LUT::call_line
+ *      For macro expansion lines, the `.as` line of the macro call (0 otherwise).
  * @var lines_LUT::next
  *      Pointer to the next node in the mapping list.
  */
 typedef struct lines_LUT {
     int orign_line_num;
     int new_line_num;
+    int call_line;
     lines_map_ptr next;
 } lines_LUT;
 
@@ -34,14 +37,16 @@ typedef struct lines_LUT {
  *
  * Creates a new node with the original line number (`original_line`)
  * and the new preprocessed line number (`new_line`) and appends it to the
- * end of the mapping list.
+ * end of the mapping list (after the last node, without walking the list).
  *
  * @param original_line Original line number in the `.as` file.
  * @param new_line      Corresponding line number in the `.am` file.
+ * @param call_line     The `.as` line of the macro call for macro expansion lines, 0 otherwise.
  * @param lines_map     Pointer to the head of the mapping list.
+ * @param last_line     [in/out] Last node of the mapping list (NULL if the list is empty), set to the new node.
  * @return true if successfully added, false if allocation failed or invalid args.
  */
-boolean add_lines_to_map(int original_line, int new_line, lines_map_ptr *lines_map);
+boolean add_lines_to_map(int original_line, int new_line, int call_line, lines_map_ptr *lines_map, lines_map_ptr *last_line);
 
 /**
  * @brief Retrieve the original line number given a preprocessed line number.
@@ -0,0 +1,28 @@
+#ifndef LSP_H
+#define LSP_H
+
+#include "boolean.h"
+
+
+/**
+ * @brief Run the assembler as a language server ("--lsp").
+ *
+ * Speaks the Language Server Protocol (JSON-RPC messages with a
+ * Content-Length header) over the standard input and output:
+ *  - initialize / initialized / shutdown / exit.
+ *  - textDocument/didOpen, didChange (incremental or full), didClose.
+ *  - textDocument/publishDiagnostics after every analysis of a document.
+ *  - textDocument/definition, textDocument/references and textDocument/hover
+ *    of the labels and macros.
+ *
+ * Every open document keeps its text, its symbol index and its diagnostics
+ * in memory. A document is analyzed again only after it changed, when no
+ * other message is waiting (a burst of edits triggers a single analysis), or
+ * before a query needs its symbols. Nothing is written to the disk.
+ *
+ * @return true if the client asked to shut down before the exit notification.
+ */
+boolean run_lsp(void);
+
+
+#endif
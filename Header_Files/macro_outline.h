@@ -0,0 +1,43 @@
+#ifndef MACRO_OUTLINE_H
+#define MACRO_OUTLINE_H
+
+#include "boolean.h"
+#include "context.h"
+
+
+/**
+ * @file macro_outline.h
+ * @brief Outlining of repeated macro expansions into subroutines ("--outline-macros").
+ *
+ * A macro expanded more than K times whose body is safe to outline is
+ * emitted once, at the end of the .am file, as a subroutine that ends with
+ * "rts", and every expansion is replaced with a single "jsr" line.
+ * A macro is outlined only when it saves memory words:
+ *
+ *   calls * body_words  >  calls * jsr_words + body_words + rts_words
+ *
+ * A macro body is safe to outline when it contains only instructions
+ * (no labels, no directives) and no control transfer ("jmp", "bne", "jsr",
+ * "rts" or "stop"), a branch of a moved body could skip the "rts".
+ * The program must end with "stop", "rts" or "jmp" (outside an outlined
+ * expansion), so the program never continues into the subroutines.
+ *
+ * The lines map is rebuilt, so the diagnostics of the subroutine lines
+ * point to the macro definition lines, and the "jsr" lines point to the
+ * macro call lines.
+ */
+
+
+/**
+ * @brief Outline the repeated macro expansions of the expanded file content.
+ *
+ * Sets the amount of saved words in the context.
+ *
+ * @param asmContext  Assembler context (macros list and lines map of the preprocessor).
+ * @param am_content  [in/out] The .am file content, replaced if any macro was outlined.
+ * @return true on success, false on internal error.
+ */
+boolean outline_macros(assembler_context *asmContext, text_buffer *am_content);
+
+
+#endif
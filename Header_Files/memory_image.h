@@ -0,0 +1,100 @@
+#ifndef MEMORY_IMAGE_H
+#define MEMORY_IMAGE_H
+
+#include "boolean.h"
+#include "context.h"
+#include "typedef.h"
+
+
+/**
+ * @file memory_image.h
+ * @brief Packed memory image of an assembled program.
+ *
+ * After the second pass the code and the data words are placed one after
+ * the other from the load address of the target. The image stores them in
+ * a single array of 16-bit slots (a word of every target fits in a slot),
+ * 2 bytes per word instead of a list node per word.
+ *
+ * The words are read and written by their absolute address. A plain loop
+ * from the load address up to memory_image_end() walks the whole image.
+ *
+ * The image is created once for a batch of files, and its words array is
+ * reused (and grown when needed) by the next files.
+ */
+
+
+/**
+ * @typedef image_word
+ * @brief A memory word slot (only the target word bits are used).
+ */
+typedef unsigned short image_word;
+
+
+/**
+ * @struct memory_image
+ * @brief The program words, in the address order.
+ */
+typedef struct memory_image {
+    image_word *words;          /**< Code words and then data words. */
+    unsigned int load_address;  /**< Address of the first word. */
+    unsigned int code_length;   /**< Amount of code words (IC). */
+    unsigned int data_length;   /**< Amount of data words (DC). */
+    unsigned int capacity;      /**< Allocated amount of words. */
+} memory_image;
+
+
+/**
+ * @brief Create an empty memory image.
+ *
+ * @note Terminates the program on failure (like handle_malloc).
+ *
+ * @return The new image.
+ */
+memory_image_ptr create_memory_image(void);
+
+
+/**
+ * @brief Build the memory image from the relocated instruction and data memories.
+ *
+ * @param asmContext Assembler context after a successful second pass.
+ * @param image      The image to fill (its previous words are replaced).
+ * @return true on success, false if a word address is out of the program (error printed).
+ */
+boolean build_memory_image(const assembler_context *asmContext, memory_image_ptr image);
+
+
+/**
+ * @brief Remove all the words of the image, the words array is kept for the next file.
+ */
+#define reset_memory_image(image) \
+    do { if ((image) != NULL) { (image)->code_length = 0; (image)->data_length = 0; } } while (0)
+
+
+/**
+ * @brief Get the word at an address of the image.
+ */
+#define get_image_word(image, address) ((unsigned int)(image)->words[(address) - (image)->load_address])
+
+
+/**
+ * @brief Set the word at an address of the image (masked by the target word size).
+ */
+#define set_image_word(image, address, value, word_mask) \
+    ((image)->words[(address) - (image)->load_address] = (image_word)((unsigned int)(value) & (word_mask)))
+
+
+/**
+ * @brief First address after the image.
+ */
+#define memory_image_end(image) ((image)->load_address + (image)->code_length + (image)->data_length)
+
+
+/**
+ * @brief Release the memory image.
+ *
+ * @param image_ptr Address of the image pointer (set to NULL).
+ */
+void free_memory_image(memory_image_ptr *image_ptr);
+
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+
+/**
+ * @file node_pool.h
+ * @brief Allocation of the assembler lists nodes.
+ *
+ * The nodes of the data and instruction memories, the address update
+ * requests, the externals usage list, the lines map and the macros list
+ * are allocated and released only through this module (the labels table
+ * has its own columns, see labels.c).
+ *
+ * By default every node type has a slab cache (see sys_memory.h): a node
+ * is a pointer bump in a block of nodes, and the released nodes are reused.
+ * When compiled with STATIC_NODE_POOLS defined, every node type has a
+ * statically sized array (capacities in config.h) with a free list, and
+ * those lists use no heap memory at all (the other blocks of that build
+ * come from the static heap of sys_memory.c). At the end of every file all the
+ * nodes are released together (reset_node_pools, the slabs are kept for the
+ * next file), without walking the lists.
+ *
+ * The memory words lists are bounded by the memory capacity of the largest
+ * target, so only the lines map capacity may be reached by a valid program.
+ * A full pool stops the program with a system error, the same as a failed
+ * allocation.
+ */
+
+
+/**
+ * @enum node_pool_type
+ * @brief Node types allocated by the pools.
+ */
+typedef enum node_pool_type {
+    DATA_NODE = 0,
+    INSTRUCTION_NODE,
+    ADDRESS_REQUEST_NODE,
+    EXTERNAL_NODE,
+    LINES_MAP_NODE,
+    MACRO_NODE,
+    NODE_TYPES_AMOUNT
+} node_pool_type;
+
+
+/**
+ * @brief Allocate a list node.
+ *
+ * @note Terminates the program on failure (like handle_malloc), so callers
+ *       do NOT need to check the return value for NULL.
+ *
+ * @param type Node type.
+ * @return Pointer to the node memory (not initialized).
+ */
+void* alloc_node(node_pool_type type);
+
+
+/**
+ * @brief Release a list node allocated by alloc_node.
+ *
+ * Sets the caller's pointer to NULL (like safe_free).
+ *
+ * @param type     Node type (the same as in the allocation).
+ * @param node_ptr Address of the node pointer (e.g., (void**)&temp).
+ */
+void free_node(node_pool_type type, void **node_ptr);
+
+
+/**
+ * @brief Release all the nodes of all the pools at once, the pools memory is kept.
+ *
+ * Called at the end of every file, the lists that hold the nodes must not
+ * be used after it (their heads are set to NULL by the caller).
+ */
+void reset_node_pools(void);
+
+
+/**
+ * @brief Release all the nodes of all the pools and the pools memory.
+ *
+ * Called at the end of the batch (or when aborting).
+ */
+void release_node_pools(void);
+
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "boolean.h"
+#include "typedef.h"
+
+
+/**
+ * @file options.h
+ * @brief Command-line options of the assembler.
+ *
+ * The assembler receives a list of source files and optional flags.
+ * Flags start with "--" and may appear anywhere between the file names.
+ * The legacy "debug" word is still accepted as the last argument.
+ */
+
+
+/**
+ * @struct inline_source
+ * @brief Source file content sent in a server request instead of the file on disk.
+ */
+typedef struct inline_source {
+    const char *name; /**< Source file argument of the request (e.g., "prog" or "prog.as"). */
+    const char *text; /**< Content assembled instead of reading the file. */
+} inline_source;
+
+
+/**
+ * @struct assembler_options
+ * @brief Flags that control a single assembler run.
+ *
+ * The options are parsed once per run (or once per server request)
+ * and stay unchanged while the files of that run are assembled.
+ */
+typedef struct assembler_options {
+    boolean debug;   /**< Print the saved assembler data after each file ("debug"). */
+    boolean serve;   /**< Keep the process alive and read requests from stdin ("--serve"). */
+    const char *serve_socket; /**< Read the requests from this local socket instead of stdin ("--serve=<socket>"), or NULL. */
+    int serve_workers; /**< Worker processes that answer the socket requests ("--workers=<n>"). */
+    boolean watch;   /**< Assemble the files again whenever they change ("--watch"). */
+    boolean lsp;     /**< Run as a language server over stdin/stdout ("--lsp"). */
+    boolean xref;    /**< Generate the symbols cross-reference file ("--xref"). */
+    boolean listing; /**< Generate the listing file ("--listing"). */
+    boolean size_report; /**< Print the code size report of every file ("--size-report"). */
+    boolean pool_data;   /**< Share a single copy of identical labeled data blocks ("--pool-data"). */
+    boolean outline_macros; /**< Outline the repeated macro expansions into subroutines ("--outline-macros[=K]"). */
+    int outline_threshold;  /**< Outline only macros expanded more than K times. */
+    boolean peephole;        /**< Remove the instructions without effect ("--peephole"). */
+    boolean peephole_verify; /**< Simulate the program before and after the peephole optimizer ("--peephole-verify"). */
+    const_target_ptr target; /**< Target machine profile ("--target=<name>"). */
+    boolean relaxed_limits;  /**< Accept lines and names longer than the maximum lengths ("--relaxed"). */
+    boolean stats;           /**< Print the time of every stage and the data handed between the stages ("--stats"). */
+    boolean one_pass;        /**< Assemble in a single pass with backpatch chains ("--one-pass"). */
+    const char *macro_prelude; /**< File of macros shared by all the files, read once ("--macro-prelude=<file>"), or NULL. */
+    boolean reuse_unchanged; /**< Skip files unchanged since their last successful assembly (set by the server, not a flag). */
+    const inline_source *inline_sources; /**< Sources sent with the request (set by the server, not a flag), or NULL. */
+    int inline_sources_amount;           /**< Number of entries in inline_sources. */
+} assembler_options;
+
+
+/**
+ * @brief Parse the command-line arguments into options and source files.
+ *
+ * Recognized flags are removed from @p argv, and the remaining source file
+ * names are moved to the front of the array (starting at index 1), keeping
+ * their original order. No memory is allocated.
+ *
+ * @param argc        Number of arguments (as received by main).
+ * @param argv        Arguments array (as received by main), reordered in place.
+ * @param options_out [out] Parsed options.
+ * @param files_out   [out] Number of source files left in @p argv.
+ * @return true on success, false if an unknown flag was found (error printed).
+ */
+boolean parse_options(int argc, char *argv[], assembler_options *options_out, int *files_out);
+
+
+/**
+ * @brief Find the client flag ("--connect=<socket>") without parsing the other arguments.
+ *
+ * A client forwards its other arguments to the server as is, they are
+ * parsed by the server (in the server working directory of the request).
+ *
+ * @param argc Number of arguments (as received by main).
+ * @param argv Arguments array (as received by main).
+ * @return Index of the flag in @p argv, or 0 if there is no client flag.
+ */
+int find_connect_option(int argc, char *argv[]);
+
+
+/**
+ * @brief Get the socket of a client flag found by find_connect_option.
+ *
+ * @param argument The client flag argument.
+ * @return The socket path (may be empty).
+ */
+const char* get_connect_socket(const char *argument);
+
+
+/**
+ * @brief Reset all options to their default values.
+ *
+ * @param options Options to reset.
+ */
+void init_options(assembler_options *options);
+
+
+/**
+ * @brief Find the content sent with a server request for a source file argument.
+ *
+ * @param options     Options of the run.
+ * @param source_file Source file argument, as written in the request.
+ * @return The content to assemble instead of the file, or NULL to read the file.
+ */
+const char* find_inline_source(const assembler_options *options, const char *source_file);
+
+
+/**
+ * @brief Check if two runs with the given options generate the same output files.
+ *
+ * Only the options that change the output files are compared
+ * (e.g., "--xref"), the run mode flags (debug, serve, watch, lsp) are ignored.
+ *
+ * @return true if both options generate the same output files.
+ */
+boolean is_same_output_options(const assembler_options *options1, const assembler_options *options2);
+
+
+#endif
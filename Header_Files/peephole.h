@@ -0,0 +1,42 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "boolean.h"
+#include "context.h"
+
+
+/**
+ * @file peephole.h
+ * @brief Peephole optimizer of the encoded instructions ("--peephole").
+ *
+ * Runs after a successful first pass, before the addresses relocation, and
+ * removes instructions that have no effect (by the opcode effects table):
+ *  - "mov rX, rX".
+ *  - "jmp <label>" to the next executed instruction (also when the
+ *    instructions between them were removed).
+ * The instructions that update the PSW flags are kept: "cmp" and the
+ * arithmetic instructions, so also "add #0, <dest>" and "sub #0, <dest>",
+ * whose Z flag may be read by a later "bne".
+ *
+ * The instruction addresses, the code labels and the address update requests
+ * are moved back over the removed words. A label of a removed instruction
+ * points to the next instruction, which is executed in its place.
+ *
+ * With verification ("--peephole-verify"), the program is simulated before
+ * and after the optimization, and the observable results are compared.
+ */
+
+
+/**
+ * @brief Optimize the instruction memory of a file.
+ *
+ * Prints the removed instructions and saved words, and the verification result.
+ *
+ * @param asmContext Assembler context after a successful first pass.
+ * @param verify     Compare the simulation results before and after the optimization.
+ * @return false if the verification failed (the results are different).
+ */
+boolean run_peephole(assembler_context *asmContext, boolean verify);
+
+
+#endif
@@ -6,6 +6,19 @@
 #include "boolean.h"
 #include "typedef.h"
 #include "context.h"
+#include "intern_pool.h"
+
+
+/**
+ * @struct source_reader
+ * @brief Lines source of the preprocessor: an open file, or a text in memory (an editor document).
+ */
+typedef struct source_reader {
+    FILE *file;             /**< Source file, or NULL to read the text. */
+    text_buffer text;       /**< Source text, read when there is no file (not owned by the reader). */
+    unsigned long position; /**< Position of the next line in the text. */
+} source_reader;
+
 
 /**
  * @brief Run the assembler preprocessor on a single source file.
@@ -16,38 +29,59 @@
  *  - Replaces macro invocations with their stored content.
  *  - Maintains a line mapping (.as → .am) for accurate error reporting.
  *
- * On success, writes the expanded content to asmContext->am_file_name.
+ * The source is asmContext->source_text when it is set, otherwise the .as file.
+ * On success, writes the expanded content to asmContext->am_file_name (unless
+ * asmContext->write_am_file is false), the content is also kept in asmContext->am_buffer.
  *
  * @param asmContext Assembler context (file names, macro list, line map, flags).
  * @return true on success, false on any error (also sets asmContext->preproccess_error).
  */
 boolean execute_preprocessor(assembler_context* asmContext);
 
+/**
+ * @brief Read the macro prelude of a batch ("--macro-prelude=<file>").
+ *
+ * The prelude file may hold only macro definitions, comments and empty
+ * lines. Its macros are checked like the macros of a source file, stored in
+ * asmContext->prelude_macros (kept until the end of the batch), and their
+ * names are kept in the names pool, so every file of the batch calls them
+ * without reading them again. A file macro or label with a prelude macro
+ * name is a name conflict, like a second definition in the same file.
+ *
+ * Called once, after init_assembler and before the first file.
+ *
+ * @param asmContext   Assembler context.
+ * @param prelude_file Path of the prelude file.
+ * @return true on success, false on any error (errors printed with the prelude file name).
+ */
+boolean load_macro_prelude(assembler_context *asmContext, const char *prelude_file);
+
 /**
  * @brief Append a new macro node to the macro list.
  *
  * The function takes ownership of @p name and @p content pointers.
  *
- * @param name         macro name (NUL-terminated).
+ * @param name         macro name (id in the names pool).
  * @param content      macro body content (including trailing newlines).
  * @param lines_amount Number of lines in @p content.
  * @param macro_list   Pointer to list head.
  * @param define_line
  * @return true on success, false on allocation or argument error.
  */
-boolean add_macro(char *name, char *content, int lines_amount, macro_ptr *macro_list, int define_line);
+boolean add_macro(name_id name, char *content, int lines_amount, macro_ptr *macro_list, int define_line);
 
 /**
  * @brief Print macro names and their content (debug helper).
  *
  * @param macro_list Head of the macro list (may be NULL).
+ * @param names      The names pool.
  */
-void print_macro_names(macro_ptr macro_list);
+void print_macro_names(macro_ptr macro_list, const intern_pool *names);
 
 /**
  * @brief Free the entire macro list.
  *
- * Frees each node's name, content, and the node itself; sets *macro_list to NULL.
+ * Frees each node's content and the node itself; sets *macro_list to NULL.
  *
  * @param macro_list Pointer to list head.
  */
@@ -80,15 +114,16 @@ boolean is_end_of_macro(char *line, assembler_context *asmContext);
  * @brief Read a macro body from the current file position until 'mcroend'.
  *
  * Accumulates lines into a single heap-allocated buffer and counts lines.
+ * The lines are read into the context line buffer (its previous line is lost).
  * Fails if 'mcroend' is missing or the macro body is empty.
  *
- * @param fp_in           Open FILE* positioned after the 'mcro <name>' line.
+ * @param source          Source positioned after the 'mcro <name>' line.
  * @param content_out     Out: heap-allocated buffer with the macro body.
  * @param lines_count_out Out: number of lines in the macro body.
  * @param asmContext      Context (line counters, errors).
  * @return true on success, false on error.
  */
-boolean read_macro_content(FILE *fp_in, char** content_out, int *lines_count_out, assembler_context *asmContext);
+boolean read_macro_content(source_reader *source, char** content_out, int *lines_count_out, assembler_context *asmContext);
 
 /**
  * @brief Determine whether a line is a macro invocation.
@@ -97,29 +132,37 @@ boolean read_macro_content(FILE *fp_in, char** content_out, int *lines_count_out
  * returns the corresponding macro node; otherwise returns NULL.
  *
  * @param line        Line from file.
- * @param macro_list  Macro list head.
- * @param asmContext  Context for error reporting on trailing tokens.
+ * @param asmContext  Context (the file and prelude macros, error reporting on trailing tokens).
  * @return macro_ptr Node of the invoked macro, or NULL if not a call / on error.
  */
-macro_ptr is_macro_call(char *line, macro_ptr macro_list, assembler_context *asmContext);
+macro_ptr is_macro_call(char *line, assembler_context *asmContext);
 
 /**
  * @brief Find and return a macro node by name.
  *
- * @param name       Macro name to search.
+ * @param name       Macro name id to search (NO_NAME_ID is never a macro).
  * @param macro_list Macro list head.
  * @return macro_ptr Matching node or NULL if not found.
  */
-macro_ptr get_macro(char *name, macro_ptr macro_list);
+macro_ptr get_macro(name_id name, macro_ptr macro_list);
+
+/**
+ * @brief Find a macro of the file or of the macro prelude by name.
+ *
+ * @param name       Macro name id (NO_NAME_ID is never a macro).
+ * @param asmContext Context (the file and prelude macros lists).
+ * @return macro_ptr Matching node or NULL if not found.
+ */
+macro_ptr find_macro(name_id name, const assembler_context *asmContext);
 
 /**
  * @brief Check whether a macro with the given name is defined.
  *
- * @param name       Macro name.
+ * @param name       Macro name id (NO_NAME_ID is never a macro).
  * @param macro_list Macro list head.
  * @return true if defined, false otherwise.
  */
-boolean is_macro_defined(const char *name, macro_ptr macro_list);
+boolean is_macro_defined(name_id name, macro_ptr macro_list);
 
 /**
  * @brief Check if a name is reserved by the preprocessor (e.g., "mcro", "mcroend").
@@ -142,13 +185,15 @@ typedef enum {
  * @brief Macro list node.
  *
  * Represents a single macro definition collected during preprocessing.
- * The @p name and @p content pointers are heap-allocated and owned by this node.
+ * The @p content pointer is heap-allocated and owned by this node, the
+ * name is kept in the names pool.
  */
 typedef struct macro {
-    char *name;          /**< Macro name (NUL-terminated). */
+    name_id name;        /**< Macro name (id in the names pool). */
     char *content;       /**< Full macro body as a single string. */
     int   lines;         /**< Number of macro content lines */
     int define_line;     /**< the line where macro defined in .as file */
+    boolean prelude;     /**< Defined in the macro prelude (its lines are not in the .as file). */
     macro_ptr next;      /**< Next node in the macro list. */
 }macro;
 
@@ -0,0 +1,154 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "boolean.h"
+#include "context.h"
+
+
+/**
+ * @file query.h
+ * @brief Symbol queries (server mode and language server).
+ *
+ * A source file (or an editor document) is analyzed with the preprocessor and
+ * both passes, without writing any file (not even the .am file), and the
+ * symbols found by the analysis are kept in a symbol index. The queries are
+ * answered from the index:
+ *
+ *   define <file> <symbol>   Definition location of a label or a macro.
+ *   refs   <file> <symbol>   All the use sites of a label (line, patched word).
+ *   hover  <file> <symbol>   Label kind, final address and encoded word,
+ *                            or the macro definition details.
+ *
+ * The diagnostics of the file are printed while it is analyzed.
+ */
+
+
+/**
+ * @enum symbol_kind
+ * @brief Kind of an indexed symbol.
+ */
+typedef enum symbol_kind {
+    CODE_LABEL_SYMBOL,   /**< Label of an instruction. */
+    DATA_LABEL_SYMBOL,   /**< Label of a data directive. */
+    EXTERN_LABEL_SYMBOL, /**< External label (no address in the file). */
+    MACRO_SYMBOL         /**< Macro of the file. */
+} symbol_kind;
+
+
+/**
+ * @struct indexed_symbol
+ * @brief A label or a macro of an analyzed file.
+ */
+typedef struct indexed_symbol {
+    char *name;            /**< Symbol name (in the names block of the index). */
+    symbol_kind kind;      /**< Symbol kind. */
+    boolean entry;         /**< Label exported with .entry. */
+    int define_line;       /**< Source line of the definition (or the .extern declaration). */
+    unsigned int address;  /**< Final label address. */
+    boolean has_word;      /**< The memory word at the address is known. */
+    int word;              /**< Encoded word at the label address. */
+    int body_lines;        /**< Amount of body lines of a macro (without mcro/mcroend). */
+} indexed_symbol;
+
+
+/**
+ * @struct indexed_reference
+ * @brief A use of a label as an instruction operand.
+ */
+typedef struct indexed_reference {
+    int symbol;            /**< Index of the label in the symbols of the index. */
+    int line;              /**< Source line of the use. */
+    unsigned int address;  /**< Address of the patched word. */
+    boolean has_word;      /**< The patched word is known. */
+    int word;              /**< Encoded patched word. */
+} indexed_reference;
+
+
+/**
+ * @struct symbol_index
+ * @brief The symbols of an analyzed file, kept after the file state of the context is recycled.
+ *
+ * The index is kept in retained allocations (see retain_allocation), so it
+ * lives until free_symbol_index (or until the context memory is released).
+ */
+typedef struct symbol_index {
+    char *file_name;                 /**< Analyzed source file name (.as). */
+    indexed_symbol *symbols;         /**< Labels, then macros. */
+    int symbols_amount;              /**< Amount of symbols. */
+    indexed_reference *references;   /**< Label uses, in the address order. */
+    int references_amount;           /**< Amount of references. */
+    char *names;                     /**< Block of all the symbols names. */
+    const_target_ptr target;         /**< Target of the analysis (formats the addresses and words). */
+    boolean has_errors;              /**< The file has errors, the addresses may be not final. */
+} symbol_index;
+
+
+/**
+ * @brief Check if a request starts with a symbol query command.
+ *
+ * @param command First word of the request.
+ * @return true if @p command is a query command.
+ */
+boolean is_symbol_query(const char *command);
+
+
+/**
+ * @brief Execute a symbol query request.
+ *
+ * @param args_count Number of request arguments, including the program name.
+ * @param args       Request arguments (argv style): command, file, symbol.
+ * @param asmContext Initialized assembler context (see init_assembler), its
+ *                   file state is recycled after the query.
+ * @return true if the symbol was found, false otherwise (error printed).
+ */
+boolean run_symbol_query(int args_count, char *args[], assembler_context *asmContext);
+
+
+/**
+ * @brief Analyze a source file and build its symbol index.
+ *
+ * Runs the preprocessor and both passes (each stage only if the previous
+ * succeeded) without writing any file; the diagnostics are printed. The
+ * lines unchanged since the previous analysis of the file in this context are
+ * replayed, not parsed. The file state of the context is recycled after the
+ * index is built.
+ *
+ * @param asmContext  Initialized assembler context.
+ * @param source_file Source file name (as received from the user).
+ * @param source_text Content of the file to analyze instead of reading it (an editor document), or NULL.
+ * @param index_out   [out] Symbol index (empty if the file can't be analyzed), released with free_symbol_index.
+ * @return true if at least the preprocessor completed (symbols available).
+ */
+boolean analyze_source(assembler_context *asmContext, const char *source_file, const char *source_text, symbol_index *index_out);
+
+
+/**
+ * @brief Find a symbol of an index by name.
+ *
+ * @return The symbol index in index->symbols, or -1 if not found.
+ */
+int find_indexed_symbol(const symbol_index *index, const char *name);
+
+
+/**
+ * @brief Write the hover text of a symbol (kind, definition line, address and encoded word).
+ *
+ * The address and the word of a label are left out (marked unresolved) when
+ * the analyzed file has errors, they may be not final.
+ *
+ * @param index      Symbol index.
+ * @param symbol     Symbol index in index->symbols.
+ * @param buffer_out [out] Buffer of QUERY_HOVER_MAX_LEN + 1 characters.
+ */
+void format_symbol_hover(const symbol_index *index, int symbol, char *buffer_out);
+
+
+/**
+ * @brief Release the memory of a symbol index, and leave it empty.
+ *
+ * @param index Symbol index.
+ */
+void free_symbol_index(symbol_index *index);
+
+
+#endif
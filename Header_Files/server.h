@@ -0,0 +1,42 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "boolean.h"
+
+
+/**
+ * @brief Run the assembler as a persistent request server.
+ *
+ * Keeps the process (and its warm assembler context) alive and executes
+ * assembly requests. A request holds exactly the arguments accepted by the
+ * command line (source files and flags), so any existing invocation can be
+ * forwarded to the server as is. A request may also be a symbol query
+ * (define/refs/hover, see query.h).
+ *
+ * Without a socket, the requests are read from the standard input, one
+ * request per line (arguments separated by white spaces). The output of every
+ * request is written to the standard output and is terminated by a line that
+ * contains only SERVER_END_OF_RESPONSE, after which the output is flushed.
+ * The server stops on end of input or on a SERVER_QUIT_REQUEST line.
+ *
+ * With a socket, the server listens on a local (AF_UNIX) socket, and every
+ * connection holds a single request: its length in decimal digits, then the
+ * working directory of the client and its arguments, each field terminated by
+ * '\0'. A request not received within SERVER_SOCKET_TIMEOUT_MS is rejected.
+ * An argument SERVER_INLINE_SOURCE_OPTION=<file> is followed by a field with
+ * the content of the file, which is assembled instead of the file on disk
+ * (the output files are still written in the client working directory). The
+ * request is executed in the client working directory, and the answer is its
+ * output, followed by SERVER_SOCKET_STATUS_MARK and a status byte
+ * (SERVER_SOCKET_SUCCESS or SERVER_SOCKET_FAILURE). The requests are answered
+ * by @p workers processes at the same time. The server stops on a
+ * SERVER_QUIT_REQUEST request, and removes the socket file.
+ *
+ * @param socket_path Local socket of the server, or NULL to read the standard input.
+ * @param workers     Number of worker processes that answer the socket requests.
+ * @return true when the server stopped normally, false if the socket can't be used (error printed).
+ */
+boolean run_server(const char *socket_path, int workers);
+
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "boolean.h"
+#include "config.h"
+#include "context.h"
+
+
+/**
+ * @file simulator.h
+ * @brief Simulator of the assembled program (used to verify the optimizations).
+ *
+ * The simulator runs the program from the first address of the code, with
+ * the memory image built from the first pass results: the instruction and
+ * data memories (not relocated yet) and the label addresses resolved the
+ * same way the second pass resolves them.
+ *
+ * Machine model:
+ *  - 8 registers and memory words of the target word size (two's complement).
+ *  - "cmp" updates the Z flag by the difference of its operands, and the
+ *    arithmetic instructions by their result; "bne" jumps when Z is clear.
+ *  - "jsr" and "rts" use a return addresses stack.
+ *  - "red" reads the next value of a fixed input sequence ('a', 'b', ...),
+ *    "prn" appends the value to the output.
+ *  - The matrix dimensions are not encoded in the instruction words, so a
+ *    matrix element is addressed as base + row register + column register.
+ *
+ * A run stops on "stop", on an invalid operation (unknown address, external
+ * label access, empty return stack, immediate destination), or after
+ * SIMULATOR_MAX_STEPS instructions.
+ */
+
+
+/**
+ * @enum sim_stop_reason
+ * @brief Reason of the simulation stop.
+ */
+typedef enum sim_stop_reason {
+    SIM_HALTED,        /**< "stop" executed. */
+    SIM_INVALID,       /**< Invalid operation. */
+    SIM_STEPS_LIMIT    /**< The program didn't stop within SIMULATOR_MAX_STEPS instructions. */
+} sim_stop_reason;
+
+
+/**
+ * @struct sim_result
+ * @brief Observable results of a simulation.
+ */
+typedef struct sim_result {
+    sim_stop_reason stop;                   /**< Stop reason. */
+    unsigned long steps;                    /**< Amount of executed instructions. */
+    int outputs[SIMULATOR_MAX_OUTPUTS];     /**< The first values printed by "prn". */
+    int outputs_count;                      /**< Amount of printed values (may exceed the stored ones). */
+    int data[TARGET_MAX_MEMORY_CAPACITY];   /**< Final data memory (from the first data address). */
+    unsigned int data_size;                 /**< Amount of data memory words. */
+} sim_result;
+
+
+/**
+ * @brief Run the program of a file after its first pass.
+ *
+ * Must be called after a successful first pass and before the second pass
+ * relocation. The context is not changed.
+ *
+ * @param asmContext Assembler context.
+ * @param result_out [out] Observable results of the run.
+ * @return true on success, false on invalid input.
+ */
+boolean simulate_program(const assembler_context *asmContext, sim_result *result_out);
+
+
+/**
+ * @brief Check if two simulations have the same observable results.
+ *
+ * The stop reason, the output values and the final data memory are compared
+ * (the amount of executed instructions may differ).
+ *
+ * @return true if both results are the same.
+ */
+boolean is_same_sim_result(const sim_result *result1, const sim_result *result2);
+
+
+#endif
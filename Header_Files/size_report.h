@@ -0,0 +1,73 @@
+#ifndef SIZE_REPORT_H
+#define SIZE_REPORT_H
+
+#include "boolean.h"
+#include "context.h"
+#include "labels.h"
+#include "typedef.h"
+
+
+/**
+ * @file size_report.h
+ * @brief Code size report and memory budget analysis ("--size-report").
+ *
+ * While the first pass runs, every instruction and data line records the
+ * amount of memory words it requires (even after the memory is full, so the
+ * total overshoot is known). At the end of the file the records are
+ * attributed to labels, macro expansions and source lines, and printed.
+ */
+
+
+/*operand slot without operand*/
+#define NO_OPERAND (-1)
+
+
+/**
+ * @struct size_record
+ * @brief Memory words required by a single .am line.
+ */
+typedef struct size_record {
+    int file_line;          /**< The .am file line. */
+    unsigned int words;     /**< Amount of memory words the line requires. */
+    addr_type type;         /**< CODE for instruction lines, DATA for data directives. */
+    int src_mode;           /**< Source operand addressing mode (NO_OPERAND if none). */
+    int dest_mode;          /**< Destination operand addressing mode (NO_OPERAND if none). */
+    size_record_ptr next;   /**< Next record in the list. */
+} size_record;
+
+
+/**
+ * @brief Add a size record to the end of the records list.
+ *
+ * @param file_line    The .am file line.
+ * @param words        Amount of memory words the line requires.
+ * @param type         CODE or DATA.
+ * @param src_mode     Source operand addressing mode, or NO_OPERAND.
+ * @param dest_mode    Destination operand addressing mode, or NO_OPERAND.
+ * @param records_list Pointer to the head of the records list.
+ * @return true on success, false on invalid input.
+ */
+boolean add_size_record(int file_line, unsigned int words, addr_type type, int src_mode, int dest_mode, size_record_ptr *records_list);
+
+
+/**
+ * @brief Print the size report of the assembled file.
+ *
+ * Prints the required words versus the available memory (and the overshoot),
+ * the words spent on every addressing mode, and the top consumers:
+ * labels, macro expansions and source lines.
+ *
+ * @param asmContext Assembler context (after the first pass, successful or not).
+ */
+void print_size_report(const assembler_context *asmContext);
+
+
+/**
+ * @brief Free the size records list.
+ *
+ * @param records_list Pointer to the head of the records list.
+ */
+void free_size_records(size_record_ptr *records_list);
+
+
+#endif
@@ -60,17 +60,117 @@ void* handle_realloc(void* pointer, unsigned long size);
 void safe_free(void **ptr_ptr);
 
 
+/**
+ * @brief Keep a tracked allocation between the files of a batch.
+ *
+ * Moves the pointer to the kept allocations: free_all_tracked_allocations()
+ * doesn't free it, handle_realloc() and safe_free() still update it, and
+ * free_all_memory() frees it at the end of the batch.
+ *
+ * @param ptr Pointer returned by handle_malloc() or handle_realloc().
+ */
+void retain_allocation(void *ptr);
+
+
+/**
+ * @brief Prepare the assembler context for the next file of a batch.
+ *
+ * Empties the lists, the labels table, the names pool, the memory image and
+ * the text buffers of the context without releasing their memory (the next
+ * file reuses it), frees the file names, and clears the other tracked
+ * allocations of the file.
+ *
+ * @param asmContext Pointer to the assembler context to recycle.
+ */
+void recycle_all_memory(assembler_context *asmContext);
+
+
 /**
  * @brief Free all memory associated with the assembler context.
  *
  * Calls free functions for all linked lists, frees context-owned strings,
- * and finally clears any remaining tracked allocations.
+ * and finally clears any remaining tracked allocations (including the kept ones).
  *
  * @param asmContext Pointer to the assembler context to clean up.
  */
 void free_all_memory(assembler_context *asmContext);
 
 
+/**
+ * @struct slab_cache
+ * @brief Allocator of fixed size objects (a cache per object type).
+ *
+ * The objects are taken from slabs, blocks of SLAB_OBJECTS objects that
+ * are allocated by handle_malloc. A new object is the next object of the
+ * current slab (a pointer bump) or a released object from the free list,
+ * and all the slabs of a cache are released together (slab_release). The
+ * slabs are kept allocations (see retain_allocation): slab_reset empties
+ * the cache and keeps its slabs as spare slabs for the next file.
+ *
+ * When compiled with SLAB_DEBUG defined, every object has a state word:
+ * releasing an object twice is detected, and a released object is filled
+ * with SLAB_POISON_BYTE and checked when it's reused.
+ */
+typedef struct slab_cache {
+    unsigned long object_size;   /**< Slot size (the object size aligned, and the state word in debug builds). */
+    void *slabs;                 /**< Allocated slabs (the first word of a slab links to the previous slab). */
+    void *spare_slabs;           /**< Empty slabs, used before allocating a new slab. */
+    char *next_object;           /**< Next never used slot of the current slab. */
+    char *slab_end;              /**< End of the current slab. */
+    void *free_list;             /**< Released objects. */
+} slab_cache;
+
+
+/**
+ * @brief Initialize an empty cache.
+ *
+ * @param cache       The cache.
+ * @param object_size Size of a single object.
+ */
+void init_slab_cache(slab_cache *cache, unsigned long object_size);
+
+
+/**
+ * @brief Allocate an object from a cache.
+ *
+ * @note Terminates the program on failure (like handle_malloc), so callers
+ *       do NOT need to check the return value for NULL.
+ *
+ * @param cache The cache (initialized).
+ * @return Pointer to the object memory (not initialized).
+ */
+void* slab_alloc(slab_cache *cache);
+
+
+/**
+ * @brief Return an object to the free list of its cache.
+ *
+ * Sets the caller's pointer to NULL (like safe_free).
+ *
+ * @param cache      The cache the object was allocated from.
+ * @param object_ptr Address of the object pointer.
+ */
+void slab_free(slab_cache *cache, void **object_ptr);
+
+
+/**
+ * @brief Release all the slabs of a cache (every object of the cache at once).
+ *
+ * The cache stays initialized and may be used again.
+ *
+ * @param cache The cache.
+ */
+void slab_release(slab_cache *cache);
+
+
+/**
+ * @brief Release every object of a cache at once, and keep its slabs for the next objects.
+ *
+ * @param cache The cache.
+ */
+void slab_reset(slab_cache *cache);
+
+
 
 
 
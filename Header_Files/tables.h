@@ -4,6 +4,46 @@
 #include "instructions.h"
 
 
+/**
+ * @enum opcode_number
+ * @brief Opcode numbers (also the indexes of the opcode table).
+ */
+typedef enum opcode_number {
+    MOV_OPCODE,
+    CMP_OPCODE,
+    ADD_OPCODE,
+    SUB_OPCODE,
+    LEA_OPCODE,
+    CLR_OPCODE,
+    NOT_OPCODE,
+    INC_OPCODE,
+    DEC_OPCODE,
+    JMP_OPCODE,
+    BNE_OPCODE,
+    JSR_OPCODE,
+    RED_OPCODE,
+    PRN_OPCODE,
+    RTS_OPCODE,
+    STOP_OPCODE
+} opcode_number;
+
+
+/**
+ * @enum opcode_effect
+ * @brief Run-time effects of an opcode (bit flags).
+ *
+ * Used by the optimizations that must keep the program behavior,
+ * and by the simulator.
+ */
+typedef enum opcode_effect {
+    NO_EFFECT = 0,
+    WRITES_DEST = 1,      /**< Writes the destination operand. */
+    WRITES_FLAGS = 2,     /**< Updates the PSW flags (Z). */
+    CHANGES_FLOW = 4,     /**< May change the program counter (jump, call, return, stop). */
+    INPUT_OUTPUT = 8      /**< Reads the input or writes the output. */
+} opcode_effect;
+
+
 /**
  * @brief Retrieves the global opcode table.
  *
@@ -15,6 +55,16 @@
  */
 const opcode *get_opcode_table(void);
 
+/**
+ * @brief Retrieves the run-time effects of an opcode.
+ *
+ * "cmp" and the arithmetic instructions (add, sub, clr, not, inc, dec) update the PSW flags.
+ *
+ * @param opcode_num Opcode number.
+ * @return Bit flags of opcode_effect (NO_EFFECT for an unknown opcode).
+ */
+int get_opcode_effects(int opcode_num);
+
 /**
  * @brief Retrieves the list of available registers.
  *
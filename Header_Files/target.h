@@ -0,0 +1,85 @@
+#ifndef TARGET_H
+#define TARGET_H
+
+#include "config.h"
+#include "typedef.h"
+
+
+/**
+ * @file target.h
+ * @brief Target machine profiles ("--target=<name>").
+ *
+ * A target profile describes the machine the program is assembled for:
+ * the word size, the memory size, the load address and the operand data
+ * field. The instruction word layout (opcode at the MSB, addressing modes,
+ * ERA and register fields at the LSB) is the same for all the profiles.
+ *
+ * Profiles:
+ *  - "classic": 10-bit words, 256 memory words, loaded at address 100 (default).
+ *  - "wide":    16-bit words, 1024 memory words, loaded at address 100.
+ *
+ * The encoding and base 4 formatting functions of every profile are
+ * generated from a single macro with the profile values as constants, so
+ * the selected profile costs a single indirect call per word.
+ *
+ * The line and name lengths size the parser buffers, and stay compile-time
+ * limits of config.h.
+ */
+
+
+/**
+ * @struct target_profile
+ * @brief Values and specialized functions of a target machine.
+ */
+typedef struct target_profile {
+    const char *name;                    /**< Profile name (for "--target"). */
+    int word_bit_size;                   /**< Memory word size in bits. */
+    unsigned int word_bit_mask;          /**< Mask of the memory word bits. */
+    unsigned int memory_capacity;        /**< Amount of memory words. */
+    unsigned int address_offset;         /**< Load address of the program. */
+    unsigned int memory_available_space; /**< Memory words available for the program. */
+    int opcode_bits_shift;               /**< Shift of the opcode bit-field (MSB). */
+    int operand_data_bits;               /**< Size of the operand data bit-field (MSB). */
+    int operand_data_bits_shift;         /**< Shift of the operand data bit-field. */
+    int address_print_length;            /**< Base 4 digits of an address in the output files. */
+    int data_print_length;               /**< Base 4 digits of a word in the output files. */
+
+    /** Encode an instruction first word (opcode, addressing modes and ERA). */
+    unsigned int (*encode_first_word)(unsigned int opcode, unsigned int src_mode, unsigned int dest_mode, unsigned int era);
+
+    /** Encode an operand word with the data bit-field (immediate value or label address) and ERA. */
+    unsigned int (*encode_data_word)(unsigned int data, unsigned int era);
+
+    /** Encode a registers operand word (source and destination register fields) and ERA. */
+    unsigned int (*encode_registers_word)(unsigned int src_reg, unsigned int dest_reg, unsigned int era);
+
+    /** Format an address in base 4 (address_print_length letters and a null terminator). */
+    void (*format_address)(unsigned int address, char *result_out);
+
+    /** Format a memory word in base 4 (data_print_length letters and a null terminator). */
+    void (*format_word)(unsigned int word, char *result_out);
+} target_profile;
+
+
+/**
+ * @brief Get a target profile by its name.
+ *
+ * @param name Profile name.
+ * @return The profile, or NULL if there is no such profile.
+ */
+const_target_ptr get_target_profile(const char *name);
+
+
+/**
+ * @brief Get the default target profile ("classic").
+ */
+const_target_ptr get_default_target(void);
+
+
+/**
+ * @brief Print the names of the available profiles (separated by ", ").
+ */
+void print_target_names(void);
+
+
+#endif
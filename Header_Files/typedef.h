@@ -58,13 +58,47 @@ typedef struct macro *macro_ptr;
 typedef struct lines_LUT *lines_map_ptr;
 
 /**
- * @typedef label_ptr
- * @brief Pointer to a node in the labels list.
+ * @typedef symbol_table_ptr
+ * @brief Pointer to the labels table.
  *
- * Each node stores a label name, its address, type (CODE/DATA),
- * definition type (NORMAL/EXTERN), and whether it is marked as entry.
+ * Stores the label names, addresses, types (CODE/DATA),
+ * definition types (NORMAL/EXTERN), and the entry flags.
  */
-typedef struct label *label_ptr;
+typedef struct symbol_table *symbol_table_ptr;
+
+/**
+ * @typedef intern_pool_ptr
+ * @brief Pointer to the names pool of a file.
+ *
+ * Keeps a single copy of every identifier (labels, macros, label operands
+ * and external uses) and gives it a stable name id.
+ */
+typedef struct intern_pool *intern_pool_ptr;
+
+/**
+ * @typedef name_id
+ * @brief Id of a name in the names pool (32 bits on the supported platforms).
+ *
+ * Two identifiers of the same file are equal only if their ids are equal.
+ */
+typedef unsigned int name_id;
+
+/**
+ * @typedef size_record_ptr
+ * @brief Pointer to a node in the size records list ("--size-report").
+ *
+ * Each node stores the amount of memory words required by a single line.
+ */
+typedef struct size_record *size_record_ptr;
+
+/**
+ * @typedef memory_image_ptr
+ * @brief Pointer to the packed memory image of an assembled program.
+ *
+ * Holds the code and data words in the address order, built after the
+ * second pass for the output files.
+ */
+typedef struct memory_image *memory_image_ptr;
 
 /**
  * @typedef opcode_ptr
@@ -86,4 +120,24 @@ typedef struct opcode *opcode_ptr;
 typedef const struct opcode* const_opcode_ptr;
 
 
+/**
+ * @typedef const_target_ptr
+ * @brief Pointer to a constant target machine profile.
+ *
+ * Provides the word size, memory layout and the specialized encoding
+ * functions of the machine the program is assembled for.
+ */
+typedef const struct target_profile* const_target_ptr;
+
+
+/**
+ * @typedef line_records_ptr
+ * @brief Pointer to the line records of the recently assembled files.
+ *
+ * Holds the first pass results of the lines of every file, replayed
+ * for the unchanged lines of its next run (server mode).
+ */
+typedef struct line_records *line_records_ptr;
+
+
 #endif
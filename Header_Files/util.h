@@ -31,8 +31,6 @@ typedef enum print_type {
 }print_type;
 
 
-
-
  /**
   * @brief Make an allocated copy of the input string.
   * @param string Source string (must not be NULL).
@@ -46,11 +44,57 @@ char* copy_string(const char *string);
 
 /**
  * @brief Validate an identifier (label/macro) name.
- * Rules: length ≤ NAME_MAX_LEN, starts with alpha, continues with [A-Za-z0-9_].
+ * Rules: length ≤ NAME_MAX_LEN (not checked with relaxed limits), starts with alpha, continues with [A-Za-z0-9_].
  * @param str The candidate name.
+ * @param asmContext Context (limits mode).
  * @return true if valid, false otherwise.
  */
-boolean is_name_valid(const char *str);
+boolean is_name_valid(const char *str, const assembler_context *asmContext);
+
+/**
+ * @brief Initialize an empty text buffer (allocates the initial capacity).
+ * @param buffer The buffer.
+ */
+void init_text_buffer(text_buffer *buffer);
+
+/**
+ * @brief Append a text to the end of a text buffer (grows the buffer if needed).
+ * @param buffer The buffer.
+ * @param text   Text to append.
+ * @param length Text length.
+ */
+void append_text(text_buffer *buffer, const char *text, unsigned long length);
+
+/**
+ * @brief Read a full line (including the '\n') into a text buffer, of any length.
+ * The previous buffer content is replaced.
+ * @param file   File to read from.
+ * @param line   [out] The line buffer.
+ * @return false at the end of the file (nothing was read).
+ */
+boolean read_line(FILE *file, text_buffer *line);
+
+/**
+ * @brief Read the next line (including the '\n') of a text into a line buffer, of any length.
+ * The previous line buffer content is replaced.
+ * @param text     The text.
+ * @param position [in/out] Position of the next line in the text.
+ * @param line     [out] The line buffer.
+ * @return false at the end of the text (nothing was read).
+ */
+boolean read_text_line(const text_buffer *text, unsigned long *position, text_buffer *line);
+
+/**
+ * @brief Empty a text buffer, its memory is kept (a buffer without memory is unchanged).
+ * @param buffer The buffer.
+ */
+void clear_text_buffer(text_buffer *buffer);
+
+/**
+ * @brief Release the memory of a text buffer.
+ * @param buffer The buffer.
+ */
+void free_text_buffer(text_buffer *buffer);
 
 /**
  * @brief Check that a name is available (not reserved and not already used).
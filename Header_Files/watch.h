@@ -0,0 +1,32 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include "boolean.h"
+#include "options.h"
+
+
+/**
+ * @brief Assemble the source files, and assemble them again on every change.
+ *
+ * After the first assembly of all the files, the directories of the sources
+ * are watched with inotify (on systems without inotify, the sources are polled
+ * every WATCH_POLL_INTERVAL_MS milliseconds). A burst of writes is coalesced
+ * by waiting WATCH_SETTLE_MS milliseconds without events, so it triggers a
+ * single run, and then only the changed files are assembled again.
+ * The errors of every run are received through the error sink of the context
+ * and compared (by message, an error moved by an edit is the same error) with
+ * the errors of the previous run of the same file, and only the added (+) and
+ * removed (-) diagnostics are printed after the run.
+ *
+ * The watcher runs until the process is interrupted (Ctrl+C).
+ *
+ * @param files       Number of source files in @p files_names.
+ * @param files_names Source file names (starting at index 1, as in argv).
+ * @param options     Options of the run.
+ * @return false if the files can't be watched (error printed), otherwise
+ *         the function does not return.
+ */
+boolean run_watch(int files, char *files_names[], const assembler_options *options);
+
+
+#endif
@@ -8,7 +8,9 @@
 #include "instruction_memory.h"
 #include "labels.h"
 #include "externals.h"
+#include "node_pool.h"
 #include "sys_memory.h"
+#include "target.h"
 
 
 
@@ -33,6 +35,10 @@
  * consistent and correct addressing after relocation, enabling
  * the assembler to produce valid output files.
  *
+ * The relocation and the requests are sequential walks over the lists of
+ * at most 1024 words; the requests are patched in a single merge with the
+ * instruction memory, and stop at the first undefined label in source order.
+ *
  * @author Ivgeny Tokarzhevsky
  * @date 01/09/2025
  */
@@ -41,47 +47,53 @@
 
 boolean add_addr_update_request(unsigned int IC_addr, operand *operand, address_update_request_ptr *request_list) {
 
-    address_update_request_ptr temp = NULL;
     address_update_request_ptr new_addr_update_request = NULL;
 
     /*verify that all input pointers exist*/
     if (!operand || !request_list){print_internal_error(ERROR_CODE_25, "add_addr_update_request"); return false;}
 
     /*allocate memory for new request*/
-    new_addr_update_request = (address_update_request_ptr)handle_malloc(sizeof(address_update_request));
+    new_addr_update_request = (address_update_request_ptr)alloc_node(ADDRESS_REQUEST_NODE);
 
 
     /*set the request node values*/
     new_addr_update_request->operand = operand;
     new_addr_update_request->address = IC_addr;
-    new_addr_update_request->next = NULL;
 
-    /*insert the new request in end of the list*/
-    if(*request_list == NULL) {
-        *request_list = new_addr_update_request;
-        return true;
+    /*insert the new request at the head of the list*/
+    new_addr_update_request->next = *request_list;
+    *request_list = new_addr_update_request;
+    return true;
+}
+
+
+void reverse_addr_update_requests(address_update_request_ptr *request_list) {
+
+    address_update_request_ptr reversed = NULL;
+    address_update_request_ptr temp;
+
+    if (!request_list) {
+        return;
     }
-    else {
-        temp = *request_list;
-        while(temp->next != NULL) {
-            temp = temp->next;
-        }
-        temp->next = new_addr_update_request;
-        return true;}
 
+    /*move the nodes one by one to the head of the reversed list*/
+    while (*request_list != NULL) {
+        temp = *request_list;
+        *request_list = temp->next;
+        temp->next = reversed;
+        reversed = temp;
+    }
+    *request_list = reversed;
 }
 
 
-void print_addr_update_requests(address_update_request_ptr request_list) {
+void print_addr_update_requests(address_update_request_ptr request_list, const intern_pool *names) {
 
     while (request_list != NULL) {
 
         /*access to the correct operand union field*/
-        if (request_list->operand->type == MATRIX_ACCESS) {
-            printf("\nrequest to update label addr: %s    ", request_list->operand->operand_val.matrix.label);
-        }
-        else if (request_list->operand->type == DIRECT_ACCESS) {
-            printf("\nrequest to update label addr: %s    ", request_list->operand->operand_val.label);
+        if (request_list->operand->type == MATRIX_ACCESS || request_list->operand->type == DIRECT_ACCESS) {
+            printf("\nrequest to update label addr: %s    ", get_name(names, operand_label(request_list->operand)));
         }
         else {
             return;
@@ -96,12 +108,12 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
 
     address_update_request_ptr address_update_request;
     instruction_ptr instructions_memory;
-    const char *label_name;
+    name_id label_name;
     unsigned int new_label_addr;
     unsigned int encoded_label_addr;
     instruction_ptr instruction_node;
     unsigned int inst_addr_to_update;
-    label_ptr label;
+    int label;
 
     /*verify that context exist*/
     if (!asmContext) {
@@ -114,8 +126,11 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
     instructions_memory = asmContext->instruction_memory;
 
     /*update the request addresses with the new instruction addresses(after instruction memory relocated) */
-    update_request_list_addresses(asmContext->address_update_requests);
+    update_request_list_addresses(asmContext->address_update_requests, asmContext->target->address_offset);
 
+    /*the requests and the instruction memory are both ordered by the addresses,
+     *so the instruction of a request is searched from the instruction of the previous one*/
+    instruction_node = instructions_memory;
 
     while (address_update_request != NULL) {
         if (!address_update_request->operand ) { print_internal_error(ERROR_CODE_30,"update_relocated_addresses"); return false; }
@@ -149,8 +164,10 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
             return false;
         }
 
-        /*get the instruction memory head*/
-        instruction_node = instructions_memory;
+        /*a request before the previous one (not in the addresses order), search from the head*/
+        if (instruction_node == NULL || instruction_node->address > inst_addr_to_update) {
+            instruction_node = instructions_memory;
+        }
 
         /*find the instruction memory node that must be updated with the resolved label address.*/
         while (instruction_node && instruction_node->address != inst_addr_to_update) {
@@ -162,16 +179,16 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
 
         /*verify that the label defined, otherwise print error
          * according to attempt using undefined label as operand */
-        if (is_label_defined(label_name, asmContext->labels)) {
+        if ((label = find_label(label_name, asmContext->labels)) != NO_LABEL) {
 
 
-            /*get the label that used as operand in the instruction*/
-            label = get_label(label_name, asmContext->labels);
+            /*count the use of the label that used as operand in the instruction*/
+            asmContext->labels->references[label]++;
             /*Get the label new final address*/
-            new_label_addr = get_label_address(label_name, asmContext->labels);
+            new_label_addr = asmContext->labels->addresses[label];
 
             /* - - - - -update the label encoding mode - - - - -*/
-            if (label->definition == EXTERN) {
+            if (asmContext->labels->definitions[label] == EXTERN) {
                 address_update_request->operand->encoding = EXTERNAL;
                 add_external_usage(label_name, inst_addr_to_update,(external_ptr*)&asmContext->external_labels);
             }
@@ -187,7 +204,7 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
         }
 
         /*encode the instruction operand with the resolved label address*/
-        if (!encode_label_address(new_label_addr, address_update_request->operand->encoding, &encoded_label_addr)) {
+        if (!encode_label_address(asmContext->target, new_label_addr, address_update_request->operand->encoding, &encoded_label_addr)) {
             return false;
         }
         /*update the encoded operand value in the instruction memory*/
@@ -205,27 +222,29 @@ boolean process_addr_update_requests(assembler_context *asmContext) {
 
 boolean update_labels_addresses(assembler_context *asmContext) {
 
-    label_ptr temp;
+    symbol_table_ptr labels;
+    unsigned int code_offset;
+    unsigned int data_offset;
+    int i;
 
     /*verify that the assembler context exist*/
     if (!asmContext) {
         print_internal_error(ERROR_CODE_25, "relocate_labels_addresses"); return false;
     }
-    /*get the labels list*/
-    temp = asmContext->labels;
+    /*get the labels table*/
+    labels = asmContext->labels;
 
-    /*update the label in the next way :
+    code_offset = asmContext->target->address_offset;
+    data_offset = asmContext->IC + asmContext->target->address_offset;
+
+    /*update the label in the next way (a single loop over the addresses column, selected by the types column):
      * code label -> add the memory offset to the label address.
      * data label -> add the memory offset and the Instruction count value to the label address
+     * extern label -> unchanged.
      */
-    while(temp != NULL) {
-        if (temp->type == DATA) {
-            temp->address += (asmContext->IC + MEMORY_ADDRESS_OFFSET);
-        }
-        else if (temp->type == CODE) {
-            temp->address += MEMORY_ADDRESS_OFFSET;
-        }
-        temp = temp->next;
+    for (i = 0; i < labels_amount(labels); i++) {
+        labels->addresses[i] += (labels->types[i] == DATA) ? data_offset :
+                                (labels->types[i] == CODE) ? code_offset : 0;
     }
     return true;
 }
@@ -241,7 +260,7 @@ boolean update_data_addresses(assembler_context *asm_context) {
 
     /* add to data memory the last instruction counter, then add the memory offset*/
     while(temp != NULL) {
-        temp->address += (asm_context->IC+ MEMORY_ADDRESS_OFFSET);
+        temp->address += (asm_context->IC + asm_context->target->address_offset);
         temp = temp->next;
     }
     /* now, the data memory located after the instruction memory */
@@ -259,7 +278,7 @@ boolean update_instruction_addresses(assembler_context *asmContext) {
     /*set instruction memory  after the memory offset address*/
     while(temp != NULL) {
 
-        temp->address += MEMORY_ADDRESS_OFFSET;
+        temp->address += asmContext->target->address_offset;
 
         temp = temp->next;
     }
@@ -267,12 +286,12 @@ boolean update_instruction_addresses(assembler_context *asmContext) {
     return true;
 }
 
-void update_request_list_addresses(address_update_request_ptr request_list) {
+void update_request_list_addresses(address_update_request_ptr request_list, unsigned int address_offset) {
 
     /*update the instruction address in the request list with the new relocated instruction address
      * by adding the memory offset*/
     while (request_list != NULL) {
-        request_list->address += MEMORY_ADDRESS_OFFSET;
+        request_list->address += address_offset;
         request_list = request_list->next;
     }
 }
@@ -286,7 +305,7 @@ void free_addr_update_req_list(address_update_request_ptr *request_list) {
         temp = *request_list;
         *request_list = (*request_list)->next;
 
-        safe_free((void**)&temp->operand);
-        safe_free((void**)&temp);
+        free_operand(&temp->operand);
+        free_node(ADDRESS_REQUEST_NODE, (void**)&temp);
     }
 }
@@ -1,16 +1,32 @@
 
 #include "assembler.h"
 #include <string.h>
+#include <time.h>
 #include "data_memory.h"
 #include "errors.h"
 #include "first_pass.h"
 #include "externals.h"
 #include "files.h"
+#include "intern_pool.h"
+#include "labels.h"
 #include "pre_processor.h"
 #include "second_pass.h"
 #include "tables.h"
+#include "memory_image.h"
+#include "target.h"
 #include "context.h"
 #include "sys_memory.h"
+#include "options.h"
+#include "server.h"
+#include "client.h"
+#include "build_cache.h"
+#include "watch.h"
+#include "lsp.h"
+#include "size_report.h"
+#include "util.h"
+#include "data_pool.h"
+#include "peephole.h"
+#include "backpatch.h"
 
 
 
@@ -26,12 +42,16 @@
  *  - For each input file:
  *      - Initialize the assembler context.
  *      - Remove any previously generated output files.
- *      - Run preprocessing stage (.am file generation).
+ *      - Run preprocessing stage (.am file generation, the .am content is
+ *        also handed to the passes in memory).
  *      - Execute the first pass (symbols collection, IC/DC setup).
  *      - Execute the second pass (relocations, entries resolution).
  *      - Generate output files (.obj, .ext, .ent as applicable).
  *      - Free all allocated resources.
  *  - Provide user-facing messages, progress reporting, and a final summary.
+ *  - Start the persistent server mode when requested (--serve[=<socket>]),
+ *    or forward the command line to a running server (--connect=<socket>).
+ *  - Start the watch mode when requested (--watch).
  *
  * The workflow ensures robust error detection at each stage and avoids
  * producing partial or inconsistent output files.
@@ -41,6 +61,44 @@
  */
 
 
+/**
+ * @struct stage_stats
+ * @brief Time of every stage and the data handed between the stages, over a batch of files ("--stats").
+ *
+ * The stages share the single context of the run, so they run one after
+ * another (no pipeline, no queue depths to count).
+ */
+typedef struct stage_stats {
+    clock_t preprocessor_time;     /**< Preprocessor stage time. */
+    clock_t passes_time;           /**< First pass, optimizations and second pass time. */
+    clock_t output_time;           /**< Output files time. */
+    clock_t *running;              /**< Time of the running stage (NULL between the stages). */
+    clock_t started;               /**< Start time of the running stage. */
+    unsigned long am_lines;        /**< .am lines handed from the preprocessor to the passes. */
+    unsigned long am_bytes;        /**< .am bytes handed from the preprocessor to the passes. */
+    unsigned long max_am_bytes;    /**< Largest .am content of a file. */
+    unsigned long image_words;     /**< Memory words handed from the passes to the output files. */
+    unsigned long max_image_words; /**< Largest memory image of a file. */
+    unsigned long replayed_lines;  /**< .am lines replayed from the previous run instead of parsed (server mode). */
+    int output_files;              /**< Written output files. */
+} stage_stats;
+
+
+/**
+ * @brief End the running stage (its time is added to the stage time) and start the next stage.
+ *
+ * @param stats Stages statistics.
+ * @param stage Time of the next stage, or NULL to end the running stage only.
+ */
+static void enter_stage(stage_stats *stats, clock_t *stage);
+
+
+/**
+ * @brief Print the stages statistics of a batch ("--stats").
+ */
+static void print_stage_stats(const stage_stats *stats);
+
+
 int main(int argc, char* argv[]) {
 
     /*start the assembler program*/
@@ -53,84 +111,153 @@ int main(int argc, char* argv[]) {
 boolean run_assembler(int argc, char *argv[]) {
 
     int files = 0;
-    int file_success = 0;
-    boolean DEBUG = false;
-    assembler_context assembler_context;
+    int connect_index;
+    assembler_options options;
 
 
-    /*- - - for debug mode - - -*/
-    if (argc > 1 && strcmp(argv[argc-1],"debug") == 0) {
-        argc --;
-        DEBUG = true;
+    /*- - - client mode, the command line is forwarded to the server as is - - -*/
+    if ((connect_index = find_connect_option(argc, argv)) != 0) {
+        return run_client(get_connect_socket(argv[connect_index]), argc, argv, connect_index);
+    }
+
+    /*separate the flags from the source files*/
+    if (!parse_options(argc, argv, &options, &files)) {
+        printf("Program stopped.");
+        return false;
     }
 
+    /*- - - server mode - - -*/
+    if (options.serve) {
+        if (options.watch || options.lsp) {
+            printf("ERROR: --watch and --lsp can't be combined with --serve.\nProgram stopped.");
+            return false;
+        }
+        return run_server(options.serve_socket, options.serve_workers);
+    }
+
+    /*- - - language server mode - - -*/
+    if (options.lsp) {
+        if (options.watch || files > 0) {
+            printf("ERROR: --lsp takes no source files and can't be combined with --watch.\nProgram stopped.");
+            return false;
+        }
+        return run_lsp();
+    }
 
     /*verify that at least one file exist*/
-    if (argc < 2) {
+    if (files < 1) {
         /*exit if the source files missing*/
         printf("ERROR: Missing assembly source file input. Processing cannot continue.\nProgram stopped.");
         return false;
     }
 
+    /*- - - watch mode - - -*/
+    if (options.watch) {
+        return run_watch(files, argv, &options);
+    }
+
+    return assemble_files(files, argv, &options, NULL);
+}
 
-    /*save the amount of the source files*/
-    files= argc-1;
+
+boolean assemble_files(int files, char *files_names[], const assembler_options *options, warm_context *warm) {
+
+    int file_success = 0;
+    int index = files + 1;
+    assembler_context local_context;
+    assembler_context *context;
+    stage_stats stats;
+    unsigned long handed;
+    unsigned long i;
 
 
     /*source file/s found, execute the assembler*/
     printf("\n================ Assembler started ================\n\n");
 
+    memset(&stats, 0, sizeof(stats));
+    stats.running = NULL;
+
+    /*the kept context of the process already holds the tables (and the prelude, read again only if it changed)*/
+    if (warm) {
+        context = get_warm_context(warm, options->macro_prelude);
+    }
+    /*init assembler context (its buffers and tables are reused by every file),
+     * and read the macro prelude once, its macros are called by all the files*/
+    else {
+        context = &local_context;
+        init_assembler(context);
+        if (options->macro_prelude && !load_macro_prelude(context, options->macro_prelude)) {
+            free_all_memory(context);
+            context = NULL;
+        }
+    }
+
+    if (context == NULL) {
+        printf("\nMacro prelude <%s> failed, no file was assembled.\n", options->macro_prelude);
+        printf("\n\n================ Assembler finished ================\n\nSummary: 0 out of %d files assembled successfully.\n\n",files);
+        return false;
+    }
+
 
     /*iterate through every source file*/
-    while (--argc > 0) {
+    while (--index > 0) {
 
 
         /*========================================= initialize ==========================================-*/
 
-        /*init assembler context*/
-        init_assembler(&assembler_context);
+        /*reset the file state of the context*/
+        reset_assembler(context);
 
 
-        /*get the file name and file path*/
-        /* allocated, required to release memory in the end*/
-        split_name_and_path(argv[argc], &assembler_context.as_file_name,&assembler_context.file_path);
+        /*set the source file name, path and the .am file names*/
+        if (!set_file_names(context, files_names[index])) {
+            /*continue to the next file*/
+            continue;
+        }
 
 
-        /*if the file name provided without file extension, add the assembly source file's extension*/
-        if (get_file_extension(assembler_context.as_file_name) == NULL) {
-            assembler_context.as_file_name =  (char*)handle_realloc(assembler_context.as_file_name,(strlen(assembler_context.as_file_name)+strlen(ASSEMBLY_FILE_EXTENSION)+1) * sizeof(char));
-            strcat(assembler_context.as_file_name,".as");
-        }
+        /*the content sent with the request is assembled instead of the file (server mode)*/
+        context->source_text = find_inline_source(options, files_names[index]);
 
-        /* - - - - - - - - - - - - file name validation - - - - - - - - - - -*/
 
-        if (!is_file_name_valid(assembler_context.as_file_name)) {
-            safe_free((void**)&assembler_context.as_file_name);
-            safe_free((void**)&assembler_context.file_path);
+        /* - - - - - - unchanged file (server mode)  - - - - - - - -*/
 
-            /*continue to the next file*/
+        /*the source and its output files didn't change since the last successful run
+         * (reports printed to the user require a full run, and the macro prelude isn't tracked by the cache)*/
+        if (options->reuse_unchanged && !context->source_text && !options->debug && !options->size_report && !options->peephole_verify &&
+            !options->macro_prelude && is_build_up_to_date(context, options)) {
+            printf("\n\n\n- - - Running assembler on file: <%s> - - -\n\n",context->as_file_name);
+            printf("Source file unchanged since the last run, output files are up to date.");
+            printf("\n\nFile <%s> assembled successfully.\n\n\n",context->as_file_name);
+            file_success++;
+
+            recycle_all_memory(context);
             continue;
         }
 
 
-        /* - - - - - - full file path build for .as File - - - - - - -*/
+        /* - - - - - - remove old files  - - - - - - - -*/
 
-                         /*.as file name already exist*/
+        remove_old_files(context);
 
-        /*build and set the .am full file path*/
-        assembler_context.as_full_file_name = str_concat((assembler_context.file_path == NULL ? EMPTY_STRING : assembler_context.file_path),assembler_context.as_file_name);
+        /*collect the required words of every line for the size report*/
+        context->collect_size_records = options->size_report;
 
-        /* - - - - - full file path build for .am File  -  - - - - -*/
+        /*outline the repeated macro expansions (preprocessor)*/
+        context->outline_macros = options->outline_macros;
+        context->outline_threshold = options->outline_threshold;
 
-        /*build and set the .am file name*/
-        assembler_context.am_file_name = change_file_extension(AM_FILE, assembler_context.as_file_name);/*on error, memory allocation will stop the prog*/
-        /*build and set the .am full file path*/
-        assembler_context.am_full_file_name = str_concat((assembler_context.file_path == NULL ? EMPTY_STRING : assembler_context.file_path),assembler_context.am_file_name);
+        /*target machine profile*/
+        context->target = options->target;
 
+        /*lines and names length limits*/
+        context->relaxed_limits = options->relaxed_limits;
 
-        /* - - - - - - remove old files  - - - - - - - -*/
+        /*single pass with backpatch chains*/
+        context->one_pass = options->one_pass;
 
-        remove_old_files(&assembler_context);
+        /*replay the unchanged lines of the previous run (server mode, the size report needs every line parsed)*/
+        context->reuse_lines = options->reuse_unchanged && !options->one_pass && !options->size_report;
 
 
 
@@ -138,61 +265,112 @@ boolean run_assembler(int argc, char *argv[]) {
         /* ========================================= start file assembly =====================================================*/
 
 
-        printf("\n\n\n- - - Running assembler on file: <%s> - - -\n\n",assembler_context.as_file_name);
+        printf("\n\n\n- - - Running assembler on file: <%s> - - -\n\n",context->as_file_name);
 
 
 
         /*-==============================PREPROCESSOR ===============================*/
 
         /*execute preprocessor*/
-        if (!execute_preprocessor(&assembler_context)) {
-            printf("\n%s: preprocessing failed\n\n",assembler_context.as_file_name);
+        enter_stage(&stats, &stats.preprocessor_time);
+        if (!execute_preprocessor(context)) {
+            printf("\n%s: preprocessing failed\n\n",context->as_file_name);
 
             goto cleanup;
         }
         printf("Preprocessing stage completed.\n\n");
 
+        if (options->outline_macros) {
+            printf("Macro outlining: %u word(s) saved.\n\n", context->outline_saved_words);
+        }
+
 
 
         /*=============================== FIRST PASS ===============================-*/
 
 
+        /*the .am content is handed to the passes in memory*/
+        handed = context->am_buffer.length;
+        stats.am_bytes += handed;
+        stats.max_am_bytes = (handed > stats.max_am_bytes) ? handed : stats.max_am_bytes;
+        for (i = 0; i < handed; i++) {
+            stats.am_lines += (context->am_buffer.data[i] == '\n');
+        }
+
         /*execute first pass*/
-        if (!execute_first_pass(&assembler_context)) {
+        enter_stage(&stats, &stats.passes_time);
+        if (!execute_first_pass(context)) {
             printf("First pass failed.\n\n");
+            stats.replayed_lines += context->replayed_lines;
             goto cleanup;
         }
         printf("First pass completed.\n\n");
+        stats.replayed_lines += context->replayed_lines;
+
+
+        /*share a single copy of identical data blocks (before the data relocation)*/
+        if (options->pool_data) {
+            printf("Data pooling: %u word(s) saved.\n\n", pool_data(context));
+        }
+
+        /*remove the instructions without effect (before the code relocation)*/
+        if (options->peephole && !run_peephole(context, options->peephole_verify)) {
+            context->first_pass_error = true;
+            goto cleanup;
+        }
 
 
         /*=============================== SECOND PASS ===============================-*/
+        /*single pass: patch the remaining chains instead of the second pass*/
+        if (context->one_pass) {
+            if (!resolve_backpatch_chains(context)) {
+                printf("Backpatching failed.\n\n");
+                goto cleanup;
+            }
+            printf("Backpatching completed.\n\n");
+        }
         /*execute second pass*/
-        if (!execute_second_pass(&assembler_context)) {
+        else if (!execute_second_pass(context)) {
             printf("Second pass failed.\n\n");
             goto cleanup;
         }
-        printf("Second pass completed.\n\n");
+        else {
+            printf("Second pass completed.\n\n");
+        }
+
+        /*pack the relocated code and data words for the output files*/
+        if (!build_memory_image(context, context->memory_image)) {
+            printf("Error while building the memory image\n\n");
+            context->output_error = true;
+            goto cleanup;
+        }
+
+        /*the memory image is handed to the output files*/
+        handed = context->IC + context->DC;
+        stats.image_words += handed;
+        stats.max_image_words = (handed > stats.max_image_words) ? handed : stats.max_image_words;
 
 
 
         /* ========================= OUTPUT FILES GENERATION ===========================-*/
 
         /*creat obj file*/
-        if (!create_obj_file(&assembler_context)) {
+        enter_stage(&stats, &stats.output_time);
+        if (!create_obj_file(context)) {
             printf("Error while creating obj file\n\n");
             goto cleanup;
         }
 
         /*creat bin file*/
-        if (!create_bin_file(&assembler_context)) {
+        if (!create_bin_file(context)) {
             printf("Error while creating obj file\n\n");
             goto cleanup;
         }
 
 
         /*create ext file (if required)*/
-        if (is_externals_usage_exist(assembler_context.external_labels)) {
-            if (!create_ext_file(&assembler_context)) {
+        if (is_externals_usage_exist(context->external_labels)) {
+            if (!create_ext_file(context)) {
                 printf("Error while creating ext file\n\n");
                 goto cleanup;
 
@@ -201,58 +379,113 @@ boolean run_assembler(int argc, char *argv[]) {
 
 
         /*create ent file (if required)*/
-        if (is_entry_label_exist(assembler_context.labels)) {
-            if (!create_ent_file(&assembler_context)) {
+        if (is_entry_label_exist(context->labels)) {
+            if (!create_ent_file(context)) {
                 printf("Error while creating entry file\n\n");
                 goto cleanup;
             }
 
         }
 
+        /*create xref file (if requested)*/
+        if (options->xref) {
+            if (!create_xref_file(context)) {
+                printf("Error while creating xref file\n\n");
+                goto cleanup;
+            }
+        }
+
+        /*create listing file (if requested)*/
+        if (options->listing) {
+            if (!create_lst_file(context)) {
+                printf("Error while creating listing file\n\n");
+                goto cleanup;
+            }
+        }
+
+        /*all the output files were written, give them their names together*/
+        if (!commit_output_files(context)) {
+            printf("Error while creating the output files\n\n");
+            goto cleanup;
+        }
+
         /*print user messages, which files generated*/
+        stats.output_files += (context->obj_file_name != NULL) + (context->ext_file_name != NULL) +
+                              (context->bin_file_name != NULL) + (context->ent_file_name != NULL) +
+                              (context->xref_file_name != NULL) + (context->lst_file_name != NULL);
         printf("Output files generated: ");
-        if (assembler_context.obj_file_name) {
-            printf("%s", assembler_context.obj_file_name);
+        if (context->obj_file_name) {
+            printf("%s", context->obj_file_name);
+        }
+        if (context->ext_file_name) {
+            printf(", %s", context->ext_file_name);
+        }
+        if (context->bin_file_name) {
+            printf(", %s", context->bin_file_name);
         }
-        if (assembler_context.ext_file_name) {
-            printf(", %s", assembler_context.ext_file_name);
+        if (context->ent_file_name) {
+            printf(", %s", context->ent_file_name);
         }
-        if (assembler_context.bin_file_name) {
-            printf(", %s", assembler_context.bin_file_name);
+        if (context->xref_file_name) {
+            printf(", %s", context->xref_file_name);
         }
-        if (assembler_context.ent_file_name) {
-            printf(", %s", assembler_context.ent_file_name);
+        if (context->lst_file_name) {
+            printf(", %s", context->lst_file_name);
         }
 
 
         /*======================================= CLEAN-UP ======================================-*/
         cleanup:
+        enter_stage(&stats, NULL);
+
+        /*an output file failed, remove the output files written before it*/
+        if (context->output_error) {
+            discard_output_files(context);
+        }
 
 
         /*set the global error flag*/
-        assembler_context.global_error = assembler_context.preproc_error ||assembler_context.first_pass_error ||assembler_context.second_pass_error;
+        context->global_error = context->preproc_error ||context->first_pass_error ||context->second_pass_error ||
+                                         context->output_error;
 
 
 
+        /*remember the result for the next request (server mode)*/
+        if (options->reuse_unchanged) {
+            /*an inline source is not the file on disk, its outputs can't be reused for the file*/
+            if (!context->global_error && !context->source_text) {
+                build_cache_store(context, options);
+            }
+            else {
+                build_cache_forget(context);
+            }
+        }
+
+
         /*print the final assembly status of the file*/
-        if (!assembler_context.global_error) {
+        if (!context->global_error) {
             file_success++;/*inc success file counter*/
-            printf("\n\nFile <%s> assembled successfully.\n\n\n",assembler_context.as_file_name);
+            printf("\n\nFile <%s> assembled successfully.\n\n\n",context->as_file_name);
         }
         else {
-            printf("\n\nFile <%s> assembly failed.\n\n\n",assembler_context.as_file_name);
+            printf("\n\nFile <%s> assembly failed.\n\n\n",context->as_file_name);
         }
 
 
 
+        /*print the size report (also when the memory overflowed)*/
+        if (options->size_report)
+            print_size_report(context);
+
+
         /*on debug mode, print saved assembler data*/
-        if (DEBUG)
-            debug_data_print(&assembler_context);
+        if (options->debug)
+            debug_data_print(context);
 
 
 
-        /*free all allocated memory*/
-        free_all_memory(&assembler_context);
+        /*free the file memory, keep the context buffers for the next file*/
+        recycle_all_memory(context);
 
 
 
@@ -262,11 +495,21 @@ boolean run_assembler(int argc, char *argv[]) {
         /*======= continue to the next file ======*/
     }
 
+    /*free all allocated memory (the warm context is kept for the next run)*/
+    if (!warm) {
+        free_all_memory(context);
+    }
+
 
 
     /*assembler finished, print user message*/
     printf("\n\n================ Assembler finished ================\n\nSummary: %d out of %d files assembled successfully.\n\n",file_success,files);
 
+    /*print the stages statistics (if requested)*/
+    if (options->stats) {
+        print_stage_stats(&stats);
+    }
+
     return true;
 
 
@@ -279,6 +522,53 @@ boolean run_assembler(int argc, char *argv[]) {
 
 
 
+boolean set_file_names(assembler_context *context, const char *source_file) {
+
+    /*verify that all input pointers exist*/
+    if (context == NULL || source_file == NULL) {
+        print_internal_error(ERROR_CODE_25,"set_file_names");
+        return false;
+    }
+
+    /*get the file name and file path*/
+    /* allocated, required to release memory in the end*/
+    split_name_and_path(source_file, &context->as_file_name,&context->file_path);
+
+
+    /*if the file name provided without file extension, add the assembly source file's extension*/
+    if (get_file_extension(context->as_file_name) == NULL) {
+        context->as_file_name =  (char*)handle_realloc(context->as_file_name,(strlen(context->as_file_name)+strlen(ASSEMBLY_FILE_EXTENSION)+1) * sizeof(char));
+        strcat(context->as_file_name,".as");
+    }
+
+    /* - - - - - - - - - - - - file name validation - - - - - - - - - - -*/
+
+    if (!is_file_name_valid(context->as_file_name)) {
+        safe_free((void**)&context->as_file_name);
+        safe_free((void**)&context->file_path);
+
+        return false;
+    }
+
+
+    /* - - - - - - full file path build for .as File - - - - - - -*/
+
+                     /*.as file name already exist*/
+
+    /*build and set the .am full file path*/
+    context->as_full_file_name = str_concat((context->file_path == NULL ? EMPTY_STRING : context->file_path),context->as_file_name);
+
+    /* - - - - - full file path build for .am File  -  - - - - -*/
+
+    /*build and set the .am file name*/
+    context->am_file_name = change_file_extension(AM_FILE, context->as_file_name);/*on error, memory allocation will stop the prog*/
+    /*build and set the .am full file path*/
+    context->am_full_file_name = str_concat((context->file_path == NULL ? EMPTY_STRING : context->file_path),context->am_file_name);
+
+    return true;
+}
+
+
 int init_assembler(assembler_context* context) {
 
     /*verify that input context exist*/
@@ -286,6 +576,59 @@ int init_assembler(assembler_context* context) {
         print_internal_error(ERROR_CODE_25,"init_assembler");
         return false;
     }
+    /*Initialize the file variables*/
+    reset_assembler(context);
+
+    /*constant tables*/
+    context->opcode_table = get_opcode_table();
+    context->data_directive_table = get_data_directives_table();
+    context->attributes_directive_table = get_attributes_directives_table();
+    context->registers = get_registers();
+    context->macro_declaration_table = get_macro_declaration_table();
+
+    /*no macro prelude until load_macro_prelude*/
+    context->prelude_macros = NULL;
+
+    /*the errors are printed, unless an analysis sets its sink*/
+    context->error_sink = NULL;
+    context->error_sink_data = NULL;
+
+    /*no line records until a run replays the unchanged lines (server mode)*/
+    context->line_records = NULL;
+
+    /*the structures kept between the files (emptied by recycle_all_memory)*/
+    context->names = create_intern_pool();
+    context->labels = create_symbol_table(context->names);
+    context->memory_image = create_memory_image();
+    init_text_buffer(&context->line_buffer);
+    retain_allocation(context->line_buffer.data);
+    init_text_buffer(&context->am_buffer);
+    retain_allocation(context->am_buffer.data);
+    context->entry_lines_capacity = ENTRY_LINES_INITIAL_CAPACITY;
+    context->entry_lines = (entry_line*)handle_malloc(sizeof(entry_line) * context->entry_lines_capacity);
+    retain_allocation(context->entry_lines);
+    context->chain_heads_capacity = NAMES_INITIAL_CAPACITY;
+    context->chain_heads = (unsigned int*)handle_malloc(sizeof(unsigned int) * context->chain_heads_capacity);
+    retain_allocation(context->chain_heads);
+    context->instruction_words = (instruction_ptr*)handle_malloc(sizeof(instruction_ptr) * TARGET_MAX_MEMORY_CAPACITY);
+    retain_allocation(context->instruction_words);
+    context->entry_symbols_capacity = ENTRY_LINES_INITIAL_CAPACITY;
+    context->entry_symbols = (entry_symbol*)handle_malloc(sizeof(entry_symbol) * context->entry_symbols_capacity);
+    retain_allocation(context->entry_symbols);
+    reset_backpatch_chains(context);
+
+    set_error_context(context);
+    return true;
+}
+
+
+int reset_assembler(assembler_context* context) {
+
+    /*verify that input context exist*/
+    if ( context == NULL) {
+        print_internal_error(ERROR_CODE_25,"reset_assembler");
+        return false;
+    }
     /*Initialize the context variables*/
     context->as_file_name = NULL;
     context->am_file_name = NULL;
@@ -301,24 +644,148 @@ int init_assembler(assembler_context* context) {
     context->preproc_error = false;
     context->first_pass_error = false;
     context->second_pass_error = false;
+    context->output_error = false;
     context->global_error = 0;
     context->as_file_line = 0;
     context->am_file_line = 0;
     context->data_memory = NULL;
     context->instruction_memory = NULL;
     context->external_labels = NULL;
-    context->labels = NULL;
     context->macros = NULL;
     context->address_update_requests = NULL;
     context->lines_maper = NULL;
     context->second_pass_error_line = 0;
-    context->opcode_table = get_opcode_table();
-    context->data_directive_table = get_data_directives_table();
-    context->attributes_directive_table = get_attributes_directives_table();
-    context->registers = get_registers();
-    context->macro_declaration_table = get_macro_declaration_table();
+    context->entry_lines_amount = 0;
     context->bin_file_name = NULL;
+    context->xref_file_name = NULL;
+    context->lst_file_name = NULL;
+    context->size_records = NULL;
+    context->collect_size_records = false;
+    context->outline_macros = false;
+    context->outline_threshold = OUTLINE_DEFAULT_THRESHOLD;
+    context->outline_saved_words = 0;
+    context->target = get_default_target();
+    context->relaxed_limits = false;
+    context->one_pass = false;
+    context->reuse_lines = false;
+    context->replayed_lines = 0;
+    context->source_text = NULL;
+    context->write_am_file = true;
 
-    set_error_context(context);
     return true;
 }
+
+
+
+
+void init_warm_context(warm_context *warm) {
+
+    if (!warm) return;
+
+    warm->ready = false;
+    warm->has_prelude = false;
+    warm->prelude[0] = '\0';
+    memset(&warm->prelude_print, 0, sizeof(warm->prelude_print));
+    warm->error_sink = NULL;
+    warm->error_sink_data = NULL;
+}
+
+
+assembler_context* get_warm_context(warm_context *warm, const char *macro_prelude) {
+
+    file_fingerprint prelude_print;
+    boolean same_prelude;
+    error_sink_function sink;
+    void *sink_data;
+
+    /*verify that all input pointers exist*/
+    if (!warm) {
+        print_internal_error(ERROR_CODE_25,"get_warm_context");
+        return NULL;
+    }
+
+    /*the loaded prelude is kept only if it is the same file, with the same content*/
+    if (macro_prelude) {
+        get_file_fingerprint(macro_prelude, &prelude_print);
+        same_prelude = warm->has_prelude && strcmp(warm->prelude, macro_prelude) == 0 &&
+                       is_same_fingerprint(&warm->prelude_print, &prelude_print);
+    }
+    else {
+        same_prelude = !warm->has_prelude;
+    }
+
+    if (warm->ready && same_prelude) {
+        set_error_context(&warm->context);
+        warm->context.error_sink = warm->error_sink;
+        warm->context.error_sink_data = warm->error_sink_data;
+        return &warm->context;
+    }
+
+    /*open the context again with the requested prelude (the error sink is kept)*/
+    sink = warm->error_sink;
+    sink_data = warm->error_sink_data;
+    release_warm_context(warm);
+    warm->error_sink = sink;
+    warm->error_sink_data = sink_data;
+    init_assembler(&warm->context);
+    warm->context.error_sink = sink;
+    warm->context.error_sink_data = sink_data;
+    warm->ready = true;
+
+    if (macro_prelude) {
+        if (!load_macro_prelude(&warm->context, macro_prelude)) {
+            release_warm_context(warm);
+            return NULL;
+        }
+
+        /*a name longer than the saved names is never matched, its prelude is read on every run*/
+        warm->has_prelude = true;
+        if (strlen(macro_prelude) <= BUILD_CACHE_PATH_MAX_LEN) {
+            strcpy(warm->prelude, macro_prelude);
+        }
+        warm->prelude_print = prelude_print;
+    }
+
+    return &warm->context;
+}
+
+
+void release_warm_context(warm_context *warm) {
+
+    if (!warm) return;
+
+    if (warm->ready) {
+        free_all_memory(&warm->context);
+    }
+    init_warm_context(warm);
+}
+
+
+
+
+static void enter_stage(stage_stats *stats, clock_t *stage) {
+
+    clock_t now = clock();
+
+    if (stats->running != NULL) {
+        *stats->running += now - stats->started;
+    }
+    stats->running = stage;
+    stats->started = now;
+}
+
+
+static void print_stage_stats(const stage_stats *stats) {
+
+    printf("Stage statistics:\n");
+    printf("  %-14s%-12s%s\n", "Stage", "Time (ms)", "Handed to the next stage");
+    printf("  %-14s%-12.1f%lu .am line(s), %lu byte(s) (largest file: %lu bytes)\n", "preprocessor",
+           (double)stats->preprocessor_time * 1000.0 / CLOCKS_PER_SEC, stats->am_lines, stats->am_bytes, stats->max_am_bytes);
+    printf("  %-14s%-12.1f%lu memory word(s) (largest file: %lu words)\n", "passes",
+           (double)stats->passes_time * 1000.0 / CLOCKS_PER_SEC, stats->image_words, stats->max_image_words);
+    if (stats->replayed_lines > 0) {
+        printf("  %-14s%-12s%lu .am line(s) replayed from the previous run\n", "", "", stats->replayed_lines);
+    }
+    printf("  %-14s%-12.1f%d file(s) written\n\n", "output files",
+           (double)stats->output_time * 1000.0 / CLOCKS_PER_SEC, stats->output_files);
+}
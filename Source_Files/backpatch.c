@@ -0,0 +1,341 @@
+
+#include "backpatch.h"
+#include <string.h>
+#include "addresses.h"
+#include "encoder.h"
+#include "errors.h"
+#include "externals.h"
+#include "instruction_memory.h"
+#include "instructions.h"
+#include "intern_pool.h"
+#include "labels.h"
+#include "sys_memory.h"
+#include "target.h"
+
+
+/**
+ * @file backpatch.c
+ * @brief Single pass assembly with backpatch chains ("--one-pass").
+ *
+ * The chains live in the instruction image: the value of an unresolved
+ * operand word is the link to the previous unresolved reference of its
+ * label, so a chain costs no memory besides its head. The words are
+ * indexed by their IC while they are added, so a chain is walked (and
+ * patched) in its length, and the .am content isn't read again.
+ *
+ * The labels keep their addresses of the pass (before the relocation) until
+ * the end of the input, so the final address of a label is computed here by
+ * its type.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*chain link of the last reference of a chain*/
+#define END_OF_CHAIN 0
+
+
+/**
+ * @brief Get the final address of a label (before the labels relocation) and the encoding of its references.
+ *
+ * @param asmContext   Assembler context (the IC is final for the data labels at the end of the input only).
+ * @param label        The label id.
+ * @param encoding_out [out] EXTERNAL or RELOCATABLE.
+ * @return The final label address.
+ */
+static unsigned int final_label_address(const assembler_context *asmContext, int label, encoding_type *encoding_out);
+
+
+/**
+ * @brief Patch every word of the chain of a name with the address of its label.
+ *
+ * @param name       The name id (its chain head is emptied).
+ * @param label      The label id of the name.
+ * @param asmContext Assembler context.
+ * @return false on an encoding error or a broken chain.
+ */
+static boolean patch_chain(name_id name, int label, assembler_context *asmContext);
+
+
+/**
+ * @brief Make room for the chain head of a name (the new heads are empty).
+ */
+static void grow_chain_heads(assembler_context *asmContext, name_id name);
+
+
+
+boolean reference_label(name_id label_name, unsigned int IC_addr, assembler_context *asmContext, unsigned int *word_out) {
+
+    symbol_table_ptr labels;
+    encoding_type encoding;
+    unsigned int address;
+    int label;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !word_out || label_name == NO_NAME_ID) {
+        print_internal_error(ERROR_CODE_25, "reference_label");
+        return false;
+    }
+    labels = asmContext->labels;
+    label = find_label(label_name, labels);
+
+    /*the address of a code label defined before or of an external label is already known*/
+    if (label != NO_LABEL && (labels->definitions[label] == EXTERN || labels->types[label] == CODE)) {
+
+        address = final_label_address(asmContext, label, &encoding);
+        if (encoding == EXTERNAL &&
+            !add_external_usage(label_name, IC_addr + asmContext->target->address_offset, &asmContext->external_labels)) {
+            return false;
+        }
+        labels->references[label]++;
+
+        return encode_label_address(asmContext->target, address, encoding, word_out);
+    }
+
+    /*otherwise the word links to the previous reference, and becomes the head of the chain*/
+    grow_chain_heads(asmContext, label_name);
+    *word_out = asmContext->chain_heads[label_name];
+    asmContext->chain_heads[label_name] = IC_addr + 1;
+
+    return true;
+}
+
+
+void index_instruction_words(assembler_context *asmContext) {
+
+    instruction_ptr word;
+
+    if (!asmContext) return;
+
+    /*continue after the last indexed word*/
+    word = (asmContext->instruction_words_amount == 0) ? asmContext->instruction_memory :
+           asmContext->instruction_words[asmContext->instruction_words_amount - 1]->next;
+
+    while (word != NULL && asmContext->instruction_words_amount < TARGET_MAX_MEMORY_CAPACITY) {
+        asmContext->instruction_words[asmContext->instruction_words_amount++] = word;
+        word = word->next;
+    }
+}
+
+
+boolean patch_label_chain(const char *label, assembler_context *asmContext) {
+
+    name_id name;
+
+    /*verify that all input pointers exist*/
+    if (!label || !asmContext) {
+        print_internal_error(ERROR_CODE_25, "patch_label_chain");
+        return false;
+    }
+
+    /*no reference was made before the label*/
+    name = find_name(asmContext->names, label);
+    if (name == NO_NAME_ID || name >= asmContext->chain_heads_capacity ||
+        asmContext->chain_heads[name] == END_OF_CHAIN) {
+        return true;
+    }
+
+    return patch_chain(name, find_label(name, asmContext->labels), asmContext);
+}
+
+
+void add_entry_symbol(const char *label, assembler_context *asmContext) {
+
+    if (!label || !asmContext) return;
+
+    /*grow the entry labels array (kept between the files)*/
+    if (asmContext->entry_symbols_amount == asmContext->entry_symbols_capacity) {
+        asmContext->entry_symbols_capacity *= 2;
+        asmContext->entry_symbols = (entry_symbol*)handle_realloc(asmContext->entry_symbols,
+                                                                  sizeof(entry_symbol) * asmContext->entry_symbols_capacity);
+    }
+
+    asmContext->entry_symbols[asmContext->entry_symbols_amount].name = intern_name(asmContext->names, label);
+    asmContext->entry_symbols[asmContext->entry_symbols_amount].line = asmContext->am_file_line;
+    asmContext->entry_symbols_amount++;
+}
+
+
+boolean resolve_backpatch_chains(assembler_context *asmContext) {
+
+    symbol_table_ptr labels;
+    name_id name;
+    name_id first_undefined = NO_NAME_ID;
+    unsigned int first_reference = 0;
+    unsigned int link;
+    int entry_index;
+    int label;
+
+    /*verify that context exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25, "resolve_backpatch_chains");
+        return false;
+    }
+    labels = asmContext->labels;
+
+
+    /*- - - - - - - - - entry labels (in the source order) - - - - - - - - -*/
+
+    for (entry_index = 0; entry_index < asmContext->entry_symbols_amount; entry_index++) {
+
+        label = find_label(asmContext->entry_symbols[entry_index].name, labels);
+
+        /*verify that the label is defined as internal label*/
+        if (label == NO_LABEL) {
+            asmContext->second_pass_error_line = asmContext->entry_symbols[entry_index].line;
+            print_external_error(ERROR_CODE_141);
+            asmContext->second_pass_error = true;
+            continue;
+        }
+        if (labels->definitions[label] == EXTERN) {
+            asmContext->second_pass_error_line = asmContext->entry_symbols[entry_index].line;
+            print_external_error(ERROR_CODE_142);
+            asmContext->second_pass_error = true;
+            continue;
+        }
+        set_entry_label(labels, label);
+    }
+
+
+    /*- - - - - - - - - remaining chains (data labels, and undefined labels) - - - - - - - - -*/
+
+    for (name = 0; name < asmContext->chain_heads_capacity; name++) {
+
+        if (asmContext->chain_heads[name] == END_OF_CHAIN) {
+            continue;
+        }
+
+        label = find_label(name, labels);
+        if (label != NO_LABEL) {
+            if (!patch_chain(name, label, asmContext)) {
+                asmContext->second_pass_error = true;
+                return false;
+            }
+            continue;
+        }
+
+        /*an undefined label, its first reference is the last word of its chain*/
+        link = asmContext->chain_heads[name];
+        while (link <= asmContext->instruction_words_amount &&
+               (unsigned int)asmContext->instruction_words[link - 1]->value != END_OF_CHAIN) {
+            link = (unsigned int)asmContext->instruction_words[link - 1]->value;
+        }
+        if (link > asmContext->instruction_words_amount) {
+            print_internal_error(ERROR_CODE_29, "resolve_backpatch_chains");
+            asmContext->second_pass_error = true;
+            return false;
+        }
+        if (first_undefined == NO_NAME_ID || link < first_reference) {
+            first_undefined = name;
+            first_reference = link;
+        }
+    }
+
+    /*the attempt to use an undeclared label is reported at its first reference*/
+    if (first_undefined != NO_NAME_ID) {
+        asmContext->second_pass_error_line = asmContext->instruction_words[first_reference - 1]->file_line;
+        print_external_error(ERROR_CODE_146);
+        asmContext->second_pass_error = true;
+        return false;
+    }
+
+
+    /*- - - - - - - - - relocation - - - - - - - - -*/
+
+    if (!update_instruction_addresses(asmContext)) {
+        print_external_error(ERROR_CODE_143);
+        asmContext->second_pass_error = true;
+        return false;
+    }
+    if (!update_data_addresses(asmContext) || !update_labels_addresses(asmContext)) {
+        asmContext->second_pass_error = true;
+        return false;
+    }
+
+    return !asmContext->second_pass_error;
+}
+
+
+void reset_backpatch_chains(assembler_context *asmContext) {
+
+    if (!asmContext) return;
+
+    memset(asmContext->chain_heads, 0, sizeof(unsigned int) * asmContext->chain_heads_capacity);
+    asmContext->instruction_words_amount = 0;
+    asmContext->entry_symbols_amount = 0;
+}
+
+
+
+
+static unsigned int final_label_address(const assembler_context *asmContext, int label, encoding_type *encoding_out) {
+
+    const symbol_table *labels = asmContext->labels;
+
+    if (labels->definitions[label] == EXTERN) {
+        *encoding_out = EXTERNAL;
+        return labels->addresses[label];
+    }
+
+    /*code labels follow the memory offset, data labels follow the code*/
+    *encoding_out = RELOCATABLE;
+    return labels->addresses[label] + asmContext->target->address_offset +
+           (labels->types[label] == DATA ? asmContext->IC : 0);
+}
+
+
+static boolean patch_chain(name_id name, int label, assembler_context *asmContext) {
+
+    instruction_ptr word;
+    encoding_type encoding;
+    unsigned int address;
+    unsigned int encoded_address;
+    unsigned int link;
+
+    address = final_label_address(asmContext, label, &encoding);
+    if (!encode_label_address(asmContext->target, address, encoding, &encoded_address)) {
+        return false;
+    }
+
+    link = asmContext->chain_heads[name];
+    asmContext->chain_heads[name] = END_OF_CHAIN;
+
+    /*the chain goes from the last reference back to the first one*/
+    while (link != END_OF_CHAIN) {
+
+        /*a link out of the indexed words is a developing bug*/
+        if (link > asmContext->instruction_words_amount) {
+            print_internal_error(ERROR_CODE_29, "patch_chain");
+            return false;
+        }
+        word = asmContext->instruction_words[link - 1];
+
+        if (encoding == EXTERNAL &&
+            !add_external_usage(name, link - 1 + asmContext->target->address_offset, &asmContext->external_labels)) {
+            return false;
+        }
+        asmContext->labels->references[label]++;
+
+        link = (unsigned int)word->value;
+        word->value = (int)encoded_address;
+    }
+
+    return true;
+}
+
+
+static void grow_chain_heads(assembler_context *asmContext, name_id name) {
+
+    unsigned int old_capacity = asmContext->chain_heads_capacity;
+
+    if (name < old_capacity) {
+        return;
+    }
+
+    while (name >= asmContext->chain_heads_capacity) {
+        asmContext->chain_heads_capacity *= 2;
+    }
+    asmContext->chain_heads = (unsigned int*)handle_realloc(asmContext->chain_heads,
+                                                            sizeof(unsigned int) * asmContext->chain_heads_capacity);
+    memset(asmContext->chain_heads + old_capacity, 0, sizeof(unsigned int) * (asmContext->chain_heads_capacity - old_capacity));
+}
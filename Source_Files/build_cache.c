@@ -0,0 +1,243 @@
+
+#include "build_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "files.h"
+#include "sys_memory.h"
+#include "util.h"
+
+
+/**
+ * @file build_cache.c
+ * @brief Results cache of the previous assemblies (server mode).
+ *
+ * A fingerprint is the existence, the size and a 32-bit FNV-1a hash of a
+ * file content. The cache keeps a fingerprint of the source file, and of
+ * every output file, for each source file that was assembled successfully.
+ *
+ * The cache lives in a static table (no dynamic memory), since all the
+ * tracked memory is released at the end of every file assembly, while the
+ * cache must survive between the server requests.
+ *
+ * @date 17/10/2026
+ */
+
+
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define FINGERPRINT_MASK 0xFFFFFFFFUL
+
+
+/*output files of a source file, checked for every cached build*/
+static const file_type output_files[] = {
+    AM_FILE,
+    OBJECT_FILE,
+    BIN_FILE,
+    EXTERNAL_FILE,
+    ENTRY_FILE,
+    XREF_FILE,
+    LST_FILE
+};
+
+#define OUTPUT_FILES_AMOUNT (sizeof(output_files) / sizeof(output_files[0]))
+
+
+/**
+ * @struct build_cache_entry
+ * @brief Saved fingerprints of one successfully assembled source file.
+ */
+typedef struct build_cache_entry {
+    boolean used;                                   /**< Entry holds a cached build. */
+    char source[BUILD_CACHE_PATH_MAX_LEN + 1];      /**< Full source file path (.as). */
+    file_fingerprint source_print;                  /**< Source content fingerprint. */
+    assembler_options options;                      /**< Options of the cached run. */
+    file_fingerprint outputs_print[OUTPUT_FILES_AMOUNT]; /**< Output files fingerprints. */
+} build_cache_entry;
+
+
+static build_cache_entry build_cache[BUILD_CACHE_MAX_FILES];
+
+
+/**
+ * @brief Calculate the fingerprints of all the output files of a source file.
+ *
+ * @param asmContext   Assembler context of the source file.
+ * @param prints_out   [out] Array of OUTPUT_FILES_AMOUNT fingerprints.
+ */
+static void get_outputs_fingerprints(const assembler_context *asmContext, file_fingerprint prints_out[]);
+
+
+/**
+ * @brief Find the cache entry of a source file.
+ *
+ * @param source Full source file path.
+ * @return Pointer to the entry, or NULL if the file is not cached.
+ */
+static build_cache_entry* find_cache_entry(const char *source);
+
+
+
+
+boolean is_build_up_to_date(const assembler_context *asmContext, const assembler_options *options) {
+
+    build_cache_entry *entry;
+    file_fingerprint source_print;
+    file_fingerprint outputs_print[OUTPUT_FILES_AMOUNT];
+    unsigned int i;
+
+    if (!asmContext || !asmContext->as_full_file_name || !options) {
+        return false;
+    }
+
+    /*the file was not assembled successfully before*/
+    if ((entry = find_cache_entry(asmContext->as_full_file_name)) == NULL) {
+        return false;
+    }
+
+    /*the requested output files are different*/
+    if (!is_same_output_options(options, &entry->options)) {
+        return false;
+    }
+
+    /*the source file changed*/
+    get_file_fingerprint(asmContext->as_full_file_name, &source_print);
+    if (!source_print.exist || !is_same_fingerprint(&source_print, &entry->source_print)) {
+        return false;
+    }
+
+    /*the output files changed (edited, removed or added)*/
+    get_outputs_fingerprints(asmContext, outputs_print);
+    for (i = 0; i < OUTPUT_FILES_AMOUNT; i++) {
+        if (!is_same_fingerprint(&outputs_print[i], &entry->outputs_print[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void build_cache_store(const assembler_context *asmContext, const assembler_options *options) {
+
+    build_cache_entry *entry;
+    int i;
+
+    if (!asmContext || !asmContext->as_full_file_name || !options) {
+        return;
+    }
+
+    /*path too long to be cached*/
+    if (strlen(asmContext->as_full_file_name) > BUILD_CACHE_PATH_MAX_LEN) {
+        return;
+    }
+
+    /*find the file entry, or a free one*/
+    if ((entry = find_cache_entry(asmContext->as_full_file_name)) == NULL) {
+        for (i = 0; i < BUILD_CACHE_MAX_FILES && build_cache[i].used; i++);
+
+        /*cache is full*/
+        if (i == BUILD_CACHE_MAX_FILES) {
+            return;
+        }
+        entry = &build_cache[i];
+    }
+
+    /*save the fingerprints*/
+    entry->used = true;
+    strcpy(entry->source, asmContext->as_full_file_name);
+    entry->options = *options;
+    get_file_fingerprint(asmContext->as_full_file_name, &entry->source_print);
+    get_outputs_fingerprints(asmContext, entry->outputs_print);
+
+    /*the source can't be read anymore, don't keep it*/
+    if (!entry->source_print.exist) {
+        entry->used = false;
+    }
+}
+
+
+void build_cache_forget(const assembler_context *asmContext) {
+
+    build_cache_entry *entry;
+
+    if (!asmContext || !asmContext->as_full_file_name) {
+        return;
+    }
+
+    if ((entry = find_cache_entry(asmContext->as_full_file_name)) != NULL) {
+        entry->used = false;
+    }
+}
+
+
+
+
+void get_file_fingerprint(const char *file_name, file_fingerprint *fingerprint_out) {
+
+    FILE *file;
+    int c;
+    unsigned long hash = FNV_OFFSET_BASIS;
+    unsigned long size = 0;
+
+    fingerprint_out->exist = false;
+    fingerprint_out->size = 0;
+    fingerprint_out->hash = 0;
+
+    /*open directly, a missing file is not an error here*/
+    if ((file = fopen(file_name, "rb")) == NULL) {
+        return;
+    }
+
+    while ((c = getc(file)) != EOF) {
+        hash = ((hash ^ (unsigned char)c) * FNV_PRIME) & FINGERPRINT_MASK;
+        size++;
+    }
+    fclose(file);
+
+    fingerprint_out->exist = true;
+    fingerprint_out->size = size;
+    fingerprint_out->hash = hash;
+}
+
+
+static void get_outputs_fingerprints(const assembler_context *asmContext, file_fingerprint prints_out[]) {
+
+    char *file_name;
+    char *full_file_name;
+    unsigned int i;
+
+    for (i = 0; i < OUTPUT_FILES_AMOUNT; i++) {
+
+        /*build the output file full name*/
+        file_name = change_file_extension(output_files[i], asmContext->as_file_name);
+        full_file_name = str_concat((asmContext->file_path == NULL ? EMPTY_STRING : asmContext->file_path), file_name);
+
+        get_file_fingerprint(full_file_name, &prints_out[i]);
+
+        safe_free((void**)&file_name);
+        safe_free((void**)&full_file_name);
+    }
+}
+
+
+static build_cache_entry* find_cache_entry(const char *source) {
+
+    int i;
+
+    for (i = 0; i < BUILD_CACHE_MAX_FILES; i++) {
+        if (build_cache[i].used && strcmp(build_cache[i].source, source) == 0) {
+            return &build_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+boolean is_same_fingerprint(const file_fingerprint *print1, const file_fingerprint *print2) {
+
+    return print1->exist == print2->exist &&
+           print1->size == print2->size &&
+           print1->hash == print2->hash;
+}
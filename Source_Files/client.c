@@ -0,0 +1,235 @@
+/*local sockets and getcwd() are POSIX, not ANSI C*/
+#define _POSIX_C_SOURCE 200112L
+
+#include "client.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "config.h"
+
+
+/**
+ * @file client.c
+ * @brief Thin client of the assembler server.
+ *
+ * The client replaces a full assembler run when a server is listening on a
+ * local socket (run_server): it only forwards its command line, so the
+ * tables setup and the macro prelude reading are paid once by the server,
+ * not by every invocation.
+ *
+ * @date 17/10/2026
+ */
+
+
+/**
+ * @brief Build the request of the command line: the working directory and the arguments, each terminated by '\0'.
+ *
+ * An inline source argument is followed by the content of the standard input.
+ *
+ * @param request       [out] Buffer of SERVER_SOCKET_REQUEST_MAX_LEN bytes.
+ * @param argc          Number of arguments.
+ * @param argv          Arguments array.
+ * @param connect_index Index of the client flag (not forwarded).
+ * @return Length of the request, or 0 if it can't be built (error printed).
+ */
+static unsigned long build_request(char *request, int argc, char *argv[], int connect_index);
+
+
+/**
+ * @brief Append a '\0' terminated field to the request.
+ *
+ * @return false if the field exceeds the buffer.
+ */
+static boolean append_field(char *request, unsigned long *length, const char *field);
+
+
+/**
+ * @brief Append the standard input as a '\0' terminated field to the request.
+ *
+ * @return false if the input exceeds the buffer or contains a '\0' (error printed).
+ */
+static boolean append_standard_input(char *request, unsigned long *length);
+
+
+/**
+ * @brief Write the whole buffer to a connection.
+ *
+ * @return false on a write error.
+ */
+static boolean write_all(int connection, const char *buffer, unsigned long length);
+
+
+
+boolean run_client(const char *socket_path, int argc, char *argv[], int connect_index) {
+
+    static char request[SERVER_SOCKET_REQUEST_MAX_LEN];
+    char length_field[SERVER_SOCKET_LENGTH_MAX_DIGITS + 1];
+    char response[BUFSIZ];
+    struct sockaddr_un address;
+    unsigned long length;
+    long received;
+    long i;
+    int connection;
+    boolean status_next = false;
+    int status = -1;
+
+    if (socket_path[0] == '\0' || strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("ERROR: Invalid server socket <%s>.\nProgram stopped.", socket_path);
+        return false;
+    }
+
+    if ((length = build_request(request, argc, argv, connect_index)) == 0) {
+        return false;
+    }
+    sprintf(length_field, "%u", (unsigned int)length);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    if ((connection = socket(AF_UNIX, SOCK_STREAM, 0)) == -1 ||
+        connect(connection, (struct sockaddr*)&address, sizeof(address)) == -1) {
+        printf("ERROR: No assembler server is listening on <%s>.\nProgram stopped.", socket_path);
+        if (connection != -1) close(connection);
+        return false;
+    }
+
+    /*send the length of the request (with its '\0'), then the request*/
+    if (!write_all(connection, length_field, strlen(length_field) + 1) || !write_all(connection, request, length)) {
+        printf("ERROR: Can't send the request to the server.\nProgram stopped.");
+        close(connection);
+        return false;
+    }
+
+    /*print the output until the status mark, the status byte follows it*/
+    while (status == -1 && (received = read(connection, response, sizeof(response))) != 0) {
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (i = 0; i < received; i++) {
+            if (status_next) {
+                status = response[i];
+                break;
+            }
+            if (response[i] == SERVER_SOCKET_STATUS_MARK) {
+                status_next = true;
+            }
+            else {
+                putchar(response[i]);
+            }
+        }
+    }
+    close(connection);
+
+    if (status == -1) {
+        printf("\nERROR: The server closed the connection before the end of the response.\nProgram stopped.");
+        return false;
+    }
+
+    return status == SERVER_SOCKET_SUCCESS;
+}
+
+
+static unsigned long build_request(char *request, int argc, char *argv[], int connect_index) {
+
+    unsigned long length;
+    unsigned long option_length = strlen(SERVER_INLINE_SOURCE_OPTION);
+    boolean input_sent = false;
+    int i;
+
+    /*the working directory, the relative file names are opened in it*/
+    if (getcwd(request, SERVER_SOCKET_REQUEST_MAX_LEN) == NULL) {
+        printf("ERROR: Can't get the working directory of the client.\nProgram stopped.");
+        return 0;
+    }
+    length = strlen(request) + 1;
+
+    for (i = 1; i < argc; i++) {
+        if (i == connect_index) {
+            continue;
+        }
+        if (!append_field(request, &length, argv[i])) {
+            printf("ERROR: Request exceeds the maximum allowed length of %ld characters.\nProgram stopped.",
+                   SERVER_SOCKET_REQUEST_MAX_LEN);
+            return 0;
+        }
+
+        /*the content of an inline source follows its argument, the standard input is read once*/
+        if (strncmp(argv[i], SERVER_INLINE_SOURCE_OPTION, option_length) == 0 && argv[i][option_length] == '=') {
+            if (argv[i][option_length + 1] == '\0' || input_sent) {
+                printf("ERROR: Invalid option <%s>, a single inline source file is read from the standard input.\nProgram stopped.",
+                       argv[i]);
+                return 0;
+            }
+            if (!append_standard_input(request, &length)) {
+                return 0;
+            }
+            input_sent = true;
+        }
+    }
+
+    return length;
+}
+
+
+static boolean append_field(char *request, unsigned long *length, const char *field) {
+
+    unsigned long field_length = strlen(field) + 1;
+
+    /*the server rejects a request that fills its whole buffer*/
+    if (*length + field_length >= SERVER_SOCKET_REQUEST_MAX_LEN) {
+        return false;
+    }
+
+    memcpy(request + *length, field, field_length);
+    *length += field_length;
+    return true;
+}
+
+
+static boolean append_standard_input(char *request, unsigned long *length) {
+
+    unsigned long start = *length;
+    unsigned long received;
+
+    /*read until the end of the input, the request (with the '\0') must stay below the server limit*/
+    do {
+        if (*length >= (unsigned long)SERVER_SOCKET_REQUEST_MAX_LEN - 2) {
+            printf("ERROR: Request exceeds the maximum allowed length of %ld characters.\nProgram stopped.",
+                   SERVER_SOCKET_REQUEST_MAX_LEN);
+            return false;
+        }
+        received = fread(request + *length, 1, SERVER_SOCKET_REQUEST_MAX_LEN - 2 - *length, stdin);
+        *length += received;
+    } while (received > 0);
+
+    if (ferror(stdin) || memchr(request + start, '\0', *length - start) != NULL) {
+        printf("ERROR: Can't read the inline source from the standard input.\nProgram stopped.");
+        return false;
+    }
+
+    request[(*length)++] = '\0';
+    return true;
+}
+
+
+static boolean write_all(int connection, const char *buffer, unsigned long length) {
+
+    long written;
+
+    while (length > 0) {
+        if ((written = write(connection, buffer, length)) < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buffer += written;
+        length -= written;
+    }
+
+    return true;
+}
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include "errors.h"
 #include "util.h"
+#include "node_pool.h"
 #include "sys_memory.h"
 
 
@@ -29,7 +30,7 @@
  *  - `next`    – pointer to the next node.
  *
  * Error handling:
- *  - Ensures no memory overflows (`MEMORY_AVAILABLE_SPACE`).
+ *  - Ensures no memory overflows (the available space of the target machine).
  *  - Reports system/internal errors when allocation fails.
  *
  * This module is used by the **first pass** when directives are parsed
@@ -44,7 +45,7 @@
 
 
 
-boolean add_data_to_memory(int val, data_ptr *data_memory, unsigned int *DC, unsigned int *memory_usage) {
+boolean add_data_to_memory(int val, data_ptr *data_memory, unsigned int *DC, unsigned int *memory_usage, unsigned int memory_space, int file_line) {
 
     data_ptr temp =NULL;
     data_ptr new_data_node = NULL;
@@ -56,17 +57,18 @@ boolean add_data_to_memory(int val, data_ptr *data_memory, unsigned int *DC, uns
     }
 
     /*check available memory capacity for new node*/
-    if (*memory_usage >= MEMORY_AVAILABLE_SPACE) {
+    if (*memory_usage >= memory_space) {
         return false;
     }
 
     /*allocate memory for new data node*/
-    new_data_node = (data_ptr)handle_malloc(sizeof(data_mem));
+    new_data_node = (data_ptr)alloc_node(DATA_NODE);
 
 
     /*set new node values*/
     new_data_node->value = val;
     new_data_node->address = *DC;
+    new_data_node->file_line = file_line;
     new_data_node->next = NULL;
 
 
@@ -116,7 +118,7 @@ void free_data_memory(data_ptr *data_memory) {
     while (*data_memory != NULL) {
         temp=*data_memory;/*hold the head address*/
         *data_memory = (*data_memory)->next;/*assign the next node as head*/
-        safe_free((void**)&temp);/*free the first node (previously the head)*/
+        free_node(DATA_NODE, (void**)&temp);/*free the first node (previously the head)*/
     }
 }
 
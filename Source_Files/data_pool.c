@@ -0,0 +1,416 @@
+
+#include "data_pool.h"
+#include <stdio.h>
+#include "addresses.h"
+#include "data_memory.h"
+#include "errors.h"
+#include "instruction_memory.h"
+#include "instructions.h"
+#include "labels.h"
+#include "node_pool.h"
+#include "sys_memory.h"
+#include "tables.h"
+#include "target.h"
+
+
+/**
+ * @file data_pool.c
+ * @brief Constant pooling of identical data blocks ("--pool-data").
+ *
+ * The data memory and the labels table are both ordered by the .am lines,
+ * so the labeled blocks are collected in a single walk. Every block gets a
+ * hash of its values, and the original blocks (not copies) are kept in a
+ * hash table (open addressing, twice the blocks amount), so a block is
+ * compared word by word only with the blocks of the same length and hash.
+ *
+ * Only the read-only, self-contained blocks are pooled. The address update
+ * requests and the instruction memory are walked together once to find the
+ * labels written by an instruction, and the first label accessed as a matrix
+ * (the data from that label on is indexed, so its layout is kept).
+ *
+ * The duplicated blocks are removed in a second walk over the data memory,
+ * that also moves the remaining words back over the removed ones.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*FNV-1a hash parameters*/
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define HASH_MASK 0xFFFFFFFFUL
+
+/*the block is not a copy of a previous block*/
+#define NO_ORIGINAL (-1)
+
+/*empty bucket of the blocks hash table*/
+#define NO_BLOCK (-1)
+
+
+/**
+ * @struct data_block
+ * @brief Data generated by a single labeled data directive line.
+ */
+typedef struct data_block {
+    int label;               /**< The block label id. */
+    data_ptr first;          /**< First word of the block in the data memory. */
+    unsigned int address;    /**< Block address (relative to DC, before pooling). */
+    unsigned int length;     /**< Amount of words in the block. */
+    unsigned long hash;      /**< Hash of the block values. */
+    int original;            /**< Index of the identical previous block, or NO_ORIGINAL. */
+    boolean poolable;        /**< The block may share its storage (read-only and self-contained). */
+} data_block;
+
+
+/**
+ * @brief Find the labels whose storage must not be shared.
+ *
+ * @param asmContext     Assembler context.
+ * @param written        [out] Set for every data label written by an instruction (indexed by label id, cleared by the caller).
+ * @return The data address of the first label accessed as a matrix (DC if none).
+ */
+static unsigned int find_fixed_labels(const assembler_context *asmContext, boolean written[]);
+
+
+/**
+ * @brief Address of the destination operand word of an instruction that writes its destination.
+ *
+ * @param opcode_word The first word of the instruction.
+ * @return true if the instruction writes its destination (the address is set).
+ */
+static boolean get_written_operand_address(const assembler_context *asmContext, instruction_ptr opcode_word, unsigned int *address_out);
+
+
+/**
+ * @brief Mark the blocks that may share their storage.
+ *
+ * A block is poolable when no instruction writes its label, it is followed
+ * directly by the next labeled block (no unlabeled data continues it), and
+ * it is before the first data accessed as a matrix.
+ */
+static void mark_poolable_blocks(const assembler_context *asmContext, data_block blocks[], int amount);
+
+
+/**
+ * @brief Collect the labeled data blocks.
+ *
+ * @param asmContext  Assembler context.
+ * @param blocks_out  [out] Allocated blocks array (NULL if no blocks, caller must free).
+ * @return Amount of blocks collected.
+ */
+static int collect_data_blocks(const assembler_context *asmContext, data_block **blocks_out);
+
+
+/**
+ * @brief Find the first identical block of every block.
+ *
+ * @return Amount of data words of the copies.
+ */
+static unsigned int find_identical_blocks(data_block blocks[], int amount);
+
+
+/**
+ * @brief Check if two blocks of the same length hold the same values.
+ */
+static boolean is_same_block(const data_block *block1, const data_block *block2);
+
+
+/**
+ * @brief Remove the words of the duplicated blocks from the data memory,
+ *        and move the following words back.
+ */
+static void remove_duplicated_blocks(assembler_context *asmContext, const data_block blocks[], int amount);
+
+
+
+
+unsigned int pool_data(assembler_context *asmContext) {
+
+    data_block *blocks = NULL;
+    unsigned int saved = 0;
+    int amount;
+    int i, j;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25, "pool_data");
+        return 0;
+    }
+
+    if ((amount = collect_data_blocks(asmContext, &blocks)) == 0) {
+        return 0;
+    }
+
+    mark_poolable_blocks(asmContext, blocks, amount);
+
+    if ((saved = find_identical_blocks(blocks, amount)) > 0) {
+
+        /*update the labels (the blocks are ordered by address, an original block is always before its copies)*/
+        for (i = 0, j = 0; i < amount; i++) {
+            if (blocks[i].original == NO_ORIGINAL) {
+                asmContext->labels->addresses[blocks[i].label] -= j;
+            }
+            else {
+                asmContext->labels->addresses[blocks[i].label] = asmContext->labels->addresses[blocks[blocks[i].original].label];
+                j += blocks[i].length;
+            }
+        }
+
+        remove_duplicated_blocks(asmContext, blocks, amount);
+
+        asmContext->DC -= saved;
+        asmContext->memory_usage -= saved;
+    }
+
+    safe_free((void**)&blocks);
+    return saved;
+}
+
+
+
+
+static int collect_data_blocks(const assembler_context *asmContext, data_block **blocks_out) {
+
+    symbol_table_ptr labels = asmContext->labels;
+    data_ptr node = asmContext->data_memory;
+    data_block *blocks;
+    int data_labels = 0;
+    int amount = 0;
+    int label;
+
+    *blocks_out = NULL;
+
+    for (label = 0; label < labels_amount(labels); label++) {
+        if (labels->types[label] == DATA && labels->definitions[label] == NORMAL) data_labels++;
+    }
+    if (data_labels == 0) {
+        return 0;
+    }
+
+    blocks = (data_block*)handle_malloc(sizeof(data_block) * data_labels);
+
+    for (label = 0; label < labels_amount(labels); label++) {
+
+        if (labels->types[label] != DATA || labels->definitions[label] != NORMAL) {
+            continue;
+        }
+
+        /*find the first word of the label line*/
+        while (node && node->file_line < labels->define_lines[label]) {
+            node = node->next;
+        }
+        if (!node || node->file_line != labels->define_lines[label]) {
+            continue;
+        }
+
+        blocks[amount].label = label;
+        blocks[amount].first = node;
+        blocks[amount].address = node->address;
+        blocks[amount].length = 0;
+        blocks[amount].hash = FNV_OFFSET_BASIS;
+        blocks[amount].original = NO_ORIGINAL;
+        blocks[amount].poolable = false;
+
+        /*the block ends with the label line*/
+        while (node && node->file_line == labels->define_lines[label]) {
+            blocks[amount].hash = ((blocks[amount].hash ^ (unsigned long)(node->value & HASH_MASK)) * FNV_PRIME) & HASH_MASK;
+            blocks[amount].length++;
+            node = node->next;
+        }
+
+        amount++;
+    }
+
+    if (amount == 0) {
+        safe_free((void**)&blocks);
+        return 0;
+    }
+
+    *blocks_out = blocks;
+    return amount;
+}
+
+
+static unsigned int find_fixed_labels(const assembler_context *asmContext, boolean written[]) {
+
+    address_update_request_ptr request;
+    instruction_ptr node = asmContext->instruction_memory;
+    instruction_ptr opcode_word = NULL;
+    symbol_table_ptr labels = asmContext->labels;
+    unsigned int layout_start = asmContext->DC;
+    unsigned int written_address;
+    int label;
+
+    for (request = asmContext->address_update_requests; request; request = request->next) {
+
+        /*the first word of the request instruction (an instruction is a single line)*/
+        while (node && node->address <= request->address) {
+            if (!opcode_word || node->file_line != opcode_word->file_line) {
+                opcode_word = node;
+            }
+            node = node->next;
+        }
+
+        if (request->operand->type == MATRIX_ACCESS) {
+            label = find_label(request->operand->operand_val.matrix.label, labels);
+        }
+        else {
+            label = find_label(request->operand->operand_val.label, labels);
+        }
+        if (label == NO_LABEL || labels->types[label] != DATA || labels->definitions[label] != NORMAL) {
+            continue;
+        }
+
+        /*the words after a matrix label are indexed*/
+        if (request->operand->type == MATRIX_ACCESS && labels->addresses[label] < layout_start) {
+            layout_start = labels->addresses[label];
+        }
+
+        if (opcode_word && get_written_operand_address(asmContext, opcode_word, &written_address) &&
+            written_address == request->address) {
+            written[label] = true;
+        }
+    }
+
+    return layout_start;
+}
+
+
+static boolean get_written_operand_address(const assembler_context *asmContext, instruction_ptr opcode_word, unsigned int *address_out) {
+
+    unsigned int word = (unsigned int)opcode_word->value & asmContext->target->word_bit_mask;
+    int opcode_num = (int)(word >> asmContext->target->opcode_bits_shift);
+    int src_mode;
+
+    if (!(get_opcode_effects(opcode_num) & WRITES_DEST)) {
+        return false;
+    }
+
+    /*the destination word follows the opcode word and the source words*/
+    *address_out = opcode_word->address + 1;
+    if (asmContext->opcode_table[opcode_num].operands_amount == 2) {
+        src_mode = (int)((word & SRC_ADDR_MODE_BITS_MASK) >> SRC_ADDR_MODE_BITS_SHIFT);
+        *address_out += (src_mode == MATRIX_ACCESS) ? 2 : 1;
+    }
+
+    return true;
+}
+
+
+static void mark_poolable_blocks(const assembler_context *asmContext, data_block blocks[], int amount) {
+
+    boolean *written;
+    unsigned int layout_start;
+    unsigned int end;
+    int label;
+    int i;
+
+    written = (boolean*)handle_malloc(sizeof(boolean) * labels_amount(asmContext->labels));
+    for (label = 0; label < labels_amount(asmContext->labels); label++) {
+        written[label] = false;
+    }
+
+    layout_start = find_fixed_labels(asmContext, written);
+
+    for (i = 0; i < amount; i++) {
+        end = blocks[i].address + blocks[i].length;
+        blocks[i].poolable = !written[blocks[i].label] && end <= layout_start &&
+                             end == ((i + 1 < amount) ? blocks[i + 1].address : asmContext->DC);
+    }
+
+    safe_free((void**)&written);
+}
+
+
+static unsigned int find_identical_blocks(data_block blocks[], int amount) {
+
+    int *buckets;
+    unsigned int buckets_amount = (unsigned int)amount * 2;
+    unsigned int bucket;
+    unsigned int saved = 0;
+    int i;
+
+    buckets = (int*)handle_malloc(sizeof(int) * buckets_amount);
+    for (bucket = 0; bucket < buckets_amount; bucket++) {
+        buckets[bucket] = NO_BLOCK;
+    }
+
+    for (i = 0; i < amount; i++) {
+
+        if (!blocks[i].poolable) {
+            continue;
+        }
+
+        /*linear probing (the table is at most half full, so an empty bucket always exists)*/
+        bucket = (unsigned int)(blocks[i].hash % buckets_amount);
+        while (buckets[bucket] != NO_BLOCK &&
+               (blocks[buckets[bucket]].length != blocks[i].length ||
+                blocks[buckets[bucket]].hash != blocks[i].hash ||
+                !is_same_block(&blocks[buckets[bucket]], &blocks[i]))) {
+            bucket = (bucket + 1) % buckets_amount;
+        }
+
+        /*a copy of an original block, or a new original block*/
+        if (buckets[bucket] != NO_BLOCK) {
+            blocks[i].original = buckets[bucket];
+            saved += blocks[i].length;
+        }
+        else {
+            buckets[bucket] = i;
+        }
+    }
+
+    safe_free((void**)&buckets);
+    return saved;
+}
+
+
+static boolean is_same_block(const data_block *block1, const data_block *block2) {
+
+    data_ptr node1 = block1->first;
+    data_ptr node2 = block2->first;
+    unsigned int i;
+
+    for (i = 0; i < block1->length; i++) {
+        if (node1->value != node2->value) {
+            return false;
+        }
+        node1 = node1->next;
+        node2 = node2->next;
+    }
+
+    return true;
+}
+
+
+static void remove_duplicated_blocks(assembler_context *asmContext, const data_block blocks[], int amount) {
+
+    data_ptr node = asmContext->data_memory;
+    data_ptr prev = NULL;
+    data_ptr temp;
+    unsigned int removed = 0;
+    int block = 0;
+
+    while (node != NULL) {
+
+        /*skip the blocks that end before the word (the addresses are the original ones)*/
+        while (block < amount && node->address >= blocks[block].address + blocks[block].length) {
+            block++;
+        }
+
+        /*word of a duplicated block, remove it*/
+        if (block < amount && blocks[block].original != NO_ORIGINAL && node->address >= blocks[block].address) {
+            temp = node;
+            node = node->next;
+            if (prev) prev->next = node;
+            else asmContext->data_memory = node;
+            free_node(DATA_NODE, (void**)&temp);
+            removed++;
+            continue;
+        }
+
+        node->address -= removed;
+        prev = node;
+        node = node->next;
+    }
+}
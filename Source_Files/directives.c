@@ -9,6 +9,8 @@
 #include "util.h"
 #include "errors.h"
 #include "sys_memory.h"
+#include "size_report.h"
+#include "target.h"
 
 
 /**
@@ -120,19 +122,24 @@ boolean handle_data_directives_line(char *line, assembler_context *asmContext){
         return false;
     }
 
+    /*record the required words for the size report (counted even when the memory is full)*/
+    if (asmContext->collect_size_records) {
+        add_size_record(asmContext->am_file_line, data_count, DATA, NO_OPERAND, NO_OPERAND, &asmContext->size_records);
+    }
+
     /*******************************  INSERT THE VALUES INTO DATA MEMORY ************************************/
 
-if (asmContext->memory_usage <= MEMORY_AVAILABLE_SPACE) {
+if (asmContext->memory_usage <= asmContext->target->memory_available_space) {
     /*Insert data to data memory*/
     for ( i = 0; i < data_count; i++) {
 
         /*check number range*/
-        if (data[i] > MAX_NUM(WORD_BIT_SIZE) || data[i] < MIN_NUM(WORD_BIT_SIZE)) {
+        if (data[i] > MAX_NUM(asmContext->target->word_bit_size) || data[i] < MIN_NUM(asmContext->target->word_bit_size)) {
             print_external_error(ERROR_CODE_123);
             goto cleanup;
         }
-        if (!add_data_to_memory(data[i], &asmContext->data_memory, &asmContext->DC, &asmContext->memory_usage)) {
-            if (asmContext->memory_usage == MEMORY_AVAILABLE_SPACE) {
+        if (!add_data_to_memory(data[i], &asmContext->data_memory, &asmContext->DC, &asmContext->memory_usage, asmContext->target->memory_available_space, asmContext->am_file_line)) {
+            if (asmContext->memory_usage == asmContext->target->memory_available_space) {
                 print_external_error(ERROR_CODE_103);
 
             }
@@ -356,12 +363,9 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
         EXPECT_AFTER_NUMBER/*expect for after line, can be the end of line, white space or comma sign ','*/
     } expect_for;
 
-    char buff[MAX_LINE_LEN];/*temp buffer for each digit*/
-    int buff_pointer = 0;/*temp buff pointer*/
-    int arr[MAX_LINE_LEN];/*the extracted numbers array*/
+    const char *number_start = NULL;/*start of the current number (its optional sign)*/
     int arr_pointer = 0;/*extracted numbers array pointer*/
-    int *numbers;/*pointer to address with all extracted numbers (address returns to calling func*/
-    int i;/*for loop index*/
+    int *numbers = NULL;/*the extracted numbers (address returns to calling func)*/
     const char *p;/*temp line pointer*/
     expect_for expect;/*expect flag*/
 
@@ -392,22 +396,24 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
         return false;
     }
 
+    /*allocate the numbers array once, every number takes at least 2 chars of the line (digit and comma),
+     *so the line length bounds the amount of numbers (the line length itself is not limited)*/
+    numbers = (int*)handle_malloc(sizeof(int) * (strlen(p) / 2 + 1));
+
     /*start running till the end of the line*/
     while (*p != '\0') {
         if (expect == EXPECT_NUMBER) {
+            number_start = p;
             /*search for optional polarity sign*/
             if (*p == '+' || *p == '-') {
-                char sign = *p;
                 p++;
 
                 /*verify that the next char after sign is a digit*/
                 if (!isdigit((unsigned char)*p)) {
                     print_external_error(ERROR_CODE_130);
-                    *out_count = 0;
-                    return false;
+                    goto format_error;
                 }
-                /*number found after optional sign, insert the sign to buffer*/
-                buff[buff_pointer++] = sign;
+                /*number found after optional sign (the sign stays the first char of the number)*/
             }
 
             /*if optional sign doesn't appear, the current char must be a digit*/
@@ -424,13 +430,11 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
                 else
                     print_external_error(ERROR_CODE_131);
 
-                *out_count = 0;
-                return false;
+                goto format_error;
             }
 
-            /*read all digits*/
+            /*run over all digits*/
             while (isdigit((unsigned char)*p)) {
-                buff[buff_pointer++] = *p;
                 p++;
             }
 
@@ -438,24 +442,18 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
             /*if the loop stopped because '.' found in the number*/
             if (*p == '.') {
                 print_external_error(ERROR_CODE_173);
-                *out_count = 0;
-                return false;
+                goto format_error;
             }
 
 
             /*if the loop stopped because alpha char found in the number*/
             if (isalpha(*p)) {
                 print_external_error(ERROR_CODE_174);
-                *out_count = 0;
-                return false;
+                goto format_error;
             }
 
-            /*set \0 in the end of the numer string*/
-            buff[buff_pointer] = '\0';
-
-            /*convert the number string into a number and insert it to the numbers array*/
-            arr[arr_pointer++] = atoi(buff);
-            buff_pointer = 0;
+            /*convert the number string (optional sign and digits) into a number and insert it to the numbers array*/
+            numbers[arr_pointer++] = atoi(number_start);
             expect = EXPECT_AFTER_NUMBER; /*update expect flag*/
             /*move to the next char in the line*/
             continue;
@@ -480,8 +478,7 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
             /*invalid char found while expecting for "after number" -> end of line or comma ',' sign*/
             else {
                 print_external_error(ERROR_CODE_132);
-                *out_count = 0;
-                return false;
+                goto format_error;
             }
         }
     }
@@ -489,25 +486,18 @@ boolean extract_directive_numbers(const char *line, unsigned int *out_count, int
     /*if the line end while expecting for number, exit and print error*/
     if (expect == EXPECT_NUMBER) {
         print_external_error(ERROR_CODE_133);
-        *out_count = 0;
-        return false;
+        goto format_error;
     }
 
-    /*no format error, prepare the numbers and return the pointer of to the found numbers*/
-
-
-    /*allocate memory for found numbers*/
-    numbers = (int*)handle_malloc(sizeof(int) * arr_pointer);
-
-    /*move the found numbers to the allocated memory*/
-    for (i = 0; i < arr_pointer; i++) {
-        numbers[i] = arr[i];
-    }
-
-    /*set the out result*/
+    /*no format error, set the out result*/
     *out_count = arr_pointer;
     *out_result = numbers;
     return true;
+
+    format_error:
+    safe_free((void**)&numbers);
+    *out_count = 0;
+    return false;
 }
 
 /*receive entire line after .string directive*/
@@ -515,8 +505,7 @@ char *extract_directive_string(char * line, assembler_context *asmContext) {
 
     char *p = line;/*pointer to the start of the received line*/
     int buff_pointer = 0;/*buff index pointer*/
-    char buff[MAX_LINE_LEN];/*temp buff of extracted string*/
-    char *result;/*pointer to the extracted string*/
+    char *result = NULL;/*the extracted string (the line length bounds its length)*/
 
 
     /*verify that all necessary input variables exist*/
@@ -542,16 +531,19 @@ char *extract_directive_string(char * line, assembler_context *asmContext) {
     /*first quotes found, move to the next char*/
     p++;
 
+    /*allocate memory for the extracted string*/
+    result = (char*)handle_malloc(sizeof(char) * (strlen(p) + 1));
+
     /*run till the second quotes or till the end of the lineL*/
     while (*p != '"' && *p != '\0') {
         /*the string between the quotes must be printable char*/
         if (isprint(*p)) {
-            /*insert each found char into the buffer*/
-            buff[buff_pointer++] = *p;
+            /*insert each found char into the result*/
+            result[buff_pointer++] = *p;
         }
         else {
             print_external_error(ERROR_CODE_125);
-            return NULL;
+            goto format_error;
         }
         p++;
     }
@@ -560,11 +552,11 @@ char *extract_directive_string(char * line, assembler_context *asmContext) {
     /*if the while loop stopped because reach to the end of line, the second quotes not found, format error*/
     if (*p == '\0') {
         print_external_error(ERROR_CODE_126);
-        return NULL;
+        goto format_error;
     }
     else {
         /*second quotes found, set the end of line with '\0'*/
-        buff[buff_pointer] = '\0';
+        result[buff_pointer] = '\0';
     }
 
     /*jump over second squats*/
@@ -573,20 +565,18 @@ char *extract_directive_string(char * line, assembler_context *asmContext) {
     while (*p != '\0') {
         if (!isspace((unsigned char)*p)) {
             print_external_error(ERROR_CODE_127);
-            return NULL;
+            goto format_error;
         }
         p++;
     }
 
-    /*allocate memory for the found string*/
-    result = (char*)handle_malloc(sizeof(char) * strlen(buff)+1);
-
-    /*insert the found string into the allocated memory*/
-    strcpy(result, buff);
-
     /*return the pointer to the found string*/
     return result;
 
+    format_error:
+    safe_free((void**)&result);
+    return NULL;
+
 }
 
 boolean is_directive(const char *name, assembler_context *asmContext) {
@@ -725,7 +715,7 @@ char* get_extern_label(char* line, assembler_context *asmContext) {
     }
 
     /*if the external label name invalid*/
-    if (!is_name_valid(token)) {
+    if (!is_name_valid(token, asmContext)) {
         print_external_error(ERROR_CODE_159);
         return NULL;
     }
@@ -785,7 +775,7 @@ char* get_entry_label(char* line, assembler_context *asmContext) {
     }
 
     /*if the label name invalid*/
-    if (  !is_name_valid(token)) {
+    if (  !is_name_valid(token, asmContext)) {
         print_external_error(ERROR_CODE_139);
         return NULL;
     }
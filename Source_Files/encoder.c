@@ -10,6 +10,8 @@
 #include "util.h"
 #include "context.h"
 #include "sys_memory.h"
+#include "target.h"
+#include "backpatch.h"
 
 
 /**
@@ -23,7 +25,9 @@
  *   - Encode the main instruction word (opcode, addressing modes, ERA).
  *   - Encode additional words for operands (immediate, direct, register, matrix).
  *   - Handle fix-up requests for label-based operands, so their addresses
- *     can be patched during the second pass.
+ *     can be patched during the second pass (or encode them at once, or
+ *     thread them into the backpatch chains of their labels, in a single
+ *     pass assembly).
  *   - Safely validate that encoded values fit into the defined bit-fields
  *     and report system or external errors if they do not.
  *
@@ -32,7 +36,8 @@
  *   - ::encode_label_address — encodes a resolved label address into an operand word.
  *
  * @note This module relies on definitions from:
- *   - Config.h (bit masks, shifts, word size, constants).
+ *   - Config.h (bit-field sizes, constants).
+ *   - target.h (the word layout and encoding functions of the target machine).
  *   - context.h (assembler context and fix-up list).
  *   - instructions.h (opcode and operand definitions).
  *   - addresses.h (fix-up table management).
@@ -63,6 +68,14 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
     const  operand* operand;
     operand_type op_type;
     unsigned int IC;
+    unsigned int src_mode = 0;
+    unsigned int dest_mode = 0;
+    unsigned int operand_data;
+    unsigned int src_reg;
+    unsigned int dest_reg;
+    unsigned int label_word = 0;
+    boolean label_word_set = false;
+    const_target_ptr target;
 
 
     /*verify that all necessary input variables exist*/
@@ -74,6 +87,7 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 
     /*set input values*/
     IC = asmContext->IC;
+    target = asmContext->target;
     operands_amount = opcode->operands_amount;
 
 
@@ -84,32 +98,24 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 
     /*- - - opcode bits field - - -*/
 
-    /*reset to zero the opcode bits field*/
-    machine_word = machine_word & (~OPCODE_BITS);
-
     /*validate that the value fits within the bit-field size (internal check)*/
     if (opcode->opcode > U_MAX_NUM(OPCODE_BITS) || opcode->opcode < U_MIN_NUM) {
         print_system_error(ERROR_CODE_2);
           return false;
     }
-    /*insert the encoded opcode bits into the machine word*/
-    machine_word = machine_word | (opcode->opcode << OPCODE_BITS_SHIFT);
 
 
 
 
      /*- - - source addressing mode bits field - - - - - - -*/
 
-    /*reset to zero the source addressing mode bits field*/
-    machine_word = machine_word & ~SRC_ADDR_MODE_BITS_MASK;
     if (src_operand != NULL) {
         /*validate that the value fits within the bit-field size (internal check)*/
         if (src_operand->type > U_MAX_NUM(SRC_ADDR_MODE_BITS) || src_operand->type < U_MIN_NUM) {
             print_system_error(ERROR_CODE_3);
             return 0;
         }
-        /*insert the encoded source AM bits*/
-        machine_word = machine_word | (src_operand->type << SRC_ADDR_MODE_BITS_SHIFT);
+        src_mode = (unsigned int)src_operand->type;
     }/*if Source operand NULL, leave it with reset 0 bits */
 
 
@@ -117,17 +123,13 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 
      /*- - - destination addressing mode bits field - - - - - - -*/
 
-    /*reset to zero the dest addressing mode bits field*/
-    machine_word = machine_word & ~DEST_ADDR_MODE_BITS_MASK;
-
     if (dest_operand != NULL) {
         /*validate that the value fits within the bit-field size (internal check)*/
         if (dest_operand->type > U_MAX_NUM(DEST_ADDR_MODE_BITS) || dest_operand->type < U_MIN_NUM) {
             print_system_error(ERROR_CODE_4);
             return 0;
         }
-        /*insert the encoded destination AM bits*/
-        machine_word = machine_word | (dest_operand->type << DEST_ADDR_MODE_BITS_SHIFT);
+        dest_mode = (unsigned int)dest_operand->type;
     }/*if dest operand NULL, leave it with bits 0*/
 
 
@@ -135,23 +137,16 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 
      /*- - - - ERA bits field - - - - -*/
 
-    /*reset to zero the ERA bits field*/
-    machine_word = machine_word & ~E_R_A_BITS_MASK;
-
     /*validate that the value fits within the bit-field size (internal check)*/
     if (opcode->encoding > U_MAX_NUM(E_R_A_BITS) || opcode->encoding < U_MIN_NUM) {
         print_system_error(ERROR_CODE_5);
         return false;
     }
-    /*insert ERA bits to the machine word*/
-    machine_word = (machine_word | (opcode->encoding << E_R_A_BITS_SHIFT));
 
-    /*insert the fully encoded word into the buffer*/
-    machine_code_buff[words_count++] = machine_word & WORD_BIT_MASK;
+    /*encode the word by the target layout and insert it into the buffer*/
+    machine_code_buff[words_count++] = (unsigned short)target->encode_first_word((unsigned int)opcode->opcode, src_mode, dest_mode, (unsigned int)opcode->encoding);
     /*increment the local IC:*/
     IC++;
-    /*reset the machine word to zero for the next encoding*/
-    machine_word =0;
 
 
 
@@ -172,8 +167,11 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
             operand = src_operand;
             op_type = SOURCE;
         }
-        /*reset to zero the  word's data bits field*/
-        machine_word = machine_word & ~OPERAND_DATA_BITS_MASK;
+        /*reset to zero the word's data bits field*/
+        operand_data = 0;
+        label_word_set = false;
+        src_reg = 0;
+        dest_reg = 0;
 
         /*if the operand is necessary and doesn't exist, stop the prog and print error*/
         if (operand == NULL) {
@@ -186,12 +184,12 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
             /*immediate access operand*/
             case IMMEDIATE_ACCESS: {
                 /*validate that the value in the acceptable range and fits within the bit-field size */
-                if (operand->operand_val.val > MAX_NUM(OPERAND_DATA_BITS) || operand->operand_val.val < MIN_NUM(OPERAND_DATA_BITS)) {
+                if (operand->operand_val.val > MAX_NUM(target->operand_data_bits) || operand->operand_val.val < MIN_NUM(target->operand_data_bits)) {
                     print_external_error(ERROR_CODE_143);
                     return 0;
                 }
-                /*insert immediate operand's encoded value bits into the machine word*/
-                machine_word = machine_word | (operand->operand_val.val << OPERAND_DATA_BITS_SHIFT);
+                /*the immediate operand's value (two's complement) is the data bits field*/
+                operand_data = (unsigned int)operand->operand_val.val;
                 break;
             }
             /*register access operand*/
@@ -204,8 +202,8 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
                         if (operand->operand_val.reg > MAX_NUM(OPERAND_DATA_DEST_REG_BITS) || operand->operand_val.reg < MIN_NUM(OPERAND_DATA_DEST_REG_BITS)) {
                             print_system_error(ERROR_CODE_6);
                         }
-                        /*insert the dest register encoded value into the word*/
-                        machine_word = machine_word | (operand->operand_val.reg << OPERAND_DATA_DEST_REG_SHIFT);
+                        /*the dest register field of the word*/
+                        dest_reg = (unsigned int)operand->operand_val.reg;
                         break;
                     }
                     /*source register*/
@@ -214,8 +212,8 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
                         if (operand->operand_val.reg > MAX_NUM(OPERAND_DATA_SRC_REG_BITS) || operand->operand_val.reg < MIN_NUM(OPERAND_DATA_SRC_REG_BITS)) {
                             print_system_error(ERROR_CODE_7);
                         }
-                        /*insert the source register encoded value into the word*/
-                        machine_word = machine_word | (operand->operand_val.reg << OPERAND_DATA_SRC_REG_SHIFT);
+                        /*the source register field of the word*/
+                        src_reg = (unsigned int)operand->operand_val.reg;
                         break;
                     }
                 }
@@ -229,14 +227,21 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
                  *During the second pass, once all label addresses are resolved,
                  *the correct encoded value will be inserted. */
 
-                /*allocate memory and copy the operand for fixup table*/
-                op_temp = handle_malloc(sizeof(*operand));
+                /*single pass: encode the known address now, or thread the word into the label chain*/
+                if (asmContext->one_pass) {
+                    if (!reference_label(operand->operand_val.label, IC, asmContext, &label_word)) {
+                        return false;
+                    }
+                    label_word_set = true;
+                    break;
+                }
 
-                memcpy(op_temp, operand, sizeof(*operand));
+                /*allocate memory and copy the operand (and its label name) for fixup table*/
+                op_temp = copy_operand(operand);
 
                 /*add the label to fixup table with the label name and the address to fix up*/
                 if (!add_addr_update_request(IC, op_temp, &asmContext->address_update_requests)){
-                    safe_free((void**)&op_temp);
+                    free_operand(&op_temp);
                     return false;
                 }
 
@@ -252,38 +257,37 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
                 *During the second pass, once all label addresses are resolved,
                 *the correct encoded value will be inserted. */
 
-                /*allocate memory and copy the operand for fixup table*/
-                op_temp = handle_malloc(sizeof(*operand));
-
-                memcpy(op_temp, operand, sizeof(*operand));
-
-                /*add the label to fixup table with the label name and the address to fix up*/
-                if (!add_addr_update_request(IC, op_temp, &asmContext->address_update_requests)){
-                    safe_free((void**)&op_temp);
-                    return false;
+                /*single pass: encode the known address now, or thread the word into the label chain*/
+                if (asmContext->one_pass) {
+                    if (!reference_label(operand->operand_val.matrix.label, IC, asmContext, &label_word)) {
+                        return false;
+                    }
+                    label_word_set = true;
+                }
+                else {
+                    /*allocate memory and copy the operand (and its label name) for fixup table*/
+                    op_temp = copy_operand(operand);
+
+                    /*add the label to fixup table with the label name and the address to fix up*/
+                    if (!add_addr_update_request(IC, op_temp, &asmContext->address_update_requests)){
+                        free_operand(&op_temp);
+                        return false;
+                    }
                 }
 
 
                 /*- - - - - - - - - matrix second machine word (the registers word -> matrix's index) - - - */
 
-                /* - - - - - - encode matrix register additional word - - - - - - */
-
-                /* - - - operand data bits field - - - -*/
-
-                /*reset to zero the operand additional word data bits field*/
-                mat_regs_machine_word = mat_regs_machine_word & ~OPERAND_DATA_BITS_MASK;
-
                 /*validate that the value in the acceptable range and fits within the bit-field size */
                 if (operand->operand_val.matrix.reg_1 > MAX_NUM(OPERAND_DATA_SRC_REG_BITS) || operand->operand_val.matrix.reg_1 < MIN_NUM(OPERAND_DATA_SRC_REG_BITS) || operand->operand_val.matrix.reg_2 > MAX_NUM(OPERAND_DATA_DEST_REG_BITS) || operand->operand_val.matrix.reg_2 < MIN_NUM(OPERAND_DATA_DEST_REG_BITS)) {
                     print_system_error(ERROR_CODE_8);
                     return false;
                 }
 
-                /*encode the source register value and insert into the word */
-                mat_regs_machine_word = mat_regs_machine_word | (operand->operand_val.matrix.reg_1 << OPERAND_DATA_SRC_REG_SHIFT);
-
-                /*encode the destination register value and insert into the word */
-                mat_regs_machine_word = mat_regs_machine_word | (operand->operand_val.matrix.reg_2 << OPERAND_DATA_DEST_REG_SHIFT);
+                /*encode the row (source field) and column (destination field) registers, with the ERA bits*/
+                mat_regs_machine_word = (unsigned short)target->encode_registers_word((unsigned int)operand->operand_val.matrix.reg_1,
+                                                                                     (unsigned int)operand->operand_val.matrix.reg_2,
+                                                                                     (unsigned int)operand->operand_val.matrix.reg_encoding);
 
                 break;
             }
@@ -298,21 +302,27 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
 
         /*- - - - - -  - operand ERA bits field - - - - -*/
 
-        /*reset to zero the operand additional word ERA bits field*/
-        machine_word = machine_word & (~E_R_A_BITS_MASK);
-
         /*validate that the value in the acceptable range and fits within the bit-field size */
         if (operand->encoding > U_MAX_NUM(E_R_A_BITS) || operand->encoding < U_MIN_NUM) {
             print_system_error(ERROR_CODE_9);
             return false;
         }
 
-        /*insert ERA bits*/
-        machine_word = machine_word | (operand->encoding << E_R_A_BITS_SHIFT);
+        /*encode the operand word by the target layout*/
+        if (operand->type == REGISTER_ACCESS) {
+            machine_word = (unsigned short)target->encode_registers_word(src_reg, dest_reg, (unsigned int)operand->encoding);
+        }
+        else if (label_word_set) {
+            /*the label word of a single pass (the encoded address or the chain link)*/
+            machine_word = (unsigned short)label_word;
+        }
+        else {
+            machine_word = (unsigned short)target->encode_data_word(operand_data, (unsigned int)operand->encoding);
+        }
 
 
         /*insert operand word to buff*/
-        machine_code_buff[words_count++] = machine_word & WORD_BIT_MASK;
+        machine_code_buff[words_count++] = machine_word;
         /*increment the local IC*/
         IC++;
 
@@ -329,17 +339,11 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
             }
         }
 
-        /*-only if the operand is matrix index, encode the ERA bits field of the mat's index registers word-*/
+        /*-only if the operand is matrix index, insert the mat's index registers word-*/
         if (operand->type == MATRIX_ACCESS) {
 
-            /*reset to zero the mat second additional(registers) word ERA bits field*/
-            mat_regs_machine_word = mat_regs_machine_word & (~E_R_A_BITS_MASK);
-
-            /*insert the era bits*/
-            mat_regs_machine_word = mat_regs_machine_word | (operand->operand_val.matrix.reg_encoding << E_R_A_BITS_SHIFT);
-
             /*insert mat's operand second word to buff*/
-            machine_code_buff[words_count++] = mat_regs_machine_word & WORD_BIT_MASK;
+            machine_code_buff[words_count++] = mat_regs_machine_word;
             /*increment the local IC*/
             IC++;
         }
@@ -361,12 +365,10 @@ boolean instruction_encoder(const opcode *opcode, const operand *src_operand, co
     return true;
 }
 
-boolean encode_label_address(unsigned int new_label_addr, encoding_type encoding, unsigned int* encoded_val_out){
-
-    unsigned short encoded_word = 0;
+boolean encode_label_address(const_target_ptr target, unsigned int new_label_addr, encoding_type encoding, unsigned int* encoded_val_out){
 
     /*check if label_address in bits field range */
-    if (new_label_addr > U_MAX_NUM(OPERAND_DATA_BITS)) {
+    if (new_label_addr > U_MAX_NUM(target->operand_data_bits)) {
         print_system_error(ERROR_CODE_10);
         return false;
     }
@@ -378,39 +380,9 @@ boolean encode_label_address(unsigned int new_label_addr, encoding_type encoding
     }
 
 
-    /*- - - - - - - - - DATA BITS - - - - - - - - -*/
-
-    /*reset to zero the operand additional word data bits field*/
-    encoded_word = encoded_word & ~OPERAND_DATA_BITS_MASK;
-
-    /*insert data bits -> the label new address*/
-    encoded_word=encoded_word | (new_label_addr << OPERAND_DATA_BITS_SHIFT);
-
-
-    /*- - - - - - - - - ERA BITS - - - - - - - - -*/
-
-    /*reset to zero the operand additional word ERA bits field*/
-    encoded_word = encoded_word & ~E_R_A_BITS_MASK;
-
-    /*insert ERA bits*/
-    encoded_word = encoded_word | (encoding << E_R_A_BITS_SHIFT);
-
-
     /*- - - - - - - SET OUT RESULT - - - - - - -*/
-    *encoded_val_out = encoded_word;
+
+    /*data bits -> the label new address, and the ERA bits (by the target layout)*/
+    *encoded_val_out = target->encode_data_word(new_label_addr, (unsigned int)encoding);
     return true;
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
@@ -2,6 +2,7 @@
 #include "errors.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "config.h"
 #include "lines_map.h"
 #include "context.h"
@@ -27,6 +28,11 @@
  * Each error is mapped to a human-readable description to provide
  * meaningful feedback to the user or developer.
  *
+ * The internal and external errors are built as error reports (file, line
+ * and description). A report is printed, or handed to the error sink of the
+ * context when an analysis set one (the language server and the watch mode
+ * keep the reports, their standard output isn't scraped).
+ *
  * This header is included in most assembler modules that need to
  * report or classify errors.
  *
@@ -123,6 +129,8 @@ error external_errors[] = {
 { AM_FILE_LINE_AND_FILE_NAME,   { ERROR_CODE_180 }, "can't define label on empty line;" },
 { AM_FILE_LINE_AND_FILE_NAME,   { ERROR_CODE_181 }, "Data declaration error: unnecessary comma sign ',' before numbers." },
 { AM_FILE_LINE_AND_FILE_NAME,   { ERROR_CODE_182 }, "Data declaration error: number missing after comma sign ','." },
+{ FILE_NAME_NO_LINE,{ ERROR_CODE_183 }, "Can't write output file, no output files were created." },
+{ AS_FILE_LINE_AND_FILE_NAME,{ ERROR_CODE_184 }, "Macro prelude error: only macro declarations, comments and empty lines are allowed." },
 
 };
 
@@ -133,7 +141,8 @@ error internal_errors[] = {
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_27 }, "No encoding operation for given operand type." },
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_28 }, "Can't relocate while operand is not a label." },
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_29 }, "Relocation error: target instruction address for update not found in instruction memory." },
-    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_30 }, "Operand not provided for address update request." }
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_30 }, "Operand not provided for address update request." },
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_31 }, "Memory image error: word address is out of the program." }
 };
 
 /* ---------------- System Error Codes Table ---------------- */
@@ -148,14 +157,32 @@ error system_errors[] = {
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_8 },  "Encoding error: matrix register index number exceeds the allowed bit-field size." },
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_9 },  "Encoding error: operand ERA field value exceeds the allowed bit-field size." },
     { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_10 }, "Encoding error: label address value exceeds the allowed bit-field size." },
-    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_11 }, "Memory reallocation failed" }
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_11 }, "Memory reallocation failed" },
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_12 }, "Static node pool is full (increase its capacity in config.h)" },
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_13 }, "Slab allocator: an object was released twice" },
+    { AM_FILE_LINE_AND_FILE_NAME, { ERROR_CODE_14 }, "Slab allocator: a released object was modified (used after release)" }
 };
 
 /* ---------------- Error Printing Functions ---------------- */
 
+/**
+ * @brief Hand an error to the error sink of the context, or print it.
+ */
+static void report_error(const error_report *report);
+
+
 void print_internal_error(internal_error_code code, char* func_name) {
-    printf("\nINTERNAL ERROR: %s in function: %s.", internal_errors[code].description, func_name);
 
+    error_report report;
+
+    memset(&report, 0, sizeof(report));
+    report.file_name = asmContext ? asmContext->as_file_name : NULL;
+    report.file_path = asmContext ? asmContext->as_full_file_name : NULL;
+    report.internal = true;
+    report.function = func_name;
+    report.message = internal_errors[code].description;
+
+    report_error(&report);
 }
 
 void print_system_error(system_error_code code) {
@@ -165,28 +192,64 @@ void print_system_error(system_error_code code) {
 }
 
 void print_external_error(external_error_code code) {
-    char* file_name = asmContext->as_file_name;
-    unsigned int line = get_origin_file_line(asmContext->am_file_line, asmContext->lines_maper);
+
+    error_report report;
+
+    memset(&report, 0, sizeof(report));
+    report.file_name = asmContext->as_file_name;
+    report.file_path = asmContext->as_full_file_name;
+    report.has_line = true;
+    report.message = external_errors[code].description;
 
     if (external_errors[code].params == SECOND_PASS_SET_LINE_AND_FILE_NAME) {
-        printf("\n%s::%d: ERROR: %s \n\n", file_name,
-               get_origin_file_line(asmContext->second_pass_error_line, asmContext->lines_maper),
-               external_errors[code].description);
+        report.line = get_origin_file_line(asmContext->second_pass_error_line, asmContext->lines_maper);
     }
     else if (external_errors[code].params == AS_FILE_LINE_AND_FILE_NAME) {
-        printf("\n%s::%d: ERROR: %s \n\n", file_name, asmContext->as_file_line,external_errors[code].description);
+        report.line = asmContext->as_file_line;
     }
     else if (external_errors[code].params == NO_FILE_NAME_NO_LINE) {
-        printf("\n ERROR: %s \n\n",  external_errors[code].description);
+        report.file_name = NULL;
+        report.file_path = NULL;
+        report.has_line = false;
     }
     else if (external_errors[code].params == FILE_NAME_NO_LINE) {
-        printf("\n%s: ERROR: %s \n\n", file_name,external_errors[code].description);
+        report.has_line = false;
     }
     else {
-        printf("\n%s::%d: ERROR: %s \n\n", file_name, line, external_errors[code].description);
+        report.line = get_origin_file_line(asmContext->am_file_line, asmContext->lines_maper);
+    }
+
+    report_error(&report);
+}
+
+void print_error_report(const error_report *report) {
+
+    if (report->internal) {
+        printf("\nINTERNAL ERROR: %s in function: %s.", report->message, report->function);
+    }
+    else if (report->file_name == NULL) {
+        printf("\n ERROR: %s \n\n", report->message);
+    }
+    else if (!report->has_line) {
+        printf("\n%s: ERROR: %s \n\n", report->file_name, report->message);
+    }
+    else {
+        printf("\n%s::%d: ERROR: %s \n\n", report->file_name, report->line, report->message);
     }
 }
 
 void set_error_context(assembler_context* Context) {
     asmContext = Context;
 }
+
+
+static void report_error(const error_report *report) {
+
+    /*the errors of an analysis go to its receiver (the standard output may carry a protocol)*/
+    if (asmContext && asmContext->error_sink) {
+        asmContext->error_sink(asmContext->error_sink_data, report);
+    }
+    else {
+        print_error_report(report);
+    }
+}
@@ -5,6 +5,7 @@
 #include "errors.h"
 #include "labels.h"
 #include "util.h"
+#include "node_pool.h"
 #include "sys_memory.h"
 
 
@@ -39,41 +40,39 @@
 
 
 
-boolean add_external_usage(const char* label_name, unsigned int mem_addr, external_ptr *externals_list) {
-    char* extern_name;
+boolean add_external_usage(name_id label_name, unsigned int mem_addr, external_ptr *externals_list) {
     external_ptr temp;
     external_ptr new_extern_node = NULL;
 
     /*validate input parameters*/
-    if (!label_name ||!externals_list) {
+    if (label_name == NO_NAME_ID || !externals_list) {
         print_internal_error(ERROR_CODE_25,"add_external_usage");
         return false;
     }
     /*allocate memory for new node*/
-    new_extern_node = (external_ptr)handle_malloc(sizeof(external));
+    new_extern_node = (external_ptr)alloc_node(EXTERNAL_NODE);
 
 
     /*insert value into the new allocated node*/
-    extern_name = copy_string(label_name);
-
-
-    new_extern_node->label_name = extern_name;
+    new_extern_node->label_name = label_name;
     new_extern_node->mem_address = mem_addr;
     new_extern_node->next=NULL;
 
-    /*insert the node at the head if it's empty*/
-    if(*externals_list == NULL) {
+    /*insert the node at the head if it's empty (or all the usages are after it)*/
+    if(*externals_list == NULL || (*externals_list)->mem_address > mem_addr) {
+        new_extern_node->next = *externals_list;
         *externals_list = new_extern_node;
         return true;
     }
 
-    /*otherwise append in the end of the list*/
+    /*otherwise insert it after the usages up to its address (at the end, when the usages come in the addresses order)*/
     else {
         temp = *externals_list;
-        while(temp->next != NULL) {
+        while(temp->next != NULL && temp->next->mem_address <= mem_addr) {
             temp = temp->next;
         }
 
+        new_extern_node->next = temp->next;
         temp->next = new_extern_node;
 
         return true;
@@ -82,11 +81,11 @@ boolean add_external_usage(const char* label_name, unsigned int mem_addr, extern
 }
 
 
-void print_external_usages(external_ptr externals_list) {
+void print_external_usages(external_ptr externals_list, const intern_pool *names) {
 
     /*prints each node's values*/
     while (externals_list != NULL) {
-        printf("extern label: %s -> used in address: ", externals_list->label_name);
+        printf("extern label: %s -> used in address: ", get_name(names, externals_list->label_name));
         print_binary(externals_list->mem_address,10, STDOUT, NULL);
         printf("\n");
         externals_list = externals_list->next;
@@ -97,13 +96,12 @@ void print_external_usages(external_ptr externals_list) {
 void free_externals_usage_list(external_ptr *externals_list) {
     external_ptr temp = NULL;
 
-    /*free each node including the label attached name*/
+    /*free each node (the label name stays in the names pool)*/
     while (*externals_list != NULL) {
         temp=*externals_list;
         *externals_list = (*externals_list)->next;
 
-        safe_free((void**)&temp->label_name);
-        safe_free((void**)&temp);
+        free_node(EXTERNAL_NODE, (void**)&temp);
     }
 }
 
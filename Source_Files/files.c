@@ -10,9 +10,14 @@
 #include "config.h"
 #include "data_memory.h"
 #include "errors.h"
+#include "intern_pool.h"
 #include "instruction_memory.h"
 #include "labels.h"
+#include "addresses.h"
+#include "lines_map.h"
+#include "memory_image.h"
 #include "util.h"
+#include "target.h"
 
 
 /**
@@ -27,6 +32,10 @@
  *
  * It ensures consistent error reporting and safe memory usage when dealing with files.
  *
+ * The output files of a source are written one after the other, each with
+ * its own buffered stream and temporary name (see commit_output_files()):
+ * the writers share the tracked allocations and the error context.
+ *
  * @author jenya tokarzhevsky
  * @date 01/09/2025
  */
@@ -40,6 +49,8 @@ static const char* file_extensions[] = {
     ".ent",
     ".am",
     ".bin",
+    ".xref",
+    ".lst",
     ""
 };
 /*file access mode*/
@@ -49,6 +60,62 @@ static const char *file_mode_str[] = {
     "r+"/*read + write*/
 };
 
+/*the output files of an assembled source (kept or removed together)*/
+static const file_type output_files[] = {
+    OBJECT_FILE,
+    EXTERNAL_FILE,
+    ENTRY_FILE,
+    BIN_FILE,
+    XREF_FILE,
+    LST_FILE
+};
+#define OUTPUT_FILES_AMOUNT ((int)(sizeof(output_files) / sizeof(output_files[0])))
+
+
+/**
+ * @brief Get the context field that holds the name of an output file.
+ */
+static char **output_file_name(assembler_context *asmContext, file_type type);
+
+
+/**
+ * @brief Get the full name (directory and name) of an output file.
+ *
+ * @param file_name The output file name.
+ * @param temp      true for the name the file is written under (before commit_output_files).
+ * @return Newly allocated full name.
+ */
+static char *output_full_name(const assembler_context *asmContext, const char *file_name, boolean temp);
+
+
+/**
+ * @brief Open an output file of the source for writing (under its temporary name).
+ *
+ * The file name is set in the context right away, so a file that fails
+ * while written is removed by discard_output_files with the rest.
+ * The file is written through a buffer of OUTPUT_FILE_BUFFER_SIZE.
+ *
+ * @return The open file, or NULL on failure (error printed, output error set).
+ */
+static FILE *open_output_file(assembler_context *asmContext, file_type type);
+
+
+/**
+ * @brief Close an output file, and check that all its content was written.
+ *
+ * @return true on success, false on a write error (error printed, output error set).
+ */
+static boolean close_output_file(assembler_context *asmContext, FILE *file);
+
+
+/**
+ * @brief Remove the written output files, and free their names.
+ *
+ * @param committed Amount of the first output files (in the output_files order) that already got their final names.
+ */
+static void remove_output_files(assembler_context *asmContext, int committed);
+
+
 
 /*
  * file name must exist
@@ -120,11 +187,9 @@ boolean create_ent_file(assembler_context *asmContext) {
 
 
     FILE* ent_file;
-    char* ent_file_name = NULL;
     char* base_4_str = NULL;
-    char* ent_full_name = NULL;
-    char* file_path = NULL;
-    label_ptr label_tmp;
+    symbol_table_ptr labels;
+    int id;
 
     /*verify that assembler_context pointer exist*/
     if (asmContext == NULL) {
@@ -132,22 +197,15 @@ boolean create_ent_file(assembler_context *asmContext) {
         return false;
     }
 
-    /*extract the labels list from the context*/
-    label_tmp = asmContext->labels;
+    /*extract the labels table from the context*/
+    labels = asmContext->labels;
 
     /*allocate memory for temp string that will hold the base 4 letters address*/
-    base_4_str = (char*)handle_malloc(sizeof(char)*OBJ_FILE_ADDRESS_PRINT_LENGTH+1);
-
-    /*prepare the full file path*/
-    ent_file_name = change_file_extension(ENTRY_FILE, asmContext->as_file_name);
-    file_path =(asmContext->file_path == NULL ? EMPTY_STRING : asmContext->file_path);
-    ent_full_name = str_concat(file_path, ent_file_name);
+    base_4_str = (char*)handle_malloc(sizeof(char)*TARGET_MAX_PRINT_LENGTH+1);
 
     /*create the .ent file*/
-    if ((ent_file = open_file(ent_full_name,WRITE)) == NULL) {
-        safe_free((void**)&ent_file_name);
+    if ((ent_file = open_output_file(asmContext, ENTRY_FILE)) == NULL) {
         safe_free((void**)&base_4_str);
-        safe_free((void**)&ent_full_name);
         return false;
     }
 
@@ -155,34 +213,24 @@ boolean create_ent_file(assembler_context *asmContext) {
 
 
     /*- - - print entry labels addresses - - - */
-    /*iterate through labels list, find the entry label
-     *and write their name and address into the file*/
-    while (label_tmp != NULL) {
-        if (label_tmp->is_entry) {
-            fprintf(ent_file, "\t%s\t", label_tmp->name);
-            to_base4_str(label_tmp->address, OBJ_FILE_ADDRESS_PRINT_LENGTH, base_4_str);
+    /*scan the entry bitset, and write the name and address of
+     *every entry label into the file*/
+    for (id = 0; id < labels_amount(labels); id++) {
+        if (is_entry_label(labels, id)) {
+            fprintf(ent_file, "\t%s\t", label_name(labels, id));
+            asmContext->target->format_address(labels->addresses[id], base_4_str);
             fprintf(ent_file,"%s\t\t\n", base_4_str);
         }
-
-        label_tmp = label_tmp->next;
     }
 
    /*close the file and free allocated unnecessary memory*/
-    fclose(ent_file);
     safe_free((void**)&base_4_str);
-    safe_free((void**)&ent_full_name);
-    /*set the new created ent file name*/
-    asmContext->ent_file_name = ent_file_name;
-
-    return true;
+    return close_output_file(asmContext, ent_file);
 }
 
 boolean create_ext_file(assembler_context *asmContext) {
 
     FILE* ext_file;
-    char* ext_file_name = NULL;
-    char* ext_full_name  = NULL;
-    char* file_path = NULL;
     char* base_4_str = NULL;
     external_ptr external_tmp;
 
@@ -196,19 +244,12 @@ boolean create_ext_file(assembler_context *asmContext) {
     external_tmp = asmContext->external_labels;
 
     /*allocate memory for temp string that will hold the base 4 letters address*/
-    base_4_str = (char*)handle_malloc(sizeof(char)*OBJ_FILE_ADDRESS_PRINT_LENGTH+1);
-
+    base_4_str = (char*)handle_malloc(sizeof(char)*TARGET_MAX_PRINT_LENGTH+1);
 
-    /*prepare the full file path*/
-    ext_file_name = change_file_extension(EXTERNAL_FILE, asmContext->as_file_name);
-    file_path = (asmContext->file_path == NULL) ? EMPTY_STRING : asmContext->file_path;
-    ext_full_name = str_concat(file_path, ext_file_name);
 
     /*create and open the .ext file*/
-    if ((ext_file = open_file(ext_full_name,WRITE)) == NULL) {
-        safe_free((void**)&ext_file_name);
+    if ((ext_file = open_output_file(asmContext, EXTERNAL_FILE)) == NULL) {
         safe_free((void**)&base_4_str);
-        safe_free((void**)&ext_full_name);
         return false;
     }
 
@@ -220,34 +261,24 @@ boolean create_ext_file(assembler_context *asmContext) {
         /*- - - print external labels usage addresses - - - */
         /*iterate through external labels list, find the external label
          *and write their name and usage address into the file*/
-        fprintf(ext_file, "\t%s\t", external_tmp->label_name);
-        to_base4_str(external_tmp->mem_address, OBJ_FILE_ADDRESS_PRINT_LENGTH, base_4_str);
+        fprintf(ext_file, "\t%s\t", get_name(asmContext->names, external_tmp->label_name));
+        asmContext->target->format_address(external_tmp->mem_address, base_4_str);
         fprintf(ext_file,"%s\t\t\n", base_4_str);
 
         external_tmp = external_tmp->next;
     }
 
     /*close the file and free unnecessary memory*/
-    fclose(ext_file);
     safe_free((void**)&base_4_str);
-    safe_free((void**)&ext_full_name);
-    /*update the new created ext file name in the context*/
-    asmContext->ext_file_name = ext_file_name;
-
-    return true;
+    return close_output_file(asmContext, ext_file);
 }
 
 boolean create_obj_file(assembler_context *asmContext) {
 
     FILE* obj_file;
-    char* obj_file_name = NULL;
     char* base_4_str = NULL;
-    data_ptr data_memory = NULL;
-    instruction_ptr instruction_memory = NULL;
-    data_ptr data_tmp = NULL;
-    instruction_ptr instruction_tmp = NULL;
-    char* file_path = NULL;
-    char* obj_full_name = NULL;
+    memory_image_ptr image = NULL;
+    unsigned int address;
 
     /*verify that assembler_context pointer exist*/
     if (!asmContext) {
@@ -255,28 +286,19 @@ boolean create_obj_file(assembler_context *asmContext) {
         return false;
     }
 
-    /*extract the data and instruction memory from the context*/
-     data_memory = asmContext->data_memory;
-     instruction_memory = asmContext->instruction_memory;
-
-    /*assign the temp pointer*/
-    data_tmp = data_memory;
-    instruction_tmp = instruction_memory;
+    /*get the memory image (code words and then data words)*/
+    if ((image = asmContext->memory_image) == NULL) {
+        print_internal_error(ERROR_CODE_25,"create_obj_file");
+        return false;
+    }
 
     /*allocate memory for temp string that will hold the base 4 letters address*/
-    base_4_str = (char*)handle_malloc(sizeof(char)* (OBJ_FILE_ADDRESS_PRINT_LENGTH > OBJ_FILE_DATA_PRINT_LENGTH ?  OBJ_FILE_ADDRESS_PRINT_LENGTH : OBJ_FILE_DATA_PRINT_LENGTH)+1);
+    base_4_str = (char*)handle_malloc(sizeof(char)*TARGET_MAX_PRINT_LENGTH+1);
 
 
-    /*prepare the full file path*/
-    obj_file_name = change_file_extension(OBJECT_FILE, asmContext->as_file_name);
-    file_path = (asmContext->file_path == NULL) ? EMPTY_STRING : asmContext->file_path;
-    obj_full_name = str_concat(file_path, obj_file_name);
-
     /*create and open the .obj file*/
-    if ((obj_file = open_file(obj_full_name,WRITE)) == NULL) {
-        safe_free((void**)&obj_file_name);
+    if ((obj_file = open_output_file(asmContext, OBJECT_FILE)) == NULL) {
         safe_free((void**)&base_4_str);
-        safe_free((void**)&obj_full_name);
         return false;
     }
 
@@ -290,34 +312,17 @@ boolean create_obj_file(assembler_context *asmContext) {
     to_base4_str(asmContext->DC, -1, base_4_str);
     fprintf(obj_file,"\t%-4s\t\t\n", base_4_str);
 
-    /*- - - print instruction memory - - - */
-    while (instruction_tmp != NULL) {
-        to_base4_str(instruction_tmp->address, OBJ_FILE_ADDRESS_PRINT_LENGTH, base_4_str);
+    /*- - - print the memory image (instruction memory and then data memory) - - - */
+    for (address = image->load_address; address < memory_image_end(image); address++) {
+        asmContext->target->format_address(address, base_4_str);
         fprintf(obj_file, "\t\t%s\t", base_4_str);
-        to_base4_str(instruction_tmp->value, OBJ_FILE_DATA_PRINT_LENGTH, base_4_str);
+        asmContext->target->format_word(get_image_word(image, address), base_4_str);
         fprintf(obj_file,"%s\t\t\n", base_4_str);
-
-        instruction_tmp = instruction_tmp->next;
-    }
-
-    /*- - - print data memory - - -*/
-    while (data_tmp != NULL) {
-        to_base4_str(data_tmp->address, OBJ_FILE_ADDRESS_PRINT_LENGTH, base_4_str);
-        fprintf(obj_file, "\t\t%s\t", base_4_str);
-        to_base4_str(data_tmp->value, OBJ_FILE_DATA_PRINT_LENGTH, base_4_str);
-        fprintf(obj_file,"%s\t\t\n", base_4_str);
-
-        data_tmp = data_tmp->next;
     }
 
     /*close the file and clear unnecessary allocated memory*/
-    fclose(obj_file);
-    asmContext->obj_file_name = obj_file_name;
     safe_free((void**)&base_4_str);
-    safe_free((void**)&obj_full_name);
-
-
-    return true;
+    return close_output_file(asmContext, obj_file);
 
 }
 
@@ -325,14 +330,9 @@ boolean create_obj_file(assembler_context *asmContext) {
 boolean create_bin_file(assembler_context *asmContext) {
 
     FILE* bin_file;
-    char* bin_file_name = NULL;
     char* base_4_str = NULL;
-    data_ptr data_memory = NULL;
-    instruction_ptr instruction_memory = NULL;
-    data_ptr data_tmp = NULL;
-    instruction_ptr instruction_tmp = NULL;
-    char* file_path = NULL;
-    char* bin_full_name = NULL;
+    memory_image_ptr image = NULL;
+    unsigned int address;
 
     /*verify that assembler_context pointer exist*/
     if (!asmContext) {
@@ -340,28 +340,19 @@ boolean create_bin_file(assembler_context *asmContext) {
         return false;
     }
 
-    /*extract the data and instruction memory from the context*/
-     data_memory = asmContext->data_memory;
-     instruction_memory = asmContext->instruction_memory;
-
-    /*assign the temp pointer*/
-    data_tmp = data_memory;
-    instruction_tmp = instruction_memory;
+    /*get the memory image (code words and then data words)*/
+    if ((image = asmContext->memory_image) == NULL) {
+        print_internal_error(ERROR_CODE_25,"create_bin_file");
+        return false;
+    }
 
     /*allocate memory for temp string that will hold the base 4 letters address*/
-    base_4_str = (char*)handle_malloc(sizeof(char)* (OBJ_FILE_ADDRESS_PRINT_LENGTH > OBJ_FILE_DATA_PRINT_LENGTH ?  OBJ_FILE_ADDRESS_PRINT_LENGTH : OBJ_FILE_DATA_PRINT_LENGTH)+1);
+    base_4_str = (char*)handle_malloc(sizeof(char)*TARGET_MAX_PRINT_LENGTH+1);
 
 
-    /*prepare the full file path*/
-    bin_file_name = change_file_extension(BIN_FILE, asmContext->as_file_name);
-    file_path = (asmContext->file_path == NULL) ? EMPTY_STRING : asmContext->file_path;
-    bin_full_name = str_concat(file_path, bin_file_name);
-
     /*create and open the .bin file*/
-    if ((bin_file = open_file(bin_full_name,WRITE)) == NULL) {
-        safe_free((void**)&bin_file_name);
+    if ((bin_file = open_output_file(asmContext, BIN_FILE)) == NULL) {
         safe_free((void**)&base_4_str);
-        safe_free((void**)&bin_full_name);
         return false;
     }
 
@@ -372,44 +363,282 @@ boolean create_bin_file(assembler_context *asmContext) {
 
     /*write the first line, instructions and data words amount.*/
     fprintf(bin_file, "\t\t");
-    print_binary(asmContext->IC, WORD_BIT_SIZE, FILE_OUT, bin_file);
+    print_binary(asmContext->IC, asmContext->target->word_bit_size, FILE_OUT, bin_file);
     fprintf(bin_file,"\t");
-    print_binary(asmContext->DC, WORD_BIT_SIZE, FILE_OUT, bin_file);
+    print_binary(asmContext->DC, asmContext->target->word_bit_size, FILE_OUT, bin_file);
     fprintf(bin_file,"\t\t\n");
 
-    /*- - - print instruction memory - - - */
-    while (instruction_tmp != NULL) {
+    /*- - - print the memory image (instruction memory and then data memory) - - - */
+    for (address = image->load_address; address < memory_image_end(image); address++) {
         fprintf(bin_file, "\t\t");
-        print_binary(instruction_tmp->address, WORD_BIT_SIZE, FILE_OUT, bin_file);
+        print_binary(address, asmContext->target->word_bit_size, FILE_OUT, bin_file);
         fprintf(bin_file,"\t");
-        print_binary(instruction_tmp->value, WORD_BIT_SIZE, FILE_OUT, bin_file);
+        print_binary(get_image_word(image, address), asmContext->target->word_bit_size, FILE_OUT, bin_file);
         fprintf(bin_file,"\t\t\n");
+    }
+
+    /*close the file and clear unnecessary allocated memory*/
+    safe_free((void**)&base_4_str);
+    return close_output_file(asmContext, bin_file);
+
+}
+
+boolean create_xref_file(assembler_context *asmContext) {
+
+    FILE* xref_file;
+    char base_4_str[TARGET_MAX_PRINT_LENGTH + 1];
+    symbol_table_ptr labels = NULL;
+    int id;
+    int use;
+    address_update_request_ptr request_tmp;
+    lines_map_ptr lines_tmp;
+    int labels_count = 0;
+    int uses_count = 0;
+    int *first_use = NULL;
+    int *next_use = NULL;
+    address_update_request_ptr *uses = NULL;
+    int *uses_lines = NULL;
 
-        instruction_tmp = instruction_tmp->next;
+    /*verify that assembler_context pointer exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25,"create_xref_file");
+        return false;
     }
 
-    /*- - - print data memory - - -*/
-    while (data_tmp != NULL) {
-        fprintf(bin_file, "\t\t");
-        print_binary(data_tmp->address, WORD_BIT_SIZE, FILE_OUT, bin_file);
-        fprintf(bin_file,"\t");
-        print_binary(data_tmp->value, WORD_BIT_SIZE, FILE_OUT, bin_file);
-        fprintf(bin_file,"\t\t\n");
+    labels = asmContext->labels;
+    labels_count = labels_amount(labels);
+
+    /*count the uses of every symbol (by its labels table index), the requests of a valid file are all defined*/
+    first_use = (int*)handle_malloc(sizeof(int) * (labels_count + 1));
+    next_use = (int*)handle_malloc(sizeof(int) * (labels_count + 1));
+    memset(first_use, 0, sizeof(int) * (labels_count + 1));
+    for (request_tmp = asmContext->address_update_requests; request_tmp != NULL; request_tmp = request_tmp->next) {
+        if ((id = find_label(operand_label(request_tmp->operand), labels)) != NO_LABEL) {
+            first_use[id + 1]++;
+            uses_count++;
+        }
+    }
 
-        data_tmp = data_tmp->next;
+    /*the uses of a symbol start after the uses of the symbols before it*/
+    for (id = 0; id < labels_count; id++) {
+        first_use[id + 1] += first_use[id];
+        next_use[id] = first_use[id];
     }
 
-    /*close the file and clear unnecessary allocated memory*/
-    fclose(bin_file);
-    asmContext->bin_file_name = bin_file_name;
-    safe_free((void**)&base_4_str);
-    safe_free((void**)&bin_full_name);
+    /*group the uses by symbol (in the source order within a symbol), with their source lines.
+     *the requests are ordered by the .am lines, the same as the lines map,
+     * so both lists are walked only once*/
+    uses = (address_update_request_ptr*)handle_malloc(sizeof(address_update_request_ptr) * (uses_count + 1));
+    uses_lines = (int*)handle_malloc(sizeof(int) * (uses_count + 1));
+    lines_tmp = asmContext->lines_maper;
+    for (request_tmp = asmContext->address_update_requests; request_tmp != NULL; request_tmp = request_tmp->next) {
+
+        if ((id = find_label(operand_label(request_tmp->operand), labels)) == NO_LABEL) {
+            continue;
+        }
+
+        while (lines_tmp != NULL && lines_tmp->new_line_num < request_tmp->operand->file_line) {
+            lines_tmp = lines_tmp->next;
+        }
 
+        use = next_use[id]++;
+        uses[use] = request_tmp;
+        uses_lines[use] = (lines_tmp != NULL && lines_tmp->new_line_num == request_tmp->operand->file_line) ?
+                          lines_tmp->orign_line_num : get_origin_file_line(request_tmp->operand->file_line, asmContext->lines_maper);
+    }
+
+    /*create and open the .xref file*/
+    if ((xref_file = open_output_file(asmContext, XREF_FILE)) != NULL) {
+
+        fprintf(xref_file,"\n\n");
+        fprintf(xref_file,"; symbols: %d\tuses: %d\n", labels_count, uses_count);
+
+        /*- - - print the symbols table: name, kind, definition line, address, uses amount, first use - - -*/
+        for (id = 0; id < labels_count; id++) {
+            asmContext->target->format_address(labels->addresses[id], base_4_str);
+            fprintf(xref_file, "\t%s\t%s%s\t%d\t%s\t%d\t%d\n",
+                    label_name(labels, id),
+                    labels->definitions[id] == EXTERN ? "extern" : (labels->types[id] == CODE ? "code" : "data"),
+                    is_entry_label(labels, id) ? ",entry" : "",
+                    get_origin_file_line(labels->define_lines[id], asmContext->lines_maper),
+                    base_4_str,
+                    first_use[id + 1] - first_use[id],
+                    first_use[id]);
+        }
+
+        /*- - - print the uses, grouped by symbol: name, source line, patched word address - - -*/
+        fprintf(xref_file,"; uses\n");
+        for (use = 0; use < uses_count; use++) {
+            asmContext->target->format_address(uses[use]->address, base_4_str);
+            fprintf(xref_file, "\t%s\t%d\t%s\n", get_name(asmContext->names, operand_label(uses[use]->operand)),
+                    uses_lines[use], base_4_str);
+        }
+    }
+
+    safe_free((void**)&first_use);
+    safe_free((void**)&next_use);
+    safe_free((void**)&uses);
+    safe_free((void**)&uses_lines);
+
+    /*close the file*/
+    return xref_file != NULL && close_output_file(asmContext, xref_file);
+}
+
+boolean create_lst_file(assembler_context *asmContext) {
+
+    FILE* lst_file;
+    unsigned long am_position = 0;
+    text_buffer *line_buffer;
+    char* line = NULL;
+    char address_str[TARGET_MAX_PRINT_LENGTH + 1];
+    char word_str[TARGET_MAX_PRINT_LENGTH + 1];
+    static const char era_letters[] = {'A', 'E', 'R', '?'};
+    instruction_ptr instruction_tmp;
+    data_ptr data_tmp;
+    address_update_request_ptr request_tmp;
+    lines_map_ptr lines_tmp;
+    const char* symbol;
+    int am_line = 0;
+    int as_line;
+    boolean first_word;
+
+    /*verify that assembler_context pointer exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25,"create_lst_file");
+        return false;
+    }
+
+    /*create and open the .lst file*/
+    if ((lst_file = open_output_file(asmContext, LST_FILE)) == NULL) {
+        return false;
+    }
+
+    /*the line buffer of the context (kept between the files)*/
+    line_buffer = &asmContext->line_buffer;
+
+    fprintf(lst_file,"; line\taddress\t\tbase4\tbinary\t\tERA\tsymbol\tsource\n");
+
+    /* The instruction words, the data words, the address update requests
+     * and the lines map are all ordered by the .am lines, so every list is
+     * walked once, together with the .am file lines.*/
+    instruction_tmp = asmContext->instruction_memory;
+    data_tmp = asmContext->data_memory;
+    request_tmp = asmContext->address_update_requests;
+    lines_tmp = asmContext->lines_maper;
+
+    /*the listing source lines are the expanded (.am) lines*/
+    while (read_text_line(&asmContext->am_buffer, &am_position, line_buffer)) {
+
+        line = line_buffer->data;
+        am_line++;
+        line[strcspn(line, "\r\n")] = '\0';
+
+        /*get the original .as line*/
+        while (lines_tmp != NULL && lines_tmp->new_line_num < am_line) {
+            lines_tmp = lines_tmp->next;
+        }
+        as_line = (lines_tmp != NULL && lines_tmp->new_line_num == am_line) ? lines_tmp->orign_line_num : am_line;
+
+        first_word = true;
+
+        /*- - - instruction words of the line - - -*/
+        while (instruction_tmp != NULL && instruction_tmp->file_line == am_line) {
+
+            /*the label that resolved the word (if any)*/
+            symbol = EMPTY_STRING;
+            if (request_tmp != NULL && request_tmp->address == instruction_tmp->address) {
+                symbol = get_name(asmContext->names, operand_label(request_tmp->operand));
+                request_tmp = request_tmp->next;
+            }
+
+            asmContext->target->format_address(instruction_tmp->address, address_str);
+            asmContext->target->format_word(instruction_tmp->value, word_str);
+            fprintf(lst_file, "%d\t%04u %s\t%s\t", as_line, instruction_tmp->address, address_str, word_str);
+            print_binary(instruction_tmp->value, asmContext->target->word_bit_size, FILE_OUT, lst_file);
+            fprintf(lst_file, "\t%c\t%s\t%s\n",
+                    era_letters[(instruction_tmp->value & E_R_A_BITS_MASK) >> E_R_A_BITS_SHIFT],
+                    symbol, first_word ? line : EMPTY_STRING);
+
+            first_word = false;
+            instruction_tmp = instruction_tmp->next;
+        }
+
+        /*- - - data words of the line - - -*/
+        while (data_tmp != NULL && data_tmp->file_line == am_line) {
+
+            asmContext->target->format_address(data_tmp->address, address_str);
+            asmContext->target->format_word(data_tmp->value, word_str);
+            fprintf(lst_file, "%d\t%04u %s\t%s\t", as_line, data_tmp->address, address_str, word_str);
+            print_binary(data_tmp->value, asmContext->target->word_bit_size, FILE_OUT, lst_file);
+            fprintf(lst_file, "\t-\t\t%s\n", first_word ? line : EMPTY_STRING);
+
+            first_word = false;
+            data_tmp = data_tmp->next;
+        }
+
+        /*- - - line without memory words (comments, attributes directives) - - -*/
+        if (first_word) {
+            fprintf(lst_file, "%d\t\t\t\t\t\t\t\t%s\n", as_line, line);
+        }
+    }
+
+    /*close the file*/
+    return close_output_file(asmContext, lst_file);
+}
+
+boolean commit_output_files(assembler_context *asmContext) {
+
+    char **file_name;
+    char *temp_name;
+    char *full_name;
+    boolean renamed;
+    int i;
+
+    /*verify that assembler_context pointer exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25,"commit_output_files");
+        return false;
+    }
+
+    /*give every written file its final name*/
+    for (i = 0; i < OUTPUT_FILES_AMOUNT; i++) {
+
+        file_name = output_file_name(asmContext, output_files[i]);
+        if (*file_name == NULL) {
+            continue;
+        }
+
+        temp_name = output_full_name(asmContext, *file_name, true);
+        full_name = output_full_name(asmContext, *file_name, false);
+        remove(full_name);
+        renamed = (rename(temp_name, full_name) == 0);
+        safe_free((void**)&temp_name);
+        safe_free((void**)&full_name);
+
+        /*a file can't get its name, remove all the output files*/
+        if (!renamed) {
+            print_external_error(ERROR_CODE_183);
+            asmContext->output_error = true;
+            remove_output_files(asmContext, i);
+            return false;
+        }
+    }
 
     return true;
+}
+
+
+void discard_output_files(assembler_context *asmContext) {
+
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25,"discard_output_files");
+        return;
+    }
 
+    remove_output_files(asmContext, 0);
 }
 
+
 char* change_file_extension(file_type type, const char *as_file_name) {
 
     char* new_file_name = NULL;
@@ -562,6 +791,8 @@ void remove_old_files(assembler_context *asmContext) {
     char* ent_file_name  = change_file_extension(ENTRY_FILE,asmContext->as_file_name);
     char* ext_file_name  = change_file_extension(EXTERNAL_FILE,asmContext->as_file_name);
     char* bin_file_name  = change_file_extension(BIN_FILE,asmContext->as_file_name);
+    char* xref_file_name  = change_file_extension(XREF_FILE,asmContext->as_file_name);
+    char* lst_file_name  = change_file_extension(LST_FILE,asmContext->as_file_name);
 
 
     /*get the files full name with directory*/
@@ -570,6 +801,8 @@ void remove_old_files(assembler_context *asmContext) {
     char* ent_full_name = str_concat(file_path, ent_file_name);
     char* ext_full_name = str_concat(file_path, ext_file_name);
     char* bin_full_name = str_concat(file_path, bin_file_name);
+    char* xref_full_name = str_concat(file_path, xref_file_name);
+    char* lst_full_name = str_concat(file_path, lst_file_name);
 
     /*remove the files*/
     remove(obj_full_name);
@@ -577,6 +810,8 @@ void remove_old_files(assembler_context *asmContext) {
     remove(ent_full_name);
     remove(ext_full_name);
     remove(bin_full_name);
+    remove(xref_full_name);
+    remove(lst_full_name);
 
     /*free files names*/
     safe_free((void**)&obj_file_name);
@@ -584,6 +819,8 @@ void remove_old_files(assembler_context *asmContext) {
     safe_free((void**)&ent_file_name);
     safe_free((void**)&ext_file_name);
     safe_free((void**)&bin_file_name);
+    safe_free((void**)&xref_file_name);
+    safe_free((void**)&lst_file_name);
 
     /*free full file name with directory*/
     safe_free((void**)&obj_full_name);
@@ -591,6 +828,8 @@ void remove_old_files(assembler_context *asmContext) {
     safe_free((void**)&ent_full_name);
     safe_free((void**)&ext_full_name);
     safe_free((void**)&bin_full_name);
+    safe_free((void**)&xref_full_name);
+    safe_free((void**)&lst_full_name);
 
 
 }
@@ -719,3 +958,104 @@ boolean split_name_and_path(const char* full_file_path_in,char** name_out,char**
     return true;
 }
 
+
+
+
+static char **output_file_name(assembler_context *asmContext, file_type type) {
+
+    switch (type) {
+        case OBJECT_FILE:
+            return &asmContext->obj_file_name;
+        case EXTERNAL_FILE:
+            return &asmContext->ext_file_name;
+        case ENTRY_FILE:
+            return &asmContext->ent_file_name;
+        case BIN_FILE:
+            return &asmContext->bin_file_name;
+        case XREF_FILE:
+            return &asmContext->xref_file_name;
+        case LST_FILE:
+            return &asmContext->lst_file_name;
+        default:
+            /*not an output file*/
+            return NULL;
+    }
+}
+
+
+static char *output_full_name(const assembler_context *asmContext, const char *file_name, boolean temp) {
+
+    char *full_name;
+    char *temp_name;
+
+    full_name = str_concat((asmContext->file_path == NULL) ? EMPTY_STRING : asmContext->file_path, file_name);
+    if (!temp) {
+        return full_name;
+    }
+
+    temp_name = str_concat(full_name, OUTPUT_TEMP_EXTENSION);
+    safe_free((void**)&full_name);
+    return temp_name;
+}
+
+
+static FILE *open_output_file(assembler_context *asmContext, file_type type) {
+
+    char **file_name = output_file_name(asmContext, type);
+    char *temp_name;
+    FILE *file;
+
+    /*the file is written under a temporary name until all the output files are written*/
+    *file_name = change_file_extension(type, asmContext->as_file_name);
+    temp_name = output_full_name(asmContext, *file_name, true);
+    file = open_file(temp_name, WRITE);
+    safe_free((void**)&temp_name);
+
+    if (file == NULL) {
+        safe_free((void**)file_name);
+        asmContext->output_error = true;
+        return NULL;
+    }
+
+    /*write the file through a large buffer (written once at the end for typical files)*/
+    setvbuf(file, NULL, _IOFBF, OUTPUT_FILE_BUFFER_SIZE);
+
+    return file;
+}
+
+
+static boolean close_output_file(assembler_context *asmContext, FILE *file) {
+
+    boolean written = !ferror(file);
+
+    /*the buffered content is written by fclose*/
+    if (fclose(file) != 0 || !written) {
+        print_external_error(ERROR_CODE_183);
+        asmContext->output_error = true;
+        return false;
+    }
+
+    return true;
+}
+
+
+static void remove_output_files(assembler_context *asmContext, int committed) {
+
+    char **file_name;
+    char *full_name;
+    int i;
+
+    for (i = 0; i < OUTPUT_FILES_AMOUNT; i++) {
+
+        file_name = output_file_name(asmContext, output_files[i]);
+        if (*file_name == NULL) {
+            continue;
+        }
+
+        /*the first files already got their final names*/
+        full_name = output_full_name(asmContext, *file_name, i >= committed);
+        remove(full_name);
+        safe_free((void**)&full_name);
+        safe_free((void**)file_name);
+    }
+}
@@ -1,6 +1,8 @@
 
 
 #include "first_pass.h"
+#include "addresses.h"
+#include "backpatch.h"
 #include <stdio.h>
 #include <string.h>
 #include "sys_memory.h"
@@ -9,6 +11,7 @@
 #include "files.h"
 #include "instructions.h"
 #include "labels.h"
+#include "line_records.h"
 #include "util.h"
 
 /**
@@ -27,26 +30,49 @@
  *  - Parse data directives and insert values into data memory.
  *  - Collect and store label definitions in the symbol table.
  *  - Record extern declarations.
+ *  - Record the positions of the .entry lines (the second pass reads only them).
  *  - Flag errors for invalid syntax, memory overflows, or invalid label usage.
  *
  * The results of the first pass are stored in the assembler context, and are later
  * refined and resolved during the second pass.
  *
+ * In a single pass assembly ("--one-pass", backpatch.c) this pass is the only
+ * one: the label operands were encoded or chained by the encoder, the chain
+ * of a code label is patched when the label is added and the chain of an
+ * external label when it's declared, and the .entry labels are kept by name
+ * (their .entry lines aren't read again).
+ *
+ * The lines are parsed in order on a single thread: the parser state (strtok,
+ * the error context, the names and nodes pools) is shared by all the lines.
+ *
  * @author Ivgeny Tokarzhevsky
  * @date 01/09/2025
  */
 
 
+/**
+ * @brief Keep a .entry line of the .am content for the second pass.
+ *
+ * @param asmContext    Assembler context (the entry lines and the current .am line).
+ * @param line_position Position of the line in the .am content.
+ */
+static void add_entry_line(assembler_context *asmContext, unsigned long line_position);
+
+
 boolean execute_first_pass(assembler_context *asmContext) {
 
+    text_buffer *line_buffer;
     char* line = NULL;
-    FILE* am_file;
+    unsigned long am_position = 0;/*position of the next .am line*/
+    unsigned long line_position;/*position of the current .am line*/
     unsigned int IC;
     unsigned int DC;
     char* label = NULL;
+    char* entry_label = NULL;
     boolean directive_processed = false;
     boolean instruction_processed = false;
     line_type type;
+    line_snapshot snapshot;
 
 
 
@@ -59,20 +85,40 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
 
 
-    /*allocate memory for reading line*/
-    line = (char*)handle_malloc(sizeof(char) * MAX_LINE_LEN + 3);
+    /*the line buffer of the context (kept between the files)*/
+    line_buffer = &asmContext->line_buffer;
+
+    /*no backpatch chain of the previous file*/
+    if (asmContext->one_pass) {
+        reset_backpatch_chains(asmContext);
+    }
+
+    /*the records of the previous run of the file (server mode)*/
+    begin_line_records(asmContext, &snapshot);
 
-    /*open the am file for reading*/
-    if ((am_file = open_file(asmContext->am_full_file_name, READ)) == NULL) { safe_free((void**)&line); return false;}
 
     /*read each line till reach end of file*/
-    while (fgets(line, MAX_LINE_LEN + 2, am_file)) {
+    while (read_text_line(&asmContext->am_buffer, &am_position, line_buffer)) {
+
+        line = line_buffer->data;
+        line_position = am_position - line_buffer->length;
 
         /*increment the line counter*/
         asmContext->am_file_line++;
 
-        /*verify line length not exceeds max allowed length*/
-        if (strlen(line) > MAX_LINE_LEN) {
+        /*an unchanged line of the previous run is replayed instead of parsed (server mode)*/
+        if (asmContext->reuse_lines) {
+            if (replay_line_record(asmContext, asmContext->am_buffer.data + line_position, am_position - line_position, &type)) {
+                if (type == ENTRY_DIRECTIVE_LINE) {
+                    add_entry_line(asmContext, line_position);
+                }
+                continue;
+            }
+            take_line_snapshot(asmContext, &snapshot);
+        }
+
+        /*verify line length not exceeds max allowed length (not in relaxed mode)*/
+        if (!asmContext->relaxed_limits && strlen(line) > MAX_LINE_LEN) {
             asmContext->first_pass_error = true;
             print_external_error(ERROR_CODE_121);
             continue;
@@ -115,7 +161,13 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
                 if (label && instruction_processed) {
                     /*If label exist and instruction line parsed successfully -> add the label to the labels list (as code)*/
-                    if (!add_label(label,IC,CODE,NORMAL, &asmContext->labels)) {
+                    if (!add_label(label,IC,CODE,NORMAL, asmContext->labels, asmContext->am_file_line)) {
+                        asmContext->first_pass_error = true;
+                    }
+                    /*single pass: the label address is known now, patch the references made before it
+                     *(after an error the chains may link words that weren't added, and nothing is output)*/
+                    else if (asmContext->one_pass && !asmContext->first_pass_error &&
+                             !patch_label_chain(label, asmContext)) {
                         asmContext->first_pass_error = true;
                     }
                 }
@@ -132,7 +184,7 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
                 if (label && directive_processed) {
                     /*If label exist and data directive line parsed successfully -> add the label to the labels list (as data)*/
-                    if (!add_label(label,DC,DATA,NORMAL, &asmContext->labels)) {
+                    if (!add_label(label,DC,DATA,NORMAL, asmContext->labels, asmContext->am_file_line)) {
                         asmContext->first_pass_error = true;
                     }
                 }
@@ -147,10 +199,15 @@ boolean execute_first_pass(assembler_context *asmContext) {
                     asmContext->first_pass_error = true;
                 }
                 else {
-                    if (!add_label(label, EXTERNAL_TEMP_ADDR,UNKNOWN_ADDR_TYPE,EXTERN, &asmContext->labels)) {
+                    if (!add_label(label, EXTERNAL_TEMP_ADDR,UNKNOWN_ADDR_TYPE,EXTERN, asmContext->labels, asmContext->am_file_line)) {
                         asmContext->first_pass_error = true;
 
                     }
+                    /*single pass: patch the references made before the declaration*/
+                    else if (asmContext->one_pass && !asmContext->first_pass_error &&
+                             !patch_label_chain(label, asmContext)) {
+                        asmContext->first_pass_error = true;
+                    }
                 }
 
                 break;
@@ -158,7 +215,22 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
 
             case ENTRY_DIRECTIVE_LINE:{
-                /*skip entry directive line (handled in second pass)*/
+                /*single pass: keep the entry label, it's checked once all the labels are defined*/
+                if (asmContext->one_pass) {
+                    entry_label = get_entry_label(line, asmContext);
+                    if (!entry_label) {
+                        /*the chains are complete, the checks at the end of the input still run (as in the second pass)*/
+                        asmContext->second_pass_error = true;
+                    }
+                    else {
+                        add_entry_symbol(entry_label, asmContext);
+                        safe_free((void**)&entry_label);
+                    }
+                    break;
+                }
+
+                /*keep the entry directive line for the second pass (handled there)*/
+                add_entry_line(asmContext, line_position);
                 break;
 
             }
@@ -196,13 +268,20 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
         }
 
+        /*keep the result of the line for the next run (server mode)*/
+        if (asmContext->reuse_lines) {
+            record_line(asmContext, asmContext->am_buffer.data + line_position, am_position - line_position, type, label, &snapshot);
+        }
 
         safe_free((void**)&label);
 
     }
-    /*clean-up allocated memory and close the used file*/
-    fclose(am_file);
-    safe_free((void**)&line);
+
+    /*the records of this run replace the records of the previous run*/
+    end_line_records(asmContext);
+
+    /*the requests were added at the head of the list, restore the address order*/
+    reverse_addr_update_requests(&asmContext->address_update_requests);
 
     /*If no error found -> return true*/
     if (!asmContext->first_pass_error) {
@@ -212,3 +291,18 @@ boolean execute_first_pass(assembler_context *asmContext) {
 
     return false;
 }
+
+
+static void add_entry_line(assembler_context *asmContext, unsigned long line_position) {
+
+    /*grow the entry lines array (kept between the files)*/
+    if (asmContext->entry_lines_amount == asmContext->entry_lines_capacity) {
+        asmContext->entry_lines_capacity *= 2;
+        asmContext->entry_lines = (entry_line*)handle_realloc(asmContext->entry_lines,
+                                                              sizeof(entry_line) * asmContext->entry_lines_capacity);
+    }
+
+    asmContext->entry_lines[asmContext->entry_lines_amount].position = line_position;
+    asmContext->entry_lines[asmContext->entry_lines_amount].line = asmContext->am_file_line;
+    asmContext->entry_lines_amount++;
+}
@@ -6,6 +6,7 @@
 #include "config.h"
 #include "util.h"
 #include "errors.h"
+#include "node_pool.h"
 #include "sys_memory.h"
 
 
@@ -32,7 +33,7 @@
 
 
 
-boolean add_instruction_to_memory(unsigned short encoded_val, instruction_ptr *instruction_memory, unsigned int* IC, unsigned int *memory_usage) {
+boolean add_instruction_to_memory(unsigned short encoded_val, instruction_ptr *instruction_memory, unsigned int* IC, unsigned int *memory_usage, unsigned int memory_space, int file_line) {
     instruction_ptr temp;
     instruction_ptr new_inst_node;
 
@@ -43,16 +44,17 @@ boolean add_instruction_to_memory(unsigned short encoded_val, instruction_ptr *i
     }
 
     /*verify that the memory is not full*/
-    if (*memory_usage == MEMORY_AVAILABLE_SPACE) {
+    if (*memory_usage == memory_space) {
         return false;
     }
 
     /*allocate memory for new node*/
-    new_inst_node = (instruction_ptr)handle_malloc(sizeof(inst_mem));
+    new_inst_node = (instruction_ptr)alloc_node(INSTRUCTION_NODE);
 
     /*insert values into the new node*/
     new_inst_node->value = encoded_val;
     new_inst_node->address = *IC;
+    new_inst_node->file_line = file_line;
     new_inst_node->next = NULL;
 
 
@@ -102,7 +104,7 @@ void free_instruction_memory(instruction_ptr *instruction_memory) {
     while(*instruction_memory != NULL) {
         temp = *instruction_memory;
         *instruction_memory = (*instruction_memory)->next;
-        safe_free((void**)&temp);
+        free_node(INSTRUCTION_NODE, (void**)&temp);
     }
 }
 
@@ -11,8 +11,12 @@
 #include "instruction_memory.h"
 #include "encoder.h"
 #include "errors.h"
+#include "intern_pool.h"
 #include "context.h"
 #include "sys_memory.h"
+#include "size_report.h"
+#include "target.h"
+#include "backpatch.h"
 
 
 /**
@@ -98,6 +102,7 @@ boolean handle_instruction_line(char *line, assembler_context *asmContext) {
 
             /*allocate memory for dest operand*/
             dest_operand = handle_malloc(sizeof(operand));
+            memset(dest_operand, 0, sizeof(operand));
 
             /*handle the 1 operand instruction line*/
             if (!handle_one_operand_line(*opcode_info, line, dest_operand, asmContext)){goto cleanUp;}
@@ -111,9 +116,11 @@ boolean handle_instruction_line(char *line, assembler_context *asmContext) {
 
             /*allocate memory for the dest and source operands*/
             dest_operand = handle_malloc(sizeof(operand));
+            memset(dest_operand, 0, sizeof(operand));
 
             /*allocate memory for source operand*/
             src_operand = handle_malloc(sizeof(operand));
+            memset(src_operand, 0, sizeof(operand));
 
             /*handle the 2 operands instruction line*/
             if (!handle_two_operands_line(*opcode_info, line, src_operand, dest_operand, asmContext)){goto cleanUp;}
@@ -136,15 +143,24 @@ boolean handle_instruction_line(char *line, assembler_context *asmContext) {
     }
 
 
+    /*record the required words for the size report (counted even when the memory is full)*/
+    if (asmContext->collect_size_records) {
+        add_size_record(asmContext->am_file_line, count, CODE,
+                        src_operand ? (int)src_operand->type : NO_OPERAND,
+                        dest_operand ? (int)dest_operand->type : NO_OPERAND,
+                        &asmContext->size_records);
+    }
+
+
     /* - - - insert the encoded machine words of the instruction line into the instruction memory - - -*/
 
         /*verify that the memory is not full*/
-    if (asmContext->memory_usage <= MEMORY_AVAILABLE_SPACE) {
+    if (asmContext->memory_usage <= asmContext->target->memory_available_space) {
         /*- - - add instruction codes to memory - - - -*/
         for ( i =0; i<count; i++) {
-            if (!add_instruction_to_memory(out[i], &(asmContext->instruction_memory), &(asmContext->IC), &asmContext->memory_usage)) {
+            if (!add_instruction_to_memory(out[i], &(asmContext->instruction_memory), &(asmContext->IC), &asmContext->memory_usage, asmContext->target->memory_available_space, asmContext->am_file_line)) {
                 /*memory insertion interrupted because the memory is full*/
-                if (asmContext->memory_usage == MEMORY_AVAILABLE_SPACE){
+                if (asmContext->memory_usage == asmContext->target->memory_available_space){
                     print_external_error(ERROR_CODE_103);
                     /* Increment memory counter past the limit to ensure the overflow error is reported only once */
                     asmContext->memory_usage ++;
@@ -156,21 +172,26 @@ boolean handle_instruction_line(char *line, assembler_context *asmContext) {
             }
 
         }
+
+        /*index the new words by their IC (the backpatch chains of a single pass are walked through them)*/
+        if (asmContext->one_pass) {
+            index_instruction_words(asmContext);
+        }
     }
 
 
     /*free allocated memory*/
     safe_free((void**)&opcode_info);
-    safe_free((void**)&src_operand);
-    safe_free((void**)&dest_operand);
+    free_operand(&src_operand);
+    free_operand(&dest_operand);
     safe_free((void**)&out);
 
     return true;
 
     cleanUp:
     safe_free((void**)&opcode_info);
-    safe_free((void**)&dest_operand);
-    safe_free((void**)&src_operand);
+    free_operand(&dest_operand);
+    free_operand(&src_operand);
     safe_free((void**)&out);
 
     return false;
@@ -599,7 +620,7 @@ boolean try_parse_matrix_operand(const char *operand_str, operand *operand, asse
                         format_error = true;
                     }
 
-                    if (!is_name_valid(label_name)) {
+                    if (!is_name_valid(label_name, asmContext)) {
                         print_external_error(ERROR_CODE_112);
                         format_error = true;
                     }
@@ -619,7 +640,7 @@ boolean try_parse_matrix_operand(const char *operand_str, operand *operand, asse
 
                     /*If the name of label is valid, and the register exists, set the result by filling the operand structure*/
                     operand->type = MATRIX_ACCESS;
-                    strcpy(operand->operand_val.matrix.label,label_name);
+                    operand->operand_val.matrix.label = intern_name(asmContext->names, label_name);
                     operand->operand_val.matrix.reg_1 = reg_1;
                     operand->operand_val.matrix.reg_2 = reg_2;
                     operand->operand_val.matrix.reg_encoding = ABSOLUTE;
@@ -787,7 +808,7 @@ boolean try_parse_direct_operand(const char *operand_str, operand *operand, cons
     }
 
     /*If the string doesn't represent a valid label name*/
-    if (!is_name_valid(operand_str))
+    if (!is_name_valid(operand_str, asmContext))
     {   /*the provided string is not a direct access operand*/
         return false;
 
@@ -796,7 +817,7 @@ boolean try_parse_direct_operand(const char *operand_str, operand *operand, cons
     /*The string is a label name (may not declared at this time)*/
 
     /*Fill the operand struct values*/
-    strcpy(operand->operand_val.label, operand_str);
+    operand->operand_val.label = intern_name(asmContext->names, operand_str);
     operand->type = DIRECT_ACCESS;
     operand->encoding = UNKNOWN;
     operand->file_line = asmContext->am_file_line;
@@ -864,10 +885,30 @@ boolean is_opcode(const char *name, assembler_context *asmContext) {
 }
 
 
+operand* copy_operand(const operand *source) {
+
+    operand *copy;
 
+    /*verify that all input pointers exist*/
+    if (!source) {
+        print_internal_error(ERROR_CODE_25,"copy_operand");
+        return NULL;
+    }
 
+    /*the label name is a name id, the copy shares it*/
+    copy = handle_malloc(sizeof(operand));
+    memcpy(copy, source, sizeof(operand));
 
+    return copy;
+}
 
 
+void free_operand(operand **operand_ptr) {
 
+    if (!operand_ptr || !*operand_ptr) {
+        return;
+    }
 
+    /*the label name stays in the names pool*/
+    safe_free((void**)operand_ptr);
+}
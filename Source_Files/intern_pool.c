@@ -0,0 +1,242 @@
+
+#include "intern_pool.h"
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "errors.h"
+#include "sys_memory.h"
+
+
+/**
+ * @file intern_pool.c
+ * @brief Pool of the identifiers of a file (string interning).
+ *
+ * @date 17/10/2026
+ */
+
+
+#ifdef STATIC_NODE_POOLS
+/*the names pool of the static build (can't grow)*/
+static intern_pool static_pool;
+static char static_chars[STATIC_NAMES_SIZE];
+static unsigned long static_offsets[STATIC_MAX_NAMES];
+static name_id static_buckets[2 * STATIC_MAX_NAMES];
+#endif
+
+
+/**
+ * @brief Hash of a name (djb2).
+ */
+static unsigned long hash_name(const char *name);
+
+
+/**
+ * @brief Get the bucket of a name: the bucket of its id, or the empty bucket to insert it.
+ */
+static unsigned int find_bucket(const intern_pool *pool, const char *name);
+
+
+/**
+ * @brief Make room for one more name.
+ *
+ * @param name_length Length of the new name.
+ */
+static void reserve_name(intern_pool_ptr pool, unsigned long name_length);
+
+
+
+
+intern_pool_ptr create_intern_pool(void) {
+
+    intern_pool_ptr pool;
+
+#ifdef STATIC_NODE_POOLS
+    pool = &static_pool;
+    pool->chars = static_chars;
+    pool->offsets = static_offsets;
+    pool->buckets = static_buckets;
+    pool->chars_capacity = STATIC_NAMES_SIZE;
+    pool->capacity = STATIC_MAX_NAMES;
+#else
+    pool = (intern_pool_ptr)handle_malloc(sizeof(intern_pool));
+    pool->chars_capacity = NAMES_INITIAL_SIZE;
+    pool->capacity = NAMES_INITIAL_CAPACITY;
+    pool->chars = (char*)handle_malloc(pool->chars_capacity);
+    pool->offsets = (unsigned long*)handle_malloc(sizeof(unsigned long) * pool->capacity);
+    pool->buckets = (name_id*)handle_malloc(sizeof(name_id) * pool->capacity * 2);
+
+    /*the pool is kept for the next files of the batch*/
+    retain_allocation(pool);
+    retain_allocation(pool->chars);
+    retain_allocation(pool->offsets);
+    retain_allocation(pool->buckets);
+#endif
+
+    pool->buckets_amount = pool->capacity * 2;
+    pool->kept = 0;
+    pool->kept_length = 0;
+    reset_intern_pool(pool);
+
+    return pool;
+}
+
+
+void reset_intern_pool(intern_pool_ptr pool) {
+
+    unsigned int i;
+    name_id id;
+
+    if (!pool) {
+        return;
+    }
+
+    pool->chars_length = pool->kept_length;
+    pool->amount = pool->kept;
+
+    for (i = 0; i < pool->buckets_amount; i++) {
+        pool->buckets[i] = NO_NAME_ID;
+    }
+
+    /*the kept names are found again with their ids*/
+    for (id = 0; id < pool->kept; id++) {
+        pool->buckets[find_bucket(pool, get_name(pool, id))] = id;
+    }
+}
+
+
+void keep_intern_names(intern_pool_ptr pool) {
+
+    if (!pool) {
+        return;
+    }
+
+    pool->kept = pool->amount;
+    pool->kept_length = pool->chars_length;
+}
+
+
+name_id intern_name(intern_pool_ptr pool, const char *name) {
+
+    unsigned long name_length;
+    unsigned int bucket;
+    name_id id;
+
+    /*verify that all input pointers exist*/
+    if (!pool || !name) {
+        print_internal_error(ERROR_CODE_25, "intern_name");
+        return NO_NAME_ID;
+    }
+
+    /*the name is already in the pool*/
+    bucket = find_bucket(pool, name);
+    if (pool->buckets[bucket] != NO_NAME_ID) {
+        return pool->buckets[bucket];
+    }
+
+    name_length = strlen(name);
+    if (pool->amount == pool->capacity || pool->chars_length + name_length + 1 > pool->chars_capacity) {
+        reserve_name(pool, name_length);
+        bucket = find_bucket(pool, name);
+    }
+
+    /*copy the name to the end of the characters array*/
+    id = pool->amount++;
+    pool->offsets[id] = pool->chars_length;
+    memcpy(pool->chars + pool->chars_length, name, name_length + 1);
+    pool->chars_length += name_length + 1;
+    pool->buckets[bucket] = id;
+
+    return id;
+}
+
+
+name_id find_name(const intern_pool *pool, const char *name) {
+
+    if (!pool || !name) {
+        return NO_NAME_ID;
+    }
+
+    return pool->buckets[find_bucket(pool, name)];
+}
+
+
+void free_intern_pool(intern_pool_ptr *pool_ptr) {
+
+    if (!pool_ptr || !*pool_ptr) {
+        return;
+    }
+
+#ifdef STATIC_NODE_POOLS
+    /*the static pool is reused by the next batch*/
+    *pool_ptr = NULL;
+#else
+    safe_free((void**)&(*pool_ptr)->chars);
+    safe_free((void**)&(*pool_ptr)->offsets);
+    safe_free((void**)&(*pool_ptr)->buckets);
+    safe_free((void**)pool_ptr);
+#endif
+}
+
+
+
+
+static unsigned long hash_name(const char *name) {
+
+    unsigned long hash = 5381;
+
+    while (*name) {
+        hash = hash * 33 + (unsigned char)*name++;
+    }
+    return hash;
+}
+
+
+static unsigned int find_bucket(const intern_pool *pool, const char *name) {
+
+    unsigned int bucket = (unsigned int)(hash_name(name) % pool->buckets_amount);
+
+    /*linear probing (the table is at most half full, so an empty bucket always exists)*/
+    while (pool->buckets[bucket] != NO_NAME_ID &&
+           strcmp(get_name(pool, pool->buckets[bucket]), name) != 0) {
+        bucket = (bucket + 1) % pool->buckets_amount;
+    }
+    return bucket;
+}
+
+
+static void reserve_name(intern_pool_ptr pool, unsigned long name_length) {
+
+#ifdef STATIC_NODE_POOLS
+    /*the static pool can't grow*/
+    (void)name_length;
+    print_system_error(ERROR_CODE_12);
+#else
+    unsigned int bucket;
+    name_id id;
+
+    /*grow the characters array*/
+    while (pool->chars_length + name_length + 1 > pool->chars_capacity) {
+        pool->chars_capacity *= 2;
+    }
+    pool->chars = (char*)handle_realloc(pool->chars, pool->chars_capacity);
+
+    if (pool->amount < pool->capacity) {
+        return;
+    }
+
+    /*grow the offsets, and rebuild the hash table in the new size*/
+    pool->capacity *= 2;
+    pool->buckets_amount = pool->capacity * 2;
+    pool->offsets = (unsigned long*)handle_realloc(pool->offsets, sizeof(unsigned long) * pool->capacity);
+    safe_free((void**)&pool->buckets);
+    pool->buckets = (name_id*)handle_malloc(sizeof(name_id) * pool->buckets_amount);
+    retain_allocation(pool->buckets);
+
+    for (bucket = 0; bucket < pool->buckets_amount; bucket++) {
+        pool->buckets[bucket] = NO_NAME_ID;
+    }
+    for (id = 0; id < pool->amount; id++) {
+        pool->buckets[find_bucket(pool, get_name(pool, id))] = id;
+    }
+#endif
+}
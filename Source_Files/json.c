@@ -0,0 +1,470 @@
+#include "json.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "util.h"
+
+
+/**
+ * @file json.c
+ * @brief Minimal JSON reading and writing of the language server messages.
+ *
+ * The reader walks the JSON text in place: skipping a value is a single scan
+ * of its characters (strings with their escapes, and nested objects and
+ * arrays by their brackets), so a member lookup costs the size of the members
+ * before it. The large document texts are decoded once, straight into the
+ * document buffer.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*JSON literals*/
+#define JSON_TRUE "true"
+#define JSON_FALSE "false"
+#define JSON_NULL "null"
+
+/*hex digits of a \u escape*/
+#define UNICODE_ESCAPE_DIGITS 4
+
+/*UTF-16 surrogates range*/
+#define HIGH_SURROGATE_FIRST 0xD800UL
+#define LOW_SURROGATE_FIRST 0xDC00UL
+#define LOW_SURROGATE_LAST 0xDFFFUL
+
+
+/**
+ * @brief Skip the JSON white spaces.
+ */
+static const char* skip_spaces(const char *text);
+
+
+/**
+ * @brief Skip a JSON string (the position is at its opening quote).
+ *
+ * @return The position after the closing quote, or NULL if the string is not terminated.
+ */
+static const char* skip_string(const char *text);
+
+
+/**
+ * @brief Read the 4 hex digits of a \u escape.
+ *
+ * @return The code unit, or -1 if the digits are invalid.
+ */
+static long read_unicode_escape(const char *digits);
+
+
+/**
+ * @brief Write a code point as UTF-8.
+ *
+ * @return Amount of bytes written.
+ */
+static int write_utf8(unsigned long code_point, char *buffer_out);
+
+
+
+const char* json_skip_value(const char *value) {
+
+    int depth = 0;
+
+    if (!value) return NULL;
+
+    value = skip_spaces(value);
+
+    do {
+        switch (*value) {
+            case '\0':
+                return NULL;
+
+            case '"':
+                if ((value = skip_string(value)) == NULL) {
+                    return NULL;
+                }
+                break;
+
+            case '{':
+            case '[':
+                depth++;
+                value++;
+                break;
+
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    return NULL;
+                }
+                depth--;
+                value++;
+                break;
+
+            default:
+                /*a number or a literal ends at a separator*/
+                if (depth == 0) {
+                    while (*value != '\0' && *value != ',' && *value != '}' && *value != ']' &&
+                           !isspace((unsigned char)*value)) {
+                        value++;
+                    }
+                }
+                else {
+                    value++;
+                }
+                break;
+        }
+    } while (depth > 0);
+
+    return skip_spaces(value);
+}
+
+
+const char* json_get_member(const char *object, const char *key) {
+
+    const char *name;
+    const char *name_end;
+    unsigned long key_length;
+
+    if (!object || !key) return NULL;
+
+    object = skip_spaces(object);
+    if (*object != '{') {
+        return NULL;
+    }
+    object = skip_spaces(object + 1);
+    key_length = strlen(key);
+
+    while (*object == '"') {
+
+        /*the member name*/
+        name = object + 1;
+        if ((name_end = skip_string(object)) == NULL) {
+            return NULL;
+        }
+        object = skip_spaces(name_end);
+        if (*object != ':') {
+            return NULL;
+        }
+        object = skip_spaces(object + 1);
+
+        /*the name is compared without decoding, the protocol names have no escapes*/
+        if ((unsigned long)(name_end - 1 - name) == key_length && strncmp(name, key, key_length) == 0) {
+            return object;
+        }
+
+        /*the next member*/
+        if ((object = json_skip_value(object)) == NULL) {
+            return NULL;
+        }
+        if (*object == ',') {
+            object = skip_spaces(object + 1);
+        }
+    }
+
+    return NULL;
+}
+
+
+const char* json_get_path(const char *object, const char *path) {
+
+    char key[JSON_MAX_KEY_LEN + 1];
+    unsigned long length;
+    const char *separator;
+
+    while (object && path) {
+        separator = strchr(path, '.');
+        length = separator ? (unsigned long)(separator - path) : strlen(path);
+        if (length > JSON_MAX_KEY_LEN) {
+            return NULL;
+        }
+
+        memcpy(key, path, length);
+        key[length] = '\0';
+        object = json_get_member(object, key);
+        path = separator ? separator + 1 : NULL;
+    }
+
+    return object;
+}
+
+
+const char* json_array_first(const char *array) {
+
+    if (!array) return NULL;
+
+    array = skip_spaces(array);
+    if (*array != '[') {
+        return NULL;
+    }
+    array = skip_spaces(array + 1);
+
+    return *array == ']' ? NULL : array;
+}
+
+
+const char* json_array_next(const char *element) {
+
+    if ((element = json_skip_value(element)) == NULL || *element != ',') {
+        return NULL;
+    }
+
+    return skip_spaces(element + 1);
+}
+
+
+boolean json_get_long(const char *value, long *value_out) {
+
+    long result = 0;
+    boolean negative = false;
+
+    if (!value || !value_out) return false;
+
+    value = skip_spaces(value);
+    if (*value == '-') {
+        negative = true;
+        value++;
+    }
+    if (!isdigit((unsigned char)*value)) {
+        return false;
+    }
+
+    while (isdigit((unsigned char)*value)) {
+        result = result * 10 + (*value - '0');
+        value++;
+    }
+
+    *value_out = negative ? -result : result;
+    return true;
+}
+
+
+boolean json_is_true(const char *value) {
+
+    if (!value) return false;
+
+    value = skip_spaces(value);
+    return strncmp(value, JSON_TRUE, strlen(JSON_TRUE)) == 0;
+}
+
+
+unsigned long json_string_size(const char *value) {
+
+    const char *end;
+
+    if (!value) return 0;
+
+    value = skip_spaces(value);
+    if (*value != '"' || (end = skip_string(value)) == NULL) {
+        return 0;
+    }
+
+    /*the decoded string is never longer than its encoding*/
+    return (unsigned long)(end - value);
+}
+
+
+long json_get_string(const char *value, char *buffer_out) {
+
+    long length = 0;
+    long unit;
+    long low_unit;
+    unsigned long code_point;
+
+    if (!value || !buffer_out) return -1;
+
+    value = skip_spaces(value);
+    if (*value != '"') {
+        return -1;
+    }
+    value++;
+
+    while (*value != '"') {
+
+        if (*value == '\0') {
+            return -1;
+        }
+
+        /*a plain character*/
+        if (*value != '\\') {
+            buffer_out[length++] = *value++;
+            continue;
+        }
+
+        /*an escape*/
+        value++;
+        switch (*value) {
+            case 'n':  buffer_out[length++] = '\n'; break;
+            case 't':  buffer_out[length++] = '\t'; break;
+            case 'r':  buffer_out[length++] = '\r'; break;
+            case 'b':  buffer_out[length++] = '\b'; break;
+            case 'f':  buffer_out[length++] = '\f'; break;
+            case '"':  buffer_out[length++] = '"'; break;
+            case '\\': buffer_out[length++] = '\\'; break;
+            case '/':  buffer_out[length++] = '/'; break;
+
+            case 'u':
+                if ((unit = read_unicode_escape(value + 1)) == -1) {
+                    return -1;
+                }
+                value += UNICODE_ESCAPE_DIGITS;
+                code_point = (unsigned long)unit;
+
+                /*a surrogates pair is a single code point*/
+                if (code_point >= HIGH_SURROGATE_FIRST && code_point < LOW_SURROGATE_FIRST &&
+                    value[1] == '\\' && value[2] == 'u' && (low_unit = read_unicode_escape(value + 3)) != -1 &&
+                    (unsigned long)low_unit >= LOW_SURROGATE_FIRST && (unsigned long)low_unit <= LOW_SURROGATE_LAST) {
+                    code_point = 0x10000UL + ((code_point - HIGH_SURROGATE_FIRST) << 10) +
+                                 ((unsigned long)low_unit - LOW_SURROGATE_FIRST);
+                    value += UNICODE_ESCAPE_DIGITS + 2;
+                }
+                length += write_utf8(code_point, buffer_out + length);
+                break;
+
+            default:
+                return -1;
+        }
+        value++;
+    }
+
+    buffer_out[length] = '\0';
+    return length;
+}
+
+
+boolean json_string_equals(const char *value, const char *text) {
+
+    unsigned long length;
+
+    if (!value || !text) return false;
+
+    value = skip_spaces(value);
+    length = strlen(text);
+
+    return *value == '"' && strncmp(value + 1, text, length) == 0 && value[length + 1] == '"';
+}
+
+
+void json_append_raw(text_buffer *buffer, const char *value) {
+
+    const char *end;
+
+    value = skip_spaces(value);
+    if ((end = json_skip_value(value)) == NULL) {
+        append_text(buffer, JSON_NULL, strlen(JSON_NULL));
+        return;
+    }
+
+    /*without the white spaces after the value*/
+    while (end > value && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    append_text(buffer, value, (unsigned long)(end - value));
+}
+
+
+void json_append_string(text_buffer *buffer, const char *text) {
+
+    char escape[UNICODE_ESCAPE_DIGITS + 3];
+    const char *start = text;
+
+    append_text(buffer, "\"", 1);
+
+    for (; *text != '\0'; text++) {
+
+        /*the characters that must be escaped, the rest are copied in runs*/
+        if (*text != '"' && *text != '\\' && (unsigned char)*text >= ' ') {
+            continue;
+        }
+
+        append_text(buffer, start, (unsigned long)(text - start));
+        switch (*text) {
+            case '"':  append_text(buffer, "\\\"", 2); break;
+            case '\\': append_text(buffer, "\\\\", 2); break;
+            case '\n': append_text(buffer, "\\n", 2); break;
+            case '\t': append_text(buffer, "\\t", 2); break;
+            case '\r': append_text(buffer, "\\r", 2); break;
+            default:
+                sprintf(escape, "\\u%04x", (unsigned int)(unsigned char)*text);
+                append_text(buffer, escape, strlen(escape));
+                break;
+        }
+        start = text + 1;
+    }
+
+    append_text(buffer, start, (unsigned long)(text - start));
+    append_text(buffer, "\"", 1);
+}
+
+
+
+
+static const char* skip_spaces(const char *text) {
+
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    return text;
+}
+
+
+static const char* skip_string(const char *text) {
+
+    /*jump over the opening quote*/
+    text++;
+
+    while (*text != '"') {
+        if (*text == '\0') {
+            return NULL;
+        }
+        /*the escaped character can't end the string*/
+        if (*text == '\\') {
+            text++;
+            if (*text == '\0') {
+                return NULL;
+            }
+        }
+        text++;
+    }
+
+    return text + 1;
+}
+
+
+static long read_unicode_escape(const char *digits) {
+
+    long unit = 0;
+    int i;
+
+    for (i = 0; i < UNICODE_ESCAPE_DIGITS; i++) {
+        if (!isxdigit((unsigned char)digits[i])) {
+            return -1;
+        }
+        unit = unit * 16 + (isdigit((unsigned char)digits[i]) ? digits[i] - '0' :
+                            tolower((unsigned char)digits[i]) - 'a' + 10);
+    }
+
+    return unit;
+}
+
+
+static int write_utf8(unsigned long code_point, char *buffer_out) {
+
+    if (code_point < 0x80UL) {
+        buffer_out[0] = (char)code_point;
+        return 1;
+    }
+    if (code_point < 0x800UL) {
+        buffer_out[0] = (char)(0xC0UL | (code_point >> 6));
+        buffer_out[1] = (char)(0x80UL | (code_point & 0x3FUL));
+        return 2;
+    }
+    if (code_point < 0x10000UL) {
+        buffer_out[0] = (char)(0xE0UL | (code_point >> 12));
+        buffer_out[1] = (char)(0x80UL | ((code_point >> 6) & 0x3FUL));
+        buffer_out[2] = (char)(0x80UL | (code_point & 0x3FUL));
+        return 3;
+    }
+    buffer_out[0] = (char)(0xF0UL | (code_point >> 18));
+    buffer_out[1] = (char)(0x80UL | ((code_point >> 12) & 0x3FUL));
+    buffer_out[2] = (char)(0x80UL | ((code_point >> 6) & 0x3FUL));
+    buffer_out[3] = (char)(0x80UL | (code_point & 0x3FUL));
+    return 4;
+}
@@ -6,6 +6,7 @@
 #include <string.h>
 #include "errors.h"
 #include "util.h"
+#include "config.h"
 #include "sys_memory.h"
 
 
@@ -15,7 +16,7 @@
  *
  * This file implements all label-related operations in the assembler:
  *   - Detecting and extracting label definitions from source lines.
- *   - Managing a linked list of labels (add, search, print, free).
+ *   - Managing the labels table (add, search, print, free).
  *   - Differentiating between label types (code, data, extern, entry).
  *   - Providing utilities for label validation and retrieval during both passes.
  *
@@ -26,6 +27,33 @@
  * @date 01/09/2025
  */
 
+
+#ifdef STATIC_NODE_POOLS
+/*the labels table of the static build (the columns can't grow)*/
+static symbol_table static_table;
+static name_id static_name_ids[STATIC_MAX_LABELS];
+static unsigned int static_addresses[STATIC_MAX_LABELS];
+static unsigned char static_types[STATIC_MAX_LABELS];
+static unsigned char static_definitions[STATIC_MAX_LABELS];
+static unsigned char static_entry_bits[(STATIC_MAX_LABELS + 7) / 8];
+static int static_define_lines[STATIC_MAX_LABELS];
+static int static_references[STATIC_MAX_LABELS];
+static int static_label_ids[STATIC_MAX_NAMES];
+#endif
+
+
+/**
+ * @brief Make room for one more label.
+ */
+static void reserve_label(symbol_table_ptr table);
+
+
+/**
+ * @brief Make room for a name id in the label ids index.
+ */
+static void reserve_label_index(symbol_table_ptr table, name_id name);
+
+
 char *find_label_definition(char *line, assembler_context *asmContext) {
 
     char *temp_line = NULL;
@@ -70,7 +98,7 @@ char *find_label_definition(char *line, assembler_context *asmContext) {
 
 
     /*verify that the label name is allowed*/
-    if (is_name_valid(token)) {
+    if (is_name_valid(token, asmContext)) {
         /*verify that the label name  not used yet*/
         if (!can_add_name(token, asmContext)) {
             print_external_error(ERROR_CODE_164);
@@ -153,140 +181,275 @@ void remove_label_from_line(char *line) {
 
 
 
-boolean add_label(const char *new_name, unsigned int address, addr_type type, def_type definition, label_ptr *labels_list) {
+symbol_table_ptr create_symbol_table(intern_pool_ptr names) {
+
+    symbol_table_ptr table;
+    unsigned int id;
+
+#ifdef STATIC_NODE_POOLS
+    table = &static_table;
+    table->name_ids = static_name_ids;
+    table->addresses = static_addresses;
+    table->types = static_types;
+    table->definitions = static_definitions;
+    table->entry_bits = static_entry_bits;
+    memset(static_entry_bits, 0, sizeof(static_entry_bits));
+    table->define_lines = static_define_lines;
+    table->references = static_references;
+    table->capacity = STATIC_MAX_LABELS;
+    table->label_ids = static_label_ids;
+    table->names_capacity = STATIC_MAX_NAMES;
+#else
+    table = (symbol_table_ptr)handle_malloc(sizeof(symbol_table));
+    table->capacity = LABELS_INITIAL_CAPACITY;
+    table->name_ids = (name_id*)handle_malloc(sizeof(name_id) * table->capacity);
+    table->addresses = (unsigned int*)handle_malloc(sizeof(unsigned int) * table->capacity);
+    table->types = (unsigned char*)handle_malloc(sizeof(unsigned char) * table->capacity);
+    table->definitions = (unsigned char*)handle_malloc(sizeof(unsigned char) * table->capacity);
+    table->entry_bits = (unsigned char*)handle_malloc(sizeof(unsigned char) * (table->capacity / 8));
+    table->define_lines = (int*)handle_malloc(sizeof(int) * table->capacity);
+    table->references = (int*)handle_malloc(sizeof(int) * table->capacity);
+    memset(table->entry_bits, 0, table->capacity / 8);
+    table->names_capacity = NAMES_INITIAL_CAPACITY;
+    table->label_ids = (int*)handle_malloc(sizeof(int) * table->names_capacity);
+
+    /*the table is kept for the next files of the batch*/
+    retain_allocation(table);
+    retain_allocation(table->name_ids);
+    retain_allocation(table->addresses);
+    retain_allocation(table->types);
+    retain_allocation(table->definitions);
+    retain_allocation(table->entry_bits);
+    retain_allocation(table->define_lines);
+    retain_allocation(table->references);
+    retain_allocation(table->label_ids);
+#endif
+
+    /*no name is a label yet*/
+    for (id = 0; id < table->names_capacity; id++) {
+        table->label_ids[id] = NO_LABEL;
+    }
+
+    table->names = names;
+    table->amount = 0;
+    return table;
+}
+
+
+void reset_symbol_table(symbol_table_ptr labels) {
 
-    label_ptr new_label = NULL, temp = NULL;
+    int id;
+
+    /*the columns are kept, the entry flags of the last file are cleared*/
+    if (labels) {
+        for (id = 0; id < labels->amount; id++) {
+            labels->label_ids[labels->name_ids[id]] = NO_LABEL;
+        }
+        memset(labels->entry_bits, 0, (labels->amount + 7) / 8);
+        labels->amount = 0;
+    }
+}
+
+
+boolean add_label(const char *new_name, unsigned int address, addr_type type, def_type definition, symbol_table_ptr labels, int define_line) {
+
+    name_id name;
+    int id;
 
     /*verify that all input pointers exist*/
-    if (new_name == NULL || labels_list == NULL) {
+    if (new_name == NULL || labels == NULL) {
         print_internal_error(ERROR_CODE_25,"add_label");
         return false;
     }
 
-    /*allocate memory for new node*/
-    new_label = (label_ptr)handle_malloc(sizeof(label));
-
-
-    /*allocate memory for label name*/
-    new_label->name = (char *) handle_malloc(strlen(new_name) + 1);
+    /*get the name id from the names pool*/
+    if ((name = intern_name(labels->names, new_name)) == NO_NAME_ID) {
+        return false;
+    }
 
+    reserve_label(labels);
+    reserve_label_index(labels, name);
 
-    /*insert values into the new allocated node*/
-    strcpy(new_label->name, new_name);
-    new_label->address = address;
-    new_label->type = type;
-    new_label->definition = definition;
-    new_label->next = NULL;
+    /*insert values into the label columns*/
+    id = labels->amount++;
+    labels->name_ids[id] = name;
 
-    /*add the node in the end of the list*/
-    if(*labels_list == NULL) {
-        *labels_list = new_label;
-    }
-    else {
-        temp = *labels_list;
-        while(temp->next != NULL) {
-            temp = temp->next;
-        }
-        temp->next = new_label;
+    /*a name is found as its first label*/
+    if (labels->label_ids[name] == NO_LABEL) {
+        labels->label_ids[name] = id;
     }
 
+    labels->addresses[id] = address;
+    labels->types[id] = (unsigned char)type;
+    labels->definitions[id] = (unsigned char)definition;
+    labels->define_lines[id] = define_line;
+    labels->references[id] = 0;
+    labels->entry_bits[id >> 3] &= (unsigned char)~(1U << (id & 7));
+
     return true;
 
 
 }
 
-void free_label_list(label_ptr *labels_list) {
-    label_ptr temp = NULL;
-
-    /*free allocate node memory*/
-    while(*labels_list != NULL) {
-        temp = *labels_list;
-        *labels_list = (*labels_list)->next;
+void free_label_list(symbol_table_ptr *labels) {
 
-        safe_free((void**)&temp->name);
-        safe_free((void**)&temp);
+    if (!labels || !*labels) {
+        return;
     }
+
+#ifdef STATIC_NODE_POOLS
+    /*the static table is reused by the next batch*/
+    *labels = NULL;
+#else
+    /*free the columns and the table (the names pool is freed by the context)*/
+    safe_free((void**)&(*labels)->name_ids);
+    safe_free((void**)&(*labels)->addresses);
+    safe_free((void**)&(*labels)->types);
+    safe_free((void**)&(*labels)->definitions);
+    safe_free((void**)&(*labels)->entry_bits);
+    safe_free((void**)&(*labels)->define_lines);
+    safe_free((void**)&(*labels)->references);
+    safe_free((void**)&(*labels)->label_ids);
+    safe_free((void**)labels);
+#endif
 }
 
-void print_labels(label_ptr labels_list) {
+void print_labels(symbol_table_ptr labels) {
+
+    int id;
 
     /*print the label values*/
-    while(labels_list != NULL) {
-        printf("Label: %s  address: %d type: %s  define: %s\n", labels_list->name, labels_list->address,
-            labels_list->type == CODE?"code":"data" ,(labels_list->is_entry?("entry"):(labels_list->definition == EXTERN?"external":"default")));
-        labels_list = labels_list->next;
+    for (id = 0; id < labels_amount(labels); id++) {
+        printf("Label: %s  address: %d type: %s  define: %s\n", label_name(labels, id), labels->addresses[id],
+            labels->types[id] == CODE?"code":"data" ,(is_entry_label(labels, id)?("entry"):(labels->definitions[id] == EXTERN?"external":"default")));
     }
 }
 
 
- unsigned int get_label_address(const char* name, label_ptr labels_list) {
+ unsigned int get_label_address(const char* name, symbol_table_ptr labels) {
+
+    int id;
 
     /*verify label name pointer exist*/
     if (!name){print_internal_error(ERROR_CODE_25,"get_label_address"); return 0;}
 
     /*return the label address if the label defined*/
-    while(labels_list != NULL) {
-        if(strcmp(labels_list->name, name) == 0) {
-            return labels_list->address;
-        }
-        labels_list = labels_list->next;
-    }
-    return 0;
+    id = get_label(name, labels);
+    return (id == NO_LABEL) ? 0 : labels->addresses[id];
 }
 
-boolean is_label_defined(const char *name, label_ptr labels_list) {
+boolean is_label_defined(const char *name, symbol_table_ptr labels) {
 
     /*verify name pointer exist*/
     if (!name) {print_internal_error(ERROR_CODE_25,"is_label_defined"); return false;}
 
-    /*check if the label defined by search the label in the labels list*/
-    while(labels_list != NULL) {
-        if(strcmp(labels_list->name, name) == 0) {
-            return true;
-        }
-        labels_list = labels_list->next;
-    }
-    return false;
+    /*check if the label defined by search the label in the labels table*/
+    return get_label(name, labels) != NO_LABEL;
 }
 
 
 
-label_ptr get_label(const char* name, label_ptr labels_list) {
+int get_label(const char* name, symbol_table_ptr labels) {
 
-    /*return the label list's node if it exist*/
-    while(labels_list != NULL) {
-        if(strcmp(labels_list->name, name) == 0) {
-            return labels_list;
-        }
-        labels_list = labels_list->next;
+    /*a name that isn't in the pool is not a label*/
+    return labels ? find_label(find_name(labels->names, name), labels) : NO_LABEL;
+}
+
+int find_label(name_id name, symbol_table_ptr labels) {
+
+    /*a name without a label (or not in the pool)*/
+    if (!labels || name == NO_NAME_ID || name >= labels->names_capacity) {
+        return NO_LABEL;
     }
-    return NULL;
+
+    return labels->label_ids[name];
 }
 
-void print_entry_labels(label_ptr labels_list) {
+void print_entry_labels(symbol_table_ptr labels) {
+
+    int id;
 
     /*print the entry labels*/
-    while(labels_list != NULL) {
-        if (labels_list->is_entry) {
-            printf("entry label: %s -> address: \n", labels_list->name);
-            print_binary(labels_list->address,10, STDOUT, NULL);
+    for (id = 0; id < labels_amount(labels); id++) {
+        if (is_entry_label(labels, id)) {
+            printf("entry label: %s -> address: \n", label_name(labels, id));
+            print_binary(labels->addresses[id],10, STDOUT, NULL);
             printf("\n");
         }
-        labels_list = labels_list->next;
     }
 }
 
-boolean is_entry_label_exist(label_ptr labels_list) {
+boolean is_entry_label_exist(symbol_table_ptr labels) {
 
-    /*check if the label defined as entry*/
-    while(labels_list != NULL) {
-        if(labels_list->is_entry) {
+    int i;
+    int full_bytes = labels_amount(labels) / 8;
+
+    /*check if any label defined as entry (a byte of the bitset at a time)*/
+    for (i = 0; i < full_bytes; i++) {
+        if (labels->entry_bits[i]) {
             return true;
         }
-        labels_list = labels_list->next;
+    }
+
+    /*only the bits of the existing labels are checked in the last byte*/
+    if (labels_amount(labels) % 8) {
+        return (labels->entry_bits[full_bytes] & ((1U << (labels_amount(labels) % 8)) - 1)) != 0;
     }
     return false;
 }
 
 
 
+
+static void reserve_label(symbol_table_ptr table) {
+
+#ifdef STATIC_NODE_POOLS
+    /*the static table can't grow*/
+    if (table->amount == table->capacity) {
+        print_system_error(ERROR_CODE_12);
+    }
+#else
+    int old_capacity = table->capacity;
+
+    /*grow all the columns together*/
+    if (table->amount == table->capacity) {
+        table->capacity *= 2;
+        table->name_ids = (name_id*)handle_realloc(table->name_ids, sizeof(name_id) * table->capacity);
+        table->addresses = (unsigned int*)handle_realloc(table->addresses, sizeof(unsigned int) * table->capacity);
+        table->types = (unsigned char*)handle_realloc(table->types, sizeof(unsigned char) * table->capacity);
+        table->definitions = (unsigned char*)handle_realloc(table->definitions, sizeof(unsigned char) * table->capacity);
+        table->entry_bits = (unsigned char*)handle_realloc(table->entry_bits, sizeof(unsigned char) * (table->capacity / 8));
+        table->define_lines = (int*)handle_realloc(table->define_lines, sizeof(int) * table->capacity);
+        table->references = (int*)handle_realloc(table->references, sizeof(int) * table->capacity);
+
+        /*the new entry flags are cleared*/
+        memset(table->entry_bits + old_capacity / 8, 0, (table->capacity - old_capacity) / 8);
+    }
+#endif
+}
+
+
+static void reserve_label_index(symbol_table_ptr table, name_id name) {
+
+#ifdef STATIC_NODE_POOLS
+    /*the static index has a slot for every name of the static pool*/
+    (void)table;
+    (void)name;
+#else
+    unsigned int old_capacity = table->names_capacity;
+    unsigned int id;
+
+    if (name < table->names_capacity) {
+        return;
+    }
+
+    /*grow the index, the new names aren't labels*/
+    while (name >= table->names_capacity) {
+        table->names_capacity *= 2;
+    }
+    table->label_ids = (int*)handle_realloc(table->label_ids, sizeof(int) * table->names_capacity);
+    for (id = old_capacity; id < table->names_capacity; id++) {
+        table->label_ids[id] = NO_LABEL;
+    }
+#endif
+}
@@ -0,0 +1,569 @@
+#include "line_records.h"
+#include <string.h>
+#include "config.h"
+#include "addresses.h"
+#include "data_memory.h"
+#include "instruction_memory.h"
+#include "instructions.h"
+#include "intern_pool.h"
+#include "labels.h"
+#include "sys_memory.h"
+#include "target.h"
+
+
+/**
+ * @file line_records.c
+ * @brief First pass results of the unchanged lines, kept between the runs (server mode).
+ *
+ * Every file keeps two record sets: the records of its previous run, which
+ * are replayed (found by a hash table of the line texts), and the records of
+ * the running pass. A replayed record is copied to the running set, so at the
+ * end of the pass the running set holds a record of every clean line of the
+ * file, and it becomes the set of the previous run. The sets are arrays of
+ * kept allocations (see retain_allocation), the records point into them by
+ * index, and they are released with the context.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*FNV-1a hash parameters*/
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define HASH_MASK 0xFFFFFFFFUL
+
+/*no record (an empty bucket, or no label)*/
+#define NO_RECORD (-1)
+#define NO_TEXT ((unsigned long)-1)
+
+
+/**
+ * @struct line_request
+ * @brief An address update request of a recorded line.
+ */
+typedef struct line_request {
+    unsigned int offset;  /**< Address of the patched word, relative to the IC at the start of the line. */
+    operand operand;      /**< The operand (its label id and line are set by the replay). */
+    unsigned long label;  /**< Offset of the operand label name in the set characters. */
+} line_request;
+
+
+/**
+ * @struct line_record
+ * @brief The first pass result of a line.
+ */
+typedef struct line_record {
+    unsigned long hash;            /**< Hash of the line text. */
+    unsigned long text;            /**< Offset of the line text in the set characters. */
+    unsigned long text_length;     /**< Length of the line text. */
+    line_type type;                /**< Type of the line. */
+    unsigned long label;           /**< Offset of the defined (or external) label in the set characters, or NO_TEXT. */
+    unsigned int words;            /**< Index of the first word in the set words. */
+    unsigned int words_amount;     /**< Amount of words (code words of an instruction, data words of a directive). */
+    unsigned int requests;         /**< Index of the first request in the set requests. */
+    unsigned int requests_amount;  /**< Amount of requests. */
+    int next;                      /**< Next record in the same hash bucket, or NO_RECORD. */
+} line_record;
+
+
+/**
+ * @struct line_record_set
+ * @brief The records of a single run of a file.
+ */
+typedef struct line_record_set {
+    line_record *records;          /**< The records, in the line order. */
+    unsigned int amount;           /**< Amount of records. */
+    unsigned int capacity;         /**< Allocated amount of records. */
+    char *chars;                   /**< The line texts and the label names. */
+    unsigned long chars_length;    /**< Used size of chars. */
+    unsigned long chars_capacity;  /**< Allocated size of chars. */
+    int *words;                    /**< The words of the records. */
+    unsigned int words_amount;     /**< Amount of words. */
+    unsigned int words_capacity;   /**< Allocated amount of words. */
+    line_request *requests;        /**< The requests of the records. */
+    unsigned int requests_amount;  /**< Amount of requests. */
+    unsigned int requests_capacity;/**< Allocated amount of requests. */
+    int *buckets;                  /**< Hash table of the records (built when the set is replayed). */
+    unsigned int buckets_amount;   /**< Size of the hash table. */
+} line_record_set;
+
+
+/**
+ * @struct line_records_file
+ * @brief The record sets of a source file.
+ */
+typedef struct line_records_file {
+    boolean used;                                /**< The entry holds a file. */
+    char source[BUILD_CACHE_PATH_MAX_LEN + 1];   /**< Full source file path (.as). */
+    const_target_ptr target;                     /**< Target of the records. */
+    boolean relaxed_limits;                      /**< Length limits of the records. */
+    unsigned long last_use;                      /**< Run counter of the last run of the file. */
+    line_record_set sets[2];                     /**< The previous run set and the running set. */
+    int previous;                                /**< Index of the previous run set. */
+} line_records_file;
+
+
+/**
+ * @struct line_records
+ * @brief The line records of the recently assembled files.
+ */
+typedef struct line_records {
+    line_records_file files[LINE_RECORDS_MAX_FILES]; /**< The files (the least recently used is replaced). */
+    unsigned long runs;                              /**< Runs counter. */
+    line_records_file *active;                       /**< File of the running pass, or NULL. */
+} line_records;
+
+
+
+/**
+ * @brief Find the records of a file, or take the entry of the least recently used file.
+ */
+static line_records_file* get_file_records(line_records *table, const char *source);
+
+
+/**
+ * @brief Empty a record set (its memory is kept).
+ */
+static void clear_record_set(line_record_set *set);
+
+
+/**
+ * @brief Build the hash table of a record set.
+ */
+static void index_record_set(line_record_set *set);
+
+
+/**
+ * @brief Find the record of a line text in the previous run set.
+ */
+static const line_record* find_record(const line_record_set *set, const char *text, unsigned long length, unsigned long hash);
+
+
+/**
+ * @brief Append characters to a record set, and return their offset.
+ */
+static unsigned long add_record_chars(line_record_set *set, const char *chars, unsigned long length);
+
+
+/**
+ * @brief Make place for more words, requests and records in a record set.
+ */
+static void reserve_record_set(line_record_set *set, unsigned int words, unsigned int requests);
+
+
+/**
+ * @brief Copy a record of the previous run set to the running set.
+ */
+static void copy_record(line_record_set *set, const line_record_set *from, const line_record *record);
+
+
+/**
+ * @brief Allocate a kept array, or grow it.
+ */
+static void* grow_kept_array(void *array, unsigned long size);
+
+
+/**
+ * @brief Hash a line text.
+ */
+static unsigned long hash_line(const char *text, unsigned long length);
+
+
+
+void begin_line_records(assembler_context *asmContext, line_snapshot *snapshot) {
+
+    line_records_file *file;
+    int i;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    if (!asmContext->reuse_lines) {
+        return;
+    }
+
+    /*the records table is kept with the context*/
+    if (asmContext->line_records == NULL) {
+        asmContext->line_records = (line_records_ptr)handle_malloc(sizeof(line_records));
+        retain_allocation(asmContext->line_records);
+        memset(asmContext->line_records, 0, sizeof(line_records));
+    }
+
+    /*a path that can't be saved is never matched, its lines are always parsed*/
+    if (!asmContext->as_full_file_name || strlen(asmContext->as_full_file_name) > BUILD_CACHE_PATH_MAX_LEN ||
+        (file = get_file_records(asmContext->line_records, asmContext->as_full_file_name)) == NULL) {
+        asmContext->reuse_lines = false;
+        return;
+    }
+
+    /*the words of the records are encoded for a target, and checked against the length limits*/
+    if (file->target != asmContext->target || file->relaxed_limits != asmContext->relaxed_limits) {
+        for (i = 0; i < 2; i++) {
+            clear_record_set(&file->sets[i]);
+        }
+        file->target = asmContext->target;
+        file->relaxed_limits = asmContext->relaxed_limits;
+    }
+
+    clear_record_set(&file->sets[1 - file->previous]);
+    file->last_use = ++asmContext->line_records->runs;
+    asmContext->line_records->active = file;
+}
+
+
+boolean replay_line_record(assembler_context *asmContext, const char *text, unsigned long length, line_type *type_out) {
+
+    line_records_file *file = asmContext->line_records->active;
+    const line_record_set *set = &file->sets[file->previous];
+    const line_record *record;
+    const line_request *request;
+    const char *label;
+    operand *request_operand;
+    unsigned int IC = asmContext->IC;
+    unsigned int DC = asmContext->DC;
+    unsigned int i;
+
+    if ((record = find_record(set, text, length, hash_line(text, length))) == NULL) {
+        return false;
+    }
+    label = (record->label != NO_TEXT) ? set->chars + record->label : NULL;
+
+    /*the checks that depend on the other lines, a failed check is parsed (and prints its error)*/
+    if (label && !can_add_name(label, asmContext)) {
+        return false;
+    }
+    if (asmContext->memory_usage + record->words_amount > asmContext->target->memory_available_space) {
+        return false;
+    }
+
+    /*the requests of the operands (their names are interned in the operands order, as by the parser)*/
+    for (i = 0; i < record->requests_amount; i++) {
+        request = &set->requests[record->requests + i];
+        request_operand = (operand*)handle_malloc(sizeof(operand));
+        memcpy(request_operand, &request->operand, sizeof(operand));
+        if (request_operand->type == MATRIX_ACCESS) {
+            request_operand->operand_val.matrix.label = intern_name(asmContext->names, set->chars + request->label);
+        }
+        else {
+            request_operand->operand_val.label = intern_name(asmContext->names, set->chars + request->label);
+        }
+        request_operand->file_line = asmContext->am_file_line;
+        add_addr_update_request(IC + request->offset, request_operand, &asmContext->address_update_requests);
+    }
+
+    /*the words, then the label of the line*/
+    switch (record->type) {
+
+        case INSTRUCTION_LINE: {
+            for (i = 0; i < record->words_amount; i++) {
+                add_instruction_to_memory((unsigned short)set->words[record->words + i], &asmContext->instruction_memory, &asmContext->IC,
+                                          &asmContext->memory_usage, asmContext->target->memory_available_space, asmContext->am_file_line);
+            }
+            if (label) {
+                add_label(label, IC, CODE, NORMAL, asmContext->labels, asmContext->am_file_line);
+            }
+            break;
+        }
+
+        case DATA_DIRECTIVE_LINE: {
+            for (i = 0; i < record->words_amount; i++) {
+                add_data_to_memory(set->words[record->words + i], &asmContext->data_memory, &asmContext->DC,
+                                   &asmContext->memory_usage, asmContext->target->memory_available_space, asmContext->am_file_line);
+            }
+            if (label) {
+                add_label(label, DC, DATA, NORMAL, asmContext->labels, asmContext->am_file_line);
+            }
+            break;
+        }
+
+        case EXTERN_DIRECTIVE_LINE: {
+            add_label(label, EXTERNAL_TEMP_ADDR, UNKNOWN_ADDR_TYPE, EXTERN, asmContext->labels, asmContext->am_file_line);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    /*the record is kept for the next run*/
+    copy_record(&file->sets[1 - file->previous], set, record);
+    asmContext->replayed_lines++;
+
+    *type_out = record->type;
+    return true;
+}
+
+
+void record_line(assembler_context *asmContext, const char *text, unsigned long length, line_type type,
+                 const char *label, const line_snapshot *snapshot) {
+
+    line_records_file *file = asmContext->line_records->active;
+    line_record_set *set = &file->sets[1 - file->previous];
+    line_record *record;
+    address_update_request_ptr request;
+    instruction_ptr code_word;
+    data_ptr data_word;
+    unsigned int words_amount;
+    unsigned int requests_amount = 0;
+    unsigned int i;
+
+    /*only a line without an error is replayed (an error line is parsed again, and prints its error)*/
+    if (snapshot->had_error || asmContext->first_pass_error || asmContext->second_pass_error) {
+        return;
+    }
+    if (type != INSTRUCTION_LINE && type != DATA_DIRECTIVE_LINE && type != EXTERN_DIRECTIVE_LINE && type != ENTRY_DIRECTIVE_LINE) {
+        return;
+    }
+
+    /*the new requests are at the head of the list, before the requests of the previous lines*/
+    for (request = asmContext->address_update_requests; request != snapshot->requests; request = request->next) {
+        requests_amount++;
+    }
+    words_amount = (asmContext->IC - snapshot->IC) + (asmContext->DC - snapshot->DC);
+    reserve_record_set(set, words_amount, requests_amount);
+
+    record = &set->records[set->amount++];
+    record->hash = hash_line(text, length);
+    record->text = add_record_chars(set, text, length);
+    record->text_length = length;
+    record->type = type;
+    record->label = label ? add_record_chars(set, label, strlen(label) + 1) : NO_TEXT;
+    record->next = NO_RECORD;
+
+    /*the words added after the last word of the snapshot*/
+    record->words = set->words_amount;
+    record->words_amount = words_amount;
+    code_word = snapshot->code_tail ? snapshot->code_tail->next : asmContext->instruction_memory;
+    for (; code_word != NULL; code_word = code_word->next) {
+        set->words[set->words_amount++] = code_word->value;
+    }
+    data_word = snapshot->data_tail ? snapshot->data_tail->next : asmContext->data_memory;
+    for (; data_word != NULL; data_word = data_word->next) {
+        set->words[set->words_amount++] = data_word->value;
+    }
+
+    /*the requests in the order they were added (the list head is the last one)*/
+    record->requests = set->requests_amount;
+    record->requests_amount = requests_amount;
+    set->requests_amount += requests_amount;
+    for (i = requests_amount, request = asmContext->address_update_requests; i > 0; i--, request = request->next) {
+        set->requests[record->requests + i - 1].offset = request->address - snapshot->IC;
+        memcpy(&set->requests[record->requests + i - 1].operand, request->operand, sizeof(operand));
+        set->requests[record->requests + i - 1].label = add_record_chars(set, get_name(asmContext->names, operand_label(request->operand)),
+                                                                       strlen(get_name(asmContext->names, operand_label(request->operand))) + 1);
+    }
+}
+
+
+void take_line_snapshot(const assembler_context *asmContext, line_snapshot *snapshot) {
+
+    /*move the tails from the tails of the previous line (every word is passed once)*/
+    if (snapshot->code_tail == NULL) {
+        snapshot->code_tail = asmContext->instruction_memory;
+    }
+    while (snapshot->code_tail && snapshot->code_tail->next) {
+        snapshot->code_tail = snapshot->code_tail->next;
+    }
+    if (snapshot->data_tail == NULL) {
+        snapshot->data_tail = asmContext->data_memory;
+    }
+    while (snapshot->data_tail && snapshot->data_tail->next) {
+        snapshot->data_tail = snapshot->data_tail->next;
+    }
+
+    snapshot->IC = asmContext->IC;
+    snapshot->DC = asmContext->DC;
+    snapshot->requests = asmContext->address_update_requests;
+    snapshot->had_error = asmContext->first_pass_error || asmContext->second_pass_error;
+}
+
+
+void end_line_records(assembler_context *asmContext) {
+
+    line_records_file *file;
+
+    if (!asmContext->reuse_lines || (file = asmContext->line_records->active) == NULL) {
+        return;
+    }
+
+    /*the running set is replayed by the next run*/
+    file->previous = 1 - file->previous;
+    index_record_set(&file->sets[file->previous]);
+    asmContext->line_records->active = NULL;
+}
+
+
+static line_records_file* get_file_records(line_records *table, const char *source) {
+
+    line_records_file *oldest = &table->files[0];
+    int i;
+
+    for (i = 0; i < LINE_RECORDS_MAX_FILES; i++) {
+        if (table->files[i].used && strcmp(table->files[i].source, source) == 0) {
+            return &table->files[i];
+        }
+        if (!table->files[i].used || (oldest->used && table->files[i].last_use < oldest->last_use)) {
+            oldest = &table->files[i];
+        }
+    }
+
+    /*a new file replaces the least recently used file (its memory is kept)*/
+    oldest->used = true;
+    strcpy(oldest->source, source);
+    clear_record_set(&oldest->sets[0]);
+    clear_record_set(&oldest->sets[1]);
+    oldest->target = NULL;
+    oldest->relaxed_limits = false;
+    return oldest;
+}
+
+
+static void clear_record_set(line_record_set *set) {
+
+    set->amount = 0;
+    set->chars_length = 0;
+    set->words_amount = 0;
+    set->requests_amount = 0;
+    set->buckets_amount = 0;
+}
+
+
+static void index_record_set(line_record_set *set) {
+
+    unsigned int bucket;
+    unsigned int i;
+
+    /*twice the records, so the chains are short*/
+    if (set->amount == 0) {
+        set->buckets_amount = 0;
+        return;
+    }
+    set->buckets = (int*)grow_kept_array(set->buckets, sizeof(int) * set->amount * 2);
+    set->buckets_amount = set->amount * 2;
+
+    for (i = 0; i < set->buckets_amount; i++) {
+        set->buckets[i] = NO_RECORD;
+    }
+
+    /*the first record of a text is found first (added last to the chain head)*/
+    for (i = set->amount; i > 0; i--) {
+        bucket = (unsigned int)(set->records[i - 1].hash % set->buckets_amount);
+        set->records[i - 1].next = set->buckets[bucket];
+        set->buckets[bucket] = (int)(i - 1);
+    }
+}
+
+
+static const line_record* find_record(const line_record_set *set, const char *text, unsigned long length, unsigned long hash) {
+
+    int index;
+
+    if (set->buckets_amount == 0) {
+        return NULL;
+    }
+
+    for (index = set->buckets[hash % set->buckets_amount]; index != NO_RECORD; index = set->records[index].next) {
+        if (set->records[index].hash == hash && set->records[index].text_length == length &&
+            memcmp(set->chars + set->records[index].text, text, length) == 0) {
+            return &set->records[index];
+        }
+    }
+
+    return NULL;
+}
+
+
+static unsigned long add_record_chars(line_record_set *set, const char *chars, unsigned long length) {
+
+    unsigned long offset = set->chars_length;
+
+    /*the capacity doubles, so adding the texts is linear in their length*/
+    if (set->chars_length + length > set->chars_capacity) {
+        set->chars_capacity = (set->chars_capacity == 0) ? LINE_RECORDS_INITIAL_CAPACITY : set->chars_capacity;
+        while (set->chars_length + length > set->chars_capacity) {
+            set->chars_capacity *= 2;
+        }
+        set->chars = (char*)grow_kept_array(set->chars, set->chars_capacity);
+    }
+
+    memcpy(set->chars + offset, chars, length);
+    set->chars_length += length;
+    return offset;
+}
+
+
+static void reserve_record_set(line_record_set *set, unsigned int words, unsigned int requests) {
+
+    if (set->amount == set->capacity) {
+        set->capacity = (set->capacity == 0) ? LINE_RECORDS_INITIAL_CAPACITY : set->capacity * 2;
+        set->records = (line_record*)grow_kept_array(set->records, sizeof(line_record) * set->capacity);
+    }
+    if (set->words_amount + words > set->words_capacity) {
+        set->words_capacity = (set->words_capacity == 0) ? LINE_RECORDS_INITIAL_CAPACITY : set->words_capacity;
+        while (set->words_amount + words > set->words_capacity) {
+            set->words_capacity *= 2;
+        }
+        set->words = (int*)grow_kept_array(set->words, sizeof(int) * set->words_capacity);
+    }
+    if (set->requests_amount + requests > set->requests_capacity) {
+        set->requests_capacity = (set->requests_capacity == 0) ? LINE_RECORDS_INITIAL_CAPACITY : set->requests_capacity;
+        while (set->requests_amount + requests > set->requests_capacity) {
+            set->requests_capacity *= 2;
+        }
+        set->requests = (line_request*)grow_kept_array(set->requests, sizeof(line_request) * set->requests_capacity);
+    }
+}
+
+
+static void copy_record(line_record_set *set, const line_record_set *from, const line_record *record) {
+
+    line_record *copy;
+    unsigned int i;
+
+    reserve_record_set(set, record->words_amount, record->requests_amount);
+
+    copy = &set->records[set->amount++];
+    *copy = *record;
+    copy->text = add_record_chars(set, from->chars + record->text, record->text_length);
+    if (record->label != NO_TEXT) {
+        copy->label = add_record_chars(set, from->chars + record->label, strlen(from->chars + record->label) + 1);
+    }
+    copy->next = NO_RECORD;
+
+    copy->words = set->words_amount;
+    memcpy(set->words + set->words_amount, from->words + record->words, sizeof(int) * record->words_amount);
+    set->words_amount += record->words_amount;
+
+    copy->requests = set->requests_amount;
+    for (i = 0; i < record->requests_amount; i++) {
+        set->requests[set->requests_amount] = from->requests[record->requests + i];
+        set->requests[set->requests_amount].label = add_record_chars(set, from->chars + from->requests[record->requests + i].label,
+                                                                     strlen(from->chars + from->requests[record->requests + i].label) + 1);
+        set->requests_amount++;
+    }
+}
+
+
+static void* grow_kept_array(void *array, unsigned long size) {
+
+    /*a new array is kept with the context, a grown array stays kept (handle_realloc updates it)*/
+    if (array == NULL) {
+        array = handle_malloc(size);
+        retain_allocation(array);
+        return array;
+    }
+
+    return handle_realloc(array, size);
+}
+
+
+static unsigned long hash_line(const char *text, unsigned long length) {
+
+    unsigned long hash = FNV_OFFSET_BASIS;
+    unsigned long i;
+
+    for (i = 0; i < length; i++) {
+        hash = ((hash ^ (unsigned char)text[i]) * FNV_PRIME) & HASH_MASK;
+    }
+
+    return hash;
+}
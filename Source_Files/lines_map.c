@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "errors.h"
+#include "node_pool.h"
 #include "sys_memory.h"
 
 /**
@@ -20,15 +21,14 @@
  */
 
 
-boolean add_lines_to_map(int original_line, int new_line, lines_map_ptr *lines_map) {
+boolean add_lines_to_map(int original_line, int new_line, int call_line, lines_map_ptr *lines_map, lines_map_ptr *last_line) {
 
-    lines_map_ptr temp;
     lines_map_ptr new_map_lines;
 
     /*allocate memory for new node*/
-    new_map_lines = (lines_map_ptr)handle_malloc(sizeof(lines_LUT));
+    new_map_lines = (lines_map_ptr)alloc_node(LINES_MAP_NODE);
 
-    if(!lines_map) {
+    if(!lines_map || !last_line) {
         print_internal_error(ERROR_CODE_25,"add_lines_to_map");
         return false;
     }
@@ -36,22 +36,18 @@ boolean add_lines_to_map(int original_line, int new_line, lines_map_ptr *lines_m
     /*set value into the new node*/
     new_map_lines->orign_line_num = original_line;
     new_map_lines->new_line_num = new_line;
+    new_map_lines->call_line = call_line;
     new_map_lines->next =NULL;
 
     /*insert the new node at the end of the list*/
     if (*lines_map == NULL) {
         *lines_map = new_map_lines;
-        return true;
     }
     else {
-        temp = *lines_map;
-        while (temp->next != NULL) {
-            temp = temp->next;
-        }
-
-        temp->next = new_map_lines;
-        return true;
+        (*last_line)->next = new_map_lines;
     }
+    *last_line = new_map_lines;
+    return true;
 
 }
 
@@ -78,7 +74,7 @@ void free_lines_map(lines_map_ptr *lines_map) {
     while (*lines_map != NULL) {
         temp = *lines_map;
         *lines_map = (*lines_map)->next;
-        safe_free((void**)&temp);
+        free_node(LINES_MAP_NODE, (void**)&temp);
     }
 }
 
@@ -103,8 +99,7 @@ void remove_last_line(lines_map_ptr *lines_map) {
 
     /* if only one node */
     if ((*lines_map)->next == NULL) {
-        safe_free((void**)lines_map);
-        *lines_map = NULL;
+        free_node(LINES_MAP_NODE, (void**)lines_map);
         return;
     }
 
@@ -120,6 +115,6 @@ void remove_last_line(lines_map_ptr *lines_map) {
     if (prev != NULL) {
         prev->next = NULL;
     }
-    safe_free((void**)&temp);
+    free_node(LINES_MAP_NODE, (void**)&temp);
 }
 
@@ -0,0 +1,979 @@
+/*select() is POSIX, not ANSI C*/
+#define _POSIX_C_SOURCE 200112L
+
+#include "lsp.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include "config.h"
+#include "assembler.h"
+#include "errors.h"
+#include "json.h"
+#include "query.h"
+#include "sys_memory.h"
+#include "util.h"
+
+
+/**
+ * @file lsp.c
+ * @brief Language server of the assembler (Language Server Protocol over stdio).
+ *
+ * The server keeps the state of every open document in memory: its text
+ * (updated in place by the incremental changes of the editor), the symbol
+ * index of its last analysis (labels, macros and label uses, see query.h)
+ * and the diagnostics of that analysis. The queries (definition, references,
+ * hover) are answered from the index, so they cost a lookup, not an assembly.
+ *
+ * A change only marks its document as stale. The stale documents are
+ * analyzed when no other message is waiting (so a burst of keystrokes
+ * triggers a single analysis), or when a query needs their symbols. The
+ * analysis runs on the document text in memory, with the warm context of the
+ * server (see warm_context), and writes nothing to the disk. The first pass
+ * parses only the lines changed since the previous analysis of the document
+ * (the other lines are replayed, see line_records.h), and the second pass
+ * resolves the labels over the whole file; the unchanged documents are never
+ * analyzed again.
+ *
+ * The diagnostics are the error reports of the assembler stages: the
+ * analysis sets the error sink of the context (see error_report), so every
+ * error is received with its line instead of printed, and the standard
+ * output carries only the protocol. An error without a line (an error of the
+ * whole file, or an internal error) covers the whole document.
+ *
+ * The positions are counted in bytes (the assembly sources are ASCII).
+ *
+ * @date 17/10/2026
+ */
+
+
+/*message header*/
+#define CONTENT_LENGTH_HEADER "Content-Length:"
+
+/*the path of a file URI follows this prefix*/
+#define FILE_URI_PREFIX "file://"
+
+/*JSON-RPC errors*/
+#define JSON_RPC_INVALID_REQUEST -32600
+#define JSON_RPC_METHOD_NOT_FOUND -32601
+
+/*protocol values*/
+#define TEXT_DOCUMENT_SYNC_INCREMENTAL 2
+#define DIAGNOSTIC_SEVERITY_ERROR 1
+
+/*the start of every message sent*/
+#define JSON_RPC_HEADER "{\"jsonrpc\":\"2.0\","
+
+/*capabilities of the server (the answer to initialize)*/
+#define SERVER_CAPABILITIES "{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,\"change\":2}," \
+                            "\"definitionProvider\":true,\"referencesProvider\":true,\"hoverProvider\":true}," \
+                            "\"serverInfo\":{\"name\":\"assembler\"}}"
+
+/*longest printed number*/
+#define NUMBER_PRINT_LENGTH 24
+
+/*longest message of an internal error (its description and function are cut to fit)*/
+#define INTERNAL_MESSAGE_MAX_LEN 255
+#define INTERNAL_MESSAGE_PART_LEN 100
+
+/*initial amount of diagnostics of a document*/
+#define DIAGNOSTICS_INITIAL_CAPACITY 8
+
+
+/**
+ * @struct lsp_diagnostic
+ * @brief A diagnostic of a document.
+ */
+typedef struct lsp_diagnostic {
+    boolean has_line;     /**< The diagnostic belongs to a line (otherwise to the whole document). */
+    int line;             /**< Source line (1 based). */
+    const char *message;  /**< Message (a constant of the errors tables). */
+    const char *function; /**< Function of an internal error, or NULL. */
+} lsp_diagnostic;
+
+
+/**
+ * @struct lsp_document
+ * @brief The state of an open document.
+ */
+typedef struct lsp_document {
+    boolean used;                  /**< The slot holds an open document. */
+    char *uri;                     /**< Document URI. */
+    char *path;                    /**< File path of the URI (names the file in the analysis). */
+    text_buffer text;              /**< Document text. */
+    boolean stale;                 /**< Changed since the last analysis. */
+    symbol_index index;            /**< Symbols of the last analysis. */
+    lsp_diagnostic *diagnostics;   /**< Diagnostics of the last analysis. */
+    int diagnostics_amount;        /**< Amount of diagnostics. */
+    int diagnostics_capacity;      /**< Allocated amount of diagnostics. */
+} lsp_document;
+
+
+/**
+ * @enum lsp_query
+ * @brief Symbol query of a request.
+ */
+typedef enum lsp_query {
+    DEFINITION_QUERY,
+    REFERENCES_QUERY,
+    HOVER_QUERY
+} lsp_query;
+
+
+/*the open documents, the received message, the message sent and a decoding buffer
+ *(all in retained allocations: the file state of the context is recycled after every analysis)*/
+static lsp_document documents[LSP_MAX_DOCUMENTS];
+static text_buffer message;
+static text_buffer response;
+static text_buffer scratch;
+
+/*context kept between the analyses*/
+static warm_context lsp_context;
+
+
+/**
+ * @brief Read the next message (headers and content) into the message buffer.
+ *
+ * @return false at the end of the input or on an invalid message.
+ */
+static boolean read_message(void);
+
+
+/**
+ * @brief Send the message in the response buffer (with its header).
+ */
+static void send_message(void);
+
+
+/**
+ * @brief Check if another message is waiting on the standard input.
+ */
+static boolean is_message_waiting(void);
+
+
+/**
+ * @brief Execute the received message.
+ *
+ * @param shutdown_requested [in/out] A shutdown request was received.
+ * @return false on the exit notification.
+ */
+static boolean handle_message(boolean *shutdown_requested);
+
+
+/**
+ * @brief Start a response to a request: the header and the id, up to the result value.
+ */
+static void start_response(const char *id);
+
+
+/**
+ * @brief Send an error response to a request.
+ */
+static void send_error(const char *id, long code, const char *error_message);
+
+
+/**
+ * @brief Open a document (didOpen), or replace the text of an open document.
+ */
+static void open_document(const char *params);
+
+
+/**
+ * @brief Apply the changes of a document (didChange).
+ */
+static void change_document(const char *params);
+
+
+/**
+ * @brief Close a document (didClose) and clear its diagnostics.
+ */
+static void close_document(const char *params);
+
+
+/**
+ * @brief Answer a definition, references or hover request.
+ */
+static void answer_query(const char *id, const char *params, lsp_query query);
+
+
+/**
+ * @brief Analyze a document, keep its symbols and diagnostics, and publish the diagnostics.
+ */
+static void analyze_document(lsp_document *document);
+
+
+/**
+ * @brief Keep an error of an analysis as a diagnostic of its document (the error sink of the analysis).
+ *
+ * @param sink_data The analyzed document.
+ * @param report    The error.
+ */
+static void collect_diagnostic(void *sink_data, const error_report *report);
+
+
+/**
+ * @brief Send the diagnostics of a document.
+ */
+static void publish_diagnostics(const lsp_document *document);
+
+
+/**
+ * @brief Find the open document of the "textDocument.uri" member of the parameters.
+ *
+ * @return The document, or NULL if it is not open.
+ */
+static lsp_document* find_document(const char *params);
+
+
+/**
+ * @brief Release the memory of a document, and free its slot.
+ */
+static void release_document(lsp_document *document);
+
+
+/**
+ * @brief Get the text offset of a position (the character is clamped to its line).
+ *
+ * @param document Document.
+ * @param position Position value ({"line":..,"character":..}).
+ * @return The offset, or the text length if the line is after the end of the text.
+ */
+static unsigned long get_position_offset(const lsp_document *document, const char *position);
+
+
+/**
+ * @brief Get the symbol name under a position.
+ *
+ * @param document Document.
+ * @param position Position value.
+ * @param name_out [out] Buffer of LSP_MAX_SYMBOL_LEN + 1 characters.
+ * @return false if there is no name under the position.
+ */
+static boolean get_symbol_at(const lsp_document *document, const char *position, char *name_out);
+
+
+/**
+ * @brief Replace a part of a document text.
+ */
+static void replace_text(text_buffer *text, unsigned long start, unsigned long end, const char *insert, unsigned long insert_length);
+
+
+/**
+ * @brief Decode a JSON string value into the decoding buffer.
+ *
+ * @return The decoded string, or NULL if the value is not a string.
+ */
+static const char* decode_string(const char *value);
+
+
+/**
+ * @brief Make an empty buffer with at least the given capacity (its content is lost).
+ */
+static void reserve_buffer(text_buffer *buffer, unsigned long capacity);
+
+
+/**
+ * @brief Allocate memory that is kept when the file state is recycled.
+ */
+static void* lsp_alloc(unsigned long size);
+
+
+/**
+ * @brief Append a number to a buffer.
+ */
+static void append_number(text_buffer *buffer, long number);
+
+
+/**
+ * @brief Append a location (a whole line start) of a document to a buffer.
+ */
+static void append_location(text_buffer *buffer, const char *uri, int line);
+
+
+/**
+ * @brief Append a range of lines to a buffer (from the start of the first line).
+ */
+static void append_lines_range(text_buffer *buffer, int first_line, int last_line, unsigned long end_character);
+
+
+/**
+ * @brief Append a literal text to a buffer.
+ */
+#define append_literal(buffer, text) append_text((buffer), (text), strlen(text))
+
+
+
+boolean run_lsp(void) {
+
+    boolean shutdown_requested = false;
+    int i;
+
+    init_warm_context(&lsp_context);
+    if (get_warm_context(&lsp_context, NULL) == NULL) {
+        return false;
+    }
+
+    reserve_buffer(&message, LSP_INITIAL_BUFFER_SIZE);
+    reserve_buffer(&response, LSP_INITIAL_BUFFER_SIZE);
+    reserve_buffer(&scratch, LSP_INITIAL_BUFFER_SIZE);
+
+    /*no hidden input buffer, so select() tells if a message is waiting*/
+    setvbuf(stdin, NULL, _IONBF, 0);
+
+    while (read_message()) {
+
+        if (!handle_message(&shutdown_requested)) {
+            break;
+        }
+
+        /*analyze the changed documents once the burst of messages ended*/
+        for (i = 0; i < LSP_MAX_DOCUMENTS && !is_message_waiting(); i++) {
+            if (documents[i].used && documents[i].stale) {
+                analyze_document(&documents[i]);
+            }
+        }
+    }
+
+    for (i = 0; i < LSP_MAX_DOCUMENTS; i++) {
+        if (documents[i].used) {
+            release_document(&documents[i]);
+        }
+    }
+    release_warm_context(&lsp_context);
+    message.data = response.data = scratch.data = NULL;/*released with the context memory*/
+
+    return shutdown_requested;
+}
+
+
+static boolean read_message(void) {
+
+    char header[LSP_HEADER_MAX_LEN + 1];
+    long content_length = -1;
+    const char *value;
+
+    /*the headers end with an empty line*/
+    while (fgets(header, sizeof(header), stdin) != NULL) {
+
+        if (header[0] == '\r' || header[0] == '\n') {
+            if (content_length >= 0) {
+                break;
+            }
+            continue;
+        }
+
+        if (strncmp(header, CONTENT_LENGTH_HEADER, strlen(CONTENT_LENGTH_HEADER)) == 0) {
+            value = header + strlen(CONTENT_LENGTH_HEADER);
+            content_length = atol(value);
+        }
+    }
+
+    if (content_length < 0 || content_length > LSP_MAX_MESSAGE_LEN) {
+        return false;
+    }
+
+    reserve_buffer(&message, (unsigned long)content_length + 1);
+    if (fread(message.data, 1, (unsigned long)content_length, stdin) != (unsigned long)content_length) {
+        return false;
+    }
+    message.data[content_length] = '\0';
+    message.length = (unsigned long)content_length;
+
+    return true;
+}
+
+
+static void send_message(void) {
+
+    printf("%s %lu\r\n\r\n", CONTENT_LENGTH_HEADER, response.length);
+    fwrite(response.data, 1, response.length, stdout);
+    fflush(stdout);
+}
+
+
+static boolean is_message_waiting(void) {
+
+    fd_set input;
+    struct timeval no_wait;
+
+    FD_ZERO(&input);
+    FD_SET(STDIN_FILENO, &input);
+    no_wait.tv_sec = 0;
+    no_wait.tv_usec = 0;
+
+    return select(STDIN_FILENO + 1, &input, NULL, NULL, &no_wait) > 0;
+}
+
+
+static boolean handle_message(boolean *shutdown_requested) {
+
+    const char *method = json_get_member(message.data, "method");
+    const char *id = json_get_member(message.data, "id");
+    const char *params = json_get_member(message.data, "params");
+
+    /*a response of the client, nothing is requested by the server*/
+    if (method == NULL) {
+        return true;
+    }
+
+    if (json_string_equals(method, "exit")) {
+        return false;
+    }
+
+    /*after shutdown only exit is allowed*/
+    if (*shutdown_requested) {
+        if (id) send_error(id, JSON_RPC_INVALID_REQUEST, "Server is shut down.");
+        return true;
+    }
+
+    if (json_string_equals(method, "initialize")) {
+        start_response(id);
+        append_literal(&response, SERVER_CAPABILITIES);
+        append_literal(&response, "}");
+        send_message();
+    }
+    else if (json_string_equals(method, "shutdown")) {
+        *shutdown_requested = true;
+        start_response(id);
+        append_literal(&response, "null}");
+        send_message();
+    }
+    else if (json_string_equals(method, "textDocument/didOpen")) {
+        open_document(params);
+    }
+    else if (json_string_equals(method, "textDocument/didChange")) {
+        change_document(params);
+    }
+    else if (json_string_equals(method, "textDocument/didClose")) {
+        close_document(params);
+    }
+    else if (json_string_equals(method, "textDocument/definition")) {
+        answer_query(id, params, DEFINITION_QUERY);
+    }
+    else if (json_string_equals(method, "textDocument/references")) {
+        answer_query(id, params, REFERENCES_QUERY);
+    }
+    else if (json_string_equals(method, "textDocument/hover")) {
+        answer_query(id, params, HOVER_QUERY);
+    }
+    /*an unknown request is answered, an unknown notification (initialized, didSave...) is ignored*/
+    else if (id) {
+        send_error(id, JSON_RPC_METHOD_NOT_FOUND, "Method not found.");
+    }
+
+    return true;
+}
+
+
+static void start_response(const char *id) {
+
+    clear_text_buffer(&response);
+    append_literal(&response, JSON_RPC_HEADER);
+    append_literal(&response, "\"id\":");
+    if (id) {
+        json_append_raw(&response, id);
+    }
+    else {
+        append_literal(&response, "null");
+    }
+    append_literal(&response, ",\"result\":");
+}
+
+
+static void send_error(const char *id, long code, const char *error_message) {
+
+    clear_text_buffer(&response);
+    append_literal(&response, JSON_RPC_HEADER);
+    append_literal(&response, "\"id\":");
+    json_append_raw(&response, id);
+    append_literal(&response, ",\"error\":{\"code\":");
+    append_number(&response, code);
+    append_literal(&response, ",\"message\":");
+    json_append_string(&response, error_message);
+    append_literal(&response, "}}");
+    send_message();
+}
+
+
+static void open_document(const char *params) {
+
+    const char *text = json_get_path(params, "textDocument.text");
+    const char *uri = decode_string(json_get_path(params, "textDocument.uri"));
+    lsp_document *document;
+    const char *path;
+    unsigned long size;
+    int i;
+
+    if (!uri || (size = json_string_size(text)) == 0) {
+        return;
+    }
+
+    /*a document opened again replaces its state*/
+    if ((document = find_document(params)) != NULL) {
+        release_document(document);
+    }
+
+    for (i = 0; i < LSP_MAX_DOCUMENTS && documents[i].used; i++);
+    if (i == LSP_MAX_DOCUMENTS) {
+        return;
+    }
+    document = &documents[i];
+
+    document->used = true;
+    document->uri = (char*)lsp_alloc(strlen(uri) + 1);
+    strcpy(document->uri, uri);
+
+    /*the path of a file URI, with its %XX escapes decoded*/
+    path = strncmp(uri, FILE_URI_PREFIX, strlen(FILE_URI_PREFIX)) == 0 ? uri + strlen(FILE_URI_PREFIX) : uri;
+    document->path = (char*)lsp_alloc(strlen(path) + 1);
+    for (i = 0; *path != '\0'; path++) {
+        if (path[0] == '%' && isxdigit((unsigned char)path[1]) && isxdigit((unsigned char)path[2])) {
+            document->path[i++] = (char)((isdigit((unsigned char)path[1]) ? path[1] - '0' : tolower((unsigned char)path[1]) - 'a' + 10) * 16 +
+                                         (isdigit((unsigned char)path[2]) ? path[2] - '0' : tolower((unsigned char)path[2]) - 'a' + 10));
+            path += 2;
+        }
+        else {
+            document->path[i++] = *path;
+        }
+    }
+    document->path[i] = '\0';
+
+    /*the text is decoded straight into the document buffer*/
+    reserve_buffer(&document->text, size);
+    document->text.length = (unsigned long)json_get_string(text, document->text.data);
+    document->stale = true;
+}
+
+
+static void change_document(const char *params) {
+
+    lsp_document *document = find_document(params);
+    const char *change;
+    const char *range;
+    const char *text;
+    unsigned long start;
+    unsigned long end;
+
+    if (document == NULL) {
+        return;
+    }
+
+    /*the changes are applied in order, each one on the result of the previous*/
+    for (change = json_array_first(json_get_member(params, "contentChanges")); change; change = json_array_next(change)) {
+
+        if ((text = decode_string(json_get_member(change, "text"))) == NULL) {
+            continue;
+        }
+
+        /*a change without a range replaces the whole text*/
+        if ((range = json_get_member(change, "range")) == NULL) {
+            start = 0;
+            end = document->text.length;
+        }
+        else {
+            start = get_position_offset(document, json_get_member(range, "start"));
+            end = get_position_offset(document, json_get_member(range, "end"));
+            if (end < start) {
+                end = start;
+            }
+        }
+
+        replace_text(&document->text, start, end, text, strlen(text));
+    }
+
+    document->stale = true;
+}
+
+
+static void close_document(const char *params) {
+
+    lsp_document *document = find_document(params);
+
+    if (document == NULL) {
+        return;
+    }
+
+    /*the closed document has no diagnostics*/
+    free_symbol_index(&document->index);
+    document->diagnostics_amount = 0;
+    publish_diagnostics(document);
+
+    release_document(document);
+}
+
+
+static void answer_query(const char *id, const char *params, lsp_query query) {
+
+    lsp_document *document = find_document(params);
+    char name[LSP_MAX_SYMBOL_LEN + 1];
+    char hover[QUERY_HOVER_MAX_LEN + 1];
+    const indexed_symbol *symbol;
+    const indexed_reference *reference;
+    int found = -1;
+    int i;
+    boolean first = true;
+
+    /*the symbols of the current text*/
+    if (document && document->stale) {
+        analyze_document(document);
+    }
+
+    if (document && get_symbol_at(document, json_get_member(params, "position"), name)) {
+        found = find_indexed_symbol(&document->index, name);
+    }
+
+    start_response(id);
+
+    if (found == -1) {
+        append_literal(&response, query == REFERENCES_QUERY ? "[]}" : "null}");
+        send_message();
+        return;
+    }
+    symbol = &document->index.symbols[found];
+
+    switch (query) {
+
+        case DEFINITION_QUERY:
+            append_location(&response, document->uri, symbol->define_line);
+            break;
+
+        case REFERENCES_QUERY:
+            append_literal(&response, "[");
+            if (json_is_true(json_get_path(params, "context.includeDeclaration"))) {
+                append_location(&response, document->uri, symbol->define_line);
+                first = false;
+            }
+            for (i = 0; i < document->index.references_amount; i++) {
+                reference = &document->index.references[i];
+                if (reference->symbol == found) {
+                    if (!first) append_literal(&response, ",");
+                    append_location(&response, document->uri, reference->line);
+                    first = false;
+                }
+            }
+            append_literal(&response, "]");
+            break;
+
+        case HOVER_QUERY:
+            format_symbol_hover(&document->index, found, hover);
+            append_literal(&response, "{\"contents\":{\"kind\":\"plaintext\",\"value\":");
+            json_append_string(&response, hover);
+            append_literal(&response, "}}");
+            break;
+    }
+
+    append_literal(&response, "}");
+    send_message();
+}
+
+
+static void analyze_document(lsp_document *document) {
+
+    assembler_context *context;
+
+    document->stale = false;
+
+    free_symbol_index(&document->index);
+    document->diagnostics_amount = 0;
+
+    if ((context = get_warm_context(&lsp_context, NULL)) != NULL) {
+
+        /*the errors are received as reports, the standard output carries the protocol*/
+        context->error_sink = collect_diagnostic;
+        context->error_sink_data = document;
+        analyze_source(context, document->path, document->text.data, &document->index);
+        context->error_sink = NULL;
+        context->error_sink_data = NULL;
+    }
+
+    publish_diagnostics(document);
+}
+
+
+static void collect_diagnostic(void *sink_data, const error_report *report) {
+
+    lsp_document *document = (lsp_document*)sink_data;
+    lsp_diagnostic *diagnostic;
+
+    /*grow the diagnostics array (kept between the analyses)*/
+    if (document->diagnostics_amount == document->diagnostics_capacity) {
+        document->diagnostics_capacity = document->diagnostics_capacity ? document->diagnostics_capacity * 2 :
+                                         DIAGNOSTICS_INITIAL_CAPACITY;
+        if (document->diagnostics == NULL) {
+            document->diagnostics = (lsp_diagnostic*)lsp_alloc(sizeof(lsp_diagnostic) * document->diagnostics_capacity);
+        }
+        else {
+            document->diagnostics = (lsp_diagnostic*)handle_realloc(document->diagnostics,
+                                                                    sizeof(lsp_diagnostic) * document->diagnostics_capacity);
+        }
+    }
+
+    /*a line before the document (not mapped) is an error of the whole document*/
+    diagnostic = &document->diagnostics[document->diagnostics_amount++];
+    diagnostic->has_line = report->has_line && report->line >= 1;
+    diagnostic->line = report->line;
+    diagnostic->message = report->message;
+    diagnostic->function = report->internal ? report->function : NULL;
+}
+
+
+static void publish_diagnostics(const lsp_document *document) {
+
+    unsigned long *line_starts;
+    unsigned long lines_amount = 1;
+    unsigned long i;
+    unsigned long line_end;
+    char internal_message[INTERNAL_MESSAGE_MAX_LEN + 1];
+    const lsp_diagnostic *diagnostic;
+    int line;
+    int d;
+
+    /*the start of every line, for the end of the diagnostics ranges*/
+    for (i = 0; i < document->text.length; i++) {
+        lines_amount += (document->text.data[i] == '\n');
+    }
+    line_starts = (unsigned long*)handle_malloc(sizeof(unsigned long) * (lines_amount + 1));
+    line_starts[0] = 0;
+    for (i = 0, lines_amount = 1; i < document->text.length; i++) {
+        if (document->text.data[i] == '\n') {
+            line_starts[lines_amount++] = i + 1;
+        }
+    }
+    line_starts[lines_amount] = document->text.length + 1;
+
+    clear_text_buffer(&response);
+    append_literal(&response, JSON_RPC_HEADER);
+    append_literal(&response, "\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":");
+    json_append_string(&response, document->uri);
+    append_literal(&response, ",\"diagnostics\":[");
+
+    for (d = 0; d < document->diagnostics_amount; d++) {
+        diagnostic = &document->diagnostics[d];
+
+        if (d > 0) append_literal(&response, ",");
+        append_literal(&response, "{\"range\":");
+
+        /*the range of the line, or of the whole document*/
+        if (diagnostic->has_line) {
+            line = diagnostic->line;
+            line_end = (unsigned long)line <= lines_amount ? line_starts[line] - line_starts[line - 1] - 1 : 0;
+            append_lines_range(&response, line, line, line_end);
+        }
+        else {
+            line_end = line_starts[lines_amount] - line_starts[lines_amount - 1] - 1;
+            append_lines_range(&response, 1, (int)lines_amount, line_end);
+        }
+
+        append_literal(&response, ",\"severity\":");
+        append_number(&response, DIAGNOSTIC_SEVERITY_ERROR);
+        append_literal(&response, ",\"source\":\"assembler\",\"message\":");
+        if (diagnostic->function) {
+            sprintf(internal_message, "Internal error: %.*s (in function %.*s)", INTERNAL_MESSAGE_PART_LEN,
+                    diagnostic->message, INTERNAL_MESSAGE_PART_LEN, diagnostic->function);
+            json_append_string(&response, internal_message);
+        }
+        else {
+            json_append_string(&response, diagnostic->message);
+        }
+        append_literal(&response, "}");
+    }
+
+    append_literal(&response, "]}}");
+    send_message();
+
+    safe_free((void**)&line_starts);
+}
+
+
+static lsp_document* find_document(const char *params) {
+
+    const char *uri = decode_string(json_get_path(params, "textDocument.uri"));
+    int i;
+
+    if (uri == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < LSP_MAX_DOCUMENTS; i++) {
+        if (documents[i].used && strcmp(documents[i].uri, uri) == 0) {
+            return &documents[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+static void release_document(lsp_document *document) {
+
+    free_symbol_index(&document->index);
+    safe_free((void**)&document->uri);
+    safe_free((void**)&document->path);
+    safe_free((void**)&document->diagnostics);
+    free_text_buffer(&document->text);
+    memset(document, 0, sizeof(lsp_document));
+}
+
+
+static unsigned long get_position_offset(const lsp_document *document, const char *position) {
+
+    const char *text = document->text.data;
+    unsigned long offset = 0;
+    long line = 0;
+    long character = 0;
+
+    json_get_long(json_get_member(position, "line"), &line);
+    json_get_long(json_get_member(position, "character"), &character);
+
+    /*the start of the line*/
+    while (line > 0 && offset < document->text.length) {
+        if (text[offset++] == '\n') {
+            line--;
+        }
+    }
+    if (line > 0) {
+        return document->text.length;
+    }
+
+    /*the character, up to the end of the line*/
+    while (character > 0 && offset < document->text.length && text[offset] != '\n') {
+        offset++;
+        character--;
+    }
+
+    return offset;
+}
+
+
+static boolean get_symbol_at(const lsp_document *document, const char *position, char *name_out) {
+
+    const char *text = document->text.data;
+    unsigned long offset;
+    unsigned long start;
+    unsigned long end;
+
+    if (position == NULL) {
+        return false;
+    }
+
+    offset = get_position_offset(document, position);
+
+    /*the name around the position (names are letters, digits and '_')*/
+    for (start = offset; start > 0 && (isalnum((unsigned char)text[start - 1]) || text[start - 1] == '_'); start--);
+    for (end = offset; end < document->text.length && (isalnum((unsigned char)text[end]) || text[end] == '_'); end++);
+
+    if (end == start || end - start > LSP_MAX_SYMBOL_LEN) {
+        return false;
+    }
+
+    memcpy(name_out, text + start, end - start);
+    name_out[end - start] = '\0';
+    return true;
+}
+
+
+static void replace_text(text_buffer *text, unsigned long start, unsigned long end, const char *insert, unsigned long insert_length) {
+
+    unsigned long new_length = text->length - (end - start) + insert_length;
+    unsigned long capacity = text->capacity;
+    char *data;
+
+    /*the text grows by doubling, the edits in place are amortized*/
+    if (new_length + 1 > capacity) {
+        while (new_length + 1 > capacity) {
+            capacity *= 2;
+        }
+        data = (char*)lsp_alloc(capacity);
+        memcpy(data, text->data, start);
+        memcpy(data + start, insert, insert_length);
+        memcpy(data + start + insert_length, text->data + end, text->length - end + 1);
+        safe_free((void**)&text->data);
+        text->data = data;
+        text->capacity = capacity;
+    }
+    else {
+        memmove(text->data + start + insert_length, text->data + end, text->length - end + 1);
+        memcpy(text->data + start, insert, insert_length);
+    }
+
+    text->length = new_length;
+}
+
+
+static const char* decode_string(const char *value) {
+
+    unsigned long size = json_string_size(value);
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    if (size > scratch.capacity) {
+        reserve_buffer(&scratch, size);
+    }
+    if (json_get_string(value, scratch.data) == -1) {
+        return NULL;
+    }
+
+    return scratch.data;
+}
+
+
+static void reserve_buffer(text_buffer *buffer, unsigned long capacity) {
+
+    if (buffer->data == NULL || buffer->capacity < capacity) {
+        safe_free((void**)&buffer->data);
+        buffer->data = (char*)lsp_alloc(capacity);
+        buffer->capacity = capacity;
+    }
+
+    buffer->length = 0;
+    buffer->data[0] = '\0';
+}
+
+
+static void* lsp_alloc(unsigned long size) {
+
+    void *memory = handle_malloc(size);
+    retain_allocation(memory);
+    return memory;
+}
+
+
+static void append_number(text_buffer *buffer, long number) {
+
+    char number_str[NUMBER_PRINT_LENGTH + 1];
+
+    sprintf(number_str, "%ld", number);
+    append_text(buffer, number_str, strlen(number_str));
+}
+
+
+static void append_location(text_buffer *buffer, const char *uri, int line) {
+
+    append_literal(buffer, "{\"uri\":");
+    json_append_string(buffer, uri);
+    append_literal(buffer, ",\"range\":");
+    append_lines_range(buffer, line, line, 0);
+    append_literal(buffer, "}");
+}
+
+
+static void append_lines_range(text_buffer *buffer, int first_line, int last_line, unsigned long end_character) {
+
+    /*the protocol lines start at 0*/
+    long protocol_first = first_line > 0 ? first_line - 1 : 0;
+    long protocol_last = last_line > 0 ? last_line - 1 : 0;
+
+    append_literal(buffer, "{\"start\":{\"line\":");
+    append_number(buffer, protocol_first);
+    append_literal(buffer, ",\"character\":0},\"end\":{\"line\":");
+    append_number(buffer, protocol_last);
+    append_literal(buffer, ",\"character\":");
+    append_number(buffer, (long)end_character);
+    append_literal(buffer, "}}");
+}
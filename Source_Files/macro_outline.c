@@ -0,0 +1,542 @@
+
+#include "macro_outline.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "config.h"
+#include "errors.h"
+#include "intern_pool.h"
+#include "instructions.h"
+#include "lines_map.h"
+#include "pre_processor.h"
+#include "sys_memory.h"
+#include "tables.h"
+#include "util.h"
+
+
+/**
+ * @file macro_outline.c
+ * @brief Outlining of repeated macro expansions into subroutines ("--outline-macros").
+ *
+ * The outlining runs at the end of the preprocessor, on the expanded content.
+ * The expansions are found through the lines map: every expansion line is
+ * mapped to its macro body line and to the macro call line, so the first
+ * line of an expansion is the one mapped to the first line of the macro body.
+ *
+ * The size of every instruction is calculated from its operands text,
+ * with the same rules as the encoder (a word for the opcode, one word for an
+ * immediate, direct or register operand, two words for a matrix operand, and
+ * a single shared word for two register operands).
+ *
+ * @date 17/10/2026
+ */
+
+
+/*line classification (not an opcode number)*/
+#define NOT_INSTRUCTION (-1)
+#define EMPTY_OR_COMMENT (-2)
+
+/*words of a "jsr <label>" and of a "rts" instruction*/
+#define JSR_WORDS 2
+#define RTS_WORDS 1
+
+/*subroutine label suffix (a macro name can't be used as a label)*/
+#define SUBROUTINE_SUFFIX "_sub"
+#define SUBROUTINE_MAX_INDEX 99
+
+
+/**
+ * @struct outline_info
+ * @brief Outlining decision of a single macro.
+ */
+typedef struct outline_info {
+    macro_ptr macro;                     /**< The macro. */
+    int calls;                           /**< Amount of the macro expansions. */
+    unsigned int body_words;             /**< Memory words of a single expansion. */
+    boolean outline;                     /**< The macro is outlined. */
+    char sub_name[NAME_MAX_LEN + 1];     /**< Subroutine label. */
+} outline_info;
+
+
+/**
+ * @brief Classify a line and calculate the words of an instruction line.
+ *
+ * @param line       The line.
+ * @param asmContext Assembler context (opcodes and registers tables).
+ * @param has_label_out [out] Set to true if the line starts with a label definition.
+ * @param words_out  [out] Memory words of the instruction.
+ * @return The opcode number, NOT_INSTRUCTION or EMPTY_OR_COMMENT.
+ */
+static int analyze_line(const char *line, assembler_context *asmContext, boolean *has_label_out, unsigned int *words_out);
+
+
+/**
+ * @brief Check if a macro body is safe to outline and calculate its words.
+ *
+ * @return true if the body is safe to outline (instructions only, no labels, no "jmp", "bne", "jsr", "rts" or "stop").
+ */
+static boolean analyze_macro_body(const outline_info *info, assembler_context *asmContext, unsigned int *words_out);
+
+
+/**
+ * @brief Check if the program never continues into the end of the file.
+ *
+ * The last instruction must be "stop", "rts" or "jmp", and must not be a
+ * part of an outlined expansion.
+ */
+static boolean is_program_end_safe(const char *am_content, lines_map_ptr lines_map, const outline_info infos[], int amount, assembler_context *asmContext);
+
+
+/**
+ * @brief Get the outlined macro whose expansion starts at a .am line.
+ *
+ * @return The macro outline info, or NULL if the line doesn't start an outlined expansion.
+ */
+static const outline_info* get_outlined_expansion(lines_map_ptr map_line, const outline_info infos[], int amount);
+
+
+/**
+ * @brief Check if a name appears as a whole word in a text.
+ */
+static boolean is_name_in_text(const char *name, const char *text);
+
+
+/**
+ * @brief Set an unused subroutine label for an outlined macro.
+ *
+ * @return true if an unused label was found.
+ */
+static boolean set_subroutine_name(outline_info *info, const outline_info infos[], int amount, const char *am_content, assembler_context *asmContext);
+
+
+/**
+ * @brief Build the new .am content and lines map.
+ *
+ * @return The new content (allocated).
+ */
+static char* build_outlined_content(const char *am_content, const outline_info infos[], int amount, assembler_context *asmContext);
+
+
+/**
+ * @brief Get the length of a line, including its '\n' (if exist).
+ */
+static unsigned long get_line_length(const char *line);
+
+
+
+
+boolean outline_macros(assembler_context *asmContext, text_buffer *am_content) {
+
+    outline_info *infos;
+    lines_map_ptr map_line;
+    macro_ptr macro;
+    char *new_content;
+    int amount = 0;
+    int outlined = 0;
+    int i;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !am_content || !am_content->data) {
+        print_internal_error(ERROR_CODE_25, "outline_macros");
+        return false;
+    }
+
+    asmContext->outline_saved_words = 0;
+
+    for (macro = asmContext->macros; macro; macro = macro->next) amount++;
+    if (amount == 0) {
+        return true;
+    }
+
+    infos = (outline_info*)handle_malloc(sizeof(outline_info) * amount);
+
+    for (i = 0, macro = asmContext->macros; macro; macro = macro->next, i++) {
+        infos[i].macro = macro;
+        infos[i].calls = 0;
+        infos[i].body_words = 0;
+        infos[i].outline = false;
+        infos[i].sub_name[0] = '\0';
+    }
+
+    /*count the expansions of every macro (first line of the body)*/
+    for (map_line = asmContext->lines_maper; map_line; map_line = map_line->next) {
+        if (map_line->call_line == 0) continue;
+        for (i = 0; i < amount; i++) {
+            if (map_line->orign_line_num == infos[i].macro->define_line + 1) {
+                infos[i].calls++;
+                break;
+            }
+        }
+    }
+
+    /*outline only the safe and profitable macros*/
+    for (i = 0; i < amount; i++) {
+        if (infos[i].calls <= asmContext->outline_threshold) continue;
+        if (!analyze_macro_body(&infos[i], asmContext, &infos[i].body_words)) continue;
+
+        if (infos[i].calls * infos[i].body_words > infos[i].calls * JSR_WORDS + infos[i].body_words + RTS_WORDS) {
+            infos[i].outline = true;
+            outlined++;
+        }
+    }
+
+    if (outlined > 0 && !is_program_end_safe(am_content->data, asmContext->lines_maper, infos, amount, asmContext)) {
+        outlined = 0;
+    }
+
+    /*choose the subroutines labels*/
+    for (i = 0; outlined > 0 && i < amount; i++) {
+        if (infos[i].outline && !set_subroutine_name(&infos[i], infos, amount, am_content->data, asmContext)) {
+            infos[i].outline = false;
+            outlined--;
+        }
+    }
+
+    if (outlined == 0) {
+        safe_free((void**)&infos);
+        return true;
+    }
+
+    /*replace the expansions with subroutine calls*/
+    new_content = build_outlined_content(am_content->data, infos, amount, asmContext);
+    clear_text_buffer(am_content);
+    append_text(am_content, new_content, strlen(new_content));
+    safe_free((void**)&new_content);
+
+    for (i = 0; i < amount; i++) {
+        if (infos[i].outline) {
+            asmContext->outline_saved_words += infos[i].calls * infos[i].body_words -
+                                               (infos[i].calls * JSR_WORDS + infos[i].body_words + RTS_WORDS);
+        }
+    }
+
+    safe_free((void**)&infos);
+    return true;
+}
+
+
+
+
+static int analyze_line(const char *line, assembler_context *asmContext, boolean *has_label_out, unsigned int *words_out) {
+
+    char buffer[MAX_LINE_LEN + 2];
+    char *token;
+    char *operands;
+    char *operand_str;
+    char *next;
+    int operand_types[2];
+    int operands_count = 0;
+    int opcode_num = NOT_INSTRUCTION;
+    int i;
+
+    *has_label_out = false;
+    *words_out = 0;
+
+    /*a longer line (relaxed mode) is not analyzed, and its macro is not outlined*/
+    if (get_line_length(line) > MAX_LINE_LEN + 1) {
+        return NOT_INSTRUCTION;
+    }
+
+    strncpy(buffer, line, MAX_LINE_LEN + 1);
+    buffer[MAX_LINE_LEN + 1] = '\0';
+    if ((next = strchr(buffer, '\n')) != NULL) *next = '\0';
+    trim_edge_white_space(buffer);
+
+    if (buffer[0] == '\0' || buffer[0] == ';') {
+        return EMPTY_OR_COMMENT;
+    }
+
+    /*skip the label definition*/
+    token = buffer;
+    next = token + strcspn(token, " \t");
+    if (next > token && *(next - 1) == ':') {
+        *has_label_out = true;
+        token = next + strspn(next, " \t");
+        next = token + strcspn(token, " \t");
+    }
+
+    /*the opcode*/
+    operands = (*next == '\0') ? next : next + 1;
+    *next = '\0';
+
+    for (i = 0; i < INSTRUCTIONS_AMOUNT; i++) {
+        if (strcmp(token, asmContext->opcode_table[i].name) == 0) {
+            opcode_num = asmContext->opcode_table[i].opcode;
+            break;
+        }
+    }
+    if (opcode_num == NOT_INSTRUCTION) {
+        return NOT_INSTRUCTION;
+    }
+
+    /*the operands (separated by commas)*/
+    operand_str = operands;
+    while (operand_str != NULL && operands_count < 2) {
+        if ((next = strchr(operand_str, ',')) != NULL) *next++ = '\0';
+        trim_edge_white_space(operand_str);
+        if (operand_str[0] != '\0') {
+            if (operand_str[0] == '#') operand_types[operands_count++] = IMMEDIATE_ACCESS;
+            else if (is_register(operand_str, asmContext)) operand_types[operands_count++] = REGISTER_ACCESS;
+            else if (strchr(operand_str, '[') != NULL) operand_types[operands_count++] = MATRIX_ACCESS;
+            else operand_types[operands_count++] = DIRECT_ACCESS;
+        }
+        operand_str = next;
+    }
+
+    /*opcode word, and the operands words*/
+    *words_out = 1;
+    if (operands_count == 2 && operand_types[0] == REGISTER_ACCESS && operand_types[1] == REGISTER_ACCESS) {
+        *words_out += 1;
+    }
+    else {
+        for (i = 0; i < operands_count; i++) {
+            *words_out += (operand_types[i] == MATRIX_ACCESS) ? 2 : 1;
+        }
+    }
+
+    return opcode_num;
+}
+
+
+static boolean analyze_macro_body(const outline_info *info, assembler_context *asmContext, unsigned int *words_out) {
+
+    const char *line = info->macro->content;
+    boolean has_label;
+    boolean first_instruction = true;
+    unsigned int words;
+    int opcode_num;
+
+    *words_out = 0;
+
+    while (*line != '\0') {
+
+        opcode_num = analyze_line(line, asmContext, &has_label, &words);
+
+        if (opcode_num != EMPTY_OR_COMMENT) {
+
+            /*only instructions without labels, and no control transfer (the subroutine must reach its "rts")*/
+            if (opcode_num == NOT_INSTRUCTION || has_label || (get_opcode_effects(opcode_num) & CHANGES_FLOW)) {
+                return false;
+            }
+
+            /*the subroutine label is added to the first instruction line*/
+            if (first_instruction && get_line_length(line) + NAME_MAX_LEN + 2 > MAX_LINE_LEN) {
+                return false;
+            }
+
+            first_instruction = false;
+            *words_out += words;
+        }
+
+        line += get_line_length(line);
+    }
+
+    return *words_out > 0;
+}
+
+
+static boolean is_program_end_safe(const char *am_content, lines_map_ptr lines_map, const outline_info infos[], int amount, assembler_context *asmContext) {
+
+    const char *line = am_content;
+    const outline_info *expansion = NULL;
+    int expansion_lines = 0;
+    int last_opcode = NOT_INSTRUCTION;
+    boolean last_outlined = false;
+    boolean has_label;
+    unsigned int words;
+    int opcode_num;
+
+    while (*line != '\0' && lines_map != NULL) {
+
+        /*track the outlined expansions*/
+        if (expansion_lines == 0 && (expansion = get_outlined_expansion(lines_map, infos, amount)) != NULL) {
+            expansion_lines = expansion->macro->lines - 1;
+        }
+
+        opcode_num = analyze_line(line, asmContext, &has_label, &words);
+        if (opcode_num >= 0) {
+            last_opcode = opcode_num;
+            last_outlined = expansion_lines > 0;
+        }
+
+        if (expansion_lines > 0) expansion_lines--;
+        line += get_line_length(line);
+        lines_map = lines_map->next;
+    }
+
+    return !last_outlined && (last_opcode == STOP_OPCODE || last_opcode == RTS_OPCODE || last_opcode == JMP_OPCODE);
+}
+
+
+static const outline_info* get_outlined_expansion(lines_map_ptr map_line, const outline_info infos[], int amount) {
+
+    int i;
+
+    if (map_line->call_line == 0) return NULL;
+
+    for (i = 0; i < amount; i++) {
+        if (infos[i].outline && map_line->orign_line_num == infos[i].macro->define_line + 1) {
+            return &infos[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+static boolean is_name_in_text(const char *name, const char *text) {
+
+    unsigned long len = strlen(name);
+    const char *found = text;
+
+    while ((found = strstr(found, name)) != NULL) {
+        if ((found == text || (!isalnum((unsigned char)found[-1]) && found[-1] != '_')) &&
+            !isalnum((unsigned char)found[len]) && found[len] != '_') {
+            return true;
+        }
+        found++;
+    }
+
+    return false;
+}
+
+
+static boolean set_subroutine_name(outline_info *info, const outline_info infos[], int amount, const char *am_content, assembler_context *asmContext) {
+
+    int index = 0;
+    int i;
+    boolean used;
+
+    while (index <= SUBROUTINE_MAX_INDEX) {
+
+        /*<macro>_sub, then <macro>_sub1, <macro>_sub2 ... (the macro name is cut if too long)*/
+        if (index == 0) {
+            sprintf(info->sub_name, "%.*s%s", NAME_MAX_LEN - 6, get_name(asmContext->names, info->macro->name), SUBROUTINE_SUFFIX);
+        }
+        else {
+            sprintf(info->sub_name, "%.*s%s%d", NAME_MAX_LEN - 6, get_name(asmContext->names, info->macro->name), SUBROUTINE_SUFFIX, index);
+        }
+
+        used = is_name_in_text(info->sub_name, am_content) || find_macro(find_name(asmContext->names, info->sub_name), asmContext) != NULL;
+        for (i = 0; i < amount && !used; i++) {
+            used = (&infos[i] != info && infos[i].outline && strcmp(infos[i].sub_name, info->sub_name) == 0);
+        }
+
+        if (!used) {
+            return true;
+        }
+        index++;
+    }
+
+    return false;
+}
+
+
+static char* build_outlined_content(const char *am_content, const outline_info infos[], int amount, assembler_context *asmContext) {
+
+    lines_map_ptr map_line = asmContext->lines_maper;
+    lines_map_ptr new_map = NULL;
+    lines_map_ptr last_map_line = NULL;
+    const outline_info *expansion;
+    const char *line = am_content;
+    const char *body_line;
+    const char *rts_name = asmContext->opcode_table[RTS_OPCODE].name;
+    const char *jsr_name = asmContext->opcode_table[JSR_OPCODE].name;
+    unsigned long size = strlen(am_content) + 2;
+    unsigned long line_len;
+    boolean has_label;
+    boolean labeled;
+    unsigned int words;
+    char *content;
+    char *end;
+    int new_line = 0;
+    int body_index;
+    int skip;
+    int i;
+
+    /*calculate the new content size (upper bound)*/
+    for (i = 0; i < amount; i++) {
+        if (!infos[i].outline) continue;
+        size += strlen(infos[i].macro->content) + strlen(infos[i].sub_name) + 2 + strlen(rts_name) + 1;
+        size += infos[i].calls * (strlen(jsr_name) + 1 + strlen(infos[i].sub_name) + 1);
+    }
+
+    content = (char*)handle_malloc(size);
+    end = content;
+
+    /*- - - the program, with the expansions replaced by calls - - -*/
+    while (*line != '\0' && map_line != NULL) {
+
+        if ((expansion = get_outlined_expansion(map_line, infos, amount)) != NULL) {
+            end += sprintf(end, "%s %s\n", jsr_name, expansion->sub_name);
+            add_lines_to_map(map_line->call_line, ++new_line, 0, &new_map, &last_map_line);
+
+            /*skip the expansion lines*/
+            for (skip = expansion->macro->lines - 1; skip > 0 && *line != '\0' && map_line != NULL; skip--) {
+                line += get_line_length(line);
+                map_line = map_line->next;
+            }
+            continue;
+        }
+
+        line_len = get_line_length(line);
+        memcpy(end, line, line_len);
+        end += line_len;
+        add_lines_to_map(map_line->orign_line_num, ++new_line, map_line->call_line, &new_map, &last_map_line);
+
+        line += line_len;
+        map_line = map_line->next;
+    }
+
+    if (end > content && *(end - 1) != '\n') {
+        *end++ = '\n';
+    }
+
+    /*- - - the subroutines - - -*/
+    for (i = 0; i < amount; i++) {
+
+        if (!infos[i].outline) continue;
+
+        body_line = infos[i].macro->content;
+        body_index = 0;
+        labeled = false;
+
+        while (*body_line != '\0') {
+            line_len = get_line_length(body_line);
+
+            /*add the subroutine label to the first instruction*/
+            if (!labeled && analyze_line(body_line, asmContext, &has_label, &words) >= 0) {
+                end += sprintf(end, "%s: ", infos[i].sub_name);
+                body_line += strspn(body_line, " \t");
+                line_len = get_line_length(body_line);
+                labeled = true;
+            }
+
+            memcpy(end, body_line, line_len);
+            end += line_len;
+            if (*(end - 1) != '\n') *end++ = '\n';
+            add_lines_to_map(infos[i].macro->define_line + (++body_index), ++new_line, 0, &new_map, &last_map_line);
+
+            body_line += line_len;
+        }
+
+        /*return from the subroutine (mapped to the "mcroend" line)*/
+        end += sprintf(end, "%s\n", rts_name);
+        add_lines_to_map(infos[i].macro->define_line + infos[i].macro->lines, ++new_line, 0, &new_map, &last_map_line);
+    }
+
+    *end = '\0';
+
+    free_lines_map(&asmContext->lines_maper);
+    asmContext->lines_maper = new_map;
+
+    return content;
+}
+
+
+static unsigned long get_line_length(const char *line) {
+
+    const char *line_end = strchr(line, '\n');
+
+    return (line_end == NULL) ? strlen(line) : (unsigned long)(line_end - line) + 1;
+}
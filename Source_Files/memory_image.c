@@ -0,0 +1,103 @@
+
+#include "memory_image.h"
+#include <stdio.h>
+#include "data_memory.h"
+#include "config.h"
+#include "errors.h"
+#include "instruction_memory.h"
+#include "sys_memory.h"
+#include "target.h"
+
+
+/**
+ * @file memory_image.c
+ * @brief Packed memory image of an assembled program.
+ *
+ * @date 17/10/2026
+ */
+
+
+
+
+memory_image_ptr create_memory_image(void) {
+
+    memory_image_ptr image;
+
+    image = (memory_image_ptr)handle_malloc(sizeof(memory_image));
+    image->load_address = 0;
+    image->code_length = 0;
+    image->data_length = 0;
+    image->capacity = MEMORY_IMAGE_INITIAL_CAPACITY;
+    image->words = (image_word*)handle_malloc(sizeof(image_word) * image->capacity);
+
+    /*the image is kept for the next files of the batch*/
+    retain_allocation(image);
+    retain_allocation(image->words);
+
+    return image;
+}
+
+
+boolean build_memory_image(const assembler_context *asmContext, memory_image_ptr image) {
+
+    instruction_ptr instruction_tmp;
+    data_ptr data_tmp;
+    unsigned int word_mask;
+    unsigned int end;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !image) {
+        print_internal_error(ERROR_CODE_25, "build_memory_image");
+        return false;
+    }
+
+    word_mask = asmContext->target->word_bit_mask;
+
+    image->load_address = asmContext->target->address_offset;
+    image->code_length = asmContext->IC;
+    image->data_length = asmContext->DC;
+
+    /*grow the words array (a larger program than the previous files)*/
+    if (image->code_length + image->data_length + 1 > image->capacity) {
+        while (image->code_length + image->data_length + 1 > image->capacity) {
+            image->capacity *= 2;
+        }
+        image->words = (image_word*)handle_realloc(image->words, sizeof(image_word) * image->capacity);
+    }
+
+    end = memory_image_end(image);
+
+    /*- - - code words - - -*/
+    for (instruction_tmp = asmContext->instruction_memory; instruction_tmp; instruction_tmp = instruction_tmp->next) {
+        if (instruction_tmp->address < image->load_address || instruction_tmp->address >= end) {
+            goto address_error;
+        }
+        set_image_word(image, instruction_tmp->address, instruction_tmp->value, word_mask);
+    }
+
+    /*- - - data words (after the code) - - -*/
+    for (data_tmp = asmContext->data_memory; data_tmp; data_tmp = data_tmp->next) {
+        if (data_tmp->address < image->load_address || data_tmp->address >= end) {
+            goto address_error;
+        }
+        set_image_word(image, data_tmp->address, data_tmp->value, word_mask);
+    }
+
+    return true;
+
+    address_error:
+    print_internal_error(ERROR_CODE_31, "build_memory_image");
+    reset_memory_image(image);
+    return false;
+}
+
+
+void free_memory_image(memory_image_ptr *image_ptr) {
+
+    if (!image_ptr || !*image_ptr) {
+        return;
+    }
+
+    safe_free((void**)&(*image_ptr)->words);
+    safe_free((void**)image_ptr);
+}
@@ -0,0 +1,189 @@
+
+#include "node_pool.h"
+#include "addresses.h"
+#include "config.h"
+#include "data_memory.h"
+#include "errors.h"
+#include "externals.h"
+#include "instruction_memory.h"
+#include "lines_map.h"
+#include "pre_processor.h"
+#include "sys_memory.h"
+
+
+/**
+ * @file node_pool.c
+ * @brief Allocation of the assembler lists nodes (heap or static pools).
+ *
+ * In the default build every pool is a slab cache of sys_memory.c.
+ *
+ * In the static build every pool is an array of slots. A slot holds a node,
+ * or the next free slot while it is released. The never used slots are
+ * taken in order, and the released slots are reused first.
+ *
+ * @date 17/10/2026
+ */
+
+
+#ifdef STATIC_NODE_POOLS
+
+
+/*pool slot of every node type (the union keeps the node alignment)*/
+typedef union data_slot { data_mem node; void *next_free; } data_slot;
+typedef union instruction_slot { inst_mem node; void *next_free; } instruction_slot;
+typedef union address_request_slot { address_update_request node; void *next_free; } address_request_slot;
+typedef union external_slot { external node; void *next_free; } external_slot;
+typedef union lines_map_slot { lines_LUT node; void *next_free; } lines_map_slot;
+typedef union macro_slot { macro node; void *next_free; } macro_slot;
+
+
+static data_slot data_slots[STATIC_MAX_MEMORY_WORDS];
+static instruction_slot instruction_slots[STATIC_MAX_MEMORY_WORDS];
+static address_request_slot address_request_slots[STATIC_MAX_MEMORY_WORDS];
+static external_slot external_slots[STATIC_MAX_MEMORY_WORDS];
+static lines_map_slot lines_map_slots[STATIC_MAX_MAPPED_LINES];
+static macro_slot macro_slots[STATIC_MAX_MACROS];
+
+
+/**
+ * @struct node_pool
+ * @brief A fixed capacity pool of a single node type.
+ */
+typedef struct node_pool {
+    char *slots;                  /**< The slots array. */
+    unsigned long slot_size;      /**< Size of a single slot. */
+    unsigned long capacity;       /**< Amount of slots. */
+    unsigned long used;           /**< Slots taken at least once (the rest were never used). */
+    void *free_list;              /**< Released slots. */
+} node_pool;
+
+
+/*in the node_pool_type order*/
+static node_pool node_pools[NODE_TYPES_AMOUNT] = {
+    { (char*)data_slots, sizeof(data_slot), STATIC_MAX_MEMORY_WORDS, 0, NULL },
+    { (char*)instruction_slots, sizeof(instruction_slot), STATIC_MAX_MEMORY_WORDS, 0, NULL },
+    { (char*)address_request_slots, sizeof(address_request_slot), STATIC_MAX_MEMORY_WORDS, 0, NULL },
+    { (char*)external_slots, sizeof(external_slot), STATIC_MAX_MEMORY_WORDS, 0, NULL },
+    { (char*)lines_map_slots, sizeof(lines_map_slot), STATIC_MAX_MAPPED_LINES, 0, NULL },
+    { (char*)macro_slots, sizeof(macro_slot), STATIC_MAX_MACROS, 0, NULL }
+};
+
+
+
+
+void* alloc_node(node_pool_type type) {
+
+    node_pool *pool = &node_pools[type];
+    void *node;
+
+    /*reuse a released slot*/
+    if (pool->free_list != NULL) {
+        node = pool->free_list;
+        pool->free_list = *(void**)node;
+        return node;
+    }
+
+    /*take the next never used slot*/
+    if (pool->used == pool->capacity) {
+        print_system_error(ERROR_CODE_12);
+    }
+
+    return pool->slots + pool->slot_size * pool->used++;
+}
+
+
+void free_node(node_pool_type type, void **node_ptr) {
+
+    node_pool *pool = &node_pools[type];
+
+    if (!node_ptr || !*node_ptr) {
+        return;
+    }
+
+    /*push the slot to the free list*/
+    *(void**)*node_ptr = pool->free_list;
+    pool->free_list = *node_ptr;
+    *node_ptr = NULL;
+}
+
+
+void reset_node_pools(void) {
+    release_node_pools();
+}
+
+
+void release_node_pools(void) {
+
+    int type;
+
+    /*all the slots are free again*/
+    for (type = 0; type < NODE_TYPES_AMOUNT; type++) {
+        node_pools[type].used = 0;
+        node_pools[type].free_list = NULL;
+    }
+}
+
+
+#else
+
+
+/*in the node_pool_type order*/
+static const unsigned long node_sizes[NODE_TYPES_AMOUNT] = {
+    sizeof(struct data_mem), sizeof(struct inst_mem), sizeof(struct address_update_request),
+    sizeof(struct external), sizeof(struct lines_LUT), sizeof(struct macro)
+};
+
+static slab_cache node_caches[NODE_TYPES_AMOUNT];
+static boolean node_caches_ready = false;
+
+
+void* alloc_node(node_pool_type type) {
+
+    int i;
+
+    /*initialize the caches with the first node*/
+    if (!node_caches_ready) {
+        for (i = 0; i < NODE_TYPES_AMOUNT; i++) {
+            init_slab_cache(&node_caches[i], node_sizes[i]);
+        }
+        node_caches_ready = true;
+    }
+
+    return slab_alloc(&node_caches[type]);
+}
+
+
+void free_node(node_pool_type type, void **node_ptr) {
+    slab_free(&node_caches[type], node_ptr);
+}
+
+
+void reset_node_pools(void) {
+
+    int type;
+
+    if (!node_caches_ready) {
+        return;
+    }
+
+    for (type = 0; type < NODE_TYPES_AMOUNT; type++) {
+        slab_reset(&node_caches[type]);
+    }
+}
+
+
+void release_node_pools(void) {
+
+    int type;
+
+    if (!node_caches_ready) {
+        return;
+    }
+
+    for (type = 0; type < NODE_TYPES_AMOUNT; type++) {
+        slab_release(&node_caches[type]);
+    }
+}
+
+
+#endif
@@ -0,0 +1,302 @@
+
+#include "options.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include "config.h"
+#include "target.h"
+
+
+/**
+ * @file options.c
+ * @brief Command-line options parsing.
+ *
+ * Separates the assembler flags from the source file names.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*legacy debug word, accepted only as the last argument*/
+#define DEBUG_ARGUMENT "debug"
+
+/*flag prefix*/
+#define OPTION_PREFIX "--"
+
+
+/*flags*/
+#define SERVE_OPTION "--serve"
+#define CONNECT_OPTION "--connect"
+#define WORKERS_OPTION "--workers"
+#define WATCH_OPTION "--watch"
+#define LSP_OPTION "--lsp"
+#define XREF_OPTION "--xref"
+#define LISTING_OPTION "--listing"
+#define SIZE_REPORT_OPTION "--size-report"
+#define POOL_DATA_OPTION "--pool-data"
+#define OUTLINE_MACROS_OPTION "--outline-macros"
+#define PEEPHOLE_OPTION "--peephole"
+#define PEEPHOLE_VERIFY_OPTION "--peephole-verify"
+#define TARGET_OPTION "--target"
+#define RELAXED_OPTION "--relaxed"
+#define STATS_OPTION "--stats"
+#define ONE_PASS_OPTION "--one-pass"
+#define MACRO_PRELUDE_OPTION "--macro-prelude"
+
+/*separates a flag from its value ("--flag=value")*/
+#define OPTION_VALUE_SEPARATOR '='
+
+/*longest numeric flag value*/
+#define MAX_OPTION_NUMBER_DIGITS 4
+
+
+
+/**
+ * @brief Parse the non-negative decimal value of a flag.
+ *
+ * @param str       The value string (after the '=').
+ * @param value_out [out] The parsed value.
+ * @return true if the whole string is a valid number.
+ */
+static boolean parse_option_number(const char *str, int *value_out);
+
+
+
+void init_options(assembler_options *options) {
+
+    if (!options) return;
+
+    options->debug = false;
+    options->serve = false;
+    options->serve_socket = NULL;
+    options->serve_workers = 1;
+    options->watch = false;
+    options->lsp = false;
+    options->xref = false;
+    options->listing = false;
+    options->size_report = false;
+    options->pool_data = false;
+    options->outline_macros = false;
+    options->outline_threshold = OUTLINE_DEFAULT_THRESHOLD;
+    options->peephole = false;
+    options->peephole_verify = false;
+    options->target = get_default_target();
+    options->relaxed_limits = false;
+    options->stats = false;
+    options->one_pass = false;
+    options->macro_prelude = NULL;
+    options->reuse_unchanged = false;
+    options->inline_sources = NULL;
+    options->inline_sources_amount = 0;
+}
+
+
+boolean parse_options(int argc, char *argv[], assembler_options *options_out, int *files_out) {
+
+    int i;
+    int files = 0;
+
+    /*verify that all input pointers exist*/
+    if (!argv || !options_out || !files_out) {
+        return false;
+    }
+
+    init_options(options_out);
+
+    /*- - - for debug mode - - -*/
+    if (argc > 1 && strcmp(argv[argc-1], DEBUG_ARGUMENT) == 0) {
+        argc--;
+        options_out->debug = true;
+    }
+
+    /*iterate through the arguments, move the files to the front of the array*/
+    for (i = 1; i < argc; i++) {
+
+        /*not a flag, keep it as source file name*/
+        if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) != 0) {
+            argv[++files] = argv[i];
+            continue;
+        }
+
+        /*set the option that matches the flag*/
+        if (strcmp(argv[i], SERVE_OPTION) == 0) {
+            options_out->serve = true;
+        }
+        else if (strncmp(argv[i], SERVE_OPTION, strlen(SERVE_OPTION)) == 0 &&
+                 argv[i][strlen(SERVE_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            options_out->serve = true;
+            options_out->serve_socket = argv[i] + strlen(SERVE_OPTION) + 1;
+            if (options_out->serve_socket[0] == '\0') {
+                printf("ERROR: Missing socket in option <%s>.\n", argv[i]);
+                return false;
+            }
+        }
+        else if (strncmp(argv[i], WORKERS_OPTION, strlen(WORKERS_OPTION)) == 0 &&
+                 argv[i][strlen(WORKERS_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            if (!parse_option_number(argv[i] + strlen(WORKERS_OPTION) + 1, &options_out->serve_workers) ||
+                options_out->serve_workers < 1 || options_out->serve_workers > SERVER_MAX_WORKERS) {
+                printf("ERROR: Invalid value in option <%s>, expected a number between 1 and %d.\n", argv[i], SERVER_MAX_WORKERS);
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], WATCH_OPTION) == 0) {
+            options_out->watch = true;
+        }
+        else if (strcmp(argv[i], LSP_OPTION) == 0) {
+            options_out->lsp = true;
+        }
+        else if (strcmp(argv[i], XREF_OPTION) == 0) {
+            options_out->xref = true;
+        }
+        else if (strcmp(argv[i], LISTING_OPTION) == 0) {
+            options_out->listing = true;
+        }
+        else if (strcmp(argv[i], SIZE_REPORT_OPTION) == 0) {
+            options_out->size_report = true;
+        }
+        else if (strcmp(argv[i], POOL_DATA_OPTION) == 0) {
+            options_out->pool_data = true;
+        }
+        else if (strcmp(argv[i], OUTLINE_MACROS_OPTION) == 0) {
+            options_out->outline_macros = true;
+        }
+        else if (strncmp(argv[i], OUTLINE_MACROS_OPTION, strlen(OUTLINE_MACROS_OPTION)) == 0 &&
+                 argv[i][strlen(OUTLINE_MACROS_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            if (!parse_option_number(argv[i] + strlen(OUTLINE_MACROS_OPTION) + 1, &options_out->outline_threshold)) {
+                printf("ERROR: Invalid value in option <%s>, expected a non-negative number.\n", argv[i]);
+                return false;
+            }
+            options_out->outline_macros = true;
+        }
+        else if (strcmp(argv[i], PEEPHOLE_OPTION) == 0) {
+            options_out->peephole = true;
+        }
+        else if (strcmp(argv[i], PEEPHOLE_VERIFY_OPTION) == 0) {
+            options_out->peephole = true;
+            options_out->peephole_verify = true;
+        }
+        else if (strncmp(argv[i], TARGET_OPTION, strlen(TARGET_OPTION)) == 0 &&
+                 argv[i][strlen(TARGET_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            options_out->target = get_target_profile(argv[i] + strlen(TARGET_OPTION) + 1);
+            if (!options_out->target) {
+                printf("ERROR: Unknown target in option <%s>, available targets: ", argv[i]);
+                print_target_names();
+                printf(".\n");
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], RELAXED_OPTION) == 0) {
+            options_out->relaxed_limits = true;
+        }
+        else if (strcmp(argv[i], STATS_OPTION) == 0) {
+            options_out->stats = true;
+        }
+        else if (strcmp(argv[i], ONE_PASS_OPTION) == 0) {
+            options_out->one_pass = true;
+        }
+        else if (strncmp(argv[i], MACRO_PRELUDE_OPTION, strlen(MACRO_PRELUDE_OPTION)) == 0 &&
+                 argv[i][strlen(MACRO_PRELUDE_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            options_out->macro_prelude = argv[i] + strlen(MACRO_PRELUDE_OPTION) + 1;
+            if (options_out->macro_prelude[0] == '\0') {
+                printf("ERROR: Missing file in option <%s>.\n", argv[i]);
+                return false;
+            }
+        }
+        else {
+            printf("ERROR: Unknown option <%s>.\n", argv[i]);
+            return false;
+        }
+    }
+
+    /*the single pass makes no address update requests, which these options read*/
+    if (options_out->one_pass && (options_out->xref || options_out->listing || options_out->pool_data || options_out->peephole)) {
+        printf("ERROR: %s can't be combined with %s, %s, %s or %s.\n", ONE_PASS_OPTION,
+               XREF_OPTION, LISTING_OPTION, POOL_DATA_OPTION, PEEPHOLE_OPTION);
+        return false;
+    }
+
+    /*the workers share the listening socket, the standard input has a single reader*/
+    if (options_out->serve_workers > 1 && !options_out->serve_socket) {
+        printf("ERROR: %s can be used only with %s=<socket>.\n", WORKERS_OPTION, SERVE_OPTION);
+        return false;
+    }
+
+    *files_out = files;
+    return true;
+}
+
+
+int find_connect_option(int argc, char *argv[]) {
+
+    int i;
+
+    if (!argv) return 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], CONNECT_OPTION, strlen(CONNECT_OPTION)) == 0 &&
+            argv[i][strlen(CONNECT_OPTION)] == OPTION_VALUE_SEPARATOR) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+
+const char* get_connect_socket(const char *argument) {
+
+    return argument + strlen(CONNECT_OPTION) + 1;
+}
+
+
+const char* find_inline_source(const assembler_options *options, const char *source_file) {
+
+    int i;
+
+    if (!options || !source_file) return NULL;
+
+    for (i = 0; i < options->inline_sources_amount; i++) {
+        if (strcmp(options->inline_sources[i].name, source_file) == 0) {
+            return options->inline_sources[i].text;
+        }
+    }
+
+    return NULL;
+}
+
+
+boolean is_same_output_options(const assembler_options *options1, const assembler_options *options2) {
+
+    if (!options1 || !options2) {
+        return false;
+    }
+
+    return options1->xref == options2->xref &&
+           options1->listing == options2->listing &&
+           options1->pool_data == options2->pool_data &&
+           options1->outline_macros == options2->outline_macros &&
+           (!options1->outline_macros || options1->outline_threshold == options2->outline_threshold) &&
+           options1->peephole == options2->peephole &&
+           options1->target == options2->target &&
+           options1->relaxed_limits == options2->relaxed_limits;
+}
+
+
+static boolean parse_option_number(const char *str, int *value_out) {
+
+    int i;
+
+    if (str[0] == '\0' || strlen(str) > MAX_OPTION_NUMBER_DIGITS) {
+        return false;
+    }
+
+    for (i = 0; str[i] != '\0'; i++) {
+        if (!isdigit((unsigned char)str[i])) {
+            return false;
+        }
+    }
+
+    *value_out = atoi(str);
+    return true;
+}
@@ -0,0 +1,373 @@
+
+#include "peephole.h"
+#include <stdio.h>
+#include "addresses.h"
+#include "errors.h"
+#include "instruction_memory.h"
+#include "instructions.h"
+#include "labels.h"
+#include "simulator.h"
+#include "node_pool.h"
+#include "sys_memory.h"
+#include "tables.h"
+#include "target.h"
+
+
+/**
+ * @file peephole.c
+ * @brief Peephole optimizer of the encoded instructions ("--peephole").
+ *
+ * The instruction memory is decoded into an instructions array (the words
+ * of every instruction are consecutive). The removable instructions are
+ * marked, and then the instruction memory, the address update requests and
+ * the code labels are updated in a single walk each.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*instruction without the operand*/
+#define NO_MODE (-1)
+
+
+/**
+ * @struct peephole_instruction
+ * @brief A decoded instruction of the instruction memory.
+ */
+typedef struct peephole_instruction {
+    instruction_ptr first;     /**< First word of the instruction. */
+    unsigned int address;      /**< Instruction address (before the optimization). */
+    unsigned int length;       /**< Amount of words. */
+    unsigned int shift;        /**< Words removed before the instruction. */
+    int opcode;                /**< Opcode number. */
+    int src_mode;              /**< Source addressing mode, or NO_MODE. */
+    int dest_mode;             /**< Destination addressing mode, or NO_MODE. */
+    int jump_label;            /**< Target label of a "jmp" to a label, or NO_LABEL. */
+    boolean removed;           /**< The instruction is removed. */
+} peephole_instruction;
+
+
+/**
+ * @brief Decode the instruction memory into an instructions array.
+ *
+ * @return Amount of instructions (the array is allocated, NULL if none).
+ */
+static int decode_instructions(const assembler_context *asmContext, peephole_instruction **instructions_out);
+
+
+/**
+ * @brief Check if an instruction has no effect (not including jumps).
+ */
+static boolean is_no_effect_instruction(const peephole_instruction *instruction);
+
+
+/**
+ * @brief Set the target label of every "jmp" to a label.
+ *
+ * The address update requests and the instructions are both ordered by
+ * address, so they are walked together once.
+ */
+static void find_jump_labels(const assembler_context *asmContext, peephole_instruction instructions[], int amount);
+
+
+/**
+ * @brief Check if a "jmp" jumps to the next executed instruction.
+ *
+ * @param index The jump index in the instructions array.
+ */
+static boolean is_jump_to_next(const peephole_instruction instructions[], int amount, int index, const assembler_context *asmContext);
+
+
+/**
+ * @brief Remove the marked instructions and move the addresses back.
+ *
+ * @return Amount of words removed.
+ */
+static unsigned int remove_instructions(assembler_context *asmContext, peephole_instruction instructions[], int amount);
+
+
+
+
+boolean run_peephole(assembler_context *asmContext, boolean verify) {
+
+    peephole_instruction *instructions = NULL;
+    sim_result before;
+    sim_result after;
+    unsigned int saved;
+    int amount;
+    int removed = 0;
+    int i;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25, "run_peephole");
+        return false;
+    }
+
+    if (verify) {
+        simulate_program(asmContext, &before);
+    }
+
+    amount = decode_instructions(asmContext, &instructions);
+
+    for (i = 0; i < amount; i++) {
+        if (is_no_effect_instruction(&instructions[i])) {
+            instructions[i].removed = true;
+            removed++;
+        }
+    }
+
+    find_jump_labels(asmContext, instructions, amount);
+
+    /*from the end, so a chain of jumps to the next instruction is removed*/
+    for (i = amount - 1; i >= 0; i--) {
+        if (!instructions[i].removed && is_jump_to_next(instructions, amount, i, asmContext)) {
+            instructions[i].removed = true;
+            removed++;
+        }
+    }
+
+    saved = (removed > 0) ? remove_instructions(asmContext, instructions, amount) : 0;
+    safe_free((void**)&instructions);
+
+    printf("Peephole: %d instruction(s) removed, %u word(s) saved.\n\n", removed, saved);
+
+    if (!verify) {
+        return true;
+    }
+
+    simulate_program(asmContext, &after);
+
+    if (before.stop == SIM_STEPS_LIMIT || after.stop == SIM_STEPS_LIMIT) {
+        printf("Peephole verification: inconclusive, the program didn't stop within %d instructions.\n\n", SIMULATOR_MAX_STEPS);
+        return true;
+    }
+
+    if (!is_same_sim_result(&before, &after)) {
+        printf("ERROR: Peephole verification failed, the program results changed.\n\n");
+        return false;
+    }
+
+    printf("Peephole verification: passed (%lu instructions executed before, %lu after).\n\n", before.steps, after.steps);
+    return true;
+}
+
+
+
+
+static int decode_instructions(const assembler_context *asmContext, peephole_instruction **instructions_out) {
+
+    instruction_ptr node;
+    peephole_instruction *instructions;
+    unsigned int word;
+    int operands;
+    int amount = 0;
+    int i;
+
+    *instructions_out = NULL;
+
+    if (asmContext->instruction_memory == NULL) {
+        return 0;
+    }
+
+    /*every instruction has at least one word*/
+    instructions = (peephole_instruction*)handle_malloc(sizeof(peephole_instruction) * asmContext->IC);
+
+    node = asmContext->instruction_memory;
+    while (node != NULL) {
+
+        word = (unsigned int)node->value & asmContext->target->word_bit_mask;
+
+        instructions[amount].first = node;
+        instructions[amount].address = node->address;
+        instructions[amount].shift = 0;
+        instructions[amount].removed = false;
+        instructions[amount].jump_label = NO_LABEL;
+        instructions[amount].opcode = (int)(word >> asmContext->target->opcode_bits_shift);
+
+        operands = asmContext->opcode_table[instructions[amount].opcode].operands_amount;
+        instructions[amount].src_mode = (operands == 2) ? (int)((word & SRC_ADDR_MODE_BITS_MASK) >> SRC_ADDR_MODE_BITS_SHIFT) : NO_MODE;
+        instructions[amount].dest_mode = (operands >= 1) ? (int)((word & DEST_ADDR_MODE_BITS_MASK) >> DEST_ADDR_MODE_BITS_SHIFT) : NO_MODE;
+
+        /*opcode word, and the operands words (two registers share a word)*/
+        instructions[amount].length = 1;
+        if (instructions[amount].src_mode == REGISTER_ACCESS && instructions[amount].dest_mode == REGISTER_ACCESS) {
+            instructions[amount].length++;
+        }
+        else {
+            if (instructions[amount].src_mode != NO_MODE) instructions[amount].length += (instructions[amount].src_mode == MATRIX_ACCESS) ? 2 : 1;
+            if (instructions[amount].dest_mode != NO_MODE) instructions[amount].length += (instructions[amount].dest_mode == MATRIX_ACCESS) ? 2 : 1;
+        }
+
+        for (i = 0; i < (int)instructions[amount].length && node != NULL; i++) {
+            node = node->next;
+        }
+        amount++;
+    }
+
+    *instructions_out = instructions;
+    return amount;
+}
+
+
+static boolean is_no_effect_instruction(const peephole_instruction *instruction) {
+
+    unsigned int operand_word;
+
+    /*an instruction that updates the flags always has an effect (a later "bne" may read them),
+     *so the additions of zero (add #0, sub #0) are kept*/
+    if (get_opcode_effects(instruction->opcode) & WRITES_FLAGS) {
+        return false;
+    }
+
+    switch (instruction->opcode) {
+
+        /*mov rX, rX*/
+        case MOV_OPCODE: {
+            if (instruction->src_mode != REGISTER_ACCESS || instruction->dest_mode != REGISTER_ACCESS) {
+                return false;
+            }
+            operand_word = (unsigned int)instruction->first->next->value;
+            return ((operand_word & OPERAND_DATA_SRC_REG_MASK) >> OPERAND_DATA_SRC_REG_SHIFT) ==
+                   ((operand_word & OPERAND_DATA_DEST_REG_MASK) >> OPERAND_DATA_DEST_REG_SHIFT);
+        }
+
+        default:
+            return false;
+    }
+}
+
+
+static void find_jump_labels(const assembler_context *asmContext, peephole_instruction instructions[], int amount) {
+
+    address_update_request_ptr request = asmContext->address_update_requests;
+    int index;
+
+    for (index = 0; index < amount; index++) {
+
+        if (instructions[index].opcode != JMP_OPCODE || instructions[index].dest_mode != DIRECT_ACCESS) {
+            continue;
+        }
+
+        /*the request of the jump operand word (the requests before it belong to the previous instructions)*/
+        while (request && request->address < instructions[index].address + 1) {
+            request = request->next;
+        }
+        if (request && request->address == instructions[index].address + 1 && request->operand->type == DIRECT_ACCESS) {
+            instructions[index].jump_label = find_label(request->operand->operand_val.label, asmContext->labels);
+        }
+    }
+}
+
+
+static boolean is_jump_to_next(const peephole_instruction instructions[], int amount, int index, const assembler_context *asmContext) {
+
+    symbol_table_ptr labels = asmContext->labels;
+    unsigned int target_address;
+    int label = instructions[index].jump_label;
+    int next;
+
+    /*the jump target label*/
+    if (label == NO_LABEL || labels->definitions[label] != NORMAL || labels->types[label] != CODE) {
+        return false;
+    }
+    target_address = labels->addresses[label];
+
+    /*all the instructions up to the target are removed*/
+    for (next = index + 1; next < amount && instructions[next].address < target_address; next++) {
+        if (!instructions[next].removed) {
+            return false;
+        }
+    }
+
+    return (next < amount) ? instructions[next].address == target_address : target_address == asmContext->IC;
+}
+
+
+static unsigned int remove_instructions(assembler_context *asmContext, peephole_instruction instructions[], int amount) {
+
+    instruction_ptr node = asmContext->instruction_memory;
+    instruction_ptr prev = NULL;
+    instruction_ptr temp;
+    address_update_request_ptr request = asmContext->address_update_requests;
+    address_update_request_ptr prev_request = NULL;
+    address_update_request_ptr temp_request;
+    symbol_table_ptr labels = asmContext->labels;
+    unsigned int *word_shifts;
+    unsigned int base = instructions[0].address;
+    unsigned int words = asmContext->IC - base;
+    int label;
+    unsigned int removed_words = 0;
+    unsigned int i;
+    int index;
+
+    /*words removed before every word address of the code (and the end of the code)*/
+    word_shifts = (unsigned int*)handle_malloc(sizeof(unsigned int) * (words + 1));
+
+    /*- - - instruction memory - - -*/
+    for (index = 0; index < amount; index++) {
+
+        instructions[index].shift = removed_words;
+
+        for (i = 0; i < instructions[index].length && node != NULL; i++) {
+            if (node->address >= base && node->address < base + words) {
+                word_shifts[node->address - base] = removed_words;
+            }
+            if (instructions[index].removed) {
+                temp = node;
+                node = node->next;
+                if (prev) prev->next = node;
+                else asmContext->instruction_memory = node;
+                free_node(INSTRUCTION_NODE, (void**)&temp);
+            }
+            else {
+                node->address -= removed_words;
+                prev = node;
+                node = node->next;
+            }
+        }
+
+        if (instructions[index].removed) {
+            removed_words += instructions[index].length;
+        }
+    }
+    word_shifts[words] = removed_words;
+
+    /*- - - address update requests (ordered by address) - - -*/
+    index = 0;
+    while (request != NULL) {
+
+        while (index < amount && request->address >= instructions[index].address + instructions[index].length) {
+            index++;
+        }
+
+        if (index < amount && instructions[index].removed) {
+            temp_request = request;
+            request = request->next;
+            if (prev_request) prev_request->next = request;
+            else asmContext->address_update_requests = request;
+            free_operand(&temp_request->operand);
+            free_node(ADDRESS_REQUEST_NODE, (void**)&temp_request);
+            continue;
+        }
+
+        request->address -= (index < amount) ? instructions[index].shift : removed_words;
+        prev_request = request;
+        request = request->next;
+    }
+
+    /*- - - code labels (a label of a removed instruction moves to the next one) - - -*/
+    for (label = 0; label < labels_amount(labels); label++) {
+        if (labels->types[label] != CODE || labels->definitions[label] != NORMAL) continue;
+
+        if (labels->addresses[label] >= base && labels->addresses[label] <= base + words) {
+            labels->addresses[label] -= word_shifts[labels->addresses[label] - base];
+        }
+    }
+    safe_free((void**)&word_shifts);
+
+    asmContext->IC -= removed_words;
+    asmContext->memory_usage -= removed_words;
+
+    return removed_words;
+}
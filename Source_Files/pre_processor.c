@@ -7,7 +7,10 @@
 #include "files.h"
 #include "boolean.h"
 #include "errors.h"
+#include "intern_pool.h"
 #include "lines_map.h"
+#include "macro_outline.h"
+#include "node_pool.h"
 #include "sys_memory.h"
 
 /**
@@ -25,19 +28,58 @@
  * The preprocessor ensures that the assembler only receives pure assembly code,
  * with no macro directives, simplifying the parsing and encoding process.
  *
+ * The source is expanded in order on a single thread: a line is a macro call
+ * only if its macro was defined on an earlier line, so a line depends on the
+ * macro table of all the lines before it.
+ *
  *
  * @author Ivgeny Tokarzhevsky
  * @date 01/09/2025
  */
 
+
+/*the separators of the preprocessor tokens*/
+#define PP_TOKEN_SEPARATORS " \t\n"
+
+
+/**
+ * @brief Get the next token of a line without changing the line.
+ *
+ * The tokens are separated like strtok(line, PP_TOKEN_SEPARATORS) does, but the
+ * line isn't copied or terminated, so the line classification allocates nothing.
+ *
+ * @param cursor Address of the scan position (moved to the end of the token).
+ * @param length Out: length of the token (may be NULL).
+ * @return The token start, or NULL if no more tokens.
+ */
+static const char *next_line_token(const char **cursor, unsigned long *length);
+
+
+/**
+ * @brief Check if a token (not null terminated) equals a word.
+ */
+static boolean is_token(const char *token, unsigned long length, const char *word);
+
+
+/**
+ * @brief Read the next line of a source (a file or a text).
+ *
+ * @param source The source.
+ * @param line   [out] The line buffer.
+ * @return false at the end of the source.
+ */
+static boolean read_source_line(source_reader *source, text_buffer *line);
+
+
 boolean execute_preprocessor(assembler_context* asmContext) {
-    FILE* as_file;
-    char line[MAX_LINE_LEN+2];/*+2 to cath line bigger then maximum allowed size*/
+    FILE* as_file = NULL;
+    source_reader source;
+    text_buffer *line;/*the current line (any length, the first pass checks the length limit)*/
     char *macro_name = NULL;
-    char* am_file_content = NULL;
+    text_buffer *am_file_content;/*the whole .am file content*/
     char *macro_content = NULL;
     macro_ptr macro;
-    char* tmp = NULL;
+    lines_map_ptr last_map_line = NULL;/*end of the lines map (the lines are appended in order)*/
     int origin_line_num =0;/*.as file line, used to build the line LUT*/
     int new_line_num = 0;/*.a file line, used to build the line LUT*/
     int macro_lines_count = 0;/*number of lines of macro content*/
@@ -54,30 +96,34 @@ boolean execute_preprocessor(assembler_context* asmContext) {
 
 
 
-    /*allocate initial memory for file content buff*/
-    am_file_content = handle_malloc(1);
+    /*the line and the file content buffers of the context (empty, kept between the files)*/
+    line = &asmContext->line_buffer;
+    am_file_content = &asmContext->am_buffer;
+    clear_text_buffer(am_file_content);
 
-    /*set '\0' at index 0 to not access unknown memory while using string functions*/
-    am_file_content[0] = '\0';
-
-    /* open the .as  file*/
-    if ((as_file = open_file(asmContext->as_full_file_name, READ)) == NULL) {
+    /* open the .as  file (an analyzed document is read from memory)*/
+    if (asmContext->source_text == NULL && (as_file = open_file(asmContext->as_full_file_name, READ)) == NULL) {
         goto cleanUp;
 
     }
+    source.file = as_file;
+    source.text.data = (char*)asmContext->source_text;
+    source.text.length = asmContext->source_text ? strlen(asmContext->source_text) : 0;
+    source.text.capacity = source.text.length + 1;
+    source.position = 0;
 
     /*read a line from file and search for macros*/
-    while (fgets(line, MAX_LINE_LEN, as_file)) {
+    while (read_source_line(&source, line)) {
         /*calculate the line numbers for lines_map*/
         asmContext->as_file_line++;
         new_line_num++;
         origin_line_num ++;
 
         /*check if the line contains start of macro declare*/
-        if ((macro_name = is_start_of_macro(line, asmContext)) != NULL) {
+        if ((macro_name = is_start_of_macro(line->data, asmContext)) != NULL) {
 
             /*check if macro_already_exist*/
-            if (!is_name_valid(macro_name)) {
+            if (!is_name_valid(macro_name, asmContext)) {
                 print_external_error(ERROR_CODE_148);
             }
 
@@ -87,14 +133,15 @@ boolean execute_preprocessor(assembler_context* asmContext) {
             }
 
             /*macro  exists get the macro content*/
-            if (!read_macro_content(as_file, &macro_content, &macro_lines_count, asmContext)) {
+            if (!read_macro_content(&source, &macro_content, &macro_lines_count, asmContext)) {
                 goto cleanUp;
             }
 
-            /*add the macro to list*/
-            if (!add_macro( macro_name, macro_content, macro_lines_count, &asmContext->macros, asmContext->as_file_line-macro_lines_count)) {
+            /*add the macro to list (the name is kept in the names pool)*/
+            if (!add_macro(intern_name(asmContext->names, macro_name), macro_content, macro_lines_count, &asmContext->macros, asmContext->as_file_line-macro_lines_count)) {
                 goto cleanUp;
             }
+            safe_free((void**)&macro_name);
 
             /*jump over the macro*/
             origin_line_num += macro_lines_count ;
@@ -112,18 +159,10 @@ boolean execute_preprocessor(assembler_context* asmContext) {
 
 
         /*if it's a macro call, find the content of the macro and add it to a temp buff*/
-        else if ((macro = is_macro_call(line, asmContext->macros, asmContext)) != NULL) {
+        else if ((macro = is_macro_call(line->data, asmContext)) != NULL) {
 
-            /*reallocate memory for the line*/
-            tmp = handle_realloc(am_file_content, strlen(am_file_content)+1 +strlen(get_macro(macro->name, asmContext->macros)->content) + 1);
-            if (!tmp) {
-                goto cleanUp;
-            }
-            else {
-                am_file_content = tmp;
-            }
             /*add the macro content to the whole file content*/
-            strcat(am_file_content,get_macro(macro->name,asmContext->macros)->content);
+            append_text(am_file_content, macro->content, strlen(macro->content));
 
 
 
@@ -131,13 +170,15 @@ boolean execute_preprocessor(assembler_context* asmContext) {
              * so when an error found in macro body, the error will print the num of the
              * invalid line that defined inside the macro declaration and not the line where
              * the macro called, because the issue is in macro content and not in the macro call.
+             * The lines of a prelude macro are not in this file, so they are mapped to the call line.
              */
             i=1;
-            macro_line = macro->define_line+1;
+            macro_line = macro->prelude ? origin_line_num : macro->define_line+1;
             while (i < macro->lines) {
-                add_lines_to_map(macro_line, new_line_num, &asmContext->lines_maper);
+                add_lines_to_map(macro_line, new_line_num, origin_line_num, &asmContext->lines_maper, &last_map_line);
 
-                new_line_num++; i++; macro_line++;
+                new_line_num++; i++;
+                if (!macro->prelude) macro_line++;
 
             }
             new_line_num--;
@@ -145,16 +186,9 @@ boolean execute_preprocessor(assembler_context* asmContext) {
         }
 
         else {/*the line is not a macro , print the original line from .as file .*/
-            tmp = handle_realloc(am_file_content, strlen(line) + 1 + strlen(am_file_content)+1);
-            if (!tmp) {
-                goto cleanUp;
-            }
-            else {
-                am_file_content = tmp;
-            }
-            /*add the line to the temp buffer*/
-            strcat(am_file_content,line);
-            add_lines_to_map(origin_line_num, new_line_num, &asmContext->lines_maper);
+            /*add the line to the file content*/
+            append_text(am_file_content, line->data, line->length);
+            add_lines_to_map(origin_line_num, new_line_num, 0, &asmContext->lines_maper, &last_map_line);
         }
 
 
@@ -166,13 +200,18 @@ boolean execute_preprocessor(assembler_context* asmContext) {
 
     /* create am file and return true if errors not found*/
     if (!asmContext->preproc_error) {
-        /*create am_file and write to am file content*/
-        if (!create_file(asmContext->am_full_file_name,am_file_content, asmContext)) {
+
+        /*replace the repeated macro expansions with subroutine calls (if requested)*/
+        if (asmContext->outline_macros && !outline_macros(asmContext, am_file_content)) {
+            goto cleanUp;
+        }
+
+        /*create am_file and write to am file content (not when the file is only analyzed)*/
+        if (asmContext->write_am_file && !create_file(asmContext->am_full_file_name,am_file_content->data, asmContext)) {
             goto cleanUp;
         }
 
-        safe_free((void**)&am_file_content);/*free allocated temp memory*/
-        fclose(as_file);/*close the file*/
+        if (as_file) fclose(as_file);/*close the file*/
 
         return true;
     }
@@ -183,25 +222,133 @@ boolean execute_preprocessor(assembler_context* asmContext) {
 cleanUp:
     /*turn on pre-processing stage error flag*/
     asmContext->preproc_error = true;
-    fclose(as_file);/*close the file*/
-    safe_free((void**)&am_file_content);/*free allocated temp memory*/
+    if (as_file) fclose(as_file);/*close the file*/
     return false;
 }
 
 
-boolean add_macro(char *name, char *content, int lines_amount, macro_ptr *macro_list, int define_line) {
+boolean load_macro_prelude(assembler_context *asmContext, const char *prelude_file) {
+    FILE *prelude = NULL;
+    source_reader source;
+    text_buffer *line;/*the current line*/
+    const char *cursor;
+    const char *token;
+    unsigned long token_length;
+    char *macro_name = NULL;
+    char *macro_content = NULL;
+    int macro_lines_count = 0;
+    macro_ptr macro;
+    macro_ptr last_macro = NULL;/*end of the prelude macros (the macros are appended in order)*/
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !prelude_file) {
+        print_internal_error(ERROR_CODE_25,"load_macro_prelude");
+        return false;
+    }
+
+    /*the errors are printed with the prelude name and lines*/
+    asmContext->as_file_name = copy_string(prelude_file);
+    asmContext->as_file_line = 0;
+    line = &asmContext->line_buffer;
+
+    /*open the prelude file*/
+    if ((prelude = open_file(prelude_file, READ)) == NULL) {
+        asmContext->preproc_error = true;
+        goto cleanUp;
+    }
+
+    source.file = prelude;
+    source.position = 0;
+
+    /*read the macro definitions*/
+    while (read_source_line(&source, line)) {
+        asmContext->as_file_line++;
+
+        /*skip the comments and the empty lines*/
+        if (is_comment_or_empty_line(line->data)) {
+            continue;
+        }
+
+        /*only macro declarations (a mcroend line is reported by is_start_of_macro)*/
+        cursor = line->data;
+        token = next_line_token(&cursor, &token_length);
+        if (!is_token(token, token_length, asmContext->macro_declaration_table[MACRO_START]) &&
+            !is_token(token, token_length, asmContext->macro_declaration_table[MACRO_END])) {
+            print_external_error(ERROR_CODE_184);
+            asmContext->preproc_error = true;
+            continue;
+        }
+
+        if ((macro_name = is_start_of_macro(line->data, asmContext)) == NULL) {
+            continue;
+        }
+
+        /*verify the macro name, like in a source file*/
+        if (!is_name_valid(macro_name, asmContext)) {
+            print_external_error(ERROR_CODE_148);
+            asmContext->preproc_error = true;
+        }
+        if (!can_add_name(macro_name,asmContext)) {
+            print_external_error(ERROR_CODE_147);
+            asmContext->preproc_error = true;
+        }
+
+        /*get the macro content*/
+        if (!read_macro_content(&source, &macro_content, &macro_lines_count, asmContext)) {
+            goto cleanUp;
+        }
+
+        /*add the macro to the prelude macros (kept until the end of the batch, not in the nodes pool)*/
+        macro = (macro_ptr)handle_malloc(sizeof(struct macro));
+        retain_allocation(macro);
+        retain_allocation(macro_content);
+        macro->name = intern_name(asmContext->names, macro_name);
+        macro->content = macro_content;
+        macro->lines = macro_lines_count;
+        macro->define_line = asmContext->as_file_line - macro_lines_count;
+        macro->prelude = true;
+        macro->next = NULL;
+
+        if (last_macro == NULL) {
+            asmContext->prelude_macros = macro;
+        }
+        else {
+            last_macro->next = macro;
+        }
+        last_macro = macro;
+        safe_free((void**)&macro_name);
+    }
+
+    cleanUp:
+    if (prelude) fclose(prelude);/*close the file*/
+    safe_free((void**)&macro_name);
+    safe_free((void**)&asmContext->as_file_name);
+    asmContext->as_file_line = 0;
+
+    if (asmContext->preproc_error) {
+        return false;
+    }
+
+    /*the prelude names get the same ids in every file of the batch*/
+    keep_intern_names(asmContext->names);
+
+    return true;
+}
+
+
+boolean add_macro(name_id name, char *content, int lines_amount, macro_ptr *macro_list, int define_line) {
 
     macro_ptr temp = NULL;
     macro_ptr p1 = NULL;
 
     /*verify that all input pointer exist*/
-    if (!name || !content ) {
+    if (name == NO_NAME_ID || !content ) {
         print_internal_error(ERROR_CODE_25,"add_macro");
         return false;
     }
 
     /*allocate memory for new node*/
-    temp = (macro_ptr)handle_malloc(sizeof(macro));
+    temp = (macro_ptr)alloc_node(MACRO_NODE);
 
 
     /*fill the new node values*/
@@ -209,6 +356,7 @@ boolean add_macro(char *name, char *content, int lines_amount, macro_ptr *macro_
     temp->content = content;
     temp->lines = lines_amount;
     temp->define_line = define_line;
+    temp->prelude = false;
     temp->next = NULL;
 
     /*add the node at the end of the list*/
@@ -227,11 +375,11 @@ boolean add_macro(char *name, char *content, int lines_amount, macro_ptr *macro_
     return true;
 }
 
-void print_macro_names(macro_ptr macro_list) {
+void print_macro_names(macro_ptr macro_list, const intern_pool *names) {
 
 /*print the macro name and the macro content*/
     while (macro_list != NULL) {
-        printf("macro name :%s\n", macro_list->name);
+        printf("macro name :%s\n", get_name(names, macro_list->name));
         printf("macro content :%s\n", macro_list->content);
         macro_list = macro_list->next;
     }
@@ -246,62 +394,57 @@ void free_macro_list(macro_ptr *macro_list) {
         temp = *macro_list;
         *macro_list = (*macro_list)->next;
 
-        safe_free((void**)&temp->name);
         safe_free((void**)&temp->content);
-        safe_free((void**)&temp);
+        free_node(MACRO_NODE, (void**)&temp);
     }
 }
 
 
 char *is_start_of_macro(char *line, assembler_context *asmContext) {
 
-    char *temp_line = NULL;
-    char *token = NULL;
+    const char *cursor = line;
+    const char *token = NULL;
+    unsigned long token_length;
     char *macro_name = NULL;
 
     /*verify the line pointer is not NULL*/
     if (!line) {print_internal_error(ERROR_CODE_25, "is_start_of_macro"); return NULL;}
 
-    /*copy the line to not change the original one*/
-    temp_line = copy_string(line);
-
 
     /*get the first token and check if the token is maco definition command (mcro)*/
-    token = strtok(temp_line, " \t\n");
-    if (token == NULL || strcmp(token, asmContext->macro_declaration_table[MACRO_START]) != 0) {
-        if (token != NULL && strcmp(token, asmContext->macro_declaration_table[MACRO_END]) == 0){
+    token = next_line_token(&cursor, &token_length);
+    if (token == NULL || !is_token(token, token_length, asmContext->macro_declaration_table[MACRO_START])) {
+        if (token != NULL && is_token(token, token_length, asmContext->macro_declaration_table[MACRO_END])){
             /*mcroend found without macro declaration before*/
             print_external_error(ERROR_CODE_177);
             /*update the error flag because function return NULL*/
             asmContext->preproc_error = true;}
-        safe_free((void**)&temp_line);
         return NULL;
     }
 
     /*if the previous token is macro definition command,
      *the current token should be the macro name*/
-    token = strtok(NULL, " \t\n");
+    token = next_line_token(&cursor, &token_length);
     if (token == NULL) {
         print_external_error(ERROR_CODE_176);
         asmContext->preproc_error = true;
-        safe_free((void**)&temp_line);
         return NULL;
     }
 
     /*verify that line ends after macro name and that there is no unnecessary tokens*/
-    if (strtok(NULL, " \t\n") != NULL) {
-        safe_free((void**)&temp_line);
+    if (next_line_token(&cursor, NULL) != NULL) {
         print_external_error(ERROR_CODE_149);
         asmContext->preproc_error = true;
         return NULL;
     }
 
    /*copy the found macro name */
-    macro_name = copy_string(token);
+    macro_name = (char*)handle_malloc(token_length + 1);
+    memcpy(macro_name, token, token_length);
+    macro_name[token_length] = '\0';
 
 
     /*return macro name if found*/
-    safe_free((void**)&temp_line);
     return macro_name;
 }
 
@@ -309,17 +452,19 @@ char *is_start_of_macro(char *line, assembler_context *asmContext) {
 
 
 boolean is_end_of_macro(char *line, assembler_context *asmContext) {
-    char *token = NULL;
+    const char *cursor = line;
+    const char *token = NULL;
+    unsigned long token_length;
 
     /*verify all input pointers exist*/
     if (!line){print_internal_error(ERROR_CODE_25, "is_end_of_macro"); return false;}
 
     /*get the first token and check if the token is a macro end command*/
-    token = strtok(line, " \t \n");
-    if (token != NULL && strcmp(token, asmContext->macro_declaration_table[MACRO_END]) == 0) {
+    token = next_line_token(&cursor, &token_length);
+    if (token != NULL && is_token(token, token_length, asmContext->macro_declaration_table[MACRO_END])) {
 
         /*verify that the line ends after macro end command and there is no unnecessary tokens*/
-        if ( strtok(NULL,"\n\t ") == NULL )
+        if (next_line_token(&cursor, NULL) == NULL )
             return true;
         else {
             print_external_error(ERROR_CODE_150);
@@ -331,44 +476,38 @@ boolean is_end_of_macro(char *line, assembler_context *asmContext) {
 }
 
 
-boolean read_macro_content(FILE *fp_in, char** content_out, int *lines_count_out, assembler_context *asmContext) {
-char temp_line[MAX_LINE_LEN + 2];
-    char safe_line[MAX_LINE_LEN + 2];
-    char *macro_content;
-    unsigned long len;
+boolean read_macro_content(source_reader *source, char** content_out, int *lines_count_out, assembler_context *asmContext) {
+    text_buffer *temp_line;/*the current line*/
+    text_buffer macro_content;
     int lines_count = 0;
-    char *temp = NULL;
 
     /*verify that all input pointers exist*/
-    if (!content_out || !lines_count_out || !fp_in ) {
+    if (!content_out || !lines_count_out || !source ) {
         print_internal_error(ERROR_CODE_25, "read_macro_content");
         return false;
     }
 
-    /*allocate memory for macro content line*/
-    macro_content = handle_malloc(sizeof(char));
-
-    /*set '\0' at index 0 to not access unknown memory while using string functions*/
-    macro_content[0] = '\0';
+    /*the line buffer of the context (the macro definition line isn't needed anymore)*/
+    temp_line = &asmContext->line_buffer;
+    init_text_buffer(&macro_content);
 
     /*read each line and add it to macro content*/
-    while (fgets(temp_line, MAX_LINE_LEN + 2, fp_in) != NULL ) {
+    while (read_source_line(source, temp_line)) {
         asmContext->as_file_line++;
         lines_count++;
-        strcpy(safe_line, temp_line);
 
 
             /*if end of macro command found, verify the macro is not empty
              *and end the read macro content operation*/
-            if (is_end_of_macro(temp_line, asmContext) == true) {
+            if (is_end_of_macro(temp_line->data, asmContext) == true) {
                 /*verify that the macro is not empty*/
-                if (strlen(macro_content) == 0) {
+                if (macro_content.length == 0) {
                     print_external_error(ERROR_CODE_151);
                     asmContext->preproc_error = true;
                     goto cleanup;
                 }
                 /*set results at out pointers*/
-                *content_out = macro_content;
+                *content_out = macro_content.data;
                 *lines_count_out = lines_count;
                 return true;
 
@@ -376,16 +515,8 @@ char temp_line[MAX_LINE_LEN + 2];
             /*macro end command not found yet*/
             else {
 
-                /*calculate the new len of macro content with the new line*/
-                len = strlen(macro_content) + strlen( safe_line) +1;
-
-                temp = handle_realloc(macro_content, len);
-
-                if (temp == NULL) {return false;}
-                macro_content = temp;
-
                 /*add the new line to macro the existing macro content*/
-                strcat(macro_content, safe_line);
+                append_text(&macro_content, temp_line->data, temp_line->length);
 
             }
 
@@ -393,34 +524,38 @@ char temp_line[MAX_LINE_LEN + 2];
     print_external_error(ERROR_CODE_152);
     asmContext->preproc_error = true;
     cleanup:
-    safe_free((void**)&macro_content);
+    free_text_buffer(&macro_content);
     return false;
 }
 
-macro_ptr is_macro_call(char *line, macro_ptr macro_list, assembler_context *asmContext) {
+macro_ptr is_macro_call(char *line, assembler_context *asmContext) {
+    const char *cursor = line;
+    const char *token_start = NULL;
     char *token = NULL;
-    char *line_copy = NULL;
+    unsigned long token_length;
+    char token_end;/*the character after the first token*/
     macro_ptr macro_node = NULL;
 
     /*verify that all input pointers exist*/
     if (!line || !asmContext){print_internal_error(ERROR_CODE_25, "is_macro_call"); return NULL;}
 
-    /*get copy of the line to not change the original*/
-    if ((line_copy = copy_string(line)) == NULL) {
-        return NULL;
-    }
-
     /*get the first token*/
-    token = strtok(line_copy, " \t\n");
+    token_start = next_line_token(&cursor, &token_length);
 
     /*if the token exist and the line is not empty*/
-    if (token != NULL) {
-        /*check if the token is a a macro name*/
-        macro_node = get_macro(token, macro_list);
+    if (token_start != NULL) {
+        token = line + (token_start - line);
+
+        /*check if the token is a a macro name (the token is terminated in place for the
+         *names pool lookup, and the line is restored right after it)*/
+        token_end = token[token_length];
+        token[token_length] = '\0';
+        macro_node = find_macro(find_name(asmContext->names, token), asmContext);
+        token[token_length] = token_end;
+
         if (macro_node != NULL) {
             /*macro name found, verify that no unnecessary tokens after macro name*/
-            if (strtok(NULL, " \t\n") == NULL) {
-                safe_free((void**)&line_copy);
+            if (next_line_token(&cursor, NULL) == NULL) {
                 /*the line is macro call, return the full macro list's node*/
                 return macro_node;
             }
@@ -433,21 +568,22 @@ macro_ptr is_macro_call(char *line, macro_ptr macro_list, assembler_context *asm
     }
 
     /*the line is not a macro call*/
-    safe_free((void**)&line_copy);
     return NULL;
 
 
 }
 
-macro_ptr get_macro(char *name, macro_ptr macro_list) {
+macro_ptr get_macro(name_id name, macro_ptr macro_list) {
 
-    /*verify that all input pointers exist*/
-    if (!name){print_internal_error(ERROR_CODE_25, "get_macro"); return NULL;}
+    /*a name that isn't in the names pool is not a macro name*/
+    if (name == NO_NAME_ID) {
+        return NULL;
+    }
 
     /*iterate through the macro list*/
     while (macro_list != NULL) {
         /*check if the provided name is a macro name*/
-        if (strcmp(macro_list->name, name) == 0) {
+        if (macro_list->name == name) {
             /*if the name found, return the macro list's node*/
             return macro_list;
         }
@@ -457,18 +593,20 @@ macro_ptr get_macro(char *name, macro_ptr macro_list) {
 
 }
 
-boolean is_macro_defined(const char *name, macro_ptr macro_list) {
+macro_ptr find_macro(name_id name, const assembler_context *asmContext) {
 
-    /*verify that all input pointers exist*/
-    if (!name){print_internal_error(ERROR_CODE_25, "is_macro_defined"); return false;}
+    macro_ptr macro_node;
 
-    while (macro_list != NULL) {
-        if (strcmp(macro_list->name, name) == 0) {
-            return true;
-        }
-        macro_list = macro_list->next;
+    /*the macros of the file, and then the macros of the prelude*/
+    if ((macro_node = get_macro(name, asmContext->macros)) != NULL) {
+        return macro_node;
     }
-    return false;
+    return get_macro(name, asmContext->prelude_macros);
+}
+
+boolean is_macro_defined(name_id name, macro_ptr macro_list) {
+
+    return get_macro(name, macro_list) != NULL;
 }
 
 boolean is_PP_saved_name(const char* name, const assembler_context *asmContext) {
@@ -491,3 +629,42 @@ boolean is_PP_saved_name(const char* name, const assembler_context *asmContext)
 
 
 
+static const char *next_line_token(const char **cursor, unsigned long *length) {
+
+    const char *token;
+
+    /*skip the separators before the token*/
+    token = *cursor + strspn(*cursor, PP_TOKEN_SEPARATORS);
+    if (*token == '\0') {
+        *cursor = token;
+        return NULL;
+    }
+
+    /*the token ends at the next separator (or at the end of the line)*/
+    *cursor = token + strcspn(token, PP_TOKEN_SEPARATORS);
+    if (length) {
+        *length = (unsigned long)(*cursor - token);
+    }
+    return token;
+}
+
+
+static boolean is_token(const char *token, unsigned long length, const char *word) {
+    return strlen(word) == length && strncmp(token, word, length) == 0;
+}
+
+
+static boolean read_source_line(source_reader *source, text_buffer *line) {
+
+    if (source->file != NULL) {
+        return read_line(source->file, line);
+    }
+
+    /*the end of the text*/
+    if (source->position >= source->text.length) {
+        clear_text_buffer(line);
+        return false;
+    }
+
+    return read_text_line(&source->text, &source->position, line);
+}
@@ -0,0 +1,562 @@
+
+#include "query.h"
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "context.h"
+#include "assembler.h"
+#include "addresses.h"
+#include "data_memory.h"
+#include "errors.h"
+#include "first_pass.h"
+#include "instruction_memory.h"
+#include "intern_pool.h"
+#include "labels.h"
+#include "lines_map.h"
+#include "pre_processor.h"
+#include "second_pass.h"
+#include "sys_memory.h"
+#include "util.h"
+#include "target.h"
+
+
+/**
+ * @file query.c
+ * @brief Symbol queries (server mode and language server).
+ *
+ * Every query analyzes the requested source file with the regular assembler
+ * stages (so the answers always match a real assembly), without writing any
+ * file: the preprocessor hands the .am content to the passes in memory, and
+ * an editor document is read from memory instead of the .as file. The first
+ * pass replays the lines unchanged since the previous analysis of the file
+ * (see line_records.h), so an edit parses only the edited lines.
+ *
+ * After the analysis, the symbols are copied into a symbol index: the labels
+ * table (definition line, address, kind and the word at the address), the
+ * macros list (definition line and body size), and the address update
+ * requests (label use sites and the patched words). The index outlives the
+ * file state of the context, so the language server (lsp.c) keeps the index
+ * of every open document and answers its queries without a new analysis.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*query commands*/
+#define DEFINE_QUERY "define"
+#define REFS_QUERY "refs"
+#define HOVER_QUERY "hover"
+
+/*command, file and symbol*/
+#define QUERY_ARGS_AMOUNT 4
+
+
+/**
+ * @brief Copy the symbols of an analyzed file into a symbol index.
+ *
+ * @param asmContext Assembler context after the analysis.
+ * @param index_out  [out] Symbol index (retained allocations).
+ */
+static void build_symbol_index(const assembler_context *asmContext, symbol_index *index_out);
+
+
+/**
+ * @brief Build the .as line of every .am line (a single walk of the lines map).
+ *
+ * @param asmContext   Assembler context.
+ * @param lines_amount [out] Amount of entries in the returned array.
+ * @return Array indexed by the .am line (tracked allocation, released with the file state).
+ */
+static int* build_origin_lines(const assembler_context *asmContext, int *lines_amount);
+
+
+/**
+ * @brief Get the .as line of an .am line from the array of build_origin_lines.
+ */
+static int get_origin_line(const int *origin_lines, int lines_amount, int am_line);
+
+
+/**
+ * @brief Build the encoded word of every address of a memory list (a single walk of the list).
+ *
+ * @param instructions Instruction memory (or NULL to use the data memory).
+ * @param data         Data memory.
+ * @param size_out     [out] Amount of addresses in the returned arrays.
+ * @param known_out    [out] Array that marks the addresses with a word.
+ * @return Array of the words indexed by address (tracked allocations, released with the file state).
+ */
+static int* build_memory_words(instruction_ptr instructions, data_ptr data, unsigned int *size_out, boolean **known_out);
+
+
+/**
+ * @brief Get the name id of the label referenced by an address update request.
+ *
+ * @return The label name id, or NO_NAME_ID if the operand doesn't reference a label.
+ */
+static name_id get_request_label_name(address_update_request_ptr request);
+
+
+/**
+ * @brief Allocate memory that is kept when the file state is recycled.
+ */
+static void* index_alloc(unsigned long size);
+
+
+/**
+ * @brief Print the definition location of a label or macro.
+ */
+static boolean query_definition(const char *symbol, const symbol_index *index);
+
+
+/**
+ * @brief Print all the use sites of a label.
+ */
+static boolean query_references(const char *symbol, const symbol_index *index);
+
+
+/**
+ * @brief Print the details of a label or macro.
+ */
+static boolean query_hover(const char *symbol, const symbol_index *index);
+
+
+
+boolean is_symbol_query(const char *command) {
+
+    if (!command) return false;
+
+    return strcmp(command, DEFINE_QUERY) == 0 ||
+           strcmp(command, REFS_QUERY) == 0 ||
+           strcmp(command, HOVER_QUERY) == 0;
+}
+
+
+boolean run_symbol_query(int args_count, char *args[], assembler_context *asmContext) {
+
+    symbol_index index;
+    boolean found = false;
+
+    /*verify that all input pointers exist*/
+    if (!args || !asmContext) {
+        print_internal_error(ERROR_CODE_25, "run_symbol_query");
+        return false;
+    }
+
+    if (args_count != QUERY_ARGS_AMOUNT) {
+        printf("ERROR: Query format is: <%s|%s|%s> <file> <symbol>.\n", DEFINE_QUERY, REFS_QUERY, HOVER_QUERY);
+        return false;
+    }
+
+    /*analyze the file, the stages print the file diagnostics*/
+    if (!analyze_source(asmContext, args[2], NULL, &index)) {
+        printf("ERROR: File <%s> can't be analyzed.\n", args[2]);
+        free_symbol_index(&index);
+        return false;
+    }
+
+    if (index.has_errors) {
+        printf("Note: file <%s> contains errors, the addresses may be not final.\n", index.file_name);
+    }
+
+    /*answer the query*/
+    if (strcmp(args[1], DEFINE_QUERY) == 0) {
+        found = query_definition(args[3], &index);
+    }
+    else if (strcmp(args[1], REFS_QUERY) == 0) {
+        found = query_references(args[3], &index);
+    }
+    else {
+        found = query_hover(args[3], &index);
+    }
+
+    if (!found) {
+        printf("ERROR: Symbol <%s> not found in file <%s>.\n", args[3], index.file_name);
+    }
+
+    free_symbol_index(&index);
+    return found;
+}
+
+
+boolean analyze_source(assembler_context *asmContext, const char *source_file, const char *source_text, symbol_index *index_out) {
+
+    boolean analyzed = false;
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !source_file || !index_out) {
+        print_internal_error(ERROR_CODE_25, "analyze_source");
+        return false;
+    }
+
+    memset(index_out, 0, sizeof(symbol_index));
+
+    /*the context is kept by the caller, only the file state is reset*/
+    reset_assembler(asmContext);
+
+    /*nothing is written, the document content replaces the .as file*/
+    asmContext->write_am_file = false;
+    asmContext->source_text = source_text;
+
+    /*the context is kept between the analyses, so the unchanged lines of the previous analysis are replayed*/
+    asmContext->reuse_lines = true;
+
+    if (set_file_names(asmContext, source_file) && execute_preprocessor(asmContext)) {
+
+        /*the second pass requires a valid first pass*/
+        if (execute_first_pass(asmContext)) {
+            execute_second_pass(asmContext);
+        }
+
+        build_symbol_index(asmContext, index_out);
+        analyzed = true;
+    }
+
+    recycle_all_memory(asmContext);
+    return analyzed;
+}
+
+
+int find_indexed_symbol(const symbol_index *index, const char *name) {
+
+    int i;
+
+    if (!index || !name) return -1;
+
+    for (i = 0; i < index->symbols_amount; i++) {
+        if (strcmp(index->symbols[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+void format_symbol_hover(const symbol_index *index, int symbol, char *buffer_out) {
+
+    const indexed_symbol *entry = &index->symbols[symbol];
+    char address_str[TARGET_MAX_PRINT_LENGTH + 1];
+    char word_str[TARGET_MAX_PRINT_LENGTH + 1];
+
+    switch (entry->kind) {
+
+        /*extern labels have no address in this file*/
+        case EXTERN_LABEL_SYMBOL:
+            sprintf(buffer_out, "%.*s: external label, declared at line %d.", QUERY_NAME_PRINT_LENGTH, entry->name,
+                    entry->define_line);
+            break;
+
+        /*the macro body lines, without the mcro and mcroend lines*/
+        case MACRO_SYMBOL:
+            sprintf(buffer_out, "%.*s: macro, defined at line %d, %d line(s).", QUERY_NAME_PRINT_LENGTH, entry->name,
+                    entry->define_line, entry->body_lines);
+            break;
+
+        default:
+            /*after an error the labels may be not relocated (or the second pass didn't run)*/
+            if (index->has_errors) {
+                sprintf(buffer_out, "%.*s: %s label%s, defined at line %d, address unresolved (the file has errors).",
+                        QUERY_NAME_PRINT_LENGTH, entry->name, entry->kind == CODE_LABEL_SYMBOL ? "code" : "data",
+                        entry->entry ? " (entry)" : "", entry->define_line);
+                break;
+            }
+            index->target->format_address(entry->address, address_str);
+            sprintf(buffer_out, "%.*s: %s label%s, defined at line %d, address %u (%s)", QUERY_NAME_PRINT_LENGTH,
+                    entry->name, entry->kind == CODE_LABEL_SYMBOL ? "code" : "data", entry->entry ? " (entry)" : "",
+                    entry->define_line, entry->address, address_str);
+            if (entry->has_word) {
+                index->target->format_word(entry->word, word_str);
+                strcat(buffer_out, ", encoded word ");
+                strcat(buffer_out, word_str);
+            }
+            strcat(buffer_out, ".");
+            break;
+    }
+}
+
+
+void free_symbol_index(symbol_index *index) {
+
+    if (!index) return;
+
+    safe_free((void**)&index->file_name);
+    safe_free((void**)&index->symbols);
+    safe_free((void**)&index->references);
+    safe_free((void**)&index->names);
+    memset(index, 0, sizeof(symbol_index));
+}
+
+
+
+
+static void build_symbol_index(const assembler_context *asmContext, symbol_index *index_out) {
+
+    symbol_table_ptr labels = asmContext->labels;
+    address_update_request_ptr request;
+    macro_ptr macro;
+    indexed_symbol *entry;
+    indexed_reference *reference;
+    int *origin_lines;
+    int lines_amount;
+    int *code_words, *data_words;
+    boolean *code_known, *data_known;
+    unsigned int code_size, data_size;
+    unsigned long names_size = 0;
+    char *name_position;
+    const char *name;
+    int label;
+    int i;
+
+    /*the lines and the words are looked up once per symbol, build their tables with a single walk*/
+    origin_lines = build_origin_lines(asmContext, &lines_amount);
+    code_words = build_memory_words(asmContext->instruction_memory, NULL, &code_size, &code_known);
+    data_words = build_memory_words(NULL, asmContext->data_memory, &data_size, &data_known);
+
+    index_out->file_name = (char*)index_alloc(strlen(asmContext->as_file_name) + 1);
+    strcpy(index_out->file_name, asmContext->as_file_name);
+    index_out->target = asmContext->target;
+    index_out->has_errors = asmContext->preproc_error || asmContext->first_pass_error || asmContext->second_pass_error;
+
+    /*count the symbols, the references and the names size*/
+    index_out->symbols_amount = labels_amount(labels);
+    for (i = 0; i < labels_amount(labels); i++) {
+        names_size += strlen(label_name(labels, i)) + 1;
+    }
+    for (macro = asmContext->macros; macro; macro = macro->next) {
+        index_out->symbols_amount++;
+        names_size += strlen(get_name(asmContext->names, macro->name)) + 1;
+    }
+    for (request = asmContext->address_update_requests; request; request = request->next) {
+        if (get_request_label_name(request) != NO_NAME_ID) {
+            index_out->references_amount++;
+        }
+    }
+
+    index_out->symbols = (indexed_symbol*)index_alloc(sizeof(indexed_symbol) * (index_out->symbols_amount + 1));
+    index_out->references = (indexed_reference*)index_alloc(sizeof(indexed_reference) * (index_out->references_amount + 1));
+    index_out->names = (char*)index_alloc(names_size + 1);
+    name_position = index_out->names;
+
+    /*the labels (the index of a label is its id in the labels table)*/
+    for (label = 0; label < labels_amount(labels); label++) {
+        entry = &index_out->symbols[label];
+        name = label_name(labels, label);
+        strcpy(name_position, name);
+        entry->name = name_position;
+        name_position += strlen(name) + 1;
+
+        entry->kind = labels->definitions[label] == EXTERN ? EXTERN_LABEL_SYMBOL :
+                      labels->types[label] == CODE ? CODE_LABEL_SYMBOL : DATA_LABEL_SYMBOL;
+        entry->entry = is_entry_label(labels, label);
+        entry->define_line = get_origin_line(origin_lines, lines_amount, labels->define_lines[label]);
+        entry->address = labels->addresses[label];
+        entry->body_lines = 0;
+
+        if (entry->kind == CODE_LABEL_SYMBOL) {
+            entry->has_word = entry->address < code_size && code_known[entry->address];
+            entry->word = entry->has_word ? code_words[entry->address] : 0;
+        }
+        else {
+            entry->has_word = entry->kind == DATA_LABEL_SYMBOL && entry->address < data_size && data_known[entry->address];
+            entry->word = entry->has_word ? data_words[entry->address] : 0;
+        }
+    }
+
+    /*the macros of the file (read_macro_content counts the mcroend line too)*/
+    for (macro = asmContext->macros; macro; macro = macro->next, label++) {
+        entry = &index_out->symbols[label];
+        name = get_name(asmContext->names, macro->name);
+        strcpy(name_position, name);
+        entry->name = name_position;
+        name_position += strlen(name) + 1;
+
+        entry->kind = MACRO_SYMBOL;
+        entry->entry = false;
+        entry->define_line = macro->define_line;
+        entry->address = 0;
+        entry->has_word = false;
+        entry->word = 0;
+        entry->body_lines = macro->lines - 1;
+    }
+
+    /*every request is a single label use in an instruction operand*/
+    reference = index_out->references;
+    for (request = asmContext->address_update_requests; request; request = request->next) {
+        if (get_request_label_name(request) == NO_NAME_ID) {
+            continue;
+        }
+        if ((reference->symbol = find_label(get_request_label_name(request), labels)) == NO_LABEL) {
+            index_out->references_amount--;
+            continue;
+        }
+        reference->line = get_origin_line(origin_lines, lines_amount, request->operand->file_line);
+        reference->address = request->address;
+        reference->has_word = request->address < code_size && code_known[request->address];
+        reference->word = reference->has_word ? code_words[request->address] : 0;
+        reference++;
+    }
+}
+
+
+static int* build_origin_lines(const assembler_context *asmContext, int *lines_amount) {
+
+    lines_map_ptr map;
+    int *origin_lines;
+    int i;
+
+    /*the .am lines are mapped in increasing order, the last one is the largest*/
+    *lines_amount = 1;
+    for (map = asmContext->lines_maper; map; map = map->next) {
+        if (map->new_line_num >= *lines_amount) {
+            *lines_amount = map->new_line_num + 1;
+        }
+    }
+
+    origin_lines = (int*)handle_malloc(sizeof(int) * (*lines_amount));
+    for (i = 0; i < *lines_amount; i++) {
+        origin_lines[i] = -1;
+    }
+
+    /*the first mapping of a line wins, as in get_origin_file_line*/
+    for (map = asmContext->lines_maper; map; map = map->next) {
+        if (map->new_line_num >= 0 && origin_lines[map->new_line_num] == -1) {
+            origin_lines[map->new_line_num] = map->orign_line_num;
+        }
+    }
+
+    return origin_lines;
+}
+
+
+static int get_origin_line(const int *origin_lines, int lines_amount, int am_line) {
+
+    if (am_line < 0 || am_line >= lines_amount) {
+        return -1;
+    }
+    return origin_lines[am_line];
+}
+
+
+static int* build_memory_words(instruction_ptr instructions, data_ptr data, unsigned int *size_out, boolean **known_out) {
+
+    instruction_ptr instruction_tmp;
+    data_ptr data_tmp;
+    int *words;
+    unsigned int i;
+
+    /*the largest address of the list*/
+    *size_out = 1;
+    for (instruction_tmp = instructions; instruction_tmp; instruction_tmp = instruction_tmp->next) {
+        if (instruction_tmp->address >= *size_out) *size_out = instruction_tmp->address + 1;
+    }
+    for (data_tmp = data; data_tmp; data_tmp = data_tmp->next) {
+        if (data_tmp->address >= *size_out) *size_out = data_tmp->address + 1;
+    }
+
+    words = (int*)handle_malloc(sizeof(int) * (*size_out));
+    *known_out = (boolean*)handle_malloc(sizeof(boolean) * (*size_out));
+    for (i = 0; i < *size_out; i++) {
+        (*known_out)[i] = false;
+    }
+
+    /*the first word of an address wins, as in a list search*/
+    for (instruction_tmp = instructions; instruction_tmp; instruction_tmp = instruction_tmp->next) {
+        if (!(*known_out)[instruction_tmp->address]) {
+            words[instruction_tmp->address] = instruction_tmp->value;
+            (*known_out)[instruction_tmp->address] = true;
+        }
+    }
+    for (data_tmp = data; data_tmp; data_tmp = data_tmp->next) {
+        if (!(*known_out)[data_tmp->address]) {
+            words[data_tmp->address] = data_tmp->value;
+            (*known_out)[data_tmp->address] = true;
+        }
+    }
+
+    return words;
+}
+
+
+static name_id get_request_label_name(address_update_request_ptr request) {
+
+    if (!request || !request->operand) return NO_NAME_ID;
+
+    switch (request->operand->type) {
+        case MATRIX_ACCESS:
+        case DIRECT_ACCESS:
+            return operand_label(request->operand);
+        default:
+            return NO_NAME_ID;
+    }
+}
+
+
+static void* index_alloc(unsigned long size) {
+
+    void *memory = handle_malloc(size);
+    retain_allocation(memory);
+    return memory;
+}
+
+
+static boolean query_definition(const char *symbol, const symbol_index *index) {
+
+    int found;
+
+    if ((found = find_indexed_symbol(index, symbol)) == -1) {
+        return false;
+    }
+
+    printf("%s:%d: %s\n", index->file_name, index->symbols[found].define_line, index->symbols[found].name);
+    return true;
+}
+
+
+static boolean query_references(const char *symbol, const symbol_index *index) {
+
+    char address_str[TARGET_MAX_PRINT_LENGTH + 1];
+    char word_str[TARGET_MAX_PRINT_LENGTH + 1];
+    const indexed_reference *reference;
+    int found;
+    int uses = 0;
+    int i;
+
+    /*only labels have references*/
+    if ((found = find_indexed_symbol(index, symbol)) == -1 || index->symbols[found].kind == MACRO_SYMBOL) {
+        return false;
+    }
+
+    for (i = 0; i < index->references_amount; i++) {
+        reference = &index->references[i];
+        if (reference->symbol != found) {
+            continue;
+        }
+
+        uses++;
+        index->target->format_address(reference->address, address_str);
+        printf("%s:%d: word address %u (%s)", index->file_name, reference->line, reference->address, address_str);
+        if (reference->has_word) {
+            index->target->format_word(reference->word, word_str);
+            printf(", encoded word %s", word_str);
+        }
+        printf("\n");
+    }
+
+    printf("%d reference(s) to <%s>.\n", uses, symbol);
+    return true;
+}
+
+
+static boolean query_hover(const char *symbol, const symbol_index *index) {
+
+    char hover[QUERY_HOVER_MAX_LEN + 1];
+    int found;
+
+    if ((found = find_indexed_symbol(index, symbol)) == -1) {
+        return false;
+    }
+
+    format_symbol_hover(index, found, hover);
+    printf("%s\n", hover);
+    return true;
+}
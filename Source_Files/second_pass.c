@@ -17,7 +17,8 @@
  * @brief Implementation of the assembler's second pass.
  *
  * The second pass is responsible for finalizing the assembly process:
- *   - Processes `.entry` directives, validating and marking entry labels.
+ *   - Processes `.entry` directives, validating and marking entry labels
+ *     (only the .entry lines found by the first pass are read again).
  *   - Performs memory relocation for both instructions and data.
  *   - Updates label addresses after relocation.
  *   - Applies pending address update requests to instruction memory,
@@ -34,9 +35,13 @@
 
 boolean execute_second_pass(assembler_context *asmContext) {
 
-    FILE* am_file;
+    unsigned long am_position;/*position of the current .am line*/
+    int am_lines;/*amount of .am lines*/
+    int entry_index;
+    text_buffer *line_buffer;
     char* line = NULL;
     char* entry_label = NULL;
+    int label_id;
     line_type type;
 
 
@@ -45,23 +50,23 @@ boolean execute_second_pass(assembler_context *asmContext) {
         print_internal_error(ERROR_CODE_25, "execute_second_pass");
         return false;
     }
-    /*reset line counter*/
-    asmContext->am_file_line = 0;
+    /*the first pass counted all the .am lines*/
+    am_lines = asmContext->am_file_line;
 
 
-    /*allocate memory for reading line*/
-    line = (char*)handle_malloc(sizeof(char) * MAX_LINE_LEN + 3);
+    /*the line buffer of the context (kept between the files)*/
+    line_buffer = &asmContext->line_buffer;
 
-    if (!line) {return false;}
-
-    /*open the am file for reading*/
-    if ((am_file = open_file(asmContext->am_full_file_name, READ)) == NULL) {safe_free((void**)&line); return false;}
     
-    /*read each line till reach end of file*/
-    while (fgets(line, MAX_LINE_LEN + 2, am_file)) {
+    /*read each .entry line (the other lines have nothing to do in the second pass)*/
+    for (entry_index = 0; entry_index < asmContext->entry_lines_amount; entry_index++) {
+
+        am_position = asmContext->entry_lines[entry_index].position;
+        read_text_line(&asmContext->am_buffer, &am_position, line_buffer);
+        line = line_buffer->data;
 
-        /*increment the line counter*/
-        asmContext->am_file_line++;
+        /*set the line counter*/
+        asmContext->am_file_line = asmContext->entry_lines[entry_index].line;
 
         /*clear white space and chars like '\n' */
         trim_edge_white_space(line);
@@ -97,8 +102,9 @@ boolean execute_second_pass(assembler_context *asmContext) {
                     continue;
                 }
 
-                /*get the label node*/
-                if (get_label(entry_label, asmContext->labels)->definition == EXTERN) {
+                /*get the label id*/
+                label_id = get_label(entry_label, asmContext->labels);
+                if (asmContext->labels->definitions[label_id] == EXTERN) {
                     asmContext->second_pass_error_line = asmContext->am_file_line;
                     print_external_error(ERROR_CODE_142);
                     asmContext->second_pass_error = true;
@@ -106,7 +112,7 @@ boolean execute_second_pass(assembler_context *asmContext) {
                     continue;
                 }
                 /*label found, update label's entry flag*/
-                get_label(entry_label, asmContext->labels) -> is_entry = true;
+                set_entry_label(asmContext->labels, label_id);
                 safe_free((void**)&entry_label);
 
                     break;
@@ -117,6 +123,9 @@ boolean execute_second_pass(assembler_context *asmContext) {
         }
     }
 
+    /*the errors after the lines point to the last line (as after reading the whole file)*/
+    asmContext->am_file_line = am_lines;
+
     /*relocate the instruction memory by moving all addresses after the memory offset*/
     if (!update_instruction_addresses(asmContext)) {
         print_external_error(ERROR_CODE_143);
@@ -141,17 +150,13 @@ boolean execute_second_pass(assembler_context *asmContext) {
 
     /*if no error found, return true*/
     if (!asmContext->second_pass_error) {
-        safe_free((void**)&line);
-        fclose(am_file);
         return true;
     }
 
 
 
     cleanup:
-    safe_free((void**)&line);
     asmContext->second_pass_error = true;
-    fclose(am_file);
     return false;
 
 }
@@ -0,0 +1,708 @@
+/*local sockets, dup2(), chdir(), fork() and poll() are POSIX, not ANSI C*/
+#define _POSIX_C_SOURCE 200112L
+
+#include "server.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "config.h"
+#include "assembler.h"
+#include "options.h"
+#include "query.h"
+
+
+/**
+ * @file server.c
+ * @brief Persistent request server of the assembler.
+ *
+ * Starting the assembler once per source file pays the process startup
+ * and the tables setup for every file. In server mode the process stays
+ * alive, and every request is assembled exactly like a command-line
+ * invocation with the same arguments.
+ *
+ * The requests are read from the standard input (one request per line), or
+ * from a local (AF_UNIX) socket: a client (client.c) connects, sends the
+ * length of its request, its working directory and its arguments, and
+ * receives the output of the request followed by its exit status. A request
+ * that is not received within SERVER_SOCKET_TIMEOUT_MS is rejected, so a
+ * stuck client can't hold the server. The request is executed in the working
+ * directory of the client, and may carry the content of a source file
+ * (SERVER_INLINE_SOURCE_OPTION) that is assembled instead of the file.
+ *
+ * The socket requests are answered by worker processes ("--workers=<n>"),
+ * each one accepting the connections of the shared listening socket, so
+ * the requests of several clients are assembled at the same time. A request
+ * changes the working directory and the standard output of its process, so
+ * the workers are processes and not threads. With a single worker the server
+ * process answers the requests itself. A quit request stops its worker, and
+ * the server then stops the other workers after their current request.
+ *
+ * The server keeps a warm context (see warm_context) between the requests:
+ * the constant tables, the names pool, the labels table, the memory image,
+ * the text buffers and the nodes slabs are built once, and the macro prelude
+ * is read again only when a request asks for another prelude (or the prelude
+ * file changed). The file state is recycled after every file, the same as
+ * in a command-line batch. The build cache (build_cache.c) is kept too, so
+ * unchanged source files are not assembled again. Every worker keeps its own
+ * warm context and build cache; the cache compares the content of the files,
+ * so the outputs written by another worker are never taken as up to date.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*context kept between the requests*/
+static warm_context server_context;
+
+
+/**
+ * @brief Execute a single request (an assembly or a symbol query).
+ *
+ * @param args_count Number of request arguments including the program name,
+ *                   or -1 if the request had too many arguments.
+ * @param args       Request arguments (argv style).
+ * @param sources        Source contents sent with the request, or NULL.
+ * @param sources_amount Number of entries in @p sources.
+ * @return true if the request was executed (the files may still fail to assemble).
+ */
+static boolean execute_request(int args_count, char *args[], const inline_source *sources, int sources_amount);
+
+
+/**
+ * @brief Read the requests from the standard input until the end of input or a quit request.
+ */
+static boolean run_stdin_server(void);
+
+
+/**
+ * @brief Read the requests from a local socket until a quit request.
+ *
+ * @param socket_path Path of the socket file (created by the server, removed when it stops).
+ * @param workers     Number of worker processes (1 to answer in the server process).
+ * @return false if the socket can't be created (error printed), true when the server stopped.
+ */
+static boolean run_socket_server(const char *socket_path, int workers);
+
+
+/**
+ * @brief Start the worker processes, and stop all of them when one of them stops.
+ *
+ * @param server_socket Listening socket, shared by the workers.
+ * @param home          Working directory of the server.
+ * @param workers       Number of worker processes.
+ */
+static void run_workers(int server_socket, const char *home, int workers);
+
+
+/**
+ * @brief Answer the connections of the listening socket until a quit request or a stop signal.
+ *
+ * @param server_socket Listening socket (non-blocking, shared with the other workers).
+ * @param home          Working directory of the server.
+ * @param stop_fd       Read end of the stop pipe, readable once the server stops the workers, or -1.
+ */
+static void serve_connections(int server_socket, const char *home, int stop_fd);
+
+
+/**
+ * @brief Create the listening socket of the server.
+ *
+ * A socket file left by a server that stopped is replaced, any other
+ * existing file (or a running server) is an error.
+ *
+ * @param socket_path Path of the socket file.
+ * @return The socket, or -1 on error (error printed).
+ */
+static int open_server_socket(const char *socket_path);
+
+
+/**
+ * @brief Read the request of a client connection.
+ *
+ * A request is its length in decimal digits, then the working directory of
+ * the client and its arguments, each field terminated by '\0'. An argument
+ * SERVER_INLINE_SOURCE_OPTION=<file> is followed by the content of the file,
+ * the file is kept as a source argument and its content as an inline source.
+ *
+ * @param connection    Client connection.
+ * @param request       [out] Buffer of SERVER_SOCKET_REQUEST_MAX_LEN bytes (the arguments point into it).
+ * @param cwd_out       [out] Working directory of the client.
+ * @param args_out      [out] Arguments array of SERVER_REQUEST_MAX_ARGS entries.
+ * @param sources_out   [out] Inline sources array of SERVER_REQUEST_MAX_ARGS entries.
+ * @param sources_amount_out [out] Number of inline sources.
+ * @return Number of arguments including the program name, -1 if the request
+ *         contains too many arguments, or 0 if the request is invalid, too long,
+ *         or not received within SERVER_SOCKET_TIMEOUT_MS.
+ */
+static int read_socket_request(int connection, char *request, char **cwd_out, char *args_out[],
+                               inline_source *sources_out, int *sources_amount_out);
+
+
+/**
+ * @brief Read exactly @p wanted bytes of a connection before a deadline.
+ *
+ * @param connection Client connection.
+ * @param buffer     [out] Buffer of at least @p wanted bytes.
+ * @param wanted     Number of bytes to read.
+ * @param deadline   Monotonic clock time after which the reading fails.
+ * @return true if all the bytes were read in time.
+ */
+static boolean read_before_deadline(int connection, char *buffer, unsigned long wanted, const struct timespec *deadline);
+
+
+/**
+ * @brief Answer a client connection: execute its request with the standard output sent to the client.
+ *
+ * @param connection Client connection.
+ * @param home       Working directory of the server (restored after the request).
+ * @return false if the request was a quit request.
+ */
+static boolean answer_socket_request(int connection, const char *home);
+
+
+/**
+ * @brief Split a request line into an arguments array (argv style).
+ *
+ * Replaces the white spaces of @p line with '\0' terminators and points
+ * each argument at the start of its word. Index 0 is reserved for the
+ * program name, as in main() arguments.
+ *
+ * @param line     Request line (modified in place).
+ * @param args_out [out] Arguments array of SERVER_REQUEST_MAX_ARGS entries.
+ * @return Number of arguments including the program name, or -1 if the
+ *         request contains too many arguments.
+ */
+static int split_request_line(char *line, char *args_out[]);
+
+
+
+boolean run_server(const char *socket_path, int workers) {
+
+    boolean result;
+
+    init_warm_context(&server_context);
+
+    result = socket_path ? run_socket_server(socket_path, workers) : run_stdin_server();
+
+    release_warm_context(&server_context);
+    return result;
+}
+
+
+static boolean run_stdin_server(void) {
+
+    char line[SERVER_REQUEST_MAX_LEN + 2];/*+2 to catch line bigger then maximum allowed size*/
+    char *args[SERVER_REQUEST_MAX_ARGS];
+    int args_count;
+    int c;
+
+    printf("\n================ Assembler server started ================\n\n");
+    printf("%s\n", SERVER_END_OF_RESPONSE);
+    fflush(stdout);
+
+    /*read the requests one by one*/
+    while (fgets(line, sizeof(line), stdin)) {
+
+        /*verify that the request line is not too long*/
+        if (strlen(line) > SERVER_REQUEST_MAX_LEN) {
+            /*skip the rest of the line*/
+            if (strchr(line, '\n') == NULL) {
+                while ((c = getchar()) != EOF && c != '\n');
+            }
+            printf("ERROR: Request exceeds the maximum allowed length of %d characters.\n", SERVER_REQUEST_MAX_LEN);
+            printf("%s\n", SERVER_END_OF_RESPONSE);
+            fflush(stdout);
+            continue;
+        }
+
+        /*split the request into arguments*/
+        args_count = split_request_line(line, args);
+
+        /*ignore empty requests*/
+        if (args_count == 1) {
+            continue;
+        }
+
+        /*stop the server*/
+        if (args_count == 2 && strcmp(args[1], SERVER_QUIT_REQUEST) == 0) {
+            break;
+        }
+
+        execute_request(args_count, args, NULL, 0);
+
+        /*mark the end of the response*/
+        printf("%s\n", SERVER_END_OF_RESPONSE);
+        fflush(stdout);
+    }
+
+    printf("\n================ Assembler server stopped ================\n\n");
+    return true;
+}
+
+
+static boolean run_socket_server(const char *socket_path, int workers) {
+
+    char home[FILENAME_MAX];
+    int server_socket;
+    int flags;
+
+    if (getcwd(home, sizeof(home)) == NULL) {
+        printf("ERROR: Can't get the working directory of the server.\n");
+        return false;
+    }
+
+    if ((server_socket = open_server_socket(socket_path)) == -1) {
+        return false;
+    }
+
+    /*the workers wait on the same socket, a connection taken by another worker must not block the accept*/
+    if ((flags = fcntl(server_socket, F_GETFL)) == -1 || fcntl(server_socket, F_SETFL, flags | O_NONBLOCK) == -1) {
+        printf("ERROR: Can't listen on socket <%s>.\n", socket_path);
+        close(server_socket);
+        unlink(socket_path);
+        return false;
+    }
+
+    /*a client that disconnects before its response ends must not stop the server*/
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("\n================ Assembler server started on <%s> ================\n\n", socket_path);
+    if (workers > 1) {
+        printf("Answering the requests with %d worker processes.\n\n", workers);
+    }
+    fflush(stdout);
+
+    if (workers > 1) {
+        run_workers(server_socket, home, workers);
+    }
+    else {
+        serve_connections(server_socket, home, -1);
+    }
+
+    close(server_socket);
+    unlink(socket_path);
+
+    printf("\n================ Assembler server stopped ================\n\n");
+    return true;
+}
+
+
+static void run_workers(int server_socket, const char *home, int workers) {
+
+    int stop_pipe[2];
+    int started;
+    pid_t worker;
+
+    if (pipe(stop_pipe) == -1) {
+        printf("ERROR: Can't start the worker processes.\n");
+        return;
+    }
+
+    /*the workers must not print the buffered output of the server again*/
+    fflush(stdout);
+
+    for (started = 0; started < workers; started++) {
+        if ((worker = fork()) == -1) {
+            printf("ERROR: Can't start the worker processes, %d of %d started.\n", started, workers);
+            break;
+        }
+
+        /*a worker answers the connections with its own warm context, until the server stops it*/
+        if (worker == 0) {
+            close(stop_pipe[1]);
+            serve_connections(server_socket, home, stop_pipe[0]);
+            release_warm_context(&server_context);
+            fflush(stdout);
+            _exit(0);
+        }
+    }
+    close(stop_pipe[0]);
+
+    /*a worker stops on a quit request (or on a failure), then the others are stopped*/
+    if (started == workers) {
+        while (wait(NULL) == -1 && errno == EINTR);
+        started--;
+    }
+
+    /*closing the pipe wakes the waiting workers, a busy worker finishes its request first*/
+    close(stop_pipe[1]);
+    while (started > 0) {
+        if (wait(NULL) == -1 && errno != EINTR) {
+            break;
+        }
+        started--;
+    }
+}
+
+
+static void serve_connections(int server_socket, const char *home, int stop_fd) {
+
+    struct pollfd waiting[2];
+    int connection;
+    int flags;
+    boolean running = true;
+
+    waiting[0].fd = server_socket;
+    waiting[0].events = POLLIN;
+    waiting[1].fd = stop_fd;
+    waiting[1].events = POLLIN;
+
+    while (running) {
+        waiting[0].revents = 0;
+        waiting[1].revents = 0;
+        if (poll(waiting, (stop_fd == -1) ? 1 : 2, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("ERROR: Can't wait for the client connections.\n");
+            break;
+        }
+
+        /*the server stops the workers*/
+        if (stop_fd != -1 && waiting[1].revents != 0) {
+            break;
+        }
+
+        if ((connection = accept(server_socket, NULL, NULL)) == -1) {
+            /*taken by another worker, or the client gave up*/
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            printf("ERROR: Can't accept a client connection.\n");
+            break;
+        }
+
+        /*some systems pass the non-blocking mode of the listening socket to the connection*/
+        if ((flags = fcntl(connection, F_GETFL)) != -1) {
+            fcntl(connection, F_SETFL, flags & ~O_NONBLOCK);
+        }
+
+        running = answer_socket_request(connection, home);
+        close(connection);
+    }
+}
+
+
+static boolean answer_socket_request(int connection, const char *home) {
+
+    static char request[SERVER_SOCKET_REQUEST_MAX_LEN];
+    char *args[SERVER_REQUEST_MAX_ARGS];
+    inline_source sources[SERVER_REQUEST_MAX_ARGS];
+    int sources_amount = 0;
+    char *cwd = NULL;
+    int args_count;
+    int saved_stdout;
+    boolean success = false;
+    boolean running = true;
+
+    args_count = read_socket_request(connection, request, &cwd, args, sources, &sources_amount);
+
+    /*the output of the request is sent to the client*/
+    fflush(stdout);
+    if ((saved_stdout = dup(STDOUT_FILENO)) == -1 || dup2(connection, STDOUT_FILENO) == -1) {
+        if (saved_stdout != -1) close(saved_stdout);
+        printf("ERROR: Can't send the output to the client.\n");
+        return true;
+    }
+
+    if (args_count == 0) {
+        printf("ERROR: Invalid request, not received within %d ms, or exceeds the maximum allowed length of %ld characters.\n",
+               SERVER_SOCKET_TIMEOUT_MS, SERVER_SOCKET_REQUEST_MAX_LEN);
+    }
+    else if (chdir(cwd) != 0) {
+        printf("ERROR: Working directory <%s> of the request is not available.\n", cwd);
+    }
+    else if (args_count == 2 && strcmp(args[1], SERVER_QUIT_REQUEST) == 0) {
+        printf("Assembler server stopped.\n");
+        success = true;
+        running = false;
+    }
+    else {
+        success = execute_request(args_count, args, sources, sources_amount);
+    }
+
+    /*the status of the request follows the output*/
+    putchar(SERVER_SOCKET_STATUS_MARK);
+    putchar(success ? SERVER_SOCKET_SUCCESS : SERVER_SOCKET_FAILURE);
+    fflush(stdout);
+
+    /*restore the standard output and the working directory of the server*/
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    if (chdir(home) != 0) {
+        printf("ERROR: Can't return to the working directory of the server.\n");
+        running = false;
+    }
+
+    return running;
+}
+
+
+static boolean execute_request(int args_count, char *args[], const inline_source *sources, int sources_amount) {
+
+    int files;
+    assembler_options options;
+    assembler_context *context;
+
+    if (args_count == -1) {
+        printf("ERROR: Request exceeds the maximum allowed amount of %d arguments.\n", SERVER_REQUEST_MAX_ARGS - 1);
+        return false;
+    }
+
+    /*symbol query (define/refs/hover), analyzed without a macro prelude*/
+    if (is_symbol_query(args[1])) {
+        if ((context = get_warm_context(&server_context, NULL)) == NULL) {
+            return false;
+        }
+        return run_symbol_query(args_count, args, context);
+    }
+
+    /*parse the request arguments exactly as command-line arguments*/
+    if (!parse_options(args_count, args, &options, &files)) {
+        return false;
+    }
+
+    /*a request can't start a nested server*/
+    if (options.serve) {
+        printf("ERROR: Server is already running.\n");
+        return false;
+    }
+
+    /*watch mode never ends, it would block the server*/
+    if (options.watch) {
+        printf("ERROR: Watch mode is not available in server mode.\n");
+        return false;
+    }
+
+    if (files < 1) {
+        printf("ERROR: Missing assembly source file input.\n");
+        return false;
+    }
+
+    /*reuse the output files of the unchanged sources, and assemble the sources sent with the request*/
+    options.reuse_unchanged = true;
+    options.inline_sources = sources;
+    options.inline_sources_amount = sources_amount;
+    return assemble_files(files, args, &options, &server_context);
+}
+
+
+static int open_server_socket(const char *socket_path) {
+
+    struct sockaddr_un address;
+    struct stat info;
+    int server_socket;
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("ERROR: Socket path <%s> is too long.\n", socket_path);
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    if ((server_socket = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+        printf("ERROR: Can't create the server socket.\n");
+        return -1;
+    }
+
+    /*replace the socket of a stopped server, never another file or a running server*/
+    if (stat(socket_path, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            printf("ERROR: File <%s> exists and is not a socket.\n", socket_path);
+            close(server_socket);
+            return -1;
+        }
+        if (connect(server_socket, (struct sockaddr*)&address, sizeof(address)) == 0) {
+            printf("ERROR: A server is already running on <%s>.\n", socket_path);
+            close(server_socket);
+            return -1;
+        }
+        close(server_socket);
+        unlink(socket_path);
+        if ((server_socket = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+            printf("ERROR: Can't create the server socket.\n");
+            return -1;
+        }
+    }
+
+    if (bind(server_socket, (struct sockaddr*)&address, sizeof(address)) == -1 ||
+        listen(server_socket, SERVER_SOCKET_BACKLOG) == -1) {
+        printf("ERROR: Can't listen on socket <%s>.\n", socket_path);
+        close(server_socket);
+        return -1;
+    }
+
+    return server_socket;
+}
+
+
+static int read_socket_request(int connection, char *request, char **cwd_out, char *args_out[],
+                               inline_source *sources_out, int *sources_amount_out) {
+
+    char length_field[SERVER_SOCKET_LENGTH_MAX_DIGITS + 1];
+    struct timespec deadline;
+    unsigned long length;
+    unsigned long position;
+    unsigned long option_length = strlen(SERVER_INLINE_SOURCE_OPTION);
+    char *field;
+    int digits = 0;
+    int count = 1;/*index 0 is reserved for the program name*/
+
+    /*the whole request must arrive before the deadline*/
+    if (clock_gettime(CLOCK_MONOTONIC, &deadline) == -1) {
+        return 0;
+    }
+    deadline.tv_sec += SERVER_SOCKET_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += (SERVER_SOCKET_TIMEOUT_MS % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    /*the length of the request, in digits terminated by '\0'*/
+    do {
+        if (digits > SERVER_SOCKET_LENGTH_MAX_DIGITS ||
+            !read_before_deadline(connection, length_field + digits, 1, &deadline)) {
+            return 0;
+        }
+    } while (length_field[digits++] != '\0');
+
+    if (digits == 1 || strspn(length_field, "0123456789") != (unsigned long)(digits - 1)) {
+        return 0;
+    }
+    length = strtoul(length_field, NULL, 10);
+    if (length == 0 || length >= (unsigned long)SERVER_SOCKET_REQUEST_MAX_LEN ||
+        !read_before_deadline(connection, request, length, &deadline)) {
+        return 0;
+    }
+
+    /*every field ends with '\0', the first is the working directory*/
+    if (request[length - 1] != '\0') {
+        return 0;
+    }
+    *cwd_out = request;
+    position = strlen(request) + 1;
+
+    *sources_amount_out = 0;
+    args_out[0] = "assembler";
+    while (position < length) {
+
+        /*no more place in the arguments array*/
+        if (count == SERVER_REQUEST_MAX_ARGS) {
+            return -1;
+        }
+        field = request + position;
+        position += strlen(field) + 1;
+
+        /*a source sent with the request: the file is an argument, the next field is its content*/
+        if (strncmp(field, SERVER_INLINE_SOURCE_OPTION, option_length) == 0 && field[option_length] == '=') {
+            if (field[option_length + 1] == '\0' || position >= length) {
+                return 0;
+            }
+            field += option_length + 1;
+            sources_out[*sources_amount_out].name = field;
+            sources_out[*sources_amount_out].text = request + position;
+            (*sources_amount_out)++;
+            position += strlen(request + position) + 1;
+        }
+
+        args_out[count++] = field;
+    }
+
+    return count;
+}
+
+
+static boolean read_before_deadline(int connection, char *buffer, unsigned long wanted, const struct timespec *deadline) {
+
+    struct pollfd waiting;
+    struct timespec now;
+    long remaining_ms;
+    long received;
+
+    waiting.fd = connection;
+    waiting.events = POLLIN;
+
+    while (wanted > 0) {
+        if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+            return false;
+        }
+        remaining_ms = (deadline->tv_sec - now.tv_sec) * 1000L + (deadline->tv_nsec - now.tv_nsec) / 1000000L;
+        if (remaining_ms <= 0) {
+            return false;
+        }
+
+        /*wait for the next part of the request, at most until the deadline*/
+        waiting.revents = 0;
+        switch (poll(&waiting, 1, (int)remaining_ms)) {
+            case -1:
+                if (errno == EINTR) continue;
+                return false;
+            case 0:
+                return false;
+            default:
+                break;
+        }
+
+        /*the client closed the connection before the end of the request*/
+        if ((received = read(connection, buffer, wanted)) <= 0) {
+            if (received < 0 && errno == EINTR) continue;
+            return false;
+        }
+        buffer += received;
+        wanted -= received;
+    }
+
+    return true;
+}
+
+
+static int split_request_line(char *line, char *args_out[]) {
+
+    char *p = line;
+    int count = 1;/*index 0 is reserved for the program name*/
+
+    args_out[0] = "assembler";
+
+    while (*p != '\0') {
+
+        /*jump over the white spaces, and cut the previous word*/
+        while (isspace((unsigned char)*p)) {
+            *p = '\0';
+            p++;
+        }
+
+        if (*p == '\0') {
+            break;
+        }
+
+        /*no more place in the arguments array*/
+        if (count == SERVER_REQUEST_MAX_ARGS) {
+            return -1;
+        }
+
+        /*save the start of the argument*/
+        args_out[count++] = p;
+
+        /*run over the word*/
+        while (*p != '\0' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,456 @@
+
+#include "simulator.h"
+#include <string.h>
+#include "addresses.h"
+#include "data_memory.h"
+#include "errors.h"
+#include "instruction_memory.h"
+#include "labels.h"
+#include "tables.h"
+#include "target.h"
+
+
+/**
+ * @file simulator.c
+ * @brief Simulator of the assembled program (used to verify the optimizations).
+ *
+ * The memory image is a plain array of memory words, the code is loaded at
+ * the load address of the target machine and the data right after it (the same
+ * layout as the second pass generates). Addresses below the code are
+ * invalid, so a jump or an access through an external label (address 0)
+ * stops the run.
+ *
+ * @date 17/10/2026
+ */
+
+
+/*first value of the "red" input sequence, and the sequence length*/
+#define SIM_INPUT_FIRST 'a'
+#define SIM_INPUT_LENGTH 26
+
+/*operand locations*/
+#define LOCATION_IMMEDIATE 0
+#define LOCATION_MEMORY 1
+#define LOCATION_REGISTER 2
+
+
+/**
+ * @struct sim_machine
+ * @brief State of the simulated machine.
+ */
+typedef struct sim_machine {
+    int memory[TARGET_MAX_MEMORY_CAPACITY]; /**< Memory words. */
+    int registers[REGISTERS_AMOUNT];        /**< Registers. */
+    unsigned int stack[SIMULATOR_STACK_SIZE]; /**< Return addresses stack. */
+    int stack_size;                         /**< Amount of return addresses in the stack. */
+    unsigned int pc;                        /**< Program counter. */
+    unsigned int code_end;                  /**< First address after the code. */
+    unsigned int memory_end;                /**< First address after the data. */
+    boolean zero_flag;                      /**< PSW Z flag. */
+    int inputs;                             /**< Amount of values read by "red". */
+    const_target_ptr target;                /**< Target machine profile (word layout and load address). */
+} sim_machine;
+
+
+/**
+ * @struct sim_operand
+ * @brief Location of a decoded operand.
+ */
+typedef struct sim_operand {
+    int location;     /**< LOCATION_IMMEDIATE, LOCATION_MEMORY or LOCATION_REGISTER. */
+    int value;        /**< Immediate value, memory address or register number. */
+} sim_operand;
+
+
+/*machine state, reset on every run*/
+static sim_machine machine;
+
+
+/**
+ * @brief Load the code and the data, and resolve the label operands.
+ */
+static void load_program(const assembler_context *asmContext);
+
+
+/**
+ * @brief Execute a single instruction.
+ *
+ * @param result [in/out] Simulation results (outputs).
+ * @return false if the program stopped (the reason is set in @p result).
+ */
+static boolean execute_instruction(sim_result *result);
+
+
+/**
+ * @brief Decode the operands words of an instruction.
+ *
+ * @param src_mode      Source addressing mode, or -1 if the instruction has no source operand.
+ * @param dest_mode     Destination addressing mode, or -1 if the instruction has no operands.
+ * @param src_out       [out] Source operand location.
+ * @param dest_out      [out] Destination operand location.
+ * @return false if an operand word is out of the code.
+ */
+static boolean decode_operands(int src_mode, int dest_mode, sim_operand *src_out, sim_operand *dest_out);
+
+
+/**
+ * @brief Decode a single operand (not a registers pair).
+ */
+static boolean decode_operand(int mode, boolean is_source, sim_operand *operand_out);
+
+
+/**
+ * @brief Read an operand value.
+ *
+ * @return false on an invalid memory address.
+ */
+static boolean read_operand(const sim_operand *operand, int *value_out);
+
+
+/**
+ * @brief Write an operand value.
+ *
+ * @return false on an invalid destination.
+ */
+static boolean write_operand(const sim_operand *operand, int value);
+
+
+/**
+ * @brief Check if an address is inside the loaded program.
+ */
+static boolean is_valid_address(int address);
+
+
+/**
+ * @brief Convert a value to a signed machine word.
+ */
+static int to_word(int value);
+
+
+
+
+boolean simulate_program(const assembler_context *asmContext, sim_result *result_out) {
+
+    /*verify that all input pointers exist*/
+    if (!asmContext || !result_out) {
+        print_internal_error(ERROR_CODE_25, "simulate_program");
+        return false;
+    }
+
+    load_program(asmContext);
+
+    result_out->stop = SIM_STEPS_LIMIT;
+    result_out->steps = 0;
+    result_out->outputs_count = 0;
+
+    while (result_out->steps < SIMULATOR_MAX_STEPS) {
+        result_out->steps++;
+        if (!execute_instruction(result_out)) {
+            break;
+        }
+    }
+
+    /*the final data memory*/
+    result_out->data_size = machine.memory_end - machine.code_end;
+    memcpy(result_out->data, &machine.memory[machine.code_end], result_out->data_size * sizeof(int));
+
+    return true;
+}
+
+
+boolean is_same_sim_result(const sim_result *result1, const sim_result *result2) {
+
+    int outputs;
+
+    if (!result1 || !result2) {
+        return false;
+    }
+
+    if (result1->stop != result2->stop ||
+        result1->outputs_count != result2->outputs_count ||
+        result1->data_size != result2->data_size) {
+        return false;
+    }
+
+    outputs = (result1->outputs_count < SIMULATOR_MAX_OUTPUTS) ? result1->outputs_count : SIMULATOR_MAX_OUTPUTS;
+
+    return memcmp(result1->outputs, result2->outputs, outputs * sizeof(int)) == 0 &&
+           memcmp(result1->data, result2->data, result1->data_size * sizeof(int)) == 0;
+}
+
+
+
+
+static void load_program(const assembler_context *asmContext) {
+
+    instruction_ptr instruction = asmContext->instruction_memory;
+    data_ptr data = asmContext->data_memory;
+    address_update_request_ptr request = asmContext->address_update_requests;
+    symbol_table_ptr labels = asmContext->labels;
+    int label;
+    unsigned int label_address;
+
+    memset(&machine, 0, sizeof(machine));
+
+    machine.target = asmContext->target;
+    machine.pc = machine.target->address_offset;
+    machine.code_end = machine.target->address_offset + asmContext->IC;
+    machine.memory_end = machine.code_end + asmContext->DC;
+
+    for (; instruction; instruction = instruction->next) {
+        machine.memory[machine.target->address_offset + instruction->address] = to_word(instruction->value);
+    }
+
+    for (; data; data = data->next) {
+        machine.memory[machine.code_end + data->address] = to_word(data->value);
+    }
+
+    /*resolve the label operands (external and undefined labels stay 0)*/
+    for (; request; request = request->next) {
+
+        label = find_label(operand_label(request->operand), labels);
+
+        if (label != NO_LABEL && labels->definitions[label] == NORMAL) {
+            label_address = machine.target->address_offset + labels->addresses[label] + (labels->types[label] == DATA ? asmContext->IC : 0);
+            machine.memory[machine.target->address_offset + request->address] =
+                to_word((int)machine.target->encode_data_word(label_address, RELOCATABLE));
+        }
+    }
+}
+
+
+static boolean execute_instruction(sim_result *result) {
+
+    const int *memory = machine.memory;
+    sim_operand src;
+    sim_operand dest;
+    unsigned int word;
+    int opcode_num;
+    int operands;
+    int src_value = 0;
+    int dest_value = 0;
+    boolean success = true;
+
+    if (machine.pc < machine.target->address_offset || machine.pc >= machine.code_end) {
+        result->stop = SIM_INVALID;
+        return false;
+    }
+
+    /*decode the first word*/
+    word = (unsigned int)memory[machine.pc] & machine.target->word_bit_mask;
+    opcode_num = (int)(word >> machine.target->opcode_bits_shift);
+    operands = get_opcode_table()[opcode_num].operands_amount;
+    machine.pc++;
+
+    if (!decode_operands(operands == 2 ? (int)((word & SRC_ADDR_MODE_BITS_MASK) >> SRC_ADDR_MODE_BITS_SHIFT) : -1,
+                         operands >= 1 ? (int)((word & DEST_ADDR_MODE_BITS_MASK) >> DEST_ADDR_MODE_BITS_SHIFT) : -1,
+                         &src, &dest)) {
+        result->stop = SIM_INVALID;
+        return false;
+    }
+
+    /*read the operands values (the addresses for lea and the jumps)*/
+    if (operands == 2 && opcode_num != LEA_OPCODE && !read_operand(&src, &src_value)) {
+        result->stop = SIM_INVALID;
+        return false;
+    }
+    if (operands >= 1 && !(get_opcode_effects(opcode_num) & CHANGES_FLOW) &&
+        opcode_num != MOV_OPCODE && opcode_num != LEA_OPCODE && opcode_num != CLR_OPCODE && opcode_num != RED_OPCODE &&
+        !read_operand(&dest, &dest_value)) {
+        result->stop = SIM_INVALID;
+        return false;
+    }
+
+    switch (opcode_num) {
+
+        case MOV_OPCODE: success = write_operand(&dest, src_value); break;
+        case CMP_OPCODE: machine.zero_flag = (to_word(src_value - dest_value) == 0); break;
+        case ADD_OPCODE: success = write_operand(&dest, dest_value + src_value); break;
+        case SUB_OPCODE: success = write_operand(&dest, dest_value - src_value); break;
+        case LEA_OPCODE: success = src.location == LOCATION_MEMORY && write_operand(&dest, src.value); break;
+        case CLR_OPCODE: success = write_operand(&dest, 0); break;
+        case NOT_OPCODE: success = write_operand(&dest, ~dest_value); break;
+        case INC_OPCODE: success = write_operand(&dest, dest_value + 1); break;
+        case DEC_OPCODE: success = write_operand(&dest, dest_value - 1); break;
+
+        case RED_OPCODE: {
+            success = write_operand(&dest, SIM_INPUT_FIRST + machine.inputs % SIM_INPUT_LENGTH);
+            machine.inputs++;
+            break;
+        }
+
+        case PRN_OPCODE: {
+            if (result->outputs_count < SIMULATOR_MAX_OUTPUTS) {
+                result->outputs[result->outputs_count] = dest_value;
+            }
+            result->outputs_count++;
+            break;
+        }
+
+        case JSR_OPCODE:
+        case JMP_OPCODE:
+        case BNE_OPCODE: {
+            /*bne jumps only when the Z flag is clear*/
+            if (opcode_num == BNE_OPCODE && machine.zero_flag) {
+                break;
+            }
+            /*jsr saves the return address*/
+            if (opcode_num == JSR_OPCODE) {
+                if (machine.stack_size >= SIMULATOR_STACK_SIZE) {
+                    success = false;
+                    break;
+                }
+                machine.stack[machine.stack_size++] = machine.pc;
+            }
+
+            if (dest.location == LOCATION_MEMORY) machine.pc = (unsigned int)dest.value;
+            else if (dest.location == LOCATION_REGISTER) machine.pc = (unsigned int)machine.registers[dest.value];
+            else success = false;
+            break;
+        }
+
+        case RTS_OPCODE: {
+            if (machine.stack_size == 0) {
+                success = false;
+                break;
+            }
+            machine.pc = machine.stack[--machine.stack_size];
+            break;
+        }
+
+        case STOP_OPCODE: {
+            result->stop = SIM_HALTED;
+            return false;
+        }
+
+        default: {
+            success = false;
+            break;
+        }
+    }
+
+    /*the arithmetic instructions set the Z flag by their result (the written destination)*/
+    if (success && (get_opcode_effects(opcode_num) & WRITES_FLAGS) && (get_opcode_effects(opcode_num) & WRITES_DEST)) {
+        success = read_operand(&dest, &dest_value);
+        machine.zero_flag = (dest_value == 0);
+    }
+
+    if (!success) {
+        result->stop = SIM_INVALID;
+    }
+
+    return success;
+}
+
+
+static boolean decode_operands(int src_mode, int dest_mode, sim_operand *src_out, sim_operand *dest_out) {
+
+    unsigned int word;
+
+    /*two register operands share a single word*/
+    if (src_mode == REGISTER_ACCESS && dest_mode == REGISTER_ACCESS) {
+        if (machine.pc >= machine.code_end) return false;
+        word = (unsigned int)machine.memory[machine.pc++] & machine.target->word_bit_mask;
+        src_out->location = LOCATION_REGISTER;
+        src_out->value = (int)((word & OPERAND_DATA_SRC_REG_MASK) >> OPERAND_DATA_SRC_REG_SHIFT);
+        dest_out->location = LOCATION_REGISTER;
+        dest_out->value = (int)((word & OPERAND_DATA_DEST_REG_MASK) >> OPERAND_DATA_DEST_REG_SHIFT);
+        return true;
+    }
+
+    if (src_mode != -1 && !decode_operand(src_mode, true, src_out)) {
+        return false;
+    }
+    if (dest_mode != -1 && !decode_operand(dest_mode, false, dest_out)) {
+        return false;
+    }
+
+    return true;
+}
+
+
+static boolean decode_operand(int mode, boolean is_source, sim_operand *operand_out) {
+
+    unsigned int word;
+    unsigned int regs_word;
+    int data_bits;
+
+    if (machine.pc >= machine.code_end) return false;
+    word = (unsigned int)machine.memory[machine.pc++] & machine.target->word_bit_mask;
+    data_bits = (int)(word >> machine.target->operand_data_bits_shift);
+
+    switch (mode) {
+
+        case IMMEDIATE_ACCESS: {
+            operand_out->location = LOCATION_IMMEDIATE;
+            /*sign extend the operand data bits*/
+            operand_out->value = (data_bits > MAX_NUM(machine.target->operand_data_bits)) ? data_bits - (1 << machine.target->operand_data_bits) : data_bits;
+            return true;
+        }
+
+        case DIRECT_ACCESS: {
+            operand_out->location = LOCATION_MEMORY;
+            operand_out->value = data_bits;
+            return true;
+        }
+
+        case MATRIX_ACCESS: {
+            if (machine.pc >= machine.code_end) return false;
+            regs_word = (unsigned int)machine.memory[machine.pc++] & machine.target->word_bit_mask;
+            operand_out->location = LOCATION_MEMORY;
+            operand_out->value = data_bits +
+                machine.registers[(regs_word & OPERAND_DATA_SRC_REG_MASK) >> OPERAND_DATA_SRC_REG_SHIFT] +
+                machine.registers[(regs_word & OPERAND_DATA_DEST_REG_MASK) >> OPERAND_DATA_DEST_REG_SHIFT];
+            return true;
+        }
+
+        default: {
+            operand_out->location = LOCATION_REGISTER;
+            operand_out->value = is_source ?
+                (int)((word & OPERAND_DATA_SRC_REG_MASK) >> OPERAND_DATA_SRC_REG_SHIFT) :
+                (int)((word & OPERAND_DATA_DEST_REG_MASK) >> OPERAND_DATA_DEST_REG_SHIFT);
+            return true;
+        }
+    }
+}
+
+
+static boolean read_operand(const sim_operand *operand, int *value_out) {
+
+    switch (operand->location) {
+        case LOCATION_IMMEDIATE: *value_out = operand->value; return true;
+        case LOCATION_REGISTER: *value_out = machine.registers[operand->value]; return true;
+        default: {
+            if (!is_valid_address(operand->value)) return false;
+            *value_out = machine.memory[operand->value];
+            return true;
+        }
+    }
+}
+
+
+static boolean write_operand(const sim_operand *operand, int value) {
+
+    switch (operand->location) {
+        case LOCATION_REGISTER: machine.registers[operand->value] = to_word(value); return true;
+        case LOCATION_MEMORY: {
+            if (!is_valid_address(operand->value)) return false;
+            machine.memory[operand->value] = to_word(value);
+            return true;
+        }
+        default: return false;
+    }
+}
+
+
+static boolean is_valid_address(int address) {
+
+    return address >= (int)machine.target->address_offset && address < (int)machine.memory_end;
+}
+
+
+static int to_word(int value) {
+
+    value &= (int)machine.target->word_bit_mask;
+    return (value > MAX_NUM(machine.target->word_bit_size)) ? value - (1 << machine.target->word_bit_size) : value;
+}
@@ -0,0 +1,347 @@
+
+#include "size_report.h"
+#include <stdio.h>
+#include "config.h"
+#include "errors.h"
+#include "intern_pool.h"
+#include "instructions.h"
+#include "lines_map.h"
+#include "pre_processor.h"
+#include "sys_memory.h"
+#include "target.h"
+
+
+/**
+ * @file size_report.c
+ * @brief Code size report and memory budget analysis ("--size-report").
+ *
+ * The records are collected by the first pass (one record for every
+ * instruction or data line), independently of the memory images, so the
+ * lines that didn't fit into the memory are counted as well.
+ *
+ * Attribution of the words:
+ *  - Label: the last code (or data) label defined up to the line.
+ *  - Macro expansion: the macro whose body contains the original .as line.
+ *  - Source line: the original .as line (through the lines map).
+ *
+ * @date 17/10/2026
+ */
+
+
+/**
+ * @struct size_consumer
+ * @brief Words attributed to a single consumer (label, macro or line).
+ */
+typedef struct size_consumer {
+    const char *name;      /**< Consumer name (NULL for source lines). */
+    unsigned int words;    /**< Attributed words. */
+} size_consumer;
+
+
+/*addressing modes names, indexed by addr_Mode*/
+static const char *addressing_modes_names[] = {
+    "immediate",
+    "direct",
+    "matrix",
+    "register"
+};
+
+#define ADDRESSING_MODES_AMOUNT 4
+
+
+/**
+ * @brief Count the words of every addressing mode in an instruction record.
+ *
+ * Immediate, direct and register operands take one word, matrix operands
+ * take two words (label address + registers word), and two register
+ * operands share a single word.
+ *
+ * @param record        Instruction record.
+ * @param operands_out  [in/out] Operands counter of every addressing mode.
+ * @param words_out     [in/out] Words counter of every addressing mode.
+ */
+static void count_operand_words(const size_record *record, unsigned int operands_out[], unsigned int words_out[]);
+
+
+/**
+ * @brief Print the top consumers of a consumers array, largest first.
+ *
+ * The words of the printed consumers are reset (the array is a temporary one).
+ *
+ * @param title     Consumers type title.
+ * @param consumers Consumers array.
+ * @param amount    Amount of consumers in the array.
+ */
+static void print_top_consumers(const char *title, size_consumer consumers[], int amount);
+
+
+/**
+ * @brief Find the macro whose body contains an original .as line.
+ *
+ * @return Index of the macro in the macros list, or -1 if the line is not a macro line.
+ */
+static int get_macro_index(int as_line, macro_ptr macro_list);
+
+
+
+
+boolean add_size_record(int file_line, unsigned int words, addr_type type, int src_mode, int dest_mode, size_record_ptr *records_list) {
+
+    size_record_ptr new_record;
+    size_record_ptr temp;
+
+    /*verify that all input pointers exist*/
+    if (!records_list) {
+        print_internal_error(ERROR_CODE_25,"add_size_record");
+        return false;
+    }
+
+    /*allocate memory for new node*/
+    new_record = (size_record_ptr)handle_malloc(sizeof(size_record));
+
+    new_record->file_line = file_line;
+    new_record->words = words;
+    new_record->type = type;
+    new_record->src_mode = src_mode;
+    new_record->dest_mode = dest_mode;
+    new_record->next = NULL;
+
+    /*add the node in the end of the list*/
+    if (*records_list == NULL) {
+        *records_list = new_record;
+    }
+    else {
+        temp = *records_list;
+        while (temp->next != NULL) {
+            temp = temp->next;
+        }
+        temp->next = new_record;
+    }
+
+    return true;
+}
+
+
+void print_size_report(const assembler_context *asmContext) {
+
+    size_record_ptr record;
+    symbol_table_ptr symbols;
+    macro_ptr macro_tmp;
+    lines_map_ptr lines_tmp;
+    size_consumer *labels = NULL;
+    size_consumer *macros = NULL;
+    size_consumer *lines = NULL;
+    unsigned int operands[ADDRESSING_MODES_AMOUNT] = {0};
+    unsigned int mode_words[ADDRESSING_MODES_AMOUNT] = {0};
+    unsigned int code_words = 0;
+    unsigned int data_words = 0;
+    unsigned int opcode_words = 0;
+    int symbols_amount;
+    int macros_amount = 0;
+    int max_line = 0;
+    int code_label = 0;   /*index 0 is "no label"*/
+    int data_label = 0;
+    int label_id;
+    int macro_index;
+    int as_line;
+    int i;
+
+    if (!asmContext) {
+        print_internal_error(ERROR_CODE_25,"print_size_report");
+        return;
+    }
+
+    /*- - - prepare the consumers arrays - - -*/
+    symbols = asmContext->labels;
+    symbols_amount = labels_amount(symbols);
+    for (macro_tmp = asmContext->macros; macro_tmp; macro_tmp = macro_tmp->next) macros_amount++;
+    for (lines_tmp = asmContext->lines_maper; lines_tmp; lines_tmp = lines_tmp->next) {
+        if (lines_tmp->orign_line_num > max_line) max_line = lines_tmp->orign_line_num;
+    }
+
+    labels = (size_consumer*)handle_malloc(sizeof(size_consumer) * (symbols_amount + 1));
+    macros = (size_consumer*)handle_malloc(sizeof(size_consumer) * (macros_amount + 1));
+    lines = (size_consumer*)handle_malloc(sizeof(size_consumer) * (max_line + 1));
+
+    labels[0].name = "(no label)";
+    labels[0].words = 0;
+    for (label_id = 0; label_id < symbols_amount; label_id++) {
+        labels[label_id + 1].name = label_name(symbols, label_id);
+        labels[label_id + 1].words = 0;
+    }
+    for (i = 0, macro_tmp = asmContext->macros; macro_tmp; macro_tmp = macro_tmp->next, i++) {
+        macros[i].name = get_name(asmContext->names, macro_tmp->name);
+        macros[i].words = 0;
+    }
+    for (i = 0; i <= max_line; i++) {
+        lines[i].name = NULL;
+        lines[i].words = 0;
+    }
+
+    /*- - - attribute the words of every record - - -*/
+
+    /*the records, the labels and the lines map are ordered by the .am lines*/
+    label_id = 0;
+    lines_tmp = asmContext->lines_maper;
+
+    for (record = asmContext->size_records; record; record = record->next) {
+
+        /*update the current code and data labels*/
+        while (label_id < symbols_amount && symbols->define_lines[label_id] <= record->file_line) {
+            if (symbols->definitions[label_id] == NORMAL) {
+                if (symbols->types[label_id] == CODE) code_label = label_id + 1;
+                else data_label = label_id + 1;
+            }
+            label_id++;
+        }
+
+        /*get the original .as line*/
+        while (lines_tmp && lines_tmp->new_line_num < record->file_line) {
+            lines_tmp = lines_tmp->next;
+        }
+        as_line = (lines_tmp && lines_tmp->new_line_num == record->file_line) ? lines_tmp->orign_line_num : 0;
+
+        if (record->type == CODE) {
+            code_words += record->words;
+            opcode_words++;
+            count_operand_words(record, operands, mode_words);
+            labels[code_label].words += record->words;
+        }
+        else {
+            data_words += record->words;
+            labels[data_label].words += record->words;
+        }
+
+        if ((macro_index = get_macro_index(as_line, asmContext->macros)) != -1) {
+            macros[macro_index].words += record->words;
+        }
+
+        lines[as_line].words += record->words;
+    }
+
+    /*- - - print the report - - -*/
+    printf("\n- - - Size report: <%s> - - -\n\n", asmContext->as_file_name);
+
+    printf("Memory words required: %u (code: %u, data: %u), available: %u.\n",
+           code_words + data_words, code_words, data_words, asmContext->target->memory_available_space);
+
+    if (code_words + data_words > asmContext->target->memory_available_space) {
+        printf("Memory overflow: %u word(s) over the available memory.\n", code_words + data_words - asmContext->target->memory_available_space);
+    }
+    else {
+        printf("Memory free: %u word(s).\n", asmContext->target->memory_available_space - (code_words + data_words));
+    }
+
+    printf("\nInstruction words by addressing mode:\n");
+    printf("\t%-10s\t%u word(s)\n", "opcode", opcode_words);
+    for (i = 0; i < ADDRESSING_MODES_AMOUNT; i++) {
+        printf("\t%-10s\t%u word(s), %u operand(s)", addressing_modes_names[i], mode_words[i], operands[i]);
+        if (i == MATRIX_ACCESS && operands[i] > 0) {
+            printf(" (+1 registers word per operand)");
+        }
+        if (i == REGISTER_ACCESS && operands[i] > mode_words[i]) {
+            printf(" (two register operands share a word)");
+        }
+        printf("\n");
+    }
+
+    print_top_consumers("labels", labels, symbols_amount + 1);
+    print_top_consumers("macro expansions", macros, macros_amount);
+    print_top_consumers("source lines", lines, max_line + 1);
+    printf("\n");
+
+    safe_free((void**)&labels);
+    safe_free((void**)&macros);
+    safe_free((void**)&lines);
+}
+
+
+void free_size_records(size_record_ptr *records_list) {
+
+    size_record_ptr temp;
+
+    if (!records_list) return;
+
+    while (*records_list != NULL) {
+        temp = *records_list;
+        *records_list = (*records_list)->next;
+        safe_free((void**)&temp);
+    }
+}
+
+
+
+
+static void count_operand_words(const size_record *record, unsigned int operands_out[], unsigned int words_out[]) {
+
+    /*two registers operands are encoded in a single word*/
+    if (record->src_mode == REGISTER_ACCESS && record->dest_mode == REGISTER_ACCESS) {
+        operands_out[REGISTER_ACCESS] += 2;
+        words_out[REGISTER_ACCESS]++;
+        return;
+    }
+
+    if (record->src_mode != NO_OPERAND) {
+        operands_out[record->src_mode]++;
+        words_out[record->src_mode] += (record->src_mode == MATRIX_ACCESS) ? 2 : 1;
+    }
+
+    if (record->dest_mode != NO_OPERAND) {
+        operands_out[record->dest_mode]++;
+        words_out[record->dest_mode] += (record->dest_mode == MATRIX_ACCESS) ? 2 : 1;
+    }
+}
+
+
+static void print_top_consumers(const char *title, size_consumer consumers[], int amount) {
+
+    int top;
+    int max_index;
+    int i;
+
+    printf("\nTop consumers (%s):\n", title);
+
+    for (top = 0; top < SIZE_REPORT_TOP_CONSUMERS; top++) {
+
+        /*find the largest consumer left*/
+        max_index = -1;
+        for (i = 0; i < amount; i++) {
+            if (consumers[i].words > 0 && (max_index == -1 || consumers[i].words > consumers[max_index].words)) {
+                max_index = i;
+            }
+        }
+
+        if (max_index == -1) {
+            break;
+        }
+
+        if (consumers[max_index].name) {
+            printf("\t%-*s\t%u word(s)\n", NAME_MAX_LEN, consumers[max_index].name, consumers[max_index].words);
+        }
+        else {
+            printf("\tline %-*d\t%u word(s)\n", NAME_MAX_LEN - 5, max_index, consumers[max_index].words);
+        }
+
+        consumers[max_index].words = 0;
+    }
+
+    if (top == 0) {
+        printf("\t(none)\n");
+    }
+}
+
+
+static int get_macro_index(int as_line, macro_ptr macro_list) {
+
+    int index = 0;
+
+    while (macro_list) {
+        if (as_line > macro_list->define_line && as_line <= macro_list->define_line + macro_list->lines) {
+            return index;
+        }
+        macro_list = macro_list->next;
+        index++;
+    }
+
+    return -1;
+}
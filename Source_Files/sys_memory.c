@@ -1,14 +1,21 @@
 
 #include "sys_memory.h"
+#include <string.h>
 #include <addresses.h>
 #include <data_memory.h>
 #include <labels.h>
 #include <pre_processor.h>
+#include "config.h"
 #include "errors.h"
 #include <stdlib.h>
 #include "externals.h"
 #include "lines_map.h"
+#include "intern_pool.h"
+#include "memory_image.h"
 #include "instruction_memory.h"
+#include "node_pool.h"
+#include "size_report.h"
+#include "util.h"
 
 
 /**
@@ -22,6 +29,13 @@
  *  - Tracks every allocation in a linked list (`allocationNode`).
  *  - Ensures proper deallocation via `safe_free()` and `free_all_tracked_allocations()`.
  *  - Automatically updates tracking when memory is reallocated.
+ *  - Allocates the fixed size objects (the lists nodes) from slab caches,
+ *    a tracked block of many objects at a time.
+ *  - Keeps the grown buffers and tables of the context between the files of
+ *    a batch (`retain_allocation()` and `recycle_all_memory()`).
+ *  - In the STATIC_NODE_POOLS build, takes every block (and every tracking
+ *    node) from a static heap of STATIC_HEAP_SIZE bytes instead of the C
+ *    library heap, so the assembler makes no heap allocation.
  *  - On allocation failure:
  *      - Prints a system error.
  *      - Frees all tracked allocations.
@@ -30,8 +44,9 @@
  * Usage notes:
  *  - Always use `handle_malloc()`, `handle_realloc()`, and `safe_free()` instead
  *    of raw `malloc`, `realloc`, or `free`.
- *  - Call `free_all_memory()` at the end of each file’s assembly or when aborting
- *    to release both assembler data structures and tracked allocations.
+ *  - Call `recycle_all_memory()` at the end of each file’s assembly, and
+ *    `free_all_memory()` at the end of the batch or when aborting to release
+ *    both assembler data structures and tracked allocations.
  *  - Because allocation failures terminate the program, **no need to check for NULL**
  *    after `handle_malloc()` or `handle_realloc()`.
  *
@@ -76,19 +91,22 @@ static void allocation_track_add(void *ptr);
 
 
 /**
- * @brief Remove a pointer from the tracking list.
+ * @brief Remove a pointer from a tracking list.
  *
  * Used when a memory block is freed to ensure the tracking list stays in sync.
  *
- * @param ptr Pointer to the memory block being freed.
+ * @param list Head of the tracking list.
+ * @param ptr  Pointer to the memory block being freed.
+ * @return The removed node (NULL if the pointer isn't in the list), the caller frees it.
  */
-static void allocation_track_remove(const void *ptr);
+static allocationNode* allocation_track_remove(allocationNode **list, const void *ptr);
 
 
 /**
  * @brief Update an existing tracked pointer after realloc().
  *
- * If realloc() changes the pointer address, this updates the entry in the list.
+ * If realloc() changes the pointer address, this updates the entry in the
+ * lists (the per file list or the kept allocations list).
  * If the old pointer is not found, the new pointer is added.
  *
  * @param old_ptr The old pointer before reallocation.
@@ -97,6 +115,94 @@ static void allocation_track_remove(const void *ptr);
 static void allocation_track_update(const void *old_ptr, void *new_ptr);
 
 
+/**
+ * @brief Free a tracking list: every tracked pointer and the list nodes.
+ *
+ * @param list Head of the tracking list (set to NULL).
+ */
+static void free_tracking_list(allocationNode **list);
+
+
+/**
+ * @brief Free the file names of the context (set to NULL).
+ */
+static void free_file_names(assembler_context *asmContext);
+
+
+/**
+ * @brief Allocate a new slab for a cache (or reuse a spare slab) and make it the current slab.
+ */
+static void slab_grow(slab_cache *cache);
+
+
+#ifdef STATIC_NODE_POOLS
+/**
+ * @struct heap_block
+ * @brief Header of a block of the static heap.
+ *
+ * The blocks follow each other from the start of the heap up to its top.
+ * The size of the previous block links the blocks backwards, so a released
+ * block is merged with both its free neighbours. A free block at the top is
+ * returned to the top instead of being listed.
+ */
+typedef struct heap_block {
+    unsigned long size;                  /**< Block size, with the header. */
+    unsigned long previous_size;         /**< Size of the block before it (0 for the first block). */
+    boolean free;                        /**< The block is in the free blocks list. */
+    struct heap_block *next_free;        /**< Next free block. */
+    struct heap_block *previous_free;    /**< Previous free block. */
+} heap_block;
+
+
+/**
+ * @brief Allocate a block of the static heap.
+ *
+ * @return The block memory, or NULL if the static heap is full.
+ */
+static void* static_heap_alloc(unsigned long size);
+
+
+/**
+ * @brief Resize a block of the static heap (a NULL pointer allocates a new block).
+ *
+ * @return The resized block, or NULL if the static heap is full (the block is unchanged).
+ */
+static void* static_heap_realloc(void *pointer, unsigned long size);
+
+
+/**
+ * @brief Release a block of the static heap (NULL is ignored).
+ */
+static void static_heap_free(void *pointer);
+
+
+/**
+ * @brief Remove a free block from the free blocks list of the static heap.
+ */
+static void static_heap_unlink(heap_block *block);
+
+
+/*the heap of the build*/
+#define system_malloc static_heap_alloc
+#define system_realloc static_heap_realloc
+#define system_free static_heap_free
+#else
+#define system_malloc malloc
+#define system_realloc realloc
+#define system_free free
+#endif
+
+
+#ifdef SLAB_DEBUG
+/**
+ * @brief Verify that a released object wasn't modified (still poisoned).
+ *
+ * @param slot The object slot (including the state word).
+ */
+static void slab_check_poison(const slab_cache *cache, const char *slot);
+#endif
+
+
 
 
 
@@ -106,6 +212,42 @@ static void allocation_track_update(const void *old_ptr, void *new_ptr);
 
 static allocationNode *allocation_node_ptr = NULL;
 
+/*allocations kept between the files (not freed by free_all_tracked_allocations)*/
+static allocationNode *retained_allocations = NULL;
+
+
+/*alignment unit of the slabs and the slab objects*/
+typedef union slab_align { void *pointer; long integer; double real; } slab_align;
+
+#ifdef SLAB_DEBUG
+/*state word before every object (debug builds)*/
+#define SLAB_STATE_SIZE sizeof(slab_align)
+#define SLAB_OBJECT_LIVE 0x51AB0001L
+#define SLAB_OBJECT_FREE 0x51AB0002L
+#define slab_state(slot) (((slab_align*)(slot))->integer)
+#else
+#define SLAB_STATE_SIZE 0
+#endif
+
+/*the free list link is kept in the first word of a released object*/
+#define slab_link(slot) (*(void**)((char*)(slot) + SLAB_STATE_SIZE))
+
+
+#ifdef STATIC_NODE_POOLS
+/*sizes of the headers and the blocks are alignment units multiples*/
+#define heap_round(size) (((size) + sizeof(slab_align) - 1) / sizeof(slab_align) * sizeof(slab_align))
+#define HEAP_HEADER_SIZE heap_round(sizeof(heap_block))
+#define heap_next(block) ((heap_block*)((char*)(block) + (block)->size))
+#define heap_previous(block) ((heap_block*)((char*)(block) - (block)->previous_size))
+
+static slab_align static_heap[STATIC_HEAP_SIZE / sizeof(slab_align)];
+static unsigned long heap_top = 0;          /*bytes taken from the start of the heap*/
+static heap_block *heap_last = NULL;        /*block just below the top (never free)*/
+static heap_block *heap_free_blocks = NULL; /*released blocks below the top*/
+
+#endif
+
+
 static void allocation_track_add(void *ptr) {
 
 
@@ -113,7 +255,7 @@ static void allocation_track_add(void *ptr) {
 
     if (!ptr) return;/*not input ptr*/
 
-    node = (allocationNode*)malloc(sizeof(allocationNode));/*allocate memory for ptr*/
+    node = (allocationNode*)system_malloc(sizeof(allocationNode));/*allocate memory for ptr*/
     if (!node) return; /*in the worst case, node wouldn't be tracked*/
 
     /*set values*/
@@ -122,10 +264,10 @@ static void allocation_track_add(void *ptr) {
     allocation_node_ptr = node;
 }
 
-static void allocation_track_remove(const void *ptr) {
+static allocationNode* allocation_track_remove(allocationNode **list, const void *ptr) {
 
     allocationNode *previous = NULL;
-    allocationNode *current = allocation_node_ptr;
+    allocationNode *current = *list;
 
     /*search for the input node*/
     while (current) {
@@ -138,41 +280,64 @@ static void allocation_track_remove(const void *ptr) {
                 previous->next = current->next;
             }
             else {
-                allocation_node_ptr = current->next;
+                *list = current->next;
             }
-            /*free the removed node memory*/
-            free(current);
-            return;
+            return current;
         }
         /*search in the next node*/
         previous = current;
         current = current->next;
     }
+    return NULL;
 }
 
 static void allocation_track_update(const void *old_ptr, void *new_ptr) {
 /*used to change pointer on memory reallocation*/
 
-    allocationNode *current = allocation_node_ptr;
+    allocationNode *lists[2];
+    allocationNode *current;
+    int i;
+
+    /*the per file allocations, and then the kept allocations*/
+    lists[0] = allocation_node_ptr;
+    lists[1] = retained_allocations;
 
     /*search for the old node*/
-    while (current) {
+    for (i = 0; i < 2; i++) {
+        for (current = lists[i]; current; current = current->next) {
 
-        if (current->ptr == old_ptr) {
-            /*set the old node as new node*/
-            current->ptr = new_ptr;
-            return;
+            if (current->ptr == old_ptr) {
+                /*set the old node as new node*/
+                current->ptr = new_ptr;
+                return;
+            }
         }
-        current = current->next;
     }
     /*if old pointer wasn't exist or NULL, add the new ptr*/
     allocation_track_add(new_ptr);
 }
 
 
+void retain_allocation(void *ptr) {
+
+    allocationNode *node;
+
+    /*move the node to the kept allocations*/
+    if ((node = allocation_track_remove(&allocation_node_ptr, ptr)) != NULL) {
+        node->next = retained_allocations;
+        retained_allocations = node;
+    }
+}
+
+
 void free_all_tracked_allocations(void) {
+    free_tracking_list(&allocation_node_ptr);
+}
 
-    allocationNode *current = allocation_node_ptr;
+
+static void free_tracking_list(allocationNode **list) {
+
+    allocationNode *current = *list;
     allocationNode *next = NULL;
     while (current) {
         /*hold the next node and free the current*/
@@ -180,16 +345,16 @@ void free_all_tracked_allocations(void) {
 
         /*free the ptr if not NULL*/
         if (current->ptr) {
-            free(current->ptr);
+            system_free(current->ptr);
         }
 
         /*free the node*/
-        free(current);
+        system_free(current);
         current = next;
     }
 
     /*set the head as NULL*/
-    allocation_node_ptr = NULL;
+    *list = NULL;
 }
 
 
@@ -199,7 +364,7 @@ void* handle_malloc(unsigned long size) {
     void *ptr;
 
     /*allocate memory*/
-    ptr = (void*)malloc(size);
+    ptr = (void*)system_malloc(size);
     if (ptr == NULL) {
         /*allocation failed, print an error*/
         print_system_error(ERROR_CODE_1);
@@ -214,7 +379,7 @@ void* handle_malloc(unsigned long size) {
 void* handle_realloc(void* pointer, unsigned long size) {
     void *new_ptr;
 
-    new_ptr = (void*)realloc(pointer, size);
+    new_ptr = (void*)system_realloc(pointer, size);
     if (new_ptr == NULL) {
         print_system_error(ERROR_CODE_11);  /* “Memory reallocation failed” */
         return NULL;
@@ -243,13 +408,18 @@ void* handle_realloc(void* pointer, unsigned long size) {
 
 void safe_free(void **ptr_ptr) {
 
+    allocationNode *node;
+
     /*verify that the input is not NULL, and the pointer value not NULL*/
     if (ptr_ptr && *ptr_ptr) {
 
-        /*remove the pointer from tracking list*/
-        allocation_track_remove(*ptr_ptr);
+        /*remove the pointer from tracking list (per file or kept)*/
+        if ((node = allocation_track_remove(&allocation_node_ptr, *ptr_ptr)) == NULL) {
+            node = allocation_track_remove(&retained_allocations, *ptr_ptr);
+        }
+        system_free(node);
         /*free memory*/
-        free(*ptr_ptr);
+        system_free(*ptr_ptr);
         /*set the pointer as NULL*/
         *ptr_ptr = NULL;
     }
@@ -259,19 +429,70 @@ void safe_free(void **ptr_ptr) {
 
 
 
-void free_all_memory(assembler_context *asmContext) {
+void recycle_all_memory(assembler_context *asmContext) {
 
-    /*execute free functions for all linked lists*/
+    /*the nodes of the lists return to their pools, the slabs are kept*/
+    asmContext->address_update_requests = NULL;
+    asmContext->macros = NULL;
+    asmContext->data_memory = NULL;
+    asmContext->instruction_memory = NULL;
+    asmContext->external_labels = NULL;
+    asmContext->lines_maper = NULL;
+    reset_node_pools();
 
-    free_addr_update_req_list(&asmContext->address_update_requests);
-    free_macro_list(&asmContext->macros);
+    /*empty the kept tables and buffers (their memory stays allocated)*/
+    reset_symbol_table(asmContext->labels);
+    reset_intern_pool(asmContext->names);
+    reset_memory_image(asmContext->memory_image);
+    clear_text_buffer(&asmContext->line_buffer);
+    clear_text_buffer(&asmContext->am_buffer);
+    asmContext->entry_lines_amount = 0;
+
+    /*free the file structures*/
+    free_size_records(&asmContext->size_records);
+    free_file_names(asmContext);
+
+    free_all_tracked_allocations();
+}
+
+
+void free_all_memory(assembler_context *asmContext) {
+
+    /*the nodes of the lists are released all together with their pools
+     *(the memory the nodes point to, like the operands and the macro contents,
+     * is tracked and freed with the other allocations below)*/
+    asmContext->address_update_requests = NULL;
+    asmContext->macros = NULL;
+    asmContext->prelude_macros = NULL;
+    asmContext->data_memory = NULL;
+    asmContext->instruction_memory = NULL;
+    asmContext->external_labels = NULL;
+    asmContext->lines_maper = NULL;
+    release_node_pools();
+
+    /*execute free functions for the other structures*/
     free_label_list(&asmContext->labels);
-    free_data_memory(&asmContext->data_memory);
-    free_instruction_memory(&asmContext->instruction_memory);
-    free_externals_usage_list(&asmContext->external_labels);
-    free_lines_map(&asmContext->lines_maper);
+    free_size_records(&asmContext->size_records);
+    free_memory_image(&asmContext->memory_image);
+    free_intern_pool(&asmContext->names);
+    free_text_buffer(&asmContext->line_buffer);
+    free_text_buffer(&asmContext->am_buffer);
+    safe_free((void**)&asmContext->entry_lines);
+    asmContext->entry_lines_amount = 0;
+    asmContext->entry_lines_capacity = 0;
 
     /*free assembler context allocated memory*/
+    free_file_names(asmContext);
+
+
+    free_all_tracked_allocations();
+    free_tracking_list(&retained_allocations);
+
+
+}
+
+
+static void free_file_names(assembler_context *asmContext) {
 
     safe_free((void**)&asmContext->am_file_name);
     safe_free((void**)&asmContext->ext_file_name);
@@ -279,12 +500,302 @@ void free_all_memory(assembler_context *asmContext) {
     safe_free((void**)&asmContext->ent_file_name);
     safe_free((void**)&asmContext->as_file_name);
     safe_free((void**)&asmContext->bin_file_name);
+    safe_free((void**)&asmContext->xref_file_name);
+    safe_free((void**)&asmContext->lst_file_name);
     safe_free((void**)&asmContext->file_path);
     safe_free((void**)&asmContext->am_full_file_name);
     safe_free((void**)&asmContext->as_full_file_name);
+}
 
 
-    free_all_tracked_allocations();
 
+void init_slab_cache(slab_cache *cache, unsigned long object_size) {
+
+    /*room for the free list link, and the alignment of every object*/
+    if (object_size < sizeof(void*)) {
+        object_size = sizeof(void*);
+    }
+    object_size = (object_size + sizeof(slab_align) - 1) / sizeof(slab_align) * sizeof(slab_align);
+
+    cache->object_size = object_size + SLAB_STATE_SIZE;
+    cache->slabs = NULL;
+    cache->spare_slabs = NULL;
+    cache->next_object = NULL;
+    cache->slab_end = NULL;
+    cache->free_list = NULL;
+}
+
+
+void* slab_alloc(slab_cache *cache) {
+
+    char *slot;
 
+    if (cache->free_list != NULL) {
+        /*reuse a released object*/
+        slot = (char*)cache->free_list;
+        cache->free_list = slab_link(slot);
+#ifdef SLAB_DEBUG
+        slab_check_poison(cache, slot);
+#endif
+    }
+    else {
+        /*take the next object of the current slab (a new slab if it's full)*/
+        if (cache->next_object == cache->slab_end) {
+            slab_grow(cache);
+        }
+        slot = cache->next_object;
+        cache->next_object += cache->object_size;
+    }
+
+#ifdef SLAB_DEBUG
+    slab_state(slot) = SLAB_OBJECT_LIVE;
+#endif
+    return slot + SLAB_STATE_SIZE;
+}
+
+
+void slab_free(slab_cache *cache, void **object_ptr) {
+
+    char *slot;
+
+    if (!cache || !object_ptr || !*object_ptr) {
+        return;
+    }
+
+    slot = (char*)*object_ptr - SLAB_STATE_SIZE;
+
+#ifdef SLAB_DEBUG
+    /*an object is released only once, and the released object is poisoned*/
+    if (slab_state(slot) != SLAB_OBJECT_LIVE) {
+        print_system_error(ERROR_CODE_13);
+    }
+    slab_state(slot) = SLAB_OBJECT_FREE;
+    memset(slot + SLAB_STATE_SIZE, SLAB_POISON_BYTE, cache->object_size - SLAB_STATE_SIZE);
+#endif
+
+    /*push the object to the free list*/
+    slab_link(slot) = cache->free_list;
+    cache->free_list = slot;
+    *object_ptr = NULL;
+}
+
+
+void slab_release(slab_cache *cache) {
+
+    void *slab;
+
+    if (!cache) {
+        return;
+    }
+
+    /*free the slabs one by one (not the objects)*/
+    slab_reset(cache);
+    while (cache->spare_slabs != NULL) {
+        slab = cache->spare_slabs;
+        cache->spare_slabs = *(void**)slab;
+        safe_free(&slab);
+    }
+}
+
+
+void slab_reset(slab_cache *cache) {
+
+    void *slab;
+
+    if (!cache) {
+        return;
+    }
+
+    /*move the slabs to the spare slabs (the next slabs to use)*/
+    while (cache->slabs != NULL) {
+        slab = cache->slabs;
+        cache->slabs = *(void**)slab;
+        *(void**)slab = cache->spare_slabs;
+        cache->spare_slabs = slab;
+    }
+
+    cache->next_object = NULL;
+    cache->slab_end = NULL;
+    cache->free_list = NULL;
+}
+
+
+static void slab_grow(slab_cache *cache) {
+
+    char *slab;
+
+    if (cache->spare_slabs != NULL) {
+        /*reuse a slab of a previous file*/
+        slab = (char*)cache->spare_slabs;
+        cache->spare_slabs = *(void**)slab;
+    }
+    else {
+        /*the slabs are kept between the files*/
+        slab = (char*)handle_malloc(sizeof(slab_align) + cache->object_size * SLAB_OBJECTS);
+        retain_allocation(slab);
+    }
+
+    /*a link to the previous slab, and then the objects*/
+    *(void**)slab = cache->slabs;
+    cache->slabs = slab;
+
+    cache->next_object = slab + sizeof(slab_align);
+    cache->slab_end = cache->next_object + cache->object_size * SLAB_OBJECTS;
+}
+
+
+#ifdef SLAB_DEBUG
+static void slab_check_poison(const slab_cache *cache, const char *slot) {
+
+    unsigned long i;
+
+    if (slab_state(slot) != SLAB_OBJECT_FREE) {
+        print_system_error(ERROR_CODE_14);
+    }
+
+    /*every byte after the free list link*/
+    for (i = SLAB_STATE_SIZE + sizeof(void*); i < cache->object_size; i++) {
+        if ((unsigned char)slot[i] != SLAB_POISON_BYTE) {
+            print_system_error(ERROR_CODE_14);
+        }
+    }
+}
+#endif
+
+
+#ifdef STATIC_NODE_POOLS
+static void* static_heap_alloc(unsigned long size) {
+
+    unsigned long block_size = HEAP_HEADER_SIZE + heap_round(size > 0 ? size : 1);
+    heap_block *block;
+    heap_block *rest;
+
+    /*the first released block that fits, split if the rest can hold a block*/
+    for (block = heap_free_blocks; block != NULL; block = block->next_free) {
+
+        if (block->size < block_size) {
+            continue;
+        }
+
+        static_heap_unlink(block);
+        if (block->size - block_size >= HEAP_HEADER_SIZE + sizeof(slab_align)) {
+            rest = (heap_block*)((char*)block + block_size);
+            rest->size = block->size - block_size;
+            rest->previous_size = block_size;
+            heap_next(rest)->previous_size = rest->size;/*a free block is never the last block*/
+            block->size = block_size;
+            rest->free = true;
+            rest->previous_free = NULL;
+            rest->next_free = heap_free_blocks;
+            if (heap_free_blocks) heap_free_blocks->previous_free = rest;
+            heap_free_blocks = rest;
+        }
+        return (char*)block + HEAP_HEADER_SIZE;
+    }
+
+    /*a new block at the top*/
+    if (block_size > sizeof(static_heap) - heap_top) {
+        return NULL;
+    }
+    block = (heap_block*)((char*)static_heap + heap_top);
+    block->size = block_size;
+    block->previous_size = heap_last ? heap_last->size : 0;
+    block->free = false;
+    heap_top += block_size;
+    heap_last = block;
+
+    return (char*)block + HEAP_HEADER_SIZE;
+}
+
+
+static void* static_heap_realloc(void *pointer, unsigned long size) {
+
+    heap_block *block;
+    unsigned long block_size = HEAP_HEADER_SIZE + heap_round(size > 0 ? size : 1);
+    void *new_pointer;
+
+    if (pointer == NULL) {
+        return static_heap_alloc(size);
+    }
+
+    block = (heap_block*)((char*)pointer - HEAP_HEADER_SIZE);
+
+    /*the block is big enough (blocks are not shrunk)*/
+    if (block->size >= block_size) {
+        return pointer;
+    }
+
+    /*the last block grows in place (the growing buffers are usually the last blocks)*/
+    if (block == heap_last && block_size - block->size <= sizeof(static_heap) - heap_top) {
+        heap_top += block_size - block->size;
+        block->size = block_size;
+        return pointer;
+    }
+
+    if ((new_pointer = static_heap_alloc(size)) == NULL) {
+        return NULL;
+    }
+    memcpy(new_pointer, pointer, block->size - HEAP_HEADER_SIZE);
+    static_heap_free(pointer);
+
+    return new_pointer;
+}
+
+
+static void static_heap_free(void *pointer) {
+
+    heap_block *block;
+    heap_block *neighbour;
+
+    if (pointer == NULL) {
+        return;
+    }
+
+    block = (heap_block*)((char*)pointer - HEAP_HEADER_SIZE);
+
+    /*merge with the next block*/
+    if (block != heap_last && (neighbour = heap_next(block))->free) {
+        static_heap_unlink(neighbour);
+        block->size += neighbour->size;
+    }
+
+    /*merge with the previous block*/
+    if (block->previous_size != 0 && (neighbour = heap_previous(block))->free) {
+        static_heap_unlink(neighbour);
+        neighbour->size += block->size;
+        if (block == heap_last) {
+            heap_last = neighbour;
+        }
+        block = neighbour;
+    }
+
+    /*the last block returns to the top*/
+    if (block == heap_last) {
+        heap_top -= block->size;
+        heap_last = block->previous_size ? heap_previous(block) : NULL;
+        return;
+    }
+
+    heap_next(block)->previous_size = block->size;
+    block->free = true;
+    block->previous_free = NULL;
+    block->next_free = heap_free_blocks;
+    if (heap_free_blocks) heap_free_blocks->previous_free = block;
+    heap_free_blocks = block;
+}
+
+
+static void static_heap_unlink(heap_block *block) {
+
+    if (block->previous_free) {
+        block->previous_free->next_free = block->next_free;
+    }
+    else {
+        heap_free_blocks = block->next_free;
+    }
+    if (block->next_free) {
+        block->next_free->previous_free = block->previous_free;
+    }
+    block->free = false;
 }
+#endif
@@ -9,6 +9,7 @@
  *
  * This module defines and exposes global tables used throughout the assembler:
  *   - Opcode table: Supported instructions with their operand rules and encodings.
+ *   - Opcode effects table: Run-time effects of every instruction.
  *   - Registers table: All valid register names.
  *   - Data directives table: Supported `.data`, `.string`, and `.mat` directives.
  *   - Attribute directives table: `.entry` and `.extern`.
@@ -39,6 +40,26 @@ static const opcode opcode_table[] ={
     {14,"rts",0,NONE,NONE,ABSOLUTE},
     {15,"stop",0,NONE,NONE,ABSOLUTE}
 };
+/*run-time effects, indexed by the opcode number*/
+static const int opcode_effects[] = {
+    WRITES_DEST,                  /*mov*/
+    WRITES_FLAGS,                 /*cmp*/
+    WRITES_DEST | WRITES_FLAGS,   /*add*/
+    WRITES_DEST | WRITES_FLAGS,   /*sub*/
+    WRITES_DEST,                  /*lea*/
+    WRITES_DEST | WRITES_FLAGS,   /*clr*/
+    WRITES_DEST | WRITES_FLAGS,   /*not*/
+    WRITES_DEST | WRITES_FLAGS,   /*inc*/
+    WRITES_DEST | WRITES_FLAGS,   /*dec*/
+    CHANGES_FLOW,                 /*jmp*/
+    CHANGES_FLOW,                 /*bne*/
+    CHANGES_FLOW,                 /*jsr*/
+    WRITES_DEST | INPUT_OUTPUT,   /*red*/
+    INPUT_OUTPUT,                 /*prn*/
+    CHANGES_FLOW,                 /*rts*/
+    CHANGES_FLOW                  /*stop*/
+};
+
 static const char* registers[] = {"r0","r1","r2","r3","r4","r5","r6","r7"};
 
 static const char *data_directives_table[] = {".data",".string",".mat"};
@@ -54,6 +75,14 @@ const opcode* get_opcode_table(void) {
     return opcode_table;
 }
 
+int get_opcode_effects(int opcode_num) {
+
+    if (opcode_num < 0 || opcode_num >= INSTRUCTIONS_AMOUNT) {
+        return NO_EFFECT;
+    }
+    return opcode_effects[opcode_num];
+}
+
 const char** get_registers(void) {
     return registers;
 }
@@ -0,0 +1,133 @@
+
+#include "target.h"
+#include <stdio.h>
+#include <string.h>
+
+
+/**
+ * @file target.c
+ * @brief Target machine profiles ("--target=<name>").
+ *
+ * Every profile gets its own copy of the encoding and formatting functions,
+ * generated by DEFINE_TARGET_FUNCTIONS with the profile values as constants
+ * (the compiler folds the shifts and masks, and unrolls the base 4 loops).
+ *
+ * @date 17/10/2026
+ */
+
+
+/*base 4 letters of the output files (the same as to_base4_str)*/
+#define BASE4_DIGIT(value) ((char)('a' + ((value) & 0x3U)))
+#define BASE4_DIGIT_BITS 2
+
+
+/**
+ * @brief Generate the specialized functions of a target profile.
+ *
+ * @param prefix        Functions names prefix.
+ * @param word_bits     Memory word size in bits.
+ * @param data_shift    Shift of the operand data bit-field.
+ * @param address_len   Base 4 digits of an address.
+ * @param data_len      Base 4 digits of a memory word.
+ */
+#define DEFINE_TARGET_FUNCTIONS(prefix, word_bits, data_shift, address_len, data_len) \
+                                                                                                    \
+static unsigned int prefix##_encode_first_word(unsigned int opcode, unsigned int src_mode, unsigned int dest_mode, unsigned int era) { \
+    return ((opcode << ((word_bits) - OPCODE_BITS)) |                                               \
+            (src_mode << SRC_ADDR_MODE_BITS_SHIFT) |                                                \
+            (dest_mode << DEST_ADDR_MODE_BITS_SHIFT) |                                              \
+            (era << E_R_A_BITS_SHIFT)) & ((1U << (word_bits)) - 1);                                 \
+}                                                                                                   \
+                                                                                                    \
+static unsigned int prefix##_encode_data_word(unsigned int data, unsigned int era) {               \
+    return ((data << (data_shift)) | (era << E_R_A_BITS_SHIFT)) & ((1U << (word_bits)) - 1);        \
+}                                                                                                   \
+                                                                                                    \
+static unsigned int prefix##_encode_registers_word(unsigned int src_reg, unsigned int dest_reg, unsigned int era) { \
+    return ((src_reg << OPERAND_DATA_SRC_REG_SHIFT) |                                               \
+            (dest_reg << OPERAND_DATA_DEST_REG_SHIFT) |                                             \
+            (era << E_R_A_BITS_SHIFT)) & ((1U << (word_bits)) - 1);                                 \
+}                                                                                                   \
+                                                                                                    \
+static void prefix##_format_address(unsigned int address, char *result_out) {                      \
+    int i;                                                                                          \
+    for (i = (address_len) - 1; i >= 0; i--) {                                                      \
+        result_out[i] = BASE4_DIGIT(address);                                                       \
+        address >>= BASE4_DIGIT_BITS;                                                               \
+    }                                                                                               \
+    result_out[address_len] = '\0';                                                                 \
+}                                                                                                   \
+                                                                                                    \
+static void prefix##_format_word(unsigned int word, char *result_out) {                            \
+    int i;                                                                                          \
+    for (i = (data_len) - 1; i >= 0; i--) {                                                         \
+        result_out[i] = BASE4_DIGIT(word);                                                          \
+        word >>= BASE4_DIGIT_BITS;                                                                  \
+    }                                                                                               \
+    result_out[data_len] = '\0';                                                                    \
+}
+
+
+DEFINE_TARGET_FUNCTIONS(classic, WORD_BIT_SIZE, OPERAND_DATA_BITS_SHIFT,
+                        OBJ_FILE_ADDRESS_PRINT_LENGTH, OBJ_FILE_DATA_PRINT_LENGTH)
+
+DEFINE_TARGET_FUNCTIONS(wide, WIDE_WORD_BIT_SIZE, WIDE_WORD_BIT_SIZE - WIDE_OPERAND_DATA_BITS,
+                        WIDE_OBJ_FILE_ADDRESS_PRINT_LENGTH, WIDE_OBJ_FILE_DATA_PRINT_LENGTH)
+
+
+static const target_profile target_profiles[] = {
+    {
+        TARGET_DEFAULT_NAME,
+        WORD_BIT_SIZE, WORD_BIT_MASK,
+        MEMORY_CAPACITY, MEMORY_ADDRESS_OFFSET, MEMORY_AVAILABLE_SPACE,
+        OPCODE_BITS_SHIFT, OPERAND_DATA_BITS, OPERAND_DATA_BITS_SHIFT,
+        OBJ_FILE_ADDRESS_PRINT_LENGTH, OBJ_FILE_DATA_PRINT_LENGTH,
+        classic_encode_first_word, classic_encode_data_word, classic_encode_registers_word,
+        classic_format_address, classic_format_word
+    },
+    {
+        "wide",
+        WIDE_WORD_BIT_SIZE, (1U << WIDE_WORD_BIT_SIZE) - 1,
+        WIDE_MEMORY_CAPACITY, WIDE_MEMORY_ADDRESS_OFFSET, WIDE_MEMORY_CAPACITY - WIDE_MEMORY_ADDRESS_OFFSET,
+        WIDE_WORD_BIT_SIZE - OPCODE_BITS, WIDE_OPERAND_DATA_BITS, WIDE_WORD_BIT_SIZE - WIDE_OPERAND_DATA_BITS,
+        WIDE_OBJ_FILE_ADDRESS_PRINT_LENGTH, WIDE_OBJ_FILE_DATA_PRINT_LENGTH,
+        wide_encode_first_word, wide_encode_data_word, wide_encode_registers_word,
+        wide_format_address, wide_format_word
+    }
+};
+
+#define TARGET_PROFILES_AMOUNT (sizeof(target_profiles) / sizeof(target_profiles[0]))
+
+
+
+
+const_target_ptr get_target_profile(const char *name) {
+
+    unsigned int i;
+
+    if (!name) {
+        return NULL;
+    }
+
+    for (i = 0; i < TARGET_PROFILES_AMOUNT; i++) {
+        if (strcmp(target_profiles[i].name, name) == 0) {
+            return &target_profiles[i];
+        }
+    }
+    return NULL;
+}
+
+
+const_target_ptr get_default_target(void) {
+    return &target_profiles[0];
+}
+
+
+void print_target_names(void) {
+
+    unsigned int i;
+
+    for (i = 0; i < TARGET_PROFILES_AMOUNT; i++) {
+        printf("%s%s", (i > 0) ? ", " : "", target_profiles[i].name);
+    }
+}
@@ -9,6 +9,7 @@
 #include "data_memory.h"
 #include "directives.h"
 #include "errors.h"
+#include "intern_pool.h"
 #include "instructions.h"
 #include "instruction_memory.h"
 #include "labels.h"
@@ -55,7 +56,7 @@ char* copy_string(const char *string) {
 
 
 
-boolean is_name_valid(const char *str) {
+boolean is_name_valid(const char *str, const assembler_context *asmContext) {
 
     int index = 0;/*str index*/
 
@@ -64,8 +65,8 @@ boolean is_name_valid(const char *str) {
         print_internal_error(ERROR_CODE_25, "is_name_valid"); return false;
     }
 
-    /*validate the name length*/
-    if (strlen(str) > NAME_MAX_LEN) {
+    /*validate the name length (unlimited with relaxed limits)*/
+    if (!(asmContext && asmContext->relaxed_limits) && strlen(str) > NAME_MAX_LEN) {
         return false;
     }
 
@@ -379,7 +380,7 @@ boolean is_used_name(const char *name, assembler_context *asmContext) {
         return false;
     }
     /*check if the provided name already defined as label or macro name*/
-    if (is_label_defined(name, asmContext->labels) || is_macro_defined(name, asmContext->macros)) {
+    if (is_label_defined(name, asmContext->labels) || find_macro(find_name(asmContext->names, name), asmContext) != NULL) {
         return true;
     }
     return false;
@@ -426,11 +427,11 @@ void debug_data_print(const assembler_context *asmContext) {
     printf("\ninstruction memory :\n\n");
     print_instruction_memory(asmContext->instruction_memory);
     printf("\ninstructions address update requests:\n\n");
-    print_addr_update_requests(asmContext->address_update_requests);
+    print_addr_update_requests(asmContext->address_update_requests, asmContext->names);
     printf("\nlabels :\n\n");
     print_labels(asmContext->labels);
     printf("\nmacros :\n\n");
-    print_macro_names(asmContext->macros);
+    print_macro_names(asmContext->macros, asmContext->names);
     print_lines_map(asmContext->lines_maper);
 
 }
@@ -457,3 +458,89 @@ char* str_concat(const char *s1, const char *s2) {
 
     return result;/*user responsible to free */
 }
+
+
+void init_text_buffer(text_buffer *buffer) {
+
+    buffer->capacity = TEXT_BUFFER_INITIAL_SIZE;
+    buffer->length = 0;
+    buffer->data = (char*)handle_malloc(sizeof(char) * buffer->capacity);
+    buffer->data[0] = '\0';
+}
+
+
+void append_text(text_buffer *buffer, const char *text, unsigned long length) {
+
+    unsigned long capacity = buffer->capacity;
+
+    /*double the capacity till the text fits (amortized constant time per char)*/
+    while (buffer->length + length + 1 > capacity) {
+        capacity *= 2;
+    }
+    if (capacity != buffer->capacity) {
+        buffer->data = (char*)handle_realloc(buffer->data, sizeof(char) * capacity);
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+}
+
+
+boolean read_line(FILE *file, text_buffer *line) {
+
+    line->length = 0;
+    line->data[0] = '\0';
+
+    /*read the line in parts, the buffer doubles whenever a part fills it*/
+    while (fgets(line->data + line->length, (int)(line->capacity - line->length), file) != NULL) {
+
+        line->length += strlen(line->data + line->length);
+
+        /*the line ended, or the file ended without '\n'*/
+        if (line->data[line->length - 1] == '\n' || line->length + 1 < line->capacity) {
+            return true;
+        }
+
+        line->capacity *= 2;
+        line->data = (char*)handle_realloc(line->data, sizeof(char) * line->capacity);
+    }
+
+    return line->length > 0;
+}
+
+
+boolean read_text_line(const text_buffer *text, unsigned long *position, text_buffer *line) {
+
+    const char *start = text->data + *position;
+    const char *end;
+    unsigned long length;
+
+    /*the line ends after the '\n' (or at the end of the text)*/
+    end = (const char*)memchr(start, '\n', text->length - *position);
+    length = (end == NULL) ? text->length - *position : (unsigned long)(end - start) + 1;
+
+    clear_text_buffer(line);
+    append_text(line, start, length);
+    *position += length;
+
+    return length > 0;
+}
+
+
+void clear_text_buffer(text_buffer *buffer) {
+
+    buffer->length = 0;
+    if (buffer->data != NULL) {
+        buffer->data[0] = '\0';
+    }
+}
+
+
+void free_text_buffer(text_buffer *buffer) {
+
+    safe_free((void**)&buffer->data);
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
@@ -0,0 +1,605 @@
+/*inotify, select() and stat() are POSIX (and Linux), not ANSI C*/
+#define _POSIX_C_SOURCE 200112L
+
+#include "watch.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include "config.h"
+#include "assembler.h"
+#include "build_cache.h"
+#include "errors.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#define WATCH_INOTIFY
+#endif
+
+
+/**
+ * @file watch.c
+ * @brief Watch mode, assembles the source files again when they change.
+ *
+ * On Linux the directories of the sources are watched with inotify: a save
+ * (a write that closed the file, or a file renamed over it) wakes the
+ * watcher at once, and the events that follow within WATCH_SETTLE_MS are
+ * coalesced into the same run. On other systems (or when inotify can't be
+ * used) the watcher polls the size and modification time of every source
+ * (a stat() call), and hashes the content only when they change.
+ * In both cases the content fingerprint (size and hash) decides if the file
+ * really changed, so a save without any change doesn't trigger a new assembly.
+ *
+ * The changed files are assembled with the build cache enabled, so the
+ * unchanged output files are kept as is. The errors of a run are received
+ * through the error sink of the context (see error_report) and kept by the
+ * full path of their source, as the run was given it. After the run, only
+ * the diagnostics that appeared or disappeared since the previous run of
+ * every changed file are printed. Two diagnostics are the same when their
+ * messages are the same, whatever their lines: an edit above an error moves
+ * its line, not the error.
+ *
+ * @date 17/10/2026
+ */
+
+
+/**
+ * @struct file_stamp
+ * @brief Size and modification time of a file (a stat() of the file).
+ */
+typedef struct file_stamp {
+    boolean exist;        /**< File exist (all other fields are 0 if not). */
+    unsigned long size;   /**< File size in bytes. */
+    time_t modified;      /**< Last modification time. */
+} file_stamp;
+
+
+/**
+ * @struct watch_diagnostic
+ * @brief A diagnostic of a watched source (an error report of a run).
+ */
+typedef struct watch_diagnostic {
+    boolean has_line;     /**< The diagnostic belongs to a line (otherwise to the whole file). */
+    int line;             /**< Source line. */
+    const char *message;  /**< Message (a constant of the errors tables). */
+    const char *function; /**< Function of an internal error, or NULL. */
+} watch_diagnostic;
+
+
+/**
+ * @struct watch_diagnostics
+ * @brief The diagnostics of a run of a watched source.
+ */
+typedef struct watch_diagnostics {
+    watch_diagnostic list[WATCH_MAX_DIAGNOSTICS]; /**< The diagnostics, in the order of the run. */
+    int amount;                                   /**< Amount of kept diagnostics. */
+    boolean cut;                                  /**< More diagnostics than WATCH_MAX_DIAGNOSTICS (the rest are not compared). */
+} watch_diagnostics;
+
+
+/*context kept between the runs (tables and macro prelude)*/
+static warm_context watch_context;
+
+/*watched sources, kept in static memory (tracked memory is released after every file)*/
+static char watched_paths[WATCH_MAX_FILES][BUILD_CACHE_PATH_MAX_LEN + 1];
+static file_fingerprint watched_prints[WATCH_MAX_FILES];
+static file_stamp watched_stamps[WATCH_MAX_FILES];
+static time_t watched_hash_times[WATCH_MAX_FILES];
+
+/*diagnostics of the last run and of the current run of every source*/
+static watch_diagnostics watched_diagnostics[WATCH_MAX_FILES];
+static watch_diagnostics run_diagnostics[WATCH_MAX_FILES];
+
+/*amount of watched sources, and the errors are also printed (the first run)*/
+static int watched_files;
+static boolean print_errors;
+
+
+/**
+ * @brief Sleep for a single poll interval.
+ */
+static void watch_sleep(void);
+
+
+/**
+ * @brief Read the size and modification time of a file.
+ *
+ * A missing (or unreadable) file gets an empty stamp.
+ */
+static void get_file_stamp(const char *file_name, file_stamp *stamp_out);
+
+
+/**
+ * @brief Hash a watched source again, and check if its content changed.
+ *
+ * @param index       Index of the watched source.
+ * @param check_stamp Hash the source only if its stamp changed since its last hash (polling).
+ * @return true if the content of the source changed.
+ */
+static boolean update_source(int index, boolean check_stamp);
+
+
+/**
+ * @brief Poll all the watched sources and mark the changed ones.
+ *
+ * @param files       Number of watched files.
+ * @param changed_out [in/out] Changed flags, newly changed files are set to true.
+ * @return true if at least one file changed since the previous poll.
+ */
+static boolean poll_sources(int files, boolean changed_out[]);
+
+
+/**
+ * @brief Wait until sources change by polling, and coalesce a burst of writes.
+ *
+ * @param files       Number of watched files.
+ * @param changed_out [in/out] Changed flags, the changed files are set to true.
+ */
+static void wait_for_changes_polling(int files, boolean changed_out[]);
+
+
+#ifdef WATCH_INOTIFY
+/**
+ * @brief Watch the directories of the sources with inotify.
+ *
+ * @param files  Number of watched files.
+ * @param wds    [out] Watch descriptor of the directory of every source.
+ * @return The inotify descriptor, or -1 if inotify can't be used.
+ */
+static int start_inotify(int files, int wds[]);
+
+
+/**
+ * @brief Wait for inotify events of the sources, and coalesce the events within WATCH_SETTLE_MS.
+ *
+ * @param fd          The inotify descriptor.
+ * @param files       Number of watched files.
+ * @param wds         Watch descriptor of the directory of every source.
+ * @param changed_out [in/out] Changed flags, the changed files are set to true.
+ * @return true if a source changed, false if the events didn't change any content.
+ */
+static boolean wait_for_changes_inotify(int fd, int files, const int wds[], boolean changed_out[]);
+#endif
+
+
+/**
+ * @brief Keep an error of a run as a diagnostic of its source (the error sink of the runs).
+ *
+ * @param sink_data Not used.
+ * @param report    The error.
+ */
+static void collect_diagnostic(void *sink_data, const error_report *report);
+
+
+/**
+ * @brief Find a watched source by the full path of its file.
+ *
+ * @return The source index, or -1 if it's not a watched source.
+ */
+static int find_watched_source(const char *path);
+
+
+/**
+ * @brief Print the diagnostics of a run that have no diagnostic with the same message in the other run.
+ *
+ * @param diagnostics Diagnostics to print.
+ * @param other       Diagnostics to compare with (every one matches a single diagnostic).
+ * @param mark        Printed before every diagnostic.
+ * @return Amount of printed diagnostics.
+ */
+static int print_missing_diagnostics(const watch_diagnostics *diagnostics, const watch_diagnostics *other, const char *mark);
+
+
+/**
+ * @brief Print the diagnostics changes of a source since its previous run, and keep the new diagnostics.
+ *
+ * @param index Index of the watched source.
+ */
+static void report_source_run(int index);
+
+
+
+
+
+boolean run_watch(int files, char *files_names[], const assembler_options *options) {
+
+    assembler_options run_options = *options;
+    boolean changed[WATCH_MAX_FILES];
+    boolean assembled[WATCH_MAX_FILES];
+    char *changed_names[WATCH_MAX_FILES + 1];
+    int changed_count;
+    int i;
+    char *name;
+#ifdef WATCH_INOTIFY
+    int wds[WATCH_MAX_FILES];
+    int inotify_fd;
+#endif
+
+    if (files > WATCH_MAX_FILES) {
+        printf("ERROR: Watch mode supports up to %d source files.\n", WATCH_MAX_FILES);
+        return false;
+    }
+
+    /*the errors of every run are received by the watcher*/
+    init_warm_context(&watch_context);
+    watch_context.error_sink = collect_diagnostic;
+    watched_files = files;
+
+    /*build the watched paths, the same as the assembler does (.as added if missing)*/
+    for (i = 0; i < files; i++) {
+        name = strrchr(files_names[i + 1], '/');
+        name = (name == NULL) ? files_names[i + 1] : name + 1;
+
+        if (strlen(files_names[i + 1]) + strlen(ASSEMBLY_FILE_EXTENSION) > BUILD_CACHE_PATH_MAX_LEN) {
+            printf("ERROR: Source file path <%s> is too long to be watched.\n", files_names[i + 1]);
+            return false;
+        }
+        strcpy(watched_paths[i], files_names[i + 1]);
+        if (strchr(name, '.') == NULL) {
+            strcat(watched_paths[i], ASSEMBLY_FILE_EXTENSION);
+        }
+
+        get_file_stamp(watched_paths[i], &watched_stamps[i]);
+        watched_hash_times[i] = time(NULL);
+        get_file_fingerprint(watched_paths[i], &watched_prints[i]);
+        run_diagnostics[i].amount = 0;
+        run_diagnostics[i].cut = false;
+        changed[i] = false;
+    }
+
+    /*the output files of unchanged sources are kept*/
+    run_options.reuse_unchanged = true;
+
+    /*first full assembly, its errors are printed as usual (and kept)*/
+    print_errors = true;
+    assemble_files(files, files_names, &run_options, &watch_context);
+    print_errors = false;
+    for (i = 0; i < files; i++) {
+        watched_diagnostics[i] = run_diagnostics[i];
+    }
+
+#ifdef WATCH_INOTIFY
+    inotify_fd = start_inotify(files, wds);
+#endif
+
+    printf("Watching %d file(s) for changes (press Ctrl+C to stop)...\n", files);
+    fflush(stdout);
+
+    while (true) {
+
+#ifdef WATCH_INOTIFY
+        if (inotify_fd != -1) {
+            if (!wait_for_changes_inotify(inotify_fd, files, wds, changed)) {
+                continue;
+            }
+        }
+        else
+#endif
+        {
+            wait_for_changes_polling(files, changed);
+        }
+
+        /*collect the changed files (index 0 is unused, as in argv)*/
+        changed_count = 0;
+        changed_names[0] = files_names[0];
+        for (i = 0; i < files; i++) {
+            assembled[i] = changed[i];
+            if (changed[i]) {
+                changed_names[++changed_count] = files_names[i + 1];
+                changed[i] = false;
+                run_diagnostics[i].amount = 0;
+                run_diagnostics[i].cut = false;
+            }
+        }
+
+        printf("\nChanged: %d file(s).\n", changed_count);
+
+        /*the errors are kept, then only their changes are printed*/
+        assemble_files(changed_count, changed_names, &run_options, &watch_context);
+        for (i = 0; i < files; i++) {
+            if (assembled[i]) {
+                report_source_run(i);
+            }
+        }
+
+        printf("\nWatching %d file(s) for changes (press Ctrl+C to stop)...\n", files);
+        fflush(stdout);
+    }
+
+    return true;
+}
+
+
+static void watch_sleep(void) {
+
+    struct timespec interval;
+
+    interval.tv_sec = WATCH_POLL_INTERVAL_MS / 1000;
+    interval.tv_nsec = (WATCH_POLL_INTERVAL_MS % 1000) * 1000000L;
+
+    nanosleep(&interval, NULL);
+}
+
+
+static void get_file_stamp(const char *file_name, file_stamp *stamp_out) {
+
+    struct stat info;
+
+    memset(stamp_out, 0, sizeof(file_stamp));
+    if (stat(file_name, &info) == 0) {
+        stamp_out->exist = true;
+        stamp_out->size = (unsigned long)info.st_size;
+        stamp_out->modified = info.st_mtime;
+    }
+}
+
+
+static boolean update_source(int index, boolean check_stamp) {
+
+    file_stamp stamp;
+    file_fingerprint current;
+
+    get_file_stamp(watched_paths[index], &stamp);
+
+    /*same stamp, and the last hash was taken after the modification second*/
+    if (check_stamp && stamp.exist == watched_stamps[index].exist && stamp.size == watched_stamps[index].size &&
+        stamp.modified == watched_stamps[index].modified && (!stamp.exist || stamp.modified < watched_hash_times[index])) {
+        return false;
+    }
+
+    watched_stamps[index] = stamp;
+    watched_hash_times[index] = time(NULL);
+    get_file_fingerprint(watched_paths[index], &current);
+
+    if (is_same_fingerprint(&current, &watched_prints[index])) {
+        return false;
+    }
+
+    watched_prints[index] = current;
+    return true;
+}
+
+
+static boolean poll_sources(int files, boolean changed_out[]) {
+
+    boolean any_change = false;
+    int i;
+
+    for (i = 0; i < files; i++) {
+        if (update_source(i, true)) {
+            changed_out[i] = true;
+            any_change = true;
+        }
+    }
+
+    return any_change;
+}
+
+
+static void wait_for_changes_polling(int files, boolean changed_out[]) {
+
+    int quiet_polls;
+
+    do {
+        watch_sleep();
+    } while (!poll_sources(files, changed_out));
+
+    /*coalesce a burst of writes, wait until the sources are stable*/
+    quiet_polls = 0;
+    while (quiet_polls < WATCH_SETTLE_POLLS) {
+        watch_sleep();
+        quiet_polls = poll_sources(files, changed_out) ? 0 : quiet_polls + 1;
+    }
+}
+
+
+#ifdef WATCH_INOTIFY
+static int start_inotify(int files, int wds[]) {
+
+    char directory[BUILD_CACHE_PATH_MAX_LEN + 1];
+    char *separator;
+    int fd;
+    int i;
+
+    if ((fd = inotify_init()) == -1) {
+        return -1;
+    }
+
+    /*watch the directories, an editor may save by renaming a new file over the source*/
+    for (i = 0; i < files; i++) {
+        strcpy(directory, watched_paths[i]);
+        separator = strrchr(directory, '/');
+        if (separator == NULL) {
+            strcpy(directory, ".");
+        }
+        else {
+            separator[(separator == directory) ? 1 : 0] = '\0';
+        }
+
+        wds[i] = inotify_add_watch(fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+        if (wds[i] == -1) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    return fd;
+}
+
+
+static boolean wait_for_changes_inotify(int fd, int files, const int wds[], boolean changed_out[]) {
+
+    /*aligned for the events structure*/
+    union {
+        char bytes[WATCH_EVENTS_BUFFER_SIZE];
+        long align;
+    } events;
+    boolean touched[WATCH_MAX_FILES];
+    const struct inotify_event *event;
+    const char *name;
+    struct timeval settle;
+    fd_set ready;
+    long length;
+    long offset;
+    boolean any_change = false;
+    int i;
+
+    for (i = 0; i < files; i++) {
+        touched[i] = false;
+    }
+
+    /*the first read blocks until an event, the next ones only within the settle time*/
+    do {
+        if ((length = (long)read(fd, events.bytes, sizeof(events.bytes))) <= 0) {
+            break;
+        }
+
+        for (offset = 0; offset < length; offset += (long)sizeof(struct inotify_event) + (long)event->len) {
+            event = (const struct inotify_event*)(events.bytes + offset);
+
+            for (i = 0; i < files; i++) {
+                name = strrchr(watched_paths[i], '/');
+                name = (name == NULL) ? watched_paths[i] : name + 1;
+
+                /*an overflow lost events, check every source*/
+                if ((event->mask & IN_Q_OVERFLOW) ||
+                    (event->wd == wds[i] && event->len > 0 && strcmp(event->name, name) == 0)) {
+                    touched[i] = true;
+                }
+            }
+        }
+
+        FD_ZERO(&ready);
+        FD_SET(fd, &ready);
+        settle.tv_sec = 0;
+        settle.tv_usec = WATCH_SETTLE_MS * 1000L;
+    } while (select(fd + 1, &ready, NULL, NULL, &settle) > 0);
+
+    /*the content decides (a save without changes doesn't trigger a run)*/
+    for (i = 0; i < files; i++) {
+        if (touched[i] && update_source(i, false)) {
+            changed_out[i] = true;
+            any_change = true;
+        }
+    }
+
+    return any_change;
+}
+#endif
+
+
+static void collect_diagnostic(void *sink_data, const error_report *report) {
+
+    watch_diagnostics *diagnostics;
+    watch_diagnostic *diagnostic;
+    int index = find_watched_source(report->file_path);
+
+    (void)sink_data;
+
+    /*the first run prints its errors, and an error of no watched source is never dropped*/
+    if (print_errors || index == -1) {
+        print_error_report(report);
+    }
+    if (index == -1) {
+        return;
+    }
+
+    diagnostics = &run_diagnostics[index];
+    if (diagnostics->amount == WATCH_MAX_DIAGNOSTICS) {
+        diagnostics->cut = true;
+        return;
+    }
+
+    diagnostic = &diagnostics->list[diagnostics->amount++];
+    diagnostic->has_line = report->has_line;
+    diagnostic->line = report->line;
+    diagnostic->message = report->message;
+    diagnostic->function = report->internal ? report->function : NULL;
+}
+
+
+static int find_watched_source(const char *path) {
+
+    int i;
+
+    if (path == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < watched_files; i++) {
+        if (strcmp(watched_paths[i], path) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+static int print_missing_diagnostics(const watch_diagnostics *diagnostics, const watch_diagnostics *other, const char *mark) {
+
+    boolean matched[WATCH_MAX_DIAGNOSTICS];
+    const watch_diagnostic *diagnostic;
+    const watch_diagnostic *other_diagnostic;
+    int printed = 0;
+    int i;
+    int j;
+
+    for (j = 0; j < other->amount; j++) {
+        matched[j] = false;
+    }
+
+    for (i = 0; i < diagnostics->amount; i++) {
+        diagnostic = &diagnostics->list[i];
+
+        /*the same message (the lines are not compared), every diagnostic of the other run matches once*/
+        for (j = 0; j < other->amount; j++) {
+            other_diagnostic = &other->list[j];
+            if (!matched[j] && strcmp(other_diagnostic->message, diagnostic->message) == 0 &&
+                (other_diagnostic->function == NULL) == (diagnostic->function == NULL)) {
+                matched[j] = true;
+                break;
+            }
+        }
+        if (j < other->amount) {
+            continue;
+        }
+
+        if (diagnostic->function) {
+            printf("  %s internal error in function %s: %s\n", mark, diagnostic->function, diagnostic->message);
+        }
+        else if (diagnostic->has_line) {
+            printf("  %s line %d: %s\n", mark, diagnostic->line, diagnostic->message);
+        }
+        else {
+            printf("  %s %s\n", mark, diagnostic->message);
+        }
+        printed++;
+    }
+
+    return printed;
+}
+
+
+static void report_source_run(int index) {
+
+    int added;
+    int removed;
+
+    printf("\nDiagnostics of <%s>:\n", watched_paths[index]);
+
+    added = print_missing_diagnostics(&run_diagnostics[index], &watched_diagnostics[index], "+");
+    removed = print_missing_diagnostics(&watched_diagnostics[index], &run_diagnostics[index], "-");
+    if (added == 0 && removed == 0) {
+        printf("  diagnostics unchanged (%s)\n", (run_diagnostics[index].amount == 0) ? "none" : "same as the last run");
+    }
+    if (run_diagnostics[index].cut) {
+        printf("  (only the first %d diagnostics are compared)\n", WATCH_MAX_DIAGNOSTICS);
+    }
+
+    watched_diagnostics[index] = run_diagnostics[index];
+}
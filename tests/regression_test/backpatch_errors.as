@@ -0,0 +1,11 @@
+; the checks at the end of a single pass (undefined labels at their first use)
+    .extern OUT
+    .entry OUT
+    .entry MISSING
+    .entry
+MAIN: jmp NOWHERE
+    prn DATA
+    bne MISSING
+    prn NOWHERE
+    stop
+DATA: .data 1
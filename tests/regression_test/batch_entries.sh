@@ -0,0 +1,24 @@
+#!/bin/sh
+# The entry flags of a file must not carry over to the next file of a batch.
+# usage: batch_entries.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(dirname "$0")
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR/entries.as" "$DIR/no_entries.as" "$WORK" || exit 1
+cd "$WORK" || exit 1
+
+# the files are assembled from the last to the first, entries.as goes first
+"$ASSEMBLER" no_entries entries > /dev/null || exit 1
+
+if [ ! -f entries.ent ]; then
+    echo "entries.ent was not created"
+    exit 1
+fi
+if [ -f no_entries.ent ]; then
+    echo "no_entries.ent was created for a file without entry labels"
+    exit 1
+fi
+exit 0
@@ -0,0 +1,3 @@
+MAIN: mov r1, r2
+END: stop
+.entry END
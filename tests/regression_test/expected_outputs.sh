@@ -0,0 +1,39 @@
+#!/bin/sh
+# Assemble <name>.as of this directory with the given flags, and compare the results with the
+# expected files of this directory: <name>.<ext> with the generated output file of the same name,
+# and <name>.stdout (if it exists) with the printed output.
+# The other <name>_*.as files of this directory (e.g. a macro prelude) are copied with the source.
+# usage: expected_outputs.sh <assembler> <name> [flags...]
+
+ASSEMBLER="$1"
+NAME="$2"
+shift 2
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR/$NAME.as" "$WORK" || exit 1
+for INPUT in "$DIR/$NAME"_*.as; do
+    [ -f "$INPUT" ] && cp "$INPUT" "$WORK"
+done
+cd "$WORK" || exit 1
+
+"$ASSEMBLER" "$@" "$NAME" > "$NAME.stdout" || exit 1
+
+RESULT=0
+for EXPECTED in "$DIR/$NAME".*; do
+    FILE=$(basename "$EXPECTED")
+    case "$FILE" in
+        *.as) continue ;;
+    esac
+
+    if [ ! -f "$FILE" ]; then
+        echo "$FILE was not generated"
+        RESULT=1
+    elif ! cmp -s "$EXPECTED" "$FILE"; then
+        echo "$FILE differs from the expected file:"
+        diff "$EXPECTED" "$FILE"
+        RESULT=1
+    fi
+done
+exit $RESULT
@@ -0,0 +1,60 @@
+; more labels than the initial table capacity, every third label is an entry
+    .entry L0
+    .entry L3
+    .entry L6
+    .entry L9
+    .entry L12
+    .entry L15
+    .entry L18
+    .entry L21
+    .entry L24
+    .entry L27
+    .entry L30
+    .entry L33
+    .entry L36
+    .entry L39
+    .extern OUT
+L0: inc r0
+L1: inc r1
+L2: inc r2
+L3: inc r3
+L4: inc r4
+L5: inc r5
+L6: inc r6
+L7: inc r7
+L8: inc r0
+L9: inc r1
+L10: inc r2
+L11: inc r3
+L12: inc r4
+L13: inc r5
+L14: inc r6
+L15: inc r7
+L16: inc r0
+L17: inc r1
+L18: inc r2
+L19: inc r3
+L20: inc r4
+L21: inc r5
+L22: inc r6
+L23: inc r7
+L24: inc r0
+L25: inc r1
+L26: inc r2
+L27: inc r3
+L28: inc r4
+L29: inc r5
+L30: inc r6
+L31: inc r7
+L32: inc r0
+L33: inc r1
+L34: inc r2
+L35: inc r3
+L36: inc r4
+L37: inc r5
+L38: inc r6
+L39: inc r7
+    jmp OUT
+    stop
+D0: .data 1
+    .entry D0
@@ -0,0 +1,80 @@
+#!/bin/sh
+# In server mode (--serve), the first pass of a changed source parses only its changed lines and
+# replays the other lines from the previous run: after every edit (a line inserted that moves the
+# IC, a data line that moves the DC, a line deleted, an invalid line, and the original again), the
+# output files and the errors are the same as those of a command line run on the same source.
+# usage: line_records.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir "$WORK/server" "$WORK/full" || exit 1
+SOURCE="$DIR/../valid_files_test/valid1.as"
+cd "$WORK" || exit 1
+
+# the edited versions of the source
+cp "$SOURCE" version1.as || exit 1
+sed '2i\    inc r1' "$SOURCE" > version2.as || exit 1
+sed '1i\EXTRA: .data 5, -6' "$SOURCE" > version3.as || exit 1
+sed '33d' "$SOURCE" > version4.as || exit 1
+sed '35i\    bogus r1' "$SOURCE" > version5.as || exit 1
+cp "$SOURCE" version6.as || exit 1
+VERSIONS="1 2 3 4 5 6"
+
+# wait until the server answered the request number $1 (the startup line is the first #done)
+wait_for_request() {
+    for TRY in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20; do
+        [ "$(grep -c '^#done' server.out)" -gt "$1" ] && return 0
+        sleep 0.1
+    done
+    echo "request $1 not answered"
+    exit 1
+}
+
+mkfifo requests || exit 1
+(cd server && "$ASSEMBLER" --serve < ../requests > ../server.out) &
+exec 3> requests
+
+RESULT=0
+for VERSION in $VERSIONS; do
+    cp "version$VERSION.as" server/prog.as || exit 1
+    echo "--stats prog" >&3
+    wait_for_request "$VERSION"
+
+    rm -f full/*
+    cp "version$VERSION.as" full/prog.as || exit 1
+    (cd full && "$ASSEMBLER" prog >> ../full.out)
+
+    for FILE in full/* server/*; do
+        NAME=$(basename "$FILE")
+        if ! cmp -s "full/$NAME" "server/$NAME"; then
+            echo "$NAME of version $VERSION differs from the command line run"
+            RESULT=1
+        fi
+    done
+    rm -f server/prog.*
+done
+
+echo quit >&3
+exec 3>&-
+wait
+
+# the errors of the server runs are those of the command line runs (the invalid version only)
+grep 'ERROR' server.out > server.errors
+grep 'ERROR' full.out > full.errors
+if ! cmp -s full.errors server.errors || [ ! -s server.errors ]; then
+    echo "the errors differ from the command line run:"
+    diff full.errors server.errors
+    RESULT=1
+fi
+
+# every run after the first one replayed lines
+if [ "$(grep -c 'line(s) replayed from the previous run' server.out)" -ne 5 ]; then
+    echo "the unchanged lines were not replayed:"
+    grep 'replayed' server.out
+    RESULT=1
+fi
+
+exit $RESULT
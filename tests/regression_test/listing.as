@@ -0,0 +1,12 @@
+; the listing keeps the source lines, the macro lines are listed with
+; the macro definition lines
+    .extern EXT
+    mcro SAVE
+    mov r1, VALUE
+    mcroend
+MAIN: prn #-1
+    SAVE
+    jmp EXT
+    stop
+VALUE: .data 5, -5
+TEXT: .string "hi"
@@ -0,0 +1,81 @@
+#!/bin/sh
+# The language server (--lsp) keeps the open documents in memory: it answers hover, definition and
+# references from the index of the document text, applies the incremental changes, publishes the
+# diagnostics of the changed text (an error of the whole file covers the whole document), and
+# writes no file. An analysis after a change replays the unchanged lines, with the same results.
+# usage: lsp.sh <assembler>
+
+ASSEMBLER="$1"
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+frame() {
+    printf 'Content-Length: %d\r\n\r\n%s' "${#1}" "$1"
+}
+
+URI="file://$WORK/doc.as"
+DOCUMENT='"textDocument":{"uri":"'$URI'"}'
+NOTES="file://$WORK/notes.txt"
+TEXT='    mcro TWICE\n    inc r1\n    inc r1\n    mcroend\nMAIN: mov r2, COUNT\n    TWICE\n    jmp MAIN\n    stop\nCOUNT: .data 7\n'
+
+{
+    frame '{"jsonrpc":"2.0","id":1,"method":"initialize","params":{}}'
+    frame '{"jsonrpc":"2.0","method":"initialized","params":{}}'
+    frame '{"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"'$URI'","languageId":"asm","version":1,"text":"'"$TEXT"'"}}}'
+    frame '{"jsonrpc":"2.0","id":2,"method":"textDocument/hover","params":{'"$DOCUMENT"',"position":{"line":5,"character":6}}}'
+    frame '{"jsonrpc":"2.0","id":3,"method":"textDocument/references","params":{'"$DOCUMENT"',"position":{"line":4,"character":1},"context":{"includeDeclaration":true}}}'
+    frame '{"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":"'$URI'","version":2},"contentChanges":[{"range":{"start":{"line":6,"character":8},"end":{"line":6,"character":12}},"text":"LOST"}]}}'
+    frame '{"jsonrpc":"2.0","id":4,"method":"textDocument/definition","params":{'"$DOCUMENT"',"position":{"line":8,"character":2}}}'
+    frame '{"jsonrpc":"2.0","id":7,"method":"textDocument/hover","params":{'"$DOCUMENT"',"position":{"line":8,"character":2}}}'
+    frame '{"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":"'$URI'","version":3},"contentChanges":[{"range":{"start":{"line":6,"character":8},"end":{"line":6,"character":12}},"text":"MAIN"}]}}'
+    frame '{"jsonrpc":"2.0","id":9,"method":"textDocument/hover","params":{'"$DOCUMENT"',"position":{"line":8,"character":2}}}'
+    frame '{"jsonrpc":"2.0","id":10,"method":"textDocument/references","params":{'"$DOCUMENT"',"position":{"line":4,"character":1},"context":{"includeDeclaration":true}}}'
+    frame '{"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"'$NOTES'","languageId":"asm","version":1,"text":"a\nb\n"}}}'
+    frame '{"jsonrpc":"2.0","id":8,"method":"textDocument/hover","params":{"textDocument":{"uri":"'$NOTES'"},"position":{"line":0,"character":0}}}'
+    frame '{"jsonrpc":"2.0","id":5,"method":"textDocument/unknown","params":{}}'
+    frame '{"jsonrpc":"2.0","id":6,"method":"shutdown"}'
+    frame '{"jsonrpc":"2.0","method":"exit"}'
+} | "$ASSEMBLER" --lsp > lsp.out
+STATUS=$?
+
+RESULT=0
+expect() {
+    if ! grep -F -q "$1" lsp.out; then
+        echo "missing: $1"
+        RESULT=1
+    fi
+}
+
+expect '"id":1,"result":{"capabilities":{"textDocumentSync":{"openClose":true,"change":2}'
+expect '"diagnostics":[]}'
+# the macro body has 2 lines (mcroend is not counted)
+expect '"id":2,"result":{"contents":{"kind":"plaintext","value":"TWICE: macro, defined at line 1, 2 line(s)."}}'
+expect '"id":3,"result":[{"uri":"'$URI'","range":{"start":{"line":4,"character":0},"end":{"line":4,"character":0}}},{"uri":"'$URI'","range":{"start":{"line":6,"character":0},"end":{"line":6,"character":0}}}]'
+# the changed text "jmp LOST" is analyzed again
+expect '{"range":{"start":{"line":6,"character":0},"end":{"line":6,"character":12}},"severity":1,"source":"assembler","message":"Attempted to use an undeclared label."}'
+expect '"id":4,"result":{"uri":"'$URI'","range":{"start":{"line":8,"character":0},"end":{"line":8,"character":0}}}'
+# the text has errors, the address of COUNT is not final
+expect '"id":7,"result":{"contents":{"kind":"plaintext","value":"COUNT: data label, defined at line 9, address unresolved (the file has errors)."}}'
+# the change undone: the unchanged lines are replayed, and the addresses are those of a full analysis
+expect '"id":9,"result":{"contents":{"kind":"plaintext","value":"COUNT: data label, defined at line 9, address 110 (bcdc), encoded word aaabd."}}'
+expect '"id":10,"result":[{"uri":"'$URI'","range":{"start":{"line":4,"character":0},"end":{"line":4,"character":0}}},{"uri":"'$URI'","range":{"start":{"line":6,"character":0},"end":{"line":6,"character":0}}}]'
+# an error without a line (not an .as file) covers the 3 lines of the document
+expect '"uri":"'$NOTES'","diagnostics":[{"range":{"start":{"line":0,"character":0},"end":{"line":2,"character":0}},"severity":1,"source":"assembler","message":"Unknown file type, the provided file is not assembly source file (.as)."}]'
+expect '"id":8,"result":null'
+expect '"id":5,"error":{"code":-32601'
+expect '"id":6,"result":null'
+
+if [ "$STATUS" -ne 0 ]; then
+    echo "exit status $STATUS after shutdown"
+    RESULT=1
+fi
+
+for FILE in doc.am doc.ob doc.ent doc.ext; do
+    if [ -e "$FILE" ]; then
+        echo "$FILE written by the analysis"
+        RESULT=1
+    fi
+done
+
+exit $RESULT
@@ -0,0 +1,7 @@
+; bad matrix register indexes are errors of their own lines
+MAIN:   jmp MAT1[2][3]
+        inc MAT1[r12][A]
+        mov MAT1[r1][r9], r2
+        add #22.3, r0
+        stop
+MAT1:   .mat [2][2] 1,2,3,4
@@ -0,0 +1,136 @@
+; more names (externals, labels, a macro) than the initial names pool size
+    .extern EXTERNAL_NAME_NUMBER_00
+    .extern EXTERNAL_NAME_NUMBER_01
+    .extern EXTERNAL_NAME_NUMBER_02
+    .extern EXTERNAL_NAME_NUMBER_03
+    .extern EXTERNAL_NAME_NUMBER_04
+    .extern EXTERNAL_NAME_NUMBER_05
+    .extern EXTERNAL_NAME_NUMBER_06
+    .extern EXTERNAL_NAME_NUMBER_07
+    .extern EXTERNAL_NAME_NUMBER_08
+    .extern EXTERNAL_NAME_NUMBER_09
+    .extern EXTERNAL_NAME_NUMBER_10
+    .extern EXTERNAL_NAME_NUMBER_11
+    .extern EXTERNAL_NAME_NUMBER_12
+    .extern EXTERNAL_NAME_NUMBER_13
+    .extern EXTERNAL_NAME_NUMBER_14
+    .extern EXTERNAL_NAME_NUMBER_15
+    .extern EXTERNAL_NAME_NUMBER_16
+    .extern EXTERNAL_NAME_NUMBER_17
+    .extern EXTERNAL_NAME_NUMBER_18
+    .extern EXTERNAL_NAME_NUMBER_19
+    .extern EXTERNAL_NAME_NUMBER_20
+    .extern EXTERNAL_NAME_NUMBER_21
+    .extern EXTERNAL_NAME_NUMBER_22
+    .extern EXTERNAL_NAME_NUMBER_23
+    .extern EXTERNAL_NAME_NUMBER_24
+    .extern EXTERNAL_NAME_NUMBER_25
+    .extern EXTERNAL_NAME_NUMBER_26
+    .extern EXTERNAL_NAME_NUMBER_27
+    .extern EXTERNAL_NAME_NUMBER_28
+    .extern EXTERNAL_NAME_NUMBER_29
+    .extern EXTERNAL_NAME_NUMBER_30
+    .extern EXTERNAL_NAME_NUMBER_31
+    .extern EXTERNAL_NAME_NUMBER_32
+    .extern EXTERNAL_NAME_NUMBER_33
+    .extern EXTERNAL_NAME_NUMBER_34
+    .extern EXTERNAL_NAME_NUMBER_35
+    .extern EXTERNAL_NAME_NUMBER_36
+    .extern EXTERNAL_NAME_NUMBER_37
+    .extern EXTERNAL_NAME_NUMBER_38
+    .extern EXTERNAL_NAME_NUMBER_39
+    mcro PRINT_THE_FIRST_EXTERNALS
+    prn EXTERNAL_NAME_NUMBER_00
+    prn EXTERNAL_NAME_NUMBER_01
+    prn EXTERNAL_NAME_NUMBER_02
+    mcroend
+    PRINT_THE_FIRST_EXTERNALS
+    prn EXTERNAL_NAME_NUMBER_03
+    prn EXTERNAL_NAME_NUMBER_04
+    prn EXTERNAL_NAME_NUMBER_05
+    prn EXTERNAL_NAME_NUMBER_06
+    prn EXTERNAL_NAME_NUMBER_07
+    prn EXTERNAL_NAME_NUMBER_08
+    prn EXTERNAL_NAME_NUMBER_09
+    prn EXTERNAL_NAME_NUMBER_10
+    prn EXTERNAL_NAME_NUMBER_11
+    prn EXTERNAL_NAME_NUMBER_12
+    prn EXTERNAL_NAME_NUMBER_13
+    prn EXTERNAL_NAME_NUMBER_14
+    prn EXTERNAL_NAME_NUMBER_15
+    prn EXTERNAL_NAME_NUMBER_16
+    prn EXTERNAL_NAME_NUMBER_17
+    prn EXTERNAL_NAME_NUMBER_18
+    prn EXTERNAL_NAME_NUMBER_19
+    prn EXTERNAL_NAME_NUMBER_20
+    prn EXTERNAL_NAME_NUMBER_21
+    prn EXTERNAL_NAME_NUMBER_22
+    prn EXTERNAL_NAME_NUMBER_23
+    prn EXTERNAL_NAME_NUMBER_24
+    prn EXTERNAL_NAME_NUMBER_25
+    prn EXTERNAL_NAME_NUMBER_26
+    prn EXTERNAL_NAME_NUMBER_27
+    prn EXTERNAL_NAME_NUMBER_28
+    prn EXTERNAL_NAME_NUMBER_29
+    prn EXTERNAL_NAME_NUMBER_30
+    prn EXTERNAL_NAME_NUMBER_31
+    prn EXTERNAL_NAME_NUMBER_32
+    prn EXTERNAL_NAME_NUMBER_33
+    prn EXTERNAL_NAME_NUMBER_34
+    prn EXTERNAL_NAME_NUMBER_35
+    prn EXTERNAL_NAME_NUMBER_36
+    prn EXTERNAL_NAME_NUMBER_37
+    prn EXTERNAL_NAME_NUMBER_38
+    prn EXTERNAL_NAME_NUMBER_39
+    PRINT_THE_FIRST_EXTERNALS
+    stop
+    .entry DATA_LABEL_NUMBER_00
+DATA_LABEL_NUMBER_00: .data 0
+    .entry DATA_LABEL_NUMBER_01
+DATA_LABEL_NUMBER_01: .data 1
+    .entry DATA_LABEL_NUMBER_02
+DATA_LABEL_NUMBER_02: .data 2
+    .entry DATA_LABEL_NUMBER_03
+DATA_LABEL_NUMBER_03: .data 3
+    .entry DATA_LABEL_NUMBER_04
+DATA_LABEL_NUMBER_04: .data 4
+    .entry DATA_LABEL_NUMBER_05
+DATA_LABEL_NUMBER_05: .data 5
+    .entry DATA_LABEL_NUMBER_06
+DATA_LABEL_NUMBER_06: .data 6
+    .entry DATA_LABEL_NUMBER_07
+DATA_LABEL_NUMBER_07: .data 7
+    .entry DATA_LABEL_NUMBER_08
+DATA_LABEL_NUMBER_08: .data 8
+    .entry DATA_LABEL_NUMBER_09
+DATA_LABEL_NUMBER_09: .data 9
+    .entry DATA_LABEL_NUMBER_10
+DATA_LABEL_NUMBER_10: .data 10
+    .entry DATA_LABEL_NUMBER_11
+DATA_LABEL_NUMBER_11: .data 11
+    .entry DATA_LABEL_NUMBER_12
+DATA_LABEL_NUMBER_12: .data 12
+    .entry DATA_LABEL_NUMBER_13
+DATA_LABEL_NUMBER_13: .data 13
+    .entry DATA_LABEL_NUMBER_14
+DATA_LABEL_NUMBER_14: .data 14
+    .entry DATA_LABEL_NUMBER_15
+DATA_LABEL_NUMBER_15: .data 15
+    .entry DATA_LABEL_NUMBER_16
+DATA_LABEL_NUMBER_16: .data 16
+    .entry DATA_LABEL_NUMBER_17
+DATA_LABEL_NUMBER_17: .data 17
+    .entry DATA_LABEL_NUMBER_18
+DATA_LABEL_NUMBER_18: .data 18
+    .entry DATA_LABEL_NUMBER_19
+DATA_LABEL_NUMBER_19: .data 19
+    .entry DATA_LABEL_NUMBER_20
+DATA_LABEL_NUMBER_20: .data 20
+    .entry DATA_LABEL_NUMBER_21
+DATA_LABEL_NUMBER_21: .data 21
+    .entry DATA_LABEL_NUMBER_22
+DATA_LABEL_NUMBER_22: .data 22
+    .entry DATA_LABEL_NUMBER_23
+DATA_LABEL_NUMBER_23: .data 23
+    .entry DATA_LABEL_NUMBER_24
+DATA_LABEL_NUMBER_24: .data 24
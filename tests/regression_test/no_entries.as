@@ -0,0 +1 @@
+MAIN: stop
@@ -0,0 +1,22 @@
+; forward references of every kind (patched by the backpatch chains)
+    .entry LOOP
+    .entry VALUES
+MAIN: jmp LOOP
+    mov VALUES, r1
+    cmp LATE, EARLY
+    lea GRID[r1][r2], r3
+    prn LATE
+    .extern SOME
+EARLY: inc r2
+LOOP: dec r1
+    bne LOOP
+    jsr END
+    prn LATE
+    add VALUES, GRID[r3][r4]
+    prn SOME
+    .extern LATE
+    jsr LATE
+END: stop
+VALUES: .data 7, -3
+GRID: .mat [2][2] 1, 2, 3, 4
+    .entry END
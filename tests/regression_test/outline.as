@@ -0,0 +1,16 @@
+; PUSH is expanded three times and outlined into a subroutine,
+; ONCE is expanded once and stays inline
+    mcro PUSH
+    mov r1, r2
+    add #4, r2
+    inc r3
+    mcroend
+    mcro ONCE
+    clr r4
+    mcroend
+MAIN: clr r1
+    PUSH
+    PUSH
+    ONCE
+    PUSH
+    stop
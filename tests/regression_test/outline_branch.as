@@ -0,0 +1,21 @@
+; the macro with a branch must stay inline, the other one is outlined
+    mcro COUNT
+    inc r1
+    inc r2
+    inc r3
+    mcroend
+
+    mcro SKIP
+    cmp r1, r2
+    bne DONE
+    inc r4
+    mcroend
+
+MAIN: clr r1
+    COUNT
+    COUNT
+    COUNT
+    SKIP
+    SKIP
+    SKIP
+DONE: stop
@@ -0,0 +1,23 @@
+#!/bin/sh
+# A macro with a control transfer instruction must not be outlined by --outline-macros.
+# usage: outline_branch.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(dirname "$0")
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR/outline_branch.as" "$WORK" || exit 1
+cd "$WORK" || exit 1
+
+"$ASSEMBLER" --outline-macros outline_branch > /dev/null || exit 1
+
+if ! grep -q "^COUNT_sub:" outline_branch.am; then
+    echo "the COUNT macro was not outlined"
+    exit 1
+fi
+if grep -q "SKIP_sub" outline_branch.am; then
+    echo "the SKIP macro (with a bne instruction) was outlined"
+    exit 1
+fi
+exit 0
@@ -0,0 +1,14 @@
+; the moves of a register to itself and the jumps to the next instruction are
+; removed, the labels and jumps move with them; the additions of zero set the
+; Z flag (read by bne), so they are kept
+MAIN: mov r1, r1
+    add #0, r2
+    jmp NEXT
+NEXT: prn #3
+    jmp SKIP
+SKIP: sub #0, r3
+    cmp r1, #0
+    bne MAIN
+    prn VALUE
+END: stop
+VALUE: .data 9
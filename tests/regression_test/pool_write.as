@@ -0,0 +1,16 @@
+; X and Y hold the same values, but X is written so both keep their storage
+; C is continued by unlabeled data, so D is not pooled (B is pooled with A)
+MAIN: mov #5, X
+    prn Y
+    prn A
+    prn B
+    prn C
+    prn D
+    stop
+X: .data 7, 8
+Y: .data 7, 8
+A: .data 1, 2
+B: .data 1, 2
+C: .data 3
+    .data 4
+D: .data 3
@@ -0,0 +1,10 @@
+; calls the macros of prelude_lib.as, and a macro of its own
+    mcro LOCAL
+    inc r3
+    mcroend
+MAIN: prn #1
+    SAVE_REGS
+    LOCAL
+    RESET
+    stop
+SAVED: .data 0
@@ -0,0 +1,10 @@
+; macros shared by the sources of a run (--macro-prelude)
+    mcro SAVE_REGS
+    mov r1, SAVED
+    mov r2, SAVED
+    mcroend
+
+    mcro RESET
+    clr r1
+    clr r2
+    mcroend
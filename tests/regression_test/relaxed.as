@@ -0,0 +1,5 @@
+; names and lines longer than the maximum lengths are accepted with --relaxed
+LONGONGONGONGONGONGONGONGONGONGONGONG: mov #1, r1
+    prn #1                                                                                          
+    jmp LONGONGONGONGONGONGONGONGONGONGONGONG
+MSGXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX: .string "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
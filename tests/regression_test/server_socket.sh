@@ -0,0 +1,76 @@
+#!/bin/sh
+# Requests forwarded by clients (--connect) to a socket server (--serve=<socket>) generate the same
+# files as the command line, in the client working directory, with the warm context and macro prelude
+# of the server reused between the requests, and a changed prelude read again. The requests are
+# answered by two worker processes, and a source may be sent with the request (--inline=<file>).
+# usage: server_socket.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d) || exit 1
+SOCKET="$WORK/server.sock"
+trap '"$ASSEMBLER" --connect="$SOCKET" quit > /dev/null 2>&1; rm -rf "$WORK"' EXIT
+
+mkdir "$WORK/valid" "$WORK/prelude" || exit 1
+cp "$DIR"/../valid_files_test/*.as "$WORK/valid" || exit 1
+cp "$DIR/prelude.as" "$DIR/prelude_lib.as" "$WORK/prelude" || exit 1
+
+"$ASSEMBLER" --serve="$SOCKET" --workers=2 > "$WORK/server.log" &
+for TRY in 1 2 3 4 5 6 7 8 9 10; do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+cd "$WORK/valid" || exit 1
+"$ASSEMBLER" --connect="$SOCKET" valid1 valid2 valid3 > /dev/null || exit 1
+
+RESULT=0
+for EXPECTED in "$DIR"/../valid_files_test/*; do
+    FILE=$(basename "$EXPECTED")
+    if ! cmp -s "$EXPECTED" "$FILE"; then
+        echo "$FILE differs from the expected file"
+        RESULT=1
+    fi
+done
+
+# the prelude is read by the first request only, and read again after it changed
+cd "$WORK/prelude" || exit 1
+for REQUEST in 1 2; do
+    "$ASSEMBLER" --connect="$SOCKET" --macro-prelude=prelude_lib.as prelude > "prelude$REQUEST.stdout" || exit 1
+    if ! cmp -s "$DIR/prelude.obj" prelude.obj; then
+        echo "prelude.obj differs from the expected file (request $REQUEST)"
+        RESULT=1
+    fi
+done
+cmp -s prelude1.stdout prelude2.stdout || { echo "prelude output differs on the warm request"; RESULT=1; }
+
+echo "stop" >> prelude_lib.as
+if "$ASSEMBLER" --connect="$SOCKET" --macro-prelude=prelude_lib.as prelude | grep -q "^File <prelude.as> assembled successfully."; then
+    echo "changed prelude was not read again"
+    RESULT=1
+fi
+
+# requests of two clients at the same time
+"$ASSEMBLER" --connect="$SOCKET" valid1 > concurrent1.stdout &
+CONCURRENT=$!
+"$ASSEMBLER" --connect="$SOCKET" valid2 > concurrent2.stdout || RESULT=1
+wait "$CONCURRENT" || RESULT=1
+
+# an inline source is assembled instead of the file on disk, on every request
+mkdir "$WORK/inline" && cd "$WORK/inline" || exit 1
+echo "MAIN: stop" > edited.as
+for REQUEST in 1 2; do
+    if ! cat "$DIR/../valid_files_test/valid1.as" | "$ASSEMBLER" --connect="$SOCKET" --inline=edited > "inline$REQUEST.stdout" ||
+       grep -q "unchanged" "inline$REQUEST.stdout" || ! cmp -s "$DIR/../valid_files_test/valid1.obj" edited.obj; then
+        echo "inline source was not assembled (request $REQUEST)"
+        RESULT=1
+    fi
+done
+
+# a failed request is reported in the client exit status
+if "$ASSEMBLER" --connect="$SOCKET" --bogus > /dev/null; then
+    echo "failed request returned a success status"
+    RESULT=1
+fi
+
+exit $RESULT
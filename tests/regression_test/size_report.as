@@ -0,0 +1,13 @@
+; words of every addressing mode, label and macro expansion
+    mcro TWICE
+    inc r1
+    inc r2
+    mcroend
+MAIN: mov #1, r2
+    TWICE
+    add ARR[r1][r2], COUNT
+    TWICE
+    stop
+COUNT: .data 7
+ARR: .mat [2][3] 1, 2, 3
+MSG: .string "size"
@@ -0,0 +1,57 @@
+; more instruction words, lines and address requests than a slab holds
+    mov #0, C0
+    mov #1, C1
+    mov #2, C2
+    mov #3, C3
+    mov #4, C4
+    mov #5, C0
+    mov #6, C1
+    mov #7, C2
+    mov #8, C3
+    mov #9, C4
+    mov #10, C0
+    mov #11, C1
+    mov #12, C2
+    mov #13, C3
+    mov #14, C4
+    mov #15, C0
+    mov #16, C1
+    mov #17, C2
+    mov #18, C3
+    mov #19, C4
+    mov #20, C0
+    mov #21, C1
+    mov #22, C2
+    mov #23, C3
+    mov #24, C4
+    mov #25, C0
+    mov #26, C1
+    mov #27, C2
+    mov #28, C3
+    mov #29, C4
+    mov #30, C0
+    mov #31, C1
+    mov #32, C2
+    mov #33, C3
+    mov #34, C4
+    mov #35, C0
+    mov #36, C1
+    mov #37, C2
+    mov #38, C3
+    mov #39, C4
+    mov #40, C0
+    mov #41, C1
+    mov #42, C2
+    mov #43, C3
+    mov #44, C4
+    mov #45, C0
+    mov #46, C1
+    mov #47, C2
+    mov #48, C3
+    mov #49, C4
+    stop
+C0: .data 0
+C1: .data 0
+C2: .data 0
+C3: .data 0
+C4: .data 0
@@ -0,0 +1,25 @@
+#!/bin/sh
+# --stats prints the stage statistics of the run after the summary: the data handed between the
+# stages (totals and largest file) are compared with stats.stdout, the times are masked.
+# usage: stats.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR/size_report.as" "$DIR/prelude.as" "$DIR/prelude_lib.as" "$WORK" || exit 1
+cd "$WORK" || exit 1
+
+"$ASSEMBLER" --stats --macro-prelude=prelude_lib.as size_report prelude > run.stdout || exit 1
+
+# from the summary on, with the time column masked
+sed -n '/^Summary:/,$p' run.stdout |
+    sed -E 's/^(  (preprocessor|passes|output files) +)[0-9]+\.[0-9]+ +/\1<time>      /' > stats.stdout
+
+if ! cmp -s "$DIR/stats.stdout" stats.stdout; then
+    echo "stats.stdout differs from the expected file:"
+    diff "$DIR/stats.stdout" stats.stdout
+    exit 1
+fi
+exit 0
@@ -0,0 +1,31 @@
+#!/bin/sh
+# A file is reported as assembled successfully only when its .obj and .bin files were written,
+# and a failed file leaves no .obj file (with every optional stage of the passes).
+# usage: success_outputs.sh <assembler>
+
+ASSEMBLER="$1"
+DIR=$(dirname "$0")
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR"/../valid_files_test/*.as "$DIR"/../invalid_files_test/*.as "$WORK" || exit 1
+cd "$WORK" || exit 1
+
+for FLAGS in "" "--pool-data" "--peephole" "--outline-macros" "--target=wide" "--one-pass" "--pool-data --peephole --outline-macros"; do
+    rm -f ./*.obj ./*.bin ./*.ent ./*.ext ./*.am
+    "$ASSEMBLER" $FLAGS ./*.as > run.log || exit 1
+
+    for SOURCE in ./*.as; do
+        NAME=$(basename "$SOURCE" .as)
+        if grep -q "^File <$NAME.as> assembled successfully." run.log; then
+            if [ ! -f "$NAME.obj" ] || [ ! -f "$NAME.bin" ]; then
+                echo "$NAME ($FLAGS): reported as assembled without its .obj/.bin files"
+                exit 1
+            fi
+        elif [ -f "$NAME.obj" ]; then
+            echo "$NAME ($FLAGS): failed but its .obj file was kept"
+            exit 1
+        fi
+    done
+done
+exit 0
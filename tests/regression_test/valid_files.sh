@@ -0,0 +1,43 @@
+#!/bin/sh
+# Assemble the files of tests/valid_files_test, and compare the generated files
+# (.am, .obj, .bin, .ent, .ext) with the expected files next to the sources.
+# With "batch", the valid files are assembled in a single run, between the files
+# of tests/invalid_files_test (the context is recycled after failed files too).
+# The other arguments are flags of every run (the outputs must not depend on them).
+# usage: valid_files.sh <assembler> [batch] [flags...]
+
+ASSEMBLER="$1"
+shift
+MODE=""
+if [ "$1" = "batch" ]; then
+    MODE="batch"
+    shift
+fi
+DIR=$(cd "$(dirname "$0")/../valid_files_test" && pwd)
+INVALID_DIR=$(cd "$(dirname "$0")/../invalid_files_test" && pwd)
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+cp "$DIR"/*.as "$INVALID_DIR"/*.as "$WORK" || exit 1
+cd "$WORK" || exit 1
+
+if [ "$MODE" = "batch" ]; then
+    "$ASSEMBLER" "$@" invalid1 valid1 invalid2 invalid3 valid2 invalid5 valid3 invalid7 > /dev/null || exit 1
+else
+    for SOURCE in valid*.as; do
+        "$ASSEMBLER" "$@" "$SOURCE" > /dev/null || exit 1
+    done
+fi
+
+RESULT=0
+for EXPECTED in "$DIR"/*; do
+    FILE=$(basename "$EXPECTED")
+    if [ ! -f "$FILE" ]; then
+        echo "$FILE was not generated"
+        RESULT=1
+    elif ! cmp -s "$EXPECTED" "$FILE"; then
+        echo "$FILE differs from the expected file"
+        RESULT=1
+    fi
+done
+exit $RESULT
@@ -0,0 +1,56 @@
+#!/bin/sh
+# The watch mode (--watch) keeps the errors of every run by the full path of their source (two
+# sources with the same name in different directories are kept apart), and prints only the
+# diagnostics added (+) or removed (-) since the previous run; an error moved by an edit is unchanged.
+# usage: watch.sh <assembler>
+
+ASSEMBLER="$1"
+WORK=$(mktemp -d) || exit 1
+trap 'kill "$WATCHER" 2> /dev/null; rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+mkdir first second || exit 1
+printf 'MAIN: mov r1, r2\n    jmp LOST\n    stop\n' > first/prog.as
+printf 'MAIN: mov r1, r2\n    stop\n' > second/prog.as
+
+"$ASSEMBLER" --watch first/prog second/prog.as > watch.out &
+WATCHER=$!
+
+# wait for the first run, then save every edit after the previous run
+wait_for_runs() {
+    for TRY in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20; do
+        [ "$(grep -c '^Watching' watch.out)" -ge "$1" ] && return 0
+        sleep 0.1
+    done
+    echo "run $1 not finished"
+    exit 1
+}
+
+wait_for_runs 1
+printf 'MAIN: mov r1, r2\n    jmp GONE\n    stop\n' > second/prog.as
+wait_for_runs 2
+printf '; a comment moves the error\nMAIN: mov r1, r2\n    jmp GONE\n    stop\n' > second/prog.as
+wait_for_runs 3
+printf 'MAIN: mov r1, r2\n    stop\n' > first/prog.as
+wait_for_runs 4
+
+kill "$WATCHER"
+tr -s '\n' < watch.out | sed 's/ *$//' | grep -E '^(Diagnostics|  |prog.as::)' > diagnostics.out
+
+cat > expected.out << 'EOF'
+prog.as::2: ERROR: Attempted to use an undeclared label.
+Diagnostics of <second/prog.as>:
+  + line 2: Attempted to use an undeclared label.
+Diagnostics of <second/prog.as>:
+  diagnostics unchanged (same as the last run)
+Diagnostics of <first/prog.as>:
+  - line 2: Attempted to use an undeclared label.
+EOF
+
+if ! cmp -s expected.out diagnostics.out; then
+    echo "unexpected diagnostics:"
+    cat diagnostics.out
+    exit 1
+fi
+
+exit 0
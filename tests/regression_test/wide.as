@@ -0,0 +1,7 @@
+; values and addresses that need the 16 bit words of the wide target
+MAIN: mov #5000, r1
+    prn #-8000
+    lea BIG, r2
+    jmp FAR
+FAR: stop
+BIG: .data 30000, -30000
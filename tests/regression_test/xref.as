@@ -0,0 +1,15 @@
+; every label with its definition, kind and uses (extern, entry, code and data)
+    .entry LOOP
+    .entry COUNT
+    .extern EXT
+MAIN: mov COUNT, r1
+LOOP: dec r1
+    cmp r1, #0
+    bne LOOP
+    jsr EXT
+    lea MAT[r1][r2], r3
+    prn EXT
+END: stop
+COUNT: .data 3
+MAT: .mat [2][2] 1, 2, 3, 4
+UNUSED: .string "ab"